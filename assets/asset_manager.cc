@@ -47,6 +47,36 @@ std::unique_ptr<fml::Mapping> AssetManager::GetAsMapping(
   return nullptr;
 }
 
+void AssetManager::GetAsMappingAsync(const std::string& asset_name,
+                                     fml::RefPtr<fml::TaskRunner> task_runner,
+                                     MappingCallback callback) const {
+  if (!task_runner || !callback) {
+    return;
+  }
+  task_runner->PostTask([self = shared_from_this(), asset_name, callback]() {
+    callback(self->GetAsMapping(asset_name));
+  });
+}
+
+void AssetManager::Prefetch(std::vector<std::string> asset_names,
+                            fml::RefPtr<fml::TaskRunner> task_runner) const {
+  if (!task_runner || asset_names.empty()) {
+    return;
+  }
+  task_runner->PostTask(
+      [self = shared_from_this(), asset_names = std::move(asset_names)]() {
+        TRACE_EVENT0("flutter", "AssetManager::Prefetch");
+        for (const auto& asset_name : asset_names) {
+          for (const auto& resolver : self->resolvers_) {
+            if (auto mapping = resolver->GetAsMapping(asset_name)) {
+              fml::PrefetchMapping(*mapping);
+              break;
+            }
+          }
+        }
+      });
+}
+
 // |AssetResolver|
 bool AssetManager::IsValid() const {
   return resolvers_.size() > 0;
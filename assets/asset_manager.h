@@ -6,17 +6,23 @@
 #define FLUTTER_ASSETS_ASSET_MANAGER_H_
 
 #include <deque>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "flutter/assets/asset_resolver.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
+#include "flutter/fml/task_runner.h"
 
 namespace flutter {
 
-class AssetManager final : public AssetResolver {
+class AssetManager final : public AssetResolver,
+                           public std::enable_shared_from_this<AssetManager> {
  public:
+  using MappingCallback = std::function<void(std::unique_ptr<fml::Mapping>)>;
+
   AssetManager();
 
   ~AssetManager() override;
@@ -32,6 +38,38 @@ class AssetManager final : public AssetResolver {
   std::unique_ptr<fml::Mapping> GetAsMapping(
       const std::string& asset_name) const override;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Resolves an asset on the given task runner instead of the
+  ///             calling thread. This is meant for callers on latency
+  ///             sensitive threads, where resolving an asset may block on
+  ///             disk access. The asset manager must be owned by a
+  ///             `std::shared_ptr` and is kept alive until the callback has
+  ///             been invoked. Resolvers must not be added while requests are
+  ///             pending.
+  ///
+  /// @param[in]  asset_name   The name of the asset.
+  /// @param[in]  task_runner  The task runner to resolve the asset on. This is
+  ///                          usually the IO task runner.
+  /// @param[in]  callback     Invoked on the task runner with the mapping of
+  ///                          the asset or nullptr if it could not be found.
+  ///
+  void GetAsMappingAsync(const std::string& asset_name,
+                         fml::RefPtr<fml::TaskRunner> task_runner,
+                         MappingCallback callback) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Resolves the given assets on the given task runner and hints
+  ///             to the system that they will be read soon. This moves the
+  ///             cost of reading the assets from storage off their first use.
+  ///             Assets that cannot be found are ignored. The same ownership
+  ///             requirements as `GetAsMappingAsync` apply.
+  ///
+  /// @param[in]  asset_names  The names of the assets that will be used soon.
+  /// @param[in]  task_runner  The task runner to resolve the assets on.
+  ///
+  void Prefetch(std::vector<std::string> asset_names,
+                fml::RefPtr<fml::TaskRunner> task_runner) const;
+
  private:
   std::deque<std::unique_ptr<AssetResolver>> resolvers_;
 
@@ -0,0 +1,109 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+
+#include "flutter/assets/asset_manager.h"
+#include "flutter/assets/packed_asset_bundle.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+std::shared_ptr<AssetManager> CreateAssetManager() {
+  PackedAssetBundle::Assets assets;
+  assets["FontManifest.json"] = std::make_unique<fml::DataMapping>("[]");
+  assets["fonts/Roboto.ttf"] = std::make_unique<fml::DataMapping>("roboto");
+
+  auto asset_manager = std::make_shared<AssetManager>();
+  asset_manager->PushBack(
+      std::make_unique<PackedAssetBundle>(PackedAssetBundle::Pack(assets)));
+  return asset_manager;
+}
+
+}  // namespace
+
+TEST(AssetManagerTest, ResolvesAssetsOnTheGivenTaskRunner) {
+  auto asset_manager = CreateAssetManager();
+  fml::Thread thread("io");
+  auto task_runner = thread.GetTaskRunner();
+
+  fml::AutoResetWaitableEvent latch;
+  bool resolved_on_task_runner = false;
+  std::string contents;
+  asset_manager->GetAsMappingAsync(
+      "fonts/Roboto.ttf", task_runner,
+      [&](std::unique_ptr<fml::Mapping> mapping) {
+        resolved_on_task_runner = task_runner->RunsTasksOnCurrentThread();
+        if (mapping) {
+          contents.assign(reinterpret_cast<const char*>(mapping->GetMapping()),
+                          mapping->GetSize());
+        }
+        latch.Signal();
+      });
+  latch.Wait();
+
+  ASSERT_TRUE(resolved_on_task_runner);
+  ASSERT_EQ(contents, "roboto");
+}
+
+TEST(AssetManagerTest, ResolvesMissingAssetsToNull) {
+  auto asset_manager = CreateAssetManager();
+  fml::Thread thread("io");
+
+  fml::AutoResetWaitableEvent latch;
+  bool found = true;
+  asset_manager->GetAsMappingAsync("missing.txt", thread.GetTaskRunner(),
+                                   [&](std::unique_ptr<fml::Mapping> mapping) {
+                                     found = mapping != nullptr;
+                                     latch.Signal();
+                                   });
+  latch.Wait();
+
+  ASSERT_FALSE(found);
+}
+
+TEST(AssetManagerTest, PendingRequestsKeepTheAssetManagerAlive) {
+  auto asset_manager = CreateAssetManager();
+  fml::Thread thread("io");
+  auto task_runner = thread.GetTaskRunner();
+
+  // Hold the task runner so that the request is pending when the last
+  // reference held by the caller goes away.
+  fml::AutoResetWaitableEvent blocker;
+  task_runner->PostTask([&blocker]() { blocker.Wait(); });
+
+  fml::AutoResetWaitableEvent latch;
+  bool found = false;
+  asset_manager->GetAsMappingAsync("FontManifest.json", task_runner,
+                                   [&](std::unique_ptr<fml::Mapping> mapping) {
+                                     found = mapping != nullptr;
+                                     latch.Signal();
+                                   });
+  asset_manager.reset();
+  blocker.Signal();
+  latch.Wait();
+
+  ASSERT_TRUE(found);
+}
+
+TEST(AssetManagerTest, PrefetchIgnoresMissingAssets) {
+  auto asset_manager = CreateAssetManager();
+  fml::Thread thread("io");
+  auto task_runner = thread.GetTaskRunner();
+
+  asset_manager->Prefetch({"FontManifest.json", "missing.txt"}, task_runner);
+
+  fml::AutoResetWaitableEvent latch;
+  task_runner->PostTask([&latch]() { latch.Signal(); });
+  latch.Wait();
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,294 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/packed_asset_bundle.h"
+
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr char kMagic[8] = {'F', 'L', 'T', 'P', 'A', 'C', 'K', '\0'};
+constexpr uint32_t kVersion = 1;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t slot_count;
+};
+
+// A slot in the hash table. Empty slots have a zero name size since assets
+// are never unnamed. Offsets are from the start of the archive.
+struct Slot {
+  uint64_t hash;
+  uint32_t name_offset;
+  uint32_t name_size;
+  uint64_t data_offset;
+  uint64_t data_size;
+};
+
+static_assert(sizeof(Header) == 16, "The archive layout must not change.");
+static_assert(sizeof(Slot) == 32, "The archive layout must not change.");
+
+// 64-bit FNV-1a, which is stable across hosts unlike std::hash.
+uint64_t HashName(const char* name, size_t size) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= static_cast<uint8_t>(name[i]);
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+size_t AlignUp(size_t offset, size_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+size_t GetSlotCount(size_t asset_count) {
+  // Keep the table at most half full so that probe sequences stay short.
+  size_t slot_count = 1;
+  while (slot_count < asset_count * 2) {
+    slot_count *= 2;
+  }
+  return slot_count;
+}
+
+bool IsInBounds(uint64_t offset, uint64_t size, uint64_t archive_size) {
+  return offset <= archive_size && size <= archive_size - offset;
+}
+
+bool CollectAssets(const fml::UniqueFD& directory,
+                   const std::string& prefix,
+                   PackedAssetBundle::Assets& assets) {
+  return fml::VisitFiles(directory, [&](const fml::UniqueFD& parent,
+                                        const std::string& filename) {
+    const auto asset_name = prefix + filename;
+    if (asset_name == PackedAssetBundle::kArchiveFileName) {
+      // An archive packed from this directory before.
+      return true;
+    }
+    if (fml::IsDirectory(parent, filename.c_str())) {
+      auto subdirectory = fml::OpenDirectoryReadOnly(parent, filename.c_str());
+      if (!subdirectory.is_valid()) {
+        FML_LOG(ERROR) << "Could not open asset directory: " << asset_name;
+        return false;
+      }
+      return CollectAssets(subdirectory, asset_name + "/", assets);
+    }
+    auto mapping = fml::FileMapping::CreateReadOnly(parent, filename);
+    if (!mapping) {
+      FML_LOG(ERROR) << "Could not read asset: " << asset_name;
+      return false;
+    }
+    assets[asset_name] = std::move(mapping);
+    return true;
+  });
+}
+
+}  // namespace
+
+PackedAssetBundle::PackedAssetBundle(std::unique_ptr<fml::Mapping> archive)
+    : archive_(std::move(archive)) {
+  is_valid_ = Validate();
+}
+
+PackedAssetBundle::~PackedAssetBundle() = default;
+
+bool PackedAssetBundle::Validate() {
+  if (!archive_ || archive_->GetMapping() == nullptr) {
+    return false;
+  }
+
+  const auto archive_size = archive_->GetSize();
+  const auto* data = archive_->GetMapping();
+  if (archive_size < sizeof(Header)) {
+    FML_DLOG(WARNING) << "Packed asset archive was truncated.";
+    return false;
+  }
+
+  Header header;
+  std::memcpy(&header, data, sizeof(Header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kVersion) {
+    FML_DLOG(WARNING) << "Packed asset archive had an unknown format.";
+    return false;
+  }
+
+  const uint64_t slot_count = header.slot_count;
+  if (slot_count == 0 || (slot_count & (slot_count - 1)) != 0 ||
+      !IsInBounds(sizeof(Header), slot_count * sizeof(Slot), archive_size)) {
+    FML_DLOG(WARNING) << "Packed asset archive had an invalid index.";
+    return false;
+  }
+
+  // Check every entry up front so that lookups never have to.
+  const auto* slots = reinterpret_cast<const Slot*>(data + sizeof(Header));
+  size_t asset_count = 0;
+  for (size_t i = 0; i < slot_count; i++) {
+    const auto& slot = slots[i];
+    if (slot.name_size == 0) {
+      continue;
+    }
+    if (!IsInBounds(slot.name_offset, slot.name_size, archive_size) ||
+        !IsInBounds(slot.data_offset, slot.data_size, archive_size)) {
+      FML_DLOG(WARNING) << "Packed asset archive had an invalid entry.";
+      return false;
+    }
+    asset_count++;
+  }
+
+  // Lookups stop at the first empty slot.
+  if (asset_count == slot_count) {
+    FML_DLOG(WARNING) << "Packed asset archive had a full index.";
+    return false;
+  }
+
+  slot_count_ = slot_count;
+  asset_count_ = asset_count;
+  return true;
+}
+
+std::unique_ptr<fml::Mapping> PackedAssetBundle::Pack(const Assets& assets) {
+  const size_t slot_count = GetSlotCount(assets.size());
+  const size_t names_offset = sizeof(Header) + slot_count * sizeof(Slot);
+
+  size_t names_size = 0;
+  for (const auto& asset : assets) {
+    names_size += asset.first.size();
+  }
+  if (names_offset + names_size > std::numeric_limits<uint32_t>::max() ||
+      slot_count > std::numeric_limits<uint32_t>::max()) {
+    FML_LOG(ERROR) << "Too many assets to pack.";
+    return nullptr;
+  }
+
+  size_t archive_size = AlignUp(names_offset + names_size, kPayloadAlignment);
+  for (const auto& asset : assets) {
+    const auto size = asset.second ? asset.second->GetSize() : 0;
+    archive_size = AlignUp(archive_size + size, kPayloadAlignment);
+  }
+
+  std::vector<uint8_t> archive(archive_size, 0);
+
+  Header header = {};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.slot_count = slot_count;
+  std::memcpy(archive.data(), &header, sizeof(Header));
+
+  auto* slots = reinterpret_cast<Slot*>(archive.data() + sizeof(Header));
+  size_t name_offset = names_offset;
+  size_t data_offset = AlignUp(names_offset + names_size, kPayloadAlignment);
+  for (const auto& asset : assets) {
+    const auto& name = asset.first;
+    if (name.empty()) {
+      FML_LOG(ERROR) << "Assets must be named.";
+      return nullptr;
+    }
+
+    const auto hash = HashName(name.data(), name.size());
+    size_t index = hash & (slot_count - 1);
+    while (slots[index].name_size != 0) {
+      index = (index + 1) & (slot_count - 1);
+    }
+
+    auto& slot = slots[index];
+    slot.hash = hash;
+    slot.name_offset = name_offset;
+    slot.name_size = name.size();
+    slot.data_offset = data_offset;
+    slot.data_size = asset.second ? asset.second->GetSize() : 0;
+
+    std::memcpy(archive.data() + name_offset, name.data(), name.size());
+    name_offset += name.size();
+
+    if (slot.data_size > 0) {
+      std::memcpy(archive.data() + data_offset, asset.second->GetMapping(),
+                  slot.data_size);
+    }
+    data_offset = AlignUp(data_offset + slot.data_size, kPayloadAlignment);
+  }
+
+  return std::make_unique<fml::DataMapping>(std::move(archive));
+}
+
+bool PackedAssetBundle::PackDirectory(
+    const fml::UniqueFD& assets_directory,
+    const fml::UniqueFD& destination_directory,
+    const char* file_name) {
+  TRACE_EVENT0("flutter", "PackedAssetBundle::PackDirectory");
+  if (!fml::IsDirectory(assets_directory)) {
+    FML_LOG(ERROR) << "The assets to pack were not in a directory.";
+    return false;
+  }
+
+  Assets assets;
+  if (!CollectAssets(assets_directory, "", assets)) {
+    return false;
+  }
+
+  auto archive = Pack(assets);
+  if (!archive) {
+    return false;
+  }
+
+  if (!fml::WriteAtomically(destination_directory, file_name, *archive)) {
+    FML_LOG(ERROR) << "Could not write the packed assets to " << file_name;
+    return false;
+  }
+  return true;
+}
+
+size_t PackedAssetBundle::GetAssetCount() const {
+  return asset_count_;
+}
+
+// |AssetResolver|
+bool PackedAssetBundle::IsValid() const {
+  return is_valid_;
+}
+
+// |AssetResolver|
+std::unique_ptr<fml::Mapping> PackedAssetBundle::GetAsMapping(
+    const std::string& asset_name) const {
+  if (!is_valid_) {
+    FML_DLOG(WARNING) << "Asset bundle was not valid.";
+    return nullptr;
+  }
+
+  if (asset_name.empty()) {
+    return nullptr;
+  }
+
+  const auto* data = archive_->GetMapping();
+  const auto* slots = reinterpret_cast<const Slot*>(data + sizeof(Header));
+  const auto hash = HashName(asset_name.data(), asset_name.size());
+  const size_t mask = slot_count_ - 1;
+
+  // The table is never full, so an empty slot always ends the probe.
+  for (size_t index = hash & mask;; index = (index + 1) & mask) {
+    const auto& slot = slots[index];
+    if (slot.name_size == 0) {
+      return nullptr;
+    }
+    if (slot.hash != hash || slot.name_size != asset_name.size() ||
+        std::memcmp(data + slot.name_offset, asset_name.data(),
+                    slot.name_size) != 0) {
+      continue;
+    }
+    return std::make_unique<fml::NonOwnedMapping>(
+        data + slot.data_offset, slot.data_size,
+        [archive = archive_](const uint8_t*, size_t) {});
+  }
+}
+
+}  // namespace flutter
@@ -0,0 +1,100 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
+#define FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "flutter/assets/asset_resolver.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Resolves assets from a single packed archive instead of one file
+///             per asset.
+///
+///             The archive starts with an open addressing hash table keyed by
+///             asset name, followed by the asset names and then the asset
+///             payloads, each aligned to a page boundary. When the archive is
+///             backed by a single file mapping, looking up an asset does not
+///             make any system calls and the returned mapping points directly
+///             into the archive.
+///
+///             Archives are created with `Pack` or `PackDirectory` (see
+///             //flutter/tools/pack_assets) and use the byte order of the
+///             host that created them. An archive named `kArchiveFileName` in
+///             an assets directory is resolved ahead of the directory by
+///             `RunConfiguration::InferFromSettings`.
+///
+class PackedAssetBundle : public AssetResolver {
+ public:
+  using Assets = std::map<std::string, std::unique_ptr<fml::Mapping>>;
+
+  static constexpr size_t kPayloadAlignment = 4096;
+
+  // The name of the archive that is looked for in assets directories.
+  static constexpr char kArchiveFileName[] = "assets.pack";
+
+  explicit PackedAssetBundle(std::unique_ptr<fml::Mapping> archive);
+
+  ~PackedAssetBundle() override;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Packs the given assets into an archive.
+  ///
+  /// @return     The archive or nullptr if the assets are too large to be
+  ///             indexed.
+  ///
+  static std::unique_ptr<fml::Mapping> Pack(const Assets& assets);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Packs all the files in a directory and its subdirectories
+  ///             into an archive. Assets are named by their path relative to
+  ///             the directory, as they would be when resolved by a
+  ///             `DirectoryAssetBundle` for the same directory. An archive
+  ///             named `kArchiveFileName` at the top of the directory is not
+  ///             packed.
+  ///
+  /// @param[in]  assets_directory       The directory containing the assets.
+  /// @param[in]  destination_directory  The directory to write the archive
+  ///                                    to.
+  /// @param[in]  file_name              The file name of the archive.
+  ///
+  /// @return     If the archive was written.
+  ///
+  static bool PackDirectory(const fml::UniqueFD& assets_directory,
+                            const fml::UniqueFD& destination_directory,
+                            const char* file_name);
+
+  size_t GetAssetCount() const;
+
+  // |AssetResolver|
+  bool IsValid() const override;
+
+  // |AssetResolver|
+  std::unique_ptr<fml::Mapping> GetAsMapping(
+      const std::string& asset_name) const override;
+
+ private:
+  // Shared with the mappings returned for each asset so that the archive
+  // outlives them.
+  std::shared_ptr<fml::Mapping> archive_;
+  size_t slot_count_ = 0;
+  size_t asset_count_ = 0;
+  bool is_valid_ = false;
+
+  bool Validate();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PackedAssetBundle);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
@@ -0,0 +1,104 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/assets/packed_asset_bundle.h"
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/mapping.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr size_t kAssetSize = 1024;
+constexpr size_t kAssetsPerDirectory = 32;
+
+// Writes |count| small assets spread across subdirectories and returns their
+// names.
+std::vector<std::string> WriteAssets(const fml::UniqueFD& directory,
+                                     size_t count) {
+  std::vector<std::string> names;
+  const fml::DataMapping contents(std::vector<uint8_t>(kAssetSize, 0x42));
+  for (size_t i = 0; i < count; i++) {
+    const auto subdirectory_name =
+        "directory_" + std::to_string(i / kAssetsPerDirectory);
+    const auto file_name = "asset_" + std::to_string(i) + ".bin";
+    auto subdirectory = fml::CreateDirectory(
+        directory, {subdirectory_name}, fml::FilePermission::kReadWrite);
+    FML_CHECK(fml::WriteAtomically(subdirectory, file_name.c_str(), contents));
+    names.push_back(subdirectory_name + "/" + file_name);
+  }
+  return names;
+}
+
+void ResolveAll(benchmark::State& state,
+                const AssetResolver& resolver,
+                const std::vector<std::string>& names) {
+  while (state.KeepRunning()) {
+    for (const auto& name : names) {
+      auto mapping = resolver.GetAsMapping(name);
+      benchmark::DoNotOptimize(mapping->GetMapping()[0]);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * names.size());
+}
+
+}  // namespace
+
+static void BM_DirectoryAssetBundleLookup(benchmark::State& state) {
+  fml::ScopedTemporaryDirectory assets_directory;
+  const auto names = WriteAssets(assets_directory.fd(), state.range(0));
+
+  DirectoryAssetBundle bundle(fml::OpenDirectory(
+      assets_directory.path().c_str(), false, fml::FilePermission::kRead));
+  ResolveAll(state, bundle, names);
+
+  fml::RemoveFilesInDirectory(assets_directory.fd());
+}
+
+static void BM_PackedAssetBundleLookup(benchmark::State& state) {
+  fml::ScopedTemporaryDirectory assets_directory;
+  const auto names = WriteAssets(assets_directory.fd(), state.range(0));
+
+  fml::ScopedTemporaryDirectory output_directory;
+  FML_CHECK(PackedAssetBundle::PackDirectory(
+      assets_directory.fd(), output_directory.fd(), "assets.pack"));
+
+  PackedAssetBundle bundle(
+      fml::FileMapping::CreateReadOnly(output_directory.fd(), "assets.pack"));
+  FML_CHECK(bundle.IsValid());
+  ResolveAll(state, bundle, names);
+
+  fml::RemoveFilesInDirectory(assets_directory.fd());
+  fml::RemoveFilesInDirectory(output_directory.fd());
+}
+
+static void BM_PackedAssetBundleOpen(benchmark::State& state) {
+  fml::ScopedTemporaryDirectory assets_directory;
+  WriteAssets(assets_directory.fd(), state.range(0));
+
+  fml::ScopedTemporaryDirectory output_directory;
+  FML_CHECK(PackedAssetBundle::PackDirectory(
+      assets_directory.fd(), output_directory.fd(), "assets.pack"));
+
+  while (state.KeepRunning()) {
+    PackedAssetBundle bundle(
+        fml::FileMapping::CreateReadOnly(output_directory.fd(), "assets.pack"));
+    benchmark::DoNotOptimize(bundle.IsValid());
+  }
+
+  fml::RemoveFilesInDirectory(assets_directory.fd());
+  fml::RemoveFilesInDirectory(output_directory.fd());
+}
+
+BENCHMARK(BM_DirectoryAssetBundleLookup)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK(BM_PackedAssetBundleLookup)->RangeMultiplier(4)->Range(16, 1024);
+BENCHMARK(BM_PackedAssetBundleOpen)->RangeMultiplier(4)->Range(16, 1024);
+
+}  // namespace flutter
@@ -0,0 +1,147 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "flutter/assets/packed_asset_bundle.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+std::string ToString(const fml::Mapping& mapping) {
+  return std::string(reinterpret_cast<const char*>(mapping.GetMapping()),
+                     mapping.GetSize());
+}
+
+PackedAssetBundle::Assets CreateAssets() {
+  PackedAssetBundle::Assets assets;
+  assets["AssetManifest.json"] = std::make_unique<fml::DataMapping>("{}");
+  assets["fonts/Roboto.ttf"] = std::make_unique<fml::DataMapping>("roboto");
+  assets["empty.txt"] =
+      std::make_unique<fml::DataMapping>(std::vector<uint8_t>{});
+  return assets;
+}
+
+bool WriteFile(const fml::UniqueFD& directory,
+               const char* name,
+               const std::string& contents) {
+  return fml::WriteAtomically(directory, name, fml::DataMapping(contents));
+}
+
+}  // namespace
+
+TEST(PackedAssetBundleTest, ResolvesPackedAssets) {
+  PackedAssetBundle bundle(PackedAssetBundle::Pack(CreateAssets()));
+  ASSERT_TRUE(bundle.IsValid());
+  ASSERT_EQ(bundle.GetAssetCount(), 3u);
+
+  auto manifest = bundle.GetAsMapping("AssetManifest.json");
+  ASSERT_NE(manifest, nullptr);
+  ASSERT_EQ(ToString(*manifest), "{}");
+
+  auto font = bundle.GetAsMapping("fonts/Roboto.ttf");
+  ASSERT_NE(font, nullptr);
+  ASSERT_EQ(ToString(*font), "roboto");
+
+  auto empty = bundle.GetAsMapping("empty.txt");
+  ASSERT_NE(empty, nullptr);
+  ASSERT_EQ(empty->GetSize(), 0u);
+
+  ASSERT_EQ(bundle.GetAsMapping("fonts/Roboto"), nullptr);
+  ASSERT_EQ(bundle.GetAsMapping(""), nullptr);
+}
+
+TEST(PackedAssetBundleTest, MappingsOutliveTheBundle) {
+  std::unique_ptr<fml::Mapping> font;
+  {
+    PackedAssetBundle bundle(PackedAssetBundle::Pack(CreateAssets()));
+    font = bundle.GetAsMapping("fonts/Roboto.ttf");
+  }
+  ASSERT_NE(font, nullptr);
+  ASSERT_EQ(ToString(*font), "roboto");
+}
+
+TEST(PackedAssetBundleTest, PacksDirectoriesWithPageAlignedPayloads) {
+  fml::ScopedTemporaryDirectory assets_directory;
+  auto fonts = fml::CreateDirectory(assets_directory.fd(), {"fonts"},
+                                    fml::FilePermission::kReadWrite);
+  ASSERT_TRUE(fonts.is_valid());
+  ASSERT_TRUE(WriteFile(assets_directory.fd(), "AssetManifest.json", "{}"));
+  ASSERT_TRUE(WriteFile(fonts, "Roboto.ttf", "roboto"));
+
+  fml::ScopedTemporaryDirectory output_directory;
+  ASSERT_TRUE(PackedAssetBundle::PackDirectory(
+      assets_directory.fd(), output_directory.fd(), "assets.pack"));
+
+  PackedAssetBundle bundle(
+      fml::FileMapping::CreateReadOnly(output_directory.fd(), "assets.pack"));
+  ASSERT_TRUE(bundle.IsValid());
+  ASSERT_EQ(bundle.GetAssetCount(), 2u);
+
+  for (const auto* name : {"AssetManifest.json", "fonts/Roboto.ttf"}) {
+    auto mapping = bundle.GetAsMapping(name);
+    ASSERT_NE(mapping, nullptr) << name;
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(mapping->GetMapping()) %
+                  PackedAssetBundle::kPayloadAlignment,
+              0u)
+        << name;
+  }
+  ASSERT_EQ(ToString(*bundle.GetAsMapping("fonts/Roboto.ttf")), "roboto");
+
+  fml::RemoveFilesInDirectory(assets_directory.fd());
+  fml::RemoveFilesInDirectory(output_directory.fd());
+}
+
+TEST(PackedAssetBundleTest, RepackingSkipsThePreviousArchive) {
+  fml::ScopedTemporaryDirectory assets_directory;
+  ASSERT_TRUE(WriteFile(assets_directory.fd(), "AssetManifest.json", "{}"));
+  for (int i = 0; i < 2; i++) {
+    ASSERT_TRUE(PackedAssetBundle::PackDirectory(
+        assets_directory.fd(), assets_directory.fd(),
+        PackedAssetBundle::kArchiveFileName));
+  }
+
+  PackedAssetBundle bundle(fml::FileMapping::CreateReadOnly(
+      assets_directory.fd(), PackedAssetBundle::kArchiveFileName));
+  ASSERT_TRUE(bundle.IsValid());
+  ASSERT_EQ(bundle.GetAssetCount(), 1u);
+  ASSERT_EQ(bundle.GetAsMapping(PackedAssetBundle::kArchiveFileName), nullptr);
+
+  fml::RemoveFilesInDirectory(assets_directory.fd());
+}
+
+TEST(PackedAssetBundleTest, RejectsInvalidArchives) {
+  ASSERT_FALSE(PackedAssetBundle(nullptr).IsValid());
+  ASSERT_FALSE(PackedAssetBundle(std::make_unique<fml::DataMapping>("FLTPACK"))
+                   .IsValid());
+
+  auto archive = PackedAssetBundle::Pack(CreateAssets());
+  ASSERT_NE(archive, nullptr);
+  std::vector<uint8_t> bytes(archive->GetMapping(),
+                             archive->GetMapping() + archive->GetSize());
+
+  auto corrupt_magic = bytes;
+  corrupt_magic[0] = 'X';
+  ASSERT_FALSE(PackedAssetBundle(
+                   std::make_unique<fml::DataMapping>(std::move(corrupt_magic)))
+                   .IsValid());
+
+  // Cutting off the payloads leaves entries that point past the archive.
+  auto truncated = bytes;
+  truncated.resize(PackedAssetBundle::kPayloadAlignment);
+  ASSERT_FALSE(PackedAssetBundle(
+                   std::make_unique<fml::DataMapping>(std::move(truncated)))
+                   .IsValid());
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -20,6 +20,28 @@
 
 namespace flutter {
 
+// The state of the raster cache at the end of a frame.
+struct RasterCacheFrameStats {
+  size_t layer_count = 0;
+  size_t layer_bytes = 0;
+  size_t picture_count = 0;
+  size_t picture_bytes = 0;
+  size_t shadow_count = 0;
+  size_t shadow_bytes = 0;
+  // The number of entries rasterized into the cache during the frame, and the
+  // time spent doing so.
+  size_t populated_count = 0;
+  fml::TimeDelta population_time;
+  // The draws of pictures hinted to change that were made from a rendition
+  // rasterized at a nearby scale, and those that found none ready.
+  size_t scaled_picture_hits = 0;
+  size_t scaled_picture_misses = 0;
+  // The smallest ratio of the scale a rendition was drawn at to the scale it
+  // was rasterized at, or 1 if there were no such draws. Lower ratios waste
+  // more of the rendition's pixels.
+  double scaled_picture_min_residual_scale = 1.0;
+};
+
 class FrameTiming {
  public:
   enum Phase { kBuildStart, kBuildFinish, kRasterStart, kRasterFinish, kCount };
@@ -27,13 +49,43 @@ class FrameTiming {
   static constexpr Phase kPhases[kCount] = {kBuildStart, kBuildFinish,
                                             kRasterStart, kRasterFinish};
 
+  // The steps of the raster phase. Unlike |Phase|, these are not reported to
+  // the framework. Steps that did not happen in a frame are left at zero.
+  enum RasterPhase {
+    kPrerollStart,
+    kPrerollFinish,
+    kPaintStart,
+    kPaintFinish,
+    kFlushStart,
+    kFlushFinish,
+    kPresentStart,
+    kPresentFinish,
+    kRasterPhaseCount
+  };
+
   fml::TimePoint Get(Phase phase) const { return data_[phase]; }
   fml::TimePoint Set(Phase phase, fml::TimePoint value) {
     return data_[phase] = value;
   }
 
+  fml::TimePoint GetRasterPhase(RasterPhase phase) const {
+    return raster_data_[phase];
+  }
+  fml::TimePoint SetRasterPhase(RasterPhase phase, fml::TimePoint value) {
+    return raster_data_[phase] = value;
+  }
+
+  const RasterCacheFrameStats& GetRasterCacheStats() const {
+    return raster_cache_stats_;
+  }
+  void SetRasterCacheStats(const RasterCacheFrameStats& stats) {
+    raster_cache_stats_ = stats;
+  }
+
  private:
   fml::TimePoint data_[kCount];
+  fml::TimePoint raster_data_[kRasterPhaseCount];
+  RasterCacheFrameStats raster_cache_stats_;
 };
 
 using TaskObserverAdd =
@@ -95,6 +147,10 @@ struct Settings {
   std::string trace_whitelist;
   bool trace_startup = false;
   bool trace_systrace = false;
+  // A comma separated list of the trace event categories recorded by the
+  // in-process trace recorder, or "*" for all categories. Unlike the timeline,
+  // the recorder is also available in release builds.
+  std::string trace_recorder_categories;
   bool dump_skp_on_shader_compilation = false;
   bool cache_sksl = false;
   bool endless_trace_buffer = false;
@@ -173,6 +229,14 @@ struct Settings {
   UnhandledExceptionCallback unhandled_exception_callback;
   bool enable_software_rendering = false;
   bool skia_deterministic_rendering_on_cpu = false;
+  // Whether the raster cache keeps pictures hinted to change at a few fixed
+  // scales and draws them scaled to the scales in between, so that they stay
+  // cached through scale animations and pinch-zooms.
+  bool scale_tolerant_raster_cache = false;
+  // The most bytes the GPU resource caches of all the engines in the process
+  // may hold together, or 0 for no process-wide limit. Shells created with a
+  // non-zero value set the limit of the process-wide ResourceCacheBudget.
+  size_t resource_cache_budget_bytes = 0;
   bool verbose_logging = false;
   std::string log_tag = "flutter";
 
@@ -4,13 +4,17 @@
 
 #include "flutter/flow/compositor_context.h"
 
+#include <algorithm>
+
 #include "flutter/flow/layers/layer_tree.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 
 namespace flutter {
 
 CompositorContext::CompositorContext(fml::Milliseconds frame_budget)
-    : raster_time_(frame_budget), ui_time_(frame_budget) {}
+    : frame_budget_(frame_budget),
+      raster_time_(frame_budget),
+      ui_time_(frame_budget) {}
 
 CompositorContext::~CompositorContext() = default;
 
@@ -18,6 +22,16 @@ void CompositorContext::BeginFrame(ScopedFrame& frame,
                                    bool enable_instrumentation) {
   if (enable_instrumentation) {
     frame_count_.Increment();
+    // Let the raster cache populate itself in what the last frame would have
+    // left of the frame budget had it not populated the cache.
+    const fml::TimeDelta last_frame_time =
+        raster_time_.LastLap() -
+        raster_cache_.GetLastFrameStats().population_time;
+    const fml::TimeDelta slack =
+        fml::TimeDelta::FromMillisecondsF(frame_budget_.count()) -
+        last_frame_time;
+    raster_cache_.SetPopulationBudget(
+        std::max(slack, fml::TimeDelta::Zero()));
     raster_time_.Start();
   }
 }
@@ -71,7 +85,9 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
     flutter::LayerTree& layer_tree,
     bool ignore_raster_cache) {
   TRACE_EVENT0("flutter", "CompositorContext::ScopedFrame::Raster");
+  RecordRasterPhase(FrameTiming::kPrerollStart);
   bool root_needs_readback = layer_tree.Preroll(*this, ignore_raster_cache);
+  RecordRasterPhase(FrameTiming::kPrerollFinish);
   bool needs_save_layer = root_needs_readback && !surface_supports_readback();
   PostPrerollResult post_preroll_result = PostPrerollResult::kSuccess;
   if (view_embedder_ && raster_thread_merger_) {
@@ -84,6 +100,7 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
   }
   // Clearing canvas after preroll reduces one render target switch when preroll
   // paints some raster cache.
+  RecordRasterPhase(FrameTiming::kPaintStart);
   if (canvas()) {
     if (needs_save_layer) {
       FML_LOG(INFO) << "Using SaveLayer to protect non-readback surface";
@@ -98,6 +115,7 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
   if (canvas() && needs_save_layer) {
     canvas()->restore();
   }
+  RecordRasterPhase(FrameTiming::kPaintFinish);
   return RasterStatus::kSuccess;
 }
 
@@ -8,6 +8,7 @@
 #include <memory>
 #include <string>
 
+#include "flutter/common/settings.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/instrumentation.h"
 #include "flutter/flow/raster_cache.h"
@@ -64,9 +65,22 @@ class CompositorContext {
 
     GrContext* gr_context() const { return gr_context_; }
 
+    // If set, |Raster| records the timestamps of the preroll and paint steps
+    // into |frame_timing|, which must outlive this frame.
+    void set_frame_timing(FrameTiming* frame_timing) {
+      frame_timing_ = frame_timing;
+    }
+
     virtual RasterStatus Raster(LayerTree& layer_tree,
                                 bool ignore_raster_cache);
 
+   protected:
+    void RecordRasterPhase(FrameTiming::RasterPhase phase) {
+      if (frame_timing_) {
+        frame_timing_->SetRasterPhase(phase, fml::TimePoint::Now());
+      }
+    }
+
    private:
     CompositorContext& context_;
     GrContext* gr_context_;
@@ -76,6 +90,7 @@ class CompositorContext {
     const bool instrumentation_enabled_;
     const bool surface_supports_readback_;
     fml::RefPtr<fml::RasterThreadMerger> raster_thread_merger_;
+    FrameTiming* frame_timing_ = nullptr;
 
     FML_DISALLOW_COPY_AND_ASSIGN(ScopedFrame);
   };
@@ -108,6 +123,7 @@ class CompositorContext {
   Stopwatch& ui_time() { return ui_time_; }
 
  private:
+  const fml::Milliseconds frame_budget_;
   RasterCache raster_cache_;
   TextureRegistry texture_registry_;
   Counter frame_count_;
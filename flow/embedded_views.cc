@@ -13,29 +13,37 @@ bool ExternalViewEmbedder::SubmitFrame(GrContext* context,
 
 void ExternalViewEmbedder::FinishFrame(){};
 
+MutatorsStack::MutatorsStack(fml::RefPtr<LayerArena> arena)
+    : arena_(std::move(arena)) {}
+
+template <typename... Args>
+void MutatorsStack::Push(Args&&... args) {
+  if (arena_) {
+    vector_.push_back(
+        arena_->MakeShared<Mutator>(std::forward<Args>(args)...));
+  } else {
+    vector_.push_back(std::make_shared<Mutator>(std::forward<Args>(args)...));
+  }
+}
+
 void MutatorsStack::PushClipRect(const SkRect& rect) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(rect);
-  vector_.push_back(element);
+  Push(rect);
 };
 
 void MutatorsStack::PushClipRRect(const SkRRect& rrect) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(rrect);
-  vector_.push_back(element);
+  Push(rrect);
 };
 
 void MutatorsStack::PushClipPath(const SkPath& path) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(path);
-  vector_.push_back(element);
+  Push(path);
 };
 
 void MutatorsStack::PushTransform(const SkMatrix& matrix) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(matrix);
-  vector_.push_back(element);
+  Push(matrix);
 };
 
 void MutatorsStack::PushOpacity(const int& alpha) {
-  std::shared_ptr<Mutator> element = std::make_shared<Mutator>(alpha);
-  vector_.push_back(element);
+  Push(alpha);
 };
 
 void MutatorsStack::Pop() {
@@ -7,6 +7,7 @@
 
 #include <vector>
 
+#include "flutter/flow/layer_arena.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/raster_thread_merger.h"
 #include "third_party/skia/include/core/SkCanvas.h"
@@ -127,6 +128,10 @@ class MutatorsStack {
  public:
   MutatorsStack() = default;
 
+  // Makes a stack that allocates its mutators from |arena|. Copies of the
+  // stack share the arena.
+  explicit MutatorsStack(fml::RefPtr<LayerArena> arena);
+
   void PushClipRect(const SkRect& rect);
   void PushClipRRect(const SkRRect& rrect);
   void PushClipPath(const SkPath& path);
@@ -179,6 +184,10 @@ class MutatorsStack {
 
  private:
   std::vector<std::shared_ptr<Mutator>> vector_;
+  fml::RefPtr<LayerArena> arena_;
+
+  template <typename... Args>
+  void Push(Args&&... args);
 };  // MutatorsStack
 
 class EmbeddedViewParams {
@@ -0,0 +1,89 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layer_arena.h"
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+// The start of each block. The memory handed out follows it, aligned for any
+// type.
+struct alignas(std::max_align_t) LayerArena::Block {
+  // Held by the arena and by each allocation made with a reference.
+  std::atomic<size_t> ref_count{1};
+
+  static Block* Create(size_t size) {
+    return new (::operator new(sizeof(Block) + size)) Block();
+  }
+
+  uintptr_t data() { return reinterpret_cast<uintptr_t>(this + 1); }
+
+  void Release() {
+    if (ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      this->~Block();
+      ::operator delete(this);
+    }
+  }
+};
+
+LayerArena::LayerArena() = default;
+
+LayerArena::~LayerArena() {
+  for (Block* block : blocks_) {
+    block->Release();
+  }
+}
+
+void* LayerArena::Allocate(size_t size, size_t alignment) {
+  return Allocate(size, alignment, 0);
+}
+
+void* LayerArena::AllocateReferenced(size_t size, size_t alignment) {
+  // The block is recorded just before the allocation.
+  alignment = std::max(alignment, alignof(Block*));
+  void* pointer = Allocate(size, alignment, sizeof(Block*));
+  Block* block = blocks_.back();
+  block->ref_count.fetch_add(1, std::memory_order_relaxed);
+  static_cast<Block**>(pointer)[-1] = block;
+  return pointer;
+}
+
+// static
+void LayerArena::ReleaseReferenced(void* pointer) {
+  static_cast<Block**>(pointer)[-1]->Release();
+}
+
+void* LayerArena::Allocate(size_t size, size_t alignment, size_t prefix) {
+  FML_DCHECK(alignment > 0 && (alignment & (alignment - 1)) == 0);
+  FML_DCHECK(alignment <= alignof(std::max_align_t));
+
+  const auto align = [alignment](uintptr_t value) {
+    return (value + alignment - 1) & ~(alignment - 1);
+  };
+  uintptr_t start = align(cursor_ + prefix);
+  if (cursor_ == 0 || start + size > end_) {
+    // Blocks are aligned for any type, so the padding before |start| only
+    // depends on |prefix|.
+    const size_t block_size =
+        std::max<size_t>(align(prefix) + size, next_block_size_);
+    next_block_size_ = std::min(next_block_size_ * 2, kMaxBlockSize);
+    blocks_.push_back(Block::Create(block_size));
+    stats_.block_count++;
+    const uintptr_t data = blocks_.back()->data();
+    start = data + align(prefix);
+    end_ = data + block_size;
+  }
+  cursor_ = start + size;
+
+  stats_.allocation_count++;
+  stats_.allocated_bytes += size;
+  return reinterpret_cast<void*>(start);
+}
+
+}  // namespace flutter
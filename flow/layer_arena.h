@@ -0,0 +1,140 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_LAYER_ARENA_H_
+#define FLUTTER_FLOW_LAYER_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/ref_counted.h"
+#include "flutter/fml/memory/ref_ptr.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Allocates the layers or mutators of a frame from a few large
+///             blocks rather than one by one from the heap.
+///
+///             Objects made by the arena are still owned through
+///             `std::shared_ptr`s, so layers the framework retains for later
+///             frames keep working. The arena and each object made from it
+///             hold a reference to the block the object was allocated from,
+///             and a block is freed once none of them remain. So once the
+///             arena is gone, an object retained for later frames keeps only
+///             its own block alive rather than the whole frame. The memory of
+///             objects released before their block is freed is not reused.
+///
+///             Allocating is not thread safe, but objects made by the arena
+///             may be released on any thread, and may outlive the arena.
+///
+class LayerArena : public fml::RefCountedThreadSafe<LayerArena> {
+ public:
+  // An allocator for `std::allocate_shared` that allocates from an arena and
+  // keeps the block of the allocated object alive while the object is.
+  template <typename T>
+  class Allocator {
+   public:
+    using value_type = T;
+
+    explicit Allocator(LayerArena* arena) : arena_(arena) {}
+
+    template <typename U>
+    Allocator(const Allocator<U>& other) : arena_(other.arena_) {}
+
+    T* allocate(size_t count) {
+      return static_cast<T*>(
+          arena_->AllocateReferenced(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* pointer, size_t count) {
+      LayerArena::ReleaseReferenced(pointer);
+    }
+
+    template <typename U>
+    bool operator==(const Allocator<U>& other) const {
+      return arena_ == other.arena_;
+    }
+
+    template <typename U>
+    bool operator!=(const Allocator<U>& other) const {
+      return arena_ != other.arena_;
+    }
+
+   private:
+    template <typename U>
+    friend class Allocator;
+
+    // Only used to allocate, which the arena's owner does while it is alive.
+    // Releasing needs just the object's block.
+    LayerArena* arena_;
+  };
+
+  struct Stats {
+    // The number of allocations served by the arena.
+    size_t allocation_count = 0;
+    // The bytes allocated from the arena.
+    size_t allocated_bytes = 0;
+    // The number of blocks the arena allocated from the heap.
+    size_t block_count = 0;
+  };
+
+  // The size of the first block. Later blocks double in size up to
+  // |kMaxBlockSize|.
+  static constexpr size_t kInitialBlockSize = 4 * 1024;
+  static constexpr size_t kMaxBlockSize = 64 * 1024;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Makes an object owned by a `std::shared_ptr` in the arena.
+  ///
+  template <typename T, typename... Args>
+  std::shared_ptr<T> MakeShared(Args&&... args) {
+    return std::allocate_shared<T>(Allocator<T>(this),
+                                   std::forward<Args>(args)...);
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Allocates |size| bytes aligned to |alignment|, which must be
+  ///             a power of two no greater than `alignof(std::max_align_t)`.
+  ///             The memory is freed along with the arena.
+  ///
+  void* Allocate(size_t size, size_t alignment);
+
+  const Stats& stats() const { return stats_; }
+
+ private:
+  struct Block;
+
+  std::vector<Block*> blocks_;
+  uintptr_t cursor_ = 0;
+  uintptr_t end_ = 0;
+  size_t next_block_size_ = kInitialBlockSize;
+  Stats stats_;
+
+  LayerArena();
+
+  ~LayerArena();
+
+  // Allocates like |Allocate|, but the memory holds a reference to its block
+  // until it is passed to |ReleaseReferenced|.
+  void* AllocateReferenced(size_t size, size_t alignment);
+
+  static void ReleaseReferenced(void* pointer);
+
+  // Allocates |size| bytes with at least |prefix| bytes before them in the
+  // same block.
+  void* Allocate(size_t size, size_t alignment, size_t prefix);
+
+  FML_FRIEND_MAKE_REF_COUNTED(LayerArena);
+  FML_FRIEND_REF_COUNTED_THREAD_SAFE(LayerArena);
+  FML_DISALLOW_COPY_AND_ASSIGN(LayerArena);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_LAYER_ARENA_H_
@@ -0,0 +1,116 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layer_arena.h"
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+class Tracked {
+ public:
+  explicit Tracked(int* live_count) : live_count_(live_count) {
+    (*live_count_)++;
+  }
+
+  ~Tracked() { (*live_count_)--; }
+
+ private:
+  int* live_count_;
+};
+
+}  // namespace
+
+TEST(LayerArenaTest, SmallObjectsShareBlocks) {
+  auto arena = fml::MakeRefCounted<LayerArena>();
+  int live_count = 0;
+  std::vector<std::shared_ptr<Tracked>> objects;
+  for (int i = 0; i < 100; i++) {
+    objects.push_back(arena->MakeShared<Tracked>(&live_count));
+  }
+  EXPECT_EQ(live_count, 100);
+  EXPECT_EQ(arena->stats().allocation_count, 100u);
+  EXPECT_EQ(arena->stats().block_count, 1u);
+
+  objects.clear();
+  EXPECT_EQ(live_count, 0);
+}
+
+TEST(LayerArenaTest, AllocationsAreAligned) {
+  auto arena = fml::MakeRefCounted<LayerArena>();
+  arena->Allocate(1, 1);
+  auto* pointer = arena->Allocate(sizeof(double), alignof(double));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(pointer) % alignof(double), 0u);
+  pointer = arena->Allocate(1, alignof(std::max_align_t));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(pointer) % alignof(std::max_align_t),
+            0u);
+}
+
+TEST(LayerArenaTest, BlocksGrowUpToMaxBlockSize) {
+  auto arena = fml::MakeRefCounted<LayerArena>();
+  size_t allocated = 0;
+  while (allocated < 4 * LayerArena::kMaxBlockSize) {
+    arena->Allocate(64, 8);
+    allocated += 64;
+  }
+  // 4 + 8 + 16 + 32 + 64 + 64 + 64 + 64 KB.
+  EXPECT_EQ(arena->stats().block_count, 8u);
+  EXPECT_EQ(arena->stats().allocated_bytes, allocated);
+}
+
+TEST(LayerArenaTest, LargeAllocationsGetTheirOwnBlock) {
+  auto arena = fml::MakeRefCounted<LayerArena>();
+  auto* pointer = static_cast<uint8_t*>(
+      arena->Allocate(2 * LayerArena::kMaxBlockSize, 8));
+  pointer[2 * LayerArena::kMaxBlockSize - 1] = 1;
+  EXPECT_EQ(arena->stats().block_count, 1u);
+}
+
+TEST(LayerArenaTest, ObjectsOutliveTheArena) {
+  int live_count = 0;
+  std::shared_ptr<Tracked> object;
+  {
+    auto arena = fml::MakeRefCounted<LayerArena>();
+    object = arena->MakeShared<Tracked>(&live_count);
+    arena->MakeShared<Tracked>(&live_count);
+  }
+  EXPECT_EQ(live_count, 1);
+
+  std::weak_ptr<Tracked> weak_object = object;
+  object.reset();
+  EXPECT_EQ(live_count, 0);
+  EXPECT_TRUE(weak_object.expired());
+}
+
+TEST(LayerArenaTest, ObjectsKeepOnlyTheirBlocksAlive) {
+  int live_count = 0;
+  std::vector<std::shared_ptr<Tracked>> retained;
+  {
+    auto arena = fml::MakeRefCounted<LayerArena>();
+    std::vector<std::shared_ptr<Tracked>> objects;
+    while (arena->stats().block_count < 4) {
+      objects.push_back(arena->MakeShared<Tracked>(&live_count));
+    }
+    // Retain an object from the first and the last block, and release the
+    // others while the arena is still alive.
+    retained.push_back(objects.front());
+    retained.push_back(objects.back());
+    objects.clear();
+  }
+  EXPECT_EQ(live_count, 2);
+
+  // Blocks are freed as their last object is released, in any order.
+  retained.erase(retained.begin());
+  EXPECT_EQ(live_count, 1);
+  retained.clear();
+  EXPECT_EQ(live_count, 0);
+}
+
+}  // namespace testing
+}  // namespace flutter
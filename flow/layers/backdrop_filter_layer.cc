@@ -4,8 +4,42 @@
 
 #include "flutter/flow/layers/backdrop_filter_layer.h"
 
+#include <cstring>
+
+#include "flutter/flow/layers/layer_tree_serialization.h"
+#include "third_party/skia/include/core/SkPixmap.h"
+
 namespace flutter {
 
+namespace {
+
+// Copies |pixmap| into |bitmap|, reusing its pixels if they have the same
+// size and format.
+bool CopyPixels(const SkPixmap& pixmap, SkBitmap* bitmap) {
+  if (bitmap->info() != pixmap.info() || !bitmap->getPixels()) {
+    if (!bitmap->tryAllocPixels(pixmap.info())) {
+      bitmap->reset();
+      return false;
+    }
+  }
+  return pixmap.readPixels(bitmap->pixmap());
+}
+
+bool PixelsEqual(const SkPixmap& a, const SkPixmap& b) {
+  if (a.info() != b.info()) {
+    return false;
+  }
+  const size_t row_bytes = a.info().minRowBytes();
+  for (int y = 0; y < a.height(); y++) {
+    if (std::memcmp(a.addr(0, y), b.addr(0, y), row_bytes) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 BackdropFilterLayer::BackdropFilterLayer(sk_sp<SkImageFilter> filter)
     : filter_(std::move(filter)) {}
 
@@ -14,16 +48,152 @@ void BackdropFilterLayer::Preroll(PrerollContext* context,
   Layer::AutoPrerollSaveLayerState save =
       Layer::AutoPrerollSaveLayerState::Create(context, true, bool(filter_));
   ContainerLayer::Preroll(context, matrix);
+  // Opacity can't be folded into the filtered backdrop.
+  set_layer_can_inherit_opacity(false);
+
+  // Only the visible part of the backdrop behind the children is filtered.
+  backdrop_bounds_ = paint_bounds();
+  if (!backdrop_bounds_.intersect(context->cull_rect)) {
+    backdrop_bounds_.setEmpty();
+  }
 }
 
 void BackdropFilterLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "BackdropFilterLayer::Paint");
   FML_DCHECK(needs_painting());
 
+  if (PaintCachedBackdrop(context)) {
+    PaintChildren(context);
+    return;
+  }
+
   Layer::AutoSaveLayer save = Layer::AutoSaveLayer::Create(
       context,
-      SkCanvas::SaveLayerRec{&paint_bounds(), nullptr, filter_.get(), 0});
+      SkCanvas::SaveLayerRec{&backdrop_bounds_, nullptr, filter_.get(), 0});
   PaintChildren(context);
 }
 
+bool BackdropFilterLayer::PaintCachedBackdrop(PaintContext& context) const {
+  // Without an embedder the internal nodes canvas only draws to the leaf
+  // nodes canvas, whose pixels are read below.
+  if (!filter_ || context.view_embedder ||
+      context.checkerboard_offscreen_layers ||
+      !children_can_inherit_opacity()) {
+    return false;
+  }
+  if (backdrop_cache_cooldown_paints_ > 0) {
+    backdrop_cache_cooldown_paints_--;
+    return false;
+  }
+  SkCanvas* canvas = context.leaf_nodes_canvas;
+  SkImageInfo info;
+  size_t row_bytes;
+  SkIPoint origin;
+  void* pixels = canvas->accessTopLayerPixels(&info, &row_bytes, &origin);
+  if (!pixels) {
+    return false;
+  }
+
+  const SkIRect layer_bounds =
+      SkIRect::MakeXYWH(origin.x(), origin.y(), info.width(), info.height());
+  SkIRect output_bounds =
+      canvas->getTotalMatrix().mapRect(backdrop_bounds_).roundOut();
+  if (!output_bounds.intersect(canvas->getDeviceClipBounds()) ||
+      !output_bounds.intersect(layer_bounds)) {
+    // None of the backdrop is visible.
+    return true;
+  }
+  SkIRect input_bounds = filter_->filterBounds(
+      output_bounds, canvas->getTotalMatrix(),
+      SkImageFilter::kReverse_MapDirection);
+  input_bounds.join(output_bounds);
+  if (!input_bounds.intersect(layer_bounds)) {
+    return false;
+  }
+  const size_t cache_bytes =
+      (static_cast<size_t>(input_bounds.width()) * input_bounds.height() +
+       static_cast<size_t>(output_bounds.width()) * output_bounds.height()) *
+      info.bytesPerPixel();
+  if (cache_bytes > kMaxCachedBackdropBytes) {
+    backdrop_cache_.reset();
+    return false;
+  }
+
+  SkPixmap input;
+  if (!SkPixmap(info, pixels, row_bytes)
+           .extractSubset(&input, input_bounds.makeOffset(-origin.x(),
+                                                          -origin.y()))) {
+    return false;
+  }
+  // The filter is applied in the local space of the layer, so its result
+  // also depends on the matrix.
+  const SkMatrix& matrix = canvas->getTotalMatrix();
+  if (backdrop_cache_ && backdrop_cache_->is_valid &&
+      backdrop_cache_->matrix == matrix &&
+      backdrop_cache_->input_bounds == input_bounds &&
+      backdrop_cache_->output_bounds == output_bounds &&
+      PixelsEqual(input, backdrop_cache_->input.pixmap())) {
+    consecutive_backdrop_cache_misses_ = 0;
+    // The pixels outside the clip were cached as they are now, so the cached
+    // pixels can replace the whole output bounds.
+    SkAutoCanvasRestore save(canvas, true);
+    canvas->resetMatrix();
+    SkPaint paint;
+    paint.setBlendMode(SkBlendMode::kSrc);
+    canvas->drawBitmap(backdrop_cache_->output, output_bounds.left(),
+                       output_bounds.top(), &paint);
+    return true;
+  }
+
+  // Only backdrops that missed before count, so that a layer whose first
+  // paint fills the cache isn't penalized.
+  if (backdrop_cache_ && backdrop_cache_->is_valid) {
+    consecutive_backdrop_cache_misses_++;
+  }
+  if (!backdrop_cache_) {
+    backdrop_cache_ = std::make_unique<BackdropCache>();
+  }
+  BackdropCache& cache = *backdrop_cache_;
+  cache.is_valid = false;
+  cache.matrix = matrix;
+  cache.input_bounds = input_bounds;
+  cache.output_bounds = output_bounds;
+  if (!CopyPixels(input, &cache.input)) {
+    return false;
+  }
+
+  {
+    // The children are painted over the filtered backdrop afterwards rather
+    // than within the same layer, which is the same as they only draw with
+    // source over blending.
+    Layer::AutoSaveLayer save = Layer::AutoSaveLayer::Create(
+        context,
+        SkCanvas::SaveLayerRec{&backdrop_bounds_, nullptr, filter_.get(), 0});
+  }
+
+  // Restoring the layer may have copied the pixels on write.
+  pixels = canvas->accessTopLayerPixels(&info, &row_bytes, &origin);
+  SkPixmap output;
+  cache.is_valid =
+      pixels &&
+      SkPixmap(info, pixels, row_bytes)
+          .extractSubset(&output, output_bounds.makeOffset(-origin.x(),
+                                                           -origin.y())) &&
+      CopyPixels(output, &cache.output);
+  if (consecutive_backdrop_cache_misses_ >=
+      kMaxConsecutiveBackdropCacheMisses) {
+    // The backdrop keeps changing, so stop caching it for a while.
+    backdrop_cache_.reset();
+    consecutive_backdrop_cache_misses_ = 0;
+    backdrop_cache_cooldown_paints_ = kBackdropCacheCooldownPaints;
+  }
+  return true;
+}
+
+void BackdropFilterLayer::Serialize(LayerTreeWriter& writer) const {
+  writer.WriteLayerHeader(SerializedLayerType::kBackdropFilter, *this);
+  writer.WriteFlattenable(filter_.get());
+  writer.WriteChildren(*this);
+}
+
 }  // namespace flutter
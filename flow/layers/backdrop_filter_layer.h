@@ -5,22 +5,60 @@
 #ifndef FLUTTER_FLOW_LAYERS_BACKDROP_FILTER_LAYER_H_
 #define FLUTTER_FLOW_LAYERS_BACKDROP_FILTER_LAYER_H_
 
+#include <memory>
+
 #include "flutter/flow/layers/container_layer.h"
 
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkImageFilter.h"
 
 namespace flutter {
 
 class BackdropFilterLayer : public ContainerLayer {
  public:
+  // Backdrops whose cached pixels would take more than this aren't cached.
+  static constexpr size_t kMaxCachedBackdropBytes = 8 << 20;
+
+  // Backdrops that changed in this many paints in a row aren't cached for
+  // the next kBackdropCacheCooldownPaints paints, as checking and caching them
+  // costs more than it saves while they keep changing.
+  static constexpr int kMaxConsecutiveBackdropCacheMisses = 3;
+  static constexpr int kBackdropCacheCooldownPaints = 60;
+
   BackdropFilterLayer(sk_sp<SkImageFilter> filter);
 
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
 
   void Paint(PaintContext& context) const override;
 
+  void Serialize(LayerTreeWriter& writer) const override;
+
  private:
+  // The backdrop the filter was last applied to and the pixels that resulted,
+  // along with their device space bounds and the matrix the filter was
+  // applied with. The bitmaps are reused while their size stays the same.
+  struct BackdropCache {
+    bool is_valid = false;
+    SkMatrix matrix;
+    SkIRect input_bounds;
+    SkIRect output_bounds;
+    SkBitmap input;
+    SkBitmap output;
+  };
+
   sk_sp<SkImageFilter> filter_;
+  SkRect backdrop_bounds_ = SkRect::MakeEmpty();
+  mutable std::unique_ptr<BackdropCache> backdrop_cache_;
+  mutable int consecutive_backdrop_cache_misses_ = 0;
+  mutable int backdrop_cache_cooldown_paints_ = 0;
+
+  // When the canvas pixels can be read directly, as with the software
+  // backend, filters the backdrop only if the pixels it depends on changed
+  // since the last paint, and otherwise draws the pixels that resulted then.
+  // The children are painted over those pixels afterwards, so this is only
+  // done for children that draw with source over blending.
+  // Returns false without painting anything if the backdrop can't be cached.
+  bool PaintCachedBackdrop(PaintContext& context) const;
 
   FML_DISALLOW_COPY_AND_ASSIGN(BackdropFilterLayer);
 };
@@ -4,16 +4,68 @@
 
 #include "flutter/flow/layers/backdrop_filter_layer.h"
 
+#include <cstdlib>
+#include <functional>
+
 #include "flutter/flow/testing/layer_test.h"
 #include "flutter/flow/testing/mock_layer.h"
 #include "flutter/fml/macros.h"
 #include "flutter/testing/mock_canvas.h"
 #include "third_party/skia/include/core/SkImageFilter.h"
+#include "third_party/skia/include/core/SkSurface.h"
 #include "third_party/skia/include/effects/SkImageFilters.h"
+#include "third_party/skia/include/utils/SkNWayCanvas.h"
 
 namespace flutter {
 namespace testing {
 
+namespace {
+
+// Paints |background| and then |layer| onto a raster surface the way the
+// rasterizer does, or just |background| and |paint| if |paint| is set.
+SkBitmap PaintToBitmap(const Layer::PaintContext& paint_context,
+                       const Layer* layer,
+                       std::function<void(SkCanvas*)> background,
+                       std::function<void(SkCanvas*)> paint = nullptr) {
+  auto surface = SkSurface::MakeRasterN32Premul(64, 64);
+  SkCanvas* canvas = surface->getCanvas();
+  background(canvas);
+  if (paint) {
+    paint(canvas);
+  } else {
+    SkNWayCanvas internal_nodes_canvas(64, 64);
+    internal_nodes_canvas.addCanvas(canvas);
+    Layer::PaintContext context = paint_context;
+    context.internal_nodes_canvas = &internal_nodes_canvas;
+    context.leaf_nodes_canvas = canvas;
+    layer->Paint(context);
+  }
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(64, 64);
+  surface->readPixels(bitmap, 0, 0);
+  return bitmap;
+}
+
+// Whether no channel of any pixel differs by more than rounding error.
+bool BitmapsAlmostEqual(const SkBitmap& a, const SkBitmap& b) {
+  for (int y = 0; y < a.height(); y++) {
+    for (int x = 0; x < a.width(); x++) {
+      const SkColor a_color = a.getColor(x, y);
+      const SkColor b_color = b.getColor(x, y);
+      for (int shift = 0; shift < 32; shift += 8) {
+        const int a_channel = (a_color >> shift) & 0xFF;
+        const int b_channel = (b_color >> shift) & 0xFF;
+        if (std::abs(a_channel - b_channel) > 1) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 using BackdropFilterLayerTest = LayerTest;
 
 #ifndef NDEBUG
@@ -213,5 +265,132 @@ TEST_F(BackdropFilterLayerTest, Readback) {
   EXPECT_FALSE(preroll_context()->surface_needs_readback);
 }
 
+TEST_F(BackdropFilterLayerTest, BackdropIsLimitedToVisibleBounds) {
+  const SkRect child_bounds = SkRect::MakeLTRB(5.0f, 6.0f, 20.5f, 21.5f);
+  const SkRect cull_rect = SkRect::MakeLTRB(10.0f, 0.0f, 40.0f, 40.0f);
+  const SkPath child_path = SkPath().addRect(child_bounds);
+  const SkPaint child_paint = SkPaint(SkColors::kYellow);
+  auto layer_filter = SkImageFilters::Paint(SkPaint(SkColors::kMagenta));
+  auto mock_layer = std::make_shared<MockLayer>(child_path, child_paint);
+  auto layer = std::make_shared<BackdropFilterLayer>(layer_filter);
+  layer->Add(mock_layer);
+
+  preroll_context()->cull_rect = cull_rect;
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_EQ(layer->paint_bounds(), child_bounds);
+
+  layer->Paint(paint_context());
+  EXPECT_EQ(mock_canvas().draw_calls(),
+            std::vector({MockCanvas::DrawCall{
+                             0, MockCanvas::SaveLayerData{
+                                    SkRect::MakeLTRB(10.0f, 6.0f, 20.5f, 21.5f),
+                                    SkPaint(), layer_filter, 1}},
+                         MockCanvas::DrawCall{
+                             1, MockCanvas::DrawPathData{child_path,
+                                                         child_paint}},
+                         MockCanvas::DrawCall{1, MockCanvas::RestoreData{0}}}));
+}
+
+TEST_F(BackdropFilterLayerTest, CachedBackdropMatchesFilteredBackdrop) {
+  const SkRect child_bounds = SkRect::MakeLTRB(16.0f, 16.0f, 48.0f, 40.5f);
+  const SkPath child_path = SkPath().addRect(child_bounds);
+  const SkPaint child_paint = SkPaint(SkColor4f{0.0f, 0.0f, 1.0f, 0.5f});
+  auto layer_filter = SkImageFilters::Blur(4.0f, 4.0f, nullptr);
+  auto mock_layer = std::make_shared<MockLayer>(
+      child_path, child_paint, false /* fake_has_platform_view */,
+      false /* fake_needs_system_composite */, false /* fake_reads_surface */,
+      true /* fake_can_inherit_opacity */);
+  auto layer = std::make_shared<BackdropFilterLayer>(layer_filter);
+  layer->Add(mock_layer);
+  layer->Preroll(preroll_context(), SkMatrix());
+
+  auto stripes = [](SkColor color) {
+    return [color](SkCanvas* canvas) {
+      SkPaint paint;
+      paint.setColor(color);
+      canvas->clear(SK_ColorWHITE);
+      for (int x = 0; x < 64; x += 8) {
+        canvas->drawRect(SkRect::MakeXYWH(x, 0, 4, 64), paint);
+      }
+    };
+  };
+  auto filtered = [&](SkCanvas* canvas) {
+    canvas->saveLayer(
+        SkCanvas::SaveLayerRec{&child_bounds, nullptr, layer_filter.get(), 0});
+    canvas->drawPath(child_path, child_paint);
+    canvas->restore();
+  };
+
+  // The backdrop is filtered and cached, and then drawn from the cache while
+  // it stays the same.
+  const SkBitmap expected =
+      PaintToBitmap(paint_context(), layer.get(), stripes(SK_ColorRED),
+                    filtered);
+  for (int i = 0; i < 2; i++) {
+    EXPECT_TRUE(BitmapsAlmostEqual(
+        PaintToBitmap(paint_context(), layer.get(), stripes(SK_ColorRED)),
+        expected));
+  }
+
+  // Once the backdrop changes, it is filtered again.
+  const SkBitmap changed =
+      PaintToBitmap(paint_context(), layer.get(), stripes(SK_ColorGREEN),
+                    filtered);
+  EXPECT_FALSE(BitmapsAlmostEqual(changed, expected));
+  EXPECT_TRUE(BitmapsAlmostEqual(
+      PaintToBitmap(paint_context(), layer.get(), stripes(SK_ColorGREEN)),
+      changed));
+
+  // A backdrop that keeps changing stops being cached, and is still filtered.
+  for (int i = 0; i < BackdropFilterLayer::kMaxConsecutiveBackdropCacheMisses;
+       i++) {
+    EXPECT_TRUE(BitmapsAlmostEqual(
+        PaintToBitmap(paint_context(), layer.get(), stripes(SK_ColorRED)),
+        expected));
+    EXPECT_TRUE(BitmapsAlmostEqual(
+        PaintToBitmap(paint_context(), layer.get(), stripes(SK_ColorGREEN)),
+        changed));
+  }
+
+  // It is cached again after a while.
+  for (int i = 0; i <= BackdropFilterLayer::kBackdropCacheCooldownPaints + 2;
+       i++) {
+    EXPECT_TRUE(BitmapsAlmostEqual(
+        PaintToBitmap(paint_context(), layer.get(), stripes(SK_ColorRED)),
+        expected));
+  }
+}
+
+TEST_F(BackdropFilterLayerTest, ChildrenThatDontBlendSourceOverStayInLayer) {
+  const SkRect child_bounds = SkRect::MakeLTRB(16.0f, 16.0f, 48.0f, 40.0f);
+  const SkPath child_path = SkPath().addRect(child_bounds);
+  SkPaint child_paint;
+  child_paint.setBlendMode(SkBlendMode::kClear);
+  auto layer_filter = SkImageFilters::Blur(4.0f, 4.0f, nullptr);
+  auto mock_layer = std::make_shared<MockLayer>(child_path, child_paint);
+  auto layer = std::make_shared<BackdropFilterLayer>(layer_filter);
+  layer->Add(mock_layer);
+  layer->Preroll(preroll_context(), SkMatrix());
+
+  auto background = [](SkCanvas* canvas) {
+    canvas->clear(SK_ColorWHITE);
+    canvas->drawRect(SkRect::MakeXYWH(24, 0, 16, 64),
+                     SkPaint(SkColor4f{1.0f, 0.0f, 0.0f, 1.0f}));
+  };
+  // Clearing within the layer leaves the unfiltered backdrop, where clearing
+  // after the layer would leave transparent pixels.
+  const SkBitmap expected = PaintToBitmap(
+      paint_context(), layer.get(), background, [&](SkCanvas* canvas) {
+        canvas->saveLayer(SkCanvas::SaveLayerRec{&child_bounds, nullptr,
+                                                 layer_filter.get(), 0});
+        canvas->drawPath(child_path, child_paint);
+        canvas->restore();
+      });
+  for (int i = 0; i < 2; i++) {
+    EXPECT_TRUE(BitmapsAlmostEqual(
+        PaintToBitmap(paint_context(), layer.get(), background), expected));
+  }
+}
+
 }  // namespace testing
 }  // namespace flutter
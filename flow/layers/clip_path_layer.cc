@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/clip_path_layer.h"
 
+#include "flutter/flow/layers/layer_tree_serialization.h"
+
 #if defined(OS_FUCHSIA)
 
 #include "lib/ui/scenic/cpp/commands.h"
@@ -32,14 +34,49 @@ void ClipPathLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
     SkRect child_paint_bounds = SkRect::MakeEmpty();
     PrerollChildren(context, matrix, &child_paint_bounds);
 
+    AnalyzeClip(context, ComputeTouchedPixelBounds(child_paint_bounds, matrix));
     if (child_paint_bounds.intersect(clip_path_bounds)) {
       set_paint_bounds(child_paint_bounds);
     }
+    // Clipping each child separately only matches clipping them together
+    // when the clip doesn't use a saveLayer of its own.
+    set_layer_can_inherit_opacity((!UsesSaveLayer() || clip_is_redundant_) &&
+                                  children_can_inherit_opacity());
     context->mutators_stack.Pop();
   }
   context->cull_rect = previous_cull_rect;
 }
 
+void ClipPathLayer::AnalyzeClip(PrerollContext* context,
+                                const SkRect& touched_bounds) {
+  clip_is_redundant_ = false;
+  clip_as_rect_ = false;
+  // The saveLayer can't be left out if the children read back from it.
+  const bool can_skip_clip =
+      !(UsesSaveLayer() && context->surface_needs_readback);
+  if (clip_path_.isInverseFillType()) {
+    return;
+  }
+
+  SkRRect clip_rrect;
+  if (clip_path_.isRect(&clip_rect_)) {
+    clip_is_redundant_ = can_skip_clip && clip_rect_.contains(touched_bounds);
+    clip_as_rect_ = true;
+  } else if (clip_path_.isRRect(&clip_rrect) ||
+             clip_path_.isOval(&clip_rect_)) {
+    if (clip_rrect.isEmpty()) {
+      clip_rrect.setOval(clip_rect_);
+    }
+    clip_is_redundant_ = can_skip_clip && clip_rrect.contains(touched_bounds);
+    clip_rect_ = clip_rrect.rect();
+    clip_as_rect_ = IsClearOfCorners(clip_rrect, touched_bounds);
+  } else {
+    clip_is_redundant_ =
+        can_skip_clip && !touched_bounds.isEmpty() &&
+        clip_path_.conservativelyContainsRect(touched_bounds);
+  }
+}
+
 #if defined(OS_FUCHSIA)
 
 void ClipPathLayer::UpdateScene(SceneUpdateContext& context) {
@@ -61,10 +98,22 @@ void ClipPathLayer::Paint(PaintContext& context) const {
     TRACE_EVENT_INSTANT0("flutter", "children not inside clip rect, skipping");
     return;
   }
+  if (clip_is_redundant_) {
+    PaintChildrenWithoutClip(context, UsesSaveLayer());
+    return;
+  }
 
   SkAutoCanvasRestore save(context.internal_nodes_canvas, true);
-  context.internal_nodes_canvas->clipPath(clip_path_,
-                                          clip_behavior_ != Clip::hardEdge);
+  if (clip_as_rect_) {
+    context.internal_nodes_canvas->clipRect(clip_rect_,
+                                            clip_behavior_ != Clip::hardEdge);
+    if (context.skipped_ops) {
+      context.skipped_ops->simplified_clips++;
+    }
+  } else {
+    context.internal_nodes_canvas->clipPath(clip_path_,
+                                            clip_behavior_ != Clip::hardEdge);
+  }
 
   if (UsesSaveLayer()) {
     context.internal_nodes_canvas->saveLayer(paint_bounds(), nullptr);
@@ -75,4 +124,11 @@ void ClipPathLayer::Paint(PaintContext& context) const {
   }
 }
 
+void ClipPathLayer::Serialize(LayerTreeWriter& writer) const {
+  writer.WriteLayerHeader(SerializedLayerType::kClipPath, *this);
+  writer.WritePath(clip_path_);
+  writer.WriteUInt32(clip_behavior_);
+  writer.WriteChildren(*this);
+}
+
 }  // namespace flutter
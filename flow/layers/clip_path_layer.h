@@ -17,6 +17,8 @@ class ClipPathLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  void Serialize(LayerTreeWriter& writer) const override;
+
   bool UsesSaveLayer() const {
     return clip_behavior_ == Clip::antiAliasWithSaveLayer;
   }
@@ -26,9 +28,20 @@ class ClipPathLayer : public ContainerLayer {
 #endif  // defined(OS_FUCHSIA)
 
  private:
+  // Works out from the bounds of the pixels that the children touch whether
+  // the clip can be left out or made as a rect clip.
+  void AnalyzeClip(PrerollContext* context, const SkRect& touched_bounds);
+
   SkPath clip_path_;
   Clip clip_behavior_;
   bool children_inside_clip_ = false;
+  // Whether the children only touch pixels inside the clip, so that neither
+  // the clip nor its saveLayer makes a difference.
+  bool clip_is_redundant_ = false;
+  // Whether the clip can be made with |clip_rect_| instead, because the path
+  // is a rect or the children are clear of the corners of its rounded rect.
+  bool clip_as_rect_ = false;
+  SkRect clip_rect_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ClipPathLayer);
 };
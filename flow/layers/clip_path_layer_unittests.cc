@@ -192,6 +192,56 @@ TEST_F(ClipPathLayerTest, PartiallyContainedChild) {
            MockCanvas::DrawCall{1, MockCanvas::RestoreData{0}}}));
 }
 
+TEST_F(ClipPathLayerTest, ChildInsideClipIsNotClipped) {
+  const SkRect child_bounds = SkRect::MakeXYWH(15.0, 15.0, 10.0, 10.0);
+  const SkPath layer_path = SkPath().addOval(SkRect::MakeWH(40.0, 40.0));
+  const SkPath child_path = SkPath().addRect(child_bounds);
+  const SkPaint child_paint = SkPaint(SkColors::kYellow);
+  auto mock_layer = std::make_shared<MockLayer>(child_path, child_paint);
+  auto layer = std::make_shared<ClipPathLayer>(layer_path, Clip::antiAlias);
+  layer->Add(mock_layer);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_EQ(mock_layer->parent_mutators(), std::vector({Mutator(layer_path)}));
+
+  SkippedPaintOps skipped_ops;
+  paint_context().skipped_ops = &skipped_ops;
+  layer->Paint(paint_context());
+  EXPECT_EQ(mock_canvas().draw_calls(),
+            std::vector({MockCanvas::DrawCall{
+                0, MockCanvas::DrawPathData{child_path, child_paint}}}));
+  EXPECT_EQ(skipped_ops.clips, 1u);
+}
+
+TEST_F(ClipPathLayerTest, ChildClearOfCornersIsClippedToRect) {
+  const SkRect child_bounds = SkRect::MakeLTRB(-5.0, 10.0, 45.0, 20.0);
+  const SkRect layer_bounds = SkRect::MakeWH(40.0, 40.0);
+  const SkPath layer_path =
+      SkPath().addRRect(SkRRect::MakeRectXY(layer_bounds, 4.0, 4.0));
+  const SkPath child_path = SkPath().addRect(child_bounds);
+  const SkPaint child_paint = SkPaint(SkColors::kYellow);
+  auto mock_layer = std::make_shared<MockLayer>(child_path, child_paint);
+  auto layer = std::make_shared<ClipPathLayer>(layer_path, Clip::hardEdge);
+  layer->Add(mock_layer);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+
+  SkippedPaintOps skipped_ops;
+  paint_context().skipped_ops = &skipped_ops;
+  layer->Paint(paint_context());
+  EXPECT_EQ(
+      mock_canvas().draw_calls(),
+      std::vector(
+          {MockCanvas::DrawCall{0, MockCanvas::SaveData{1}},
+           MockCanvas::DrawCall{
+               1, MockCanvas::ClipRectData{layer_bounds, SkClipOp::kIntersect,
+                                           MockCanvas::kHard_ClipEdgeStyle}},
+           MockCanvas::DrawCall{
+               1, MockCanvas::DrawPathData{child_path, child_paint}},
+           MockCanvas::DrawCall{1, MockCanvas::RestoreData{0}}}));
+  EXPECT_EQ(skipped_ops.simplified_clips, 1u);
+}
+
 static bool ReadbackResult(PrerollContext* context,
                            Clip clip_behavior,
                            std::shared_ptr<Layer> child,
@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/clip_rect_layer.h"
 
+#include "flutter/flow/layers/layer_tree_serialization.h"
+
 namespace flutter {
 
 ClipRectLayer::ClipRectLayer(const SkRect& clip_rect, Clip clip_behavior)
@@ -25,9 +27,18 @@ void ClipRectLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
     SkRect child_paint_bounds = SkRect::MakeEmpty();
     PrerollChildren(context, matrix, &child_paint_bounds);
 
+    // The saveLayer can't be left out if the children read back from it.
+    clip_is_redundant_ =
+        !(UsesSaveLayer() && context->surface_needs_readback) &&
+        clip_rect_.contains(
+            ComputeTouchedPixelBounds(child_paint_bounds, matrix));
     if (child_paint_bounds.intersect(clip_rect_)) {
       set_paint_bounds(child_paint_bounds);
     }
+    // Clipping each child separately only matches clipping them together
+    // when the clip doesn't use a saveLayer of its own.
+    set_layer_can_inherit_opacity((!UsesSaveLayer() || clip_is_redundant_) &&
+                                  children_can_inherit_opacity());
     context->mutators_stack.Pop();
   }
   context->cull_rect = previous_cull_rect;
@@ -54,6 +65,10 @@ void ClipRectLayer::Paint(PaintContext& context) const {
     TRACE_EVENT_INSTANT0("flutter", "children not inside clip rect, skipping");
     return;
   }
+  if (clip_is_redundant_) {
+    PaintChildrenWithoutClip(context, UsesSaveLayer());
+    return;
+  }
 
   SkAutoCanvasRestore save(context.internal_nodes_canvas, true);
   context.internal_nodes_canvas->clipRect(clip_rect_,
@@ -68,4 +83,11 @@ void ClipRectLayer::Paint(PaintContext& context) const {
   }
 }
 
+void ClipRectLayer::Serialize(LayerTreeWriter& writer) const {
+  writer.WriteLayerHeader(SerializedLayerType::kClipRect, *this);
+  writer.WriteRect(clip_rect_);
+  writer.WriteUInt32(clip_behavior_);
+  writer.WriteChildren(*this);
+}
+
 }  // namespace flutter
@@ -16,6 +16,8 @@ class ClipRectLayer : public ContainerLayer {
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
   void Paint(PaintContext& context) const override;
 
+  void Serialize(LayerTreeWriter& writer) const override;
+
   bool UsesSaveLayer() const {
     return clip_behavior_ == Clip::antiAliasWithSaveLayer;
   }
@@ -28,6 +30,9 @@ class ClipRectLayer : public ContainerLayer {
   SkRect clip_rect_;
   Clip clip_behavior_;
   bool children_inside_clip_ = false;
+  // Whether the children only touch pixels inside the clip, so that neither
+  // the clip nor its saveLayer makes a difference.
+  bool clip_is_redundant_ = false;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ClipRectLayer);
 };
@@ -4,10 +4,15 @@
 
 #include "flutter/flow/layers/clip_rect_layer.h"
 
+#include <algorithm>
+#include <cstdlib>
+
 #include "flutter/flow/testing/layer_test.h"
 #include "flutter/flow/testing/mock_layer.h"
 #include "flutter/fml/macros.h"
 #include "flutter/testing/mock_canvas.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkSurface.h"
 
 namespace flutter {
 namespace testing {
@@ -190,6 +195,126 @@ TEST_F(ClipRectLayerTest, PartiallyContainedChild) {
            MockCanvas::DrawCall{1, MockCanvas::RestoreData{0}}}));
 }
 
+TEST_F(ClipRectLayerTest, ChildInsideClipIsNotClipped) {
+  const SkRect child_bounds = SkRect::MakeXYWH(4.0, 4.0, 8.0, 8.0);
+  const SkRect layer_bounds = SkRect::MakeXYWH(0.5, 1.0, 20.0, 20.0);
+  const SkPath child_path = SkPath().addRect(child_bounds);
+  const SkPaint child_paint = SkPaint(SkColors::kYellow);
+  auto mock_layer = std::make_shared<MockLayer>(
+      child_path, child_paint, false, false, false,
+      true /* fake_can_inherit_opacity */);
+  auto layer = std::make_shared<ClipRectLayer>(layer_bounds,
+                                               Clip::antiAliasWithSaveLayer);
+  layer->Add(mock_layer);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_EQ(mock_layer->parent_mutators(),
+            std::vector({Mutator(layer_bounds)}));
+  // Without its saveLayer, the clip no longer stops opacity being inherited.
+  EXPECT_TRUE(layer->layer_can_inherit_opacity());
+
+  SkippedPaintOps skipped_ops;
+  paint_context().skipped_ops = &skipped_ops;
+  layer->Paint(paint_context());
+  EXPECT_EQ(mock_canvas().draw_calls(),
+            std::vector({MockCanvas::DrawCall{
+                0, MockCanvas::DrawPathData{child_path, child_paint}}}));
+  EXPECT_EQ(skipped_ops.clips, 1u);
+  EXPECT_EQ(skipped_ops.save_layers, 1u);
+}
+
+TEST_F(ClipRectLayerTest, ChildReadingBackKeepsSaveLayer) {
+  const SkRect child_bounds = SkRect::MakeXYWH(4.0, 4.0, 8.0, 8.0);
+  const SkRect layer_bounds = SkRect::MakeXYWH(0.5, 1.0, 20.0, 20.0);
+  const SkPath child_path = SkPath().addRect(child_bounds);
+  const SkPaint child_paint = SkPaint(SkColors::kYellow);
+  auto mock_layer = std::make_shared<MockLayer>(
+      child_path, child_paint, false, false, true /* fake_reads_surface */);
+  auto layer = std::make_shared<ClipRectLayer>(layer_bounds,
+                                               Clip::antiAliasWithSaveLayer);
+  layer->Add(mock_layer);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  layer->Paint(paint_context());
+  EXPECT_EQ(
+      mock_canvas().draw_calls(),
+      std::vector(
+          {MockCanvas::DrawCall{0, MockCanvas::SaveData{1}},
+           MockCanvas::DrawCall{
+               1, MockCanvas::ClipRectData{layer_bounds, SkClipOp::kIntersect,
+                                           MockCanvas::kSoft_ClipEdgeStyle}},
+           MockCanvas::DrawCall{
+               1, MockCanvas::SaveLayerData{layer_bounds, SkPaint(), nullptr,
+                                            2}},
+           MockCanvas::DrawCall{
+               2, MockCanvas::DrawPathData{child_path, child_paint}},
+           MockCanvas::DrawCall{2, MockCanvas::RestoreData{1}},
+           MockCanvas::DrawCall{1, MockCanvas::RestoreData{0}}}));
+}
+
+TEST_F(ClipRectLayerTest, ElidedClipMatchesClippedChildren) {
+  const SkRect layer_bounds = SkRect::MakeXYWH(0.5, 1.0, 20.0, 20.0);
+  const SkPath child_path1 = SkPath().addRect(SkRect::MakeLTRB(4, 4, 12, 12));
+  const SkPath child_path2 = SkPath().addRect(SkRect::MakeLTRB(15, 4, 19, 12));
+
+  for (const SkBlendMode blend_mode :
+       {SkBlendMode::kSrcOver, SkBlendMode::kSrc}) {
+    SkPaint child_paint = SkPaint(SkColor4f{0.0f, 0.0f, 1.0f, 0.5f});
+    child_paint.setBlendMode(blend_mode);
+    // Only children that paint with source over can inherit opacity.
+    const bool is_src_over = blend_mode == SkBlendMode::kSrcOver;
+    auto layer = std::make_shared<ClipRectLayer>(layer_bounds,
+                                                 Clip::antiAliasWithSaveLayer);
+    layer->Add(std::make_shared<MockLayer>(child_path1, child_paint, false,
+                                           false, false, is_src_over));
+    layer->Add(std::make_shared<MockLayer>(child_path2, child_paint, false,
+                                           false, false, is_src_over));
+    layer->Preroll(preroll_context(), SkMatrix());
+
+    auto elided_surface = SkSurface::MakeRasterN32Premul(32, 32);
+    SkCanvas* elided_canvas = elided_surface->getCanvas();
+    elided_canvas->clear(SK_ColorWHITE);
+    SkippedPaintOps skipped_ops;
+    Layer::PaintContext context = paint_context();
+    context.internal_nodes_canvas = elided_canvas;
+    context.leaf_nodes_canvas = elided_canvas;
+    context.skipped_ops = &skipped_ops;
+    layer->Paint(context);
+    EXPECT_EQ(skipped_ops.clips, 1u);
+    EXPECT_EQ(skipped_ops.save_layers, is_src_over ? 1u : 0u);
+
+    auto clipped_surface = SkSurface::MakeRasterN32Premul(32, 32);
+    SkCanvas* clipped_canvas = clipped_surface->getCanvas();
+    clipped_canvas->clear(SK_ColorWHITE);
+    clipped_canvas->clipRect(layer_bounds, true);
+    clipped_canvas->saveLayer(layer_bounds, nullptr);
+    clipped_canvas->drawPath(child_path1, child_paint);
+    clipped_canvas->drawPath(child_path2, child_paint);
+    clipped_canvas->restore();
+
+    SkBitmap elided;
+    elided.allocN32Pixels(32, 32);
+    elided_surface->readPixels(elided, 0, 0);
+    SkBitmap clipped;
+    clipped.allocN32Pixels(32, 32);
+    clipped_surface->readPixels(clipped, 0, 0);
+    // Compositing through the saveLayer may round differently.
+    int max_difference = 0;
+    for (int y = 0; y < 32; y++) {
+      for (int x = 0; x < 32; x++) {
+        const SkColor elided_color = elided.getColor(x, y);
+        const SkColor clipped_color = clipped.getColor(x, y);
+        for (int shift = 0; shift < 32; shift += 8) {
+          max_difference = std::max(
+              max_difference, std::abs(int((elided_color >> shift) & 0xFF) -
+                                       int((clipped_color >> shift) & 0xFF)));
+        }
+      }
+    }
+    EXPECT_LE(max_difference, 1);
+  }
+}
+
 static bool ReadbackResult(PrerollContext* context,
                            Clip clip_behavior,
                            std::shared_ptr<Layer> child,
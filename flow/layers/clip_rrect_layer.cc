@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/clip_rrect_layer.h"
 
+#include "flutter/flow/layers/layer_tree_serialization.h"
+
 namespace flutter {
 
 ClipRRectLayer::ClipRRectLayer(const SkRRect& clip_rrect, Clip clip_behavior)
@@ -26,9 +28,21 @@ void ClipRRectLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
     SkRect child_paint_bounds = SkRect::MakeEmpty();
     PrerollChildren(context, matrix, &child_paint_bounds);
 
+    const SkRect touched_bounds =
+        ComputeTouchedPixelBounds(child_paint_bounds, matrix);
+    // The saveLayer can't be left out if the children read back from it.
+    clip_is_redundant_ =
+        !(UsesSaveLayer() && context->surface_needs_readback) &&
+        clip_rrect_.contains(touched_bounds);
+    clip_as_rect_ = !clip_rrect_.isRect() &&
+                    IsClearOfCorners(clip_rrect_, touched_bounds);
     if (child_paint_bounds.intersect(clip_rrect_bounds)) {
       set_paint_bounds(child_paint_bounds);
     }
+    // Clipping each child separately only matches clipping them together
+    // when the clip doesn't use a saveLayer of its own.
+    set_layer_can_inherit_opacity((!UsesSaveLayer() || clip_is_redundant_) &&
+                                  children_can_inherit_opacity());
     context->mutators_stack.Pop();
   }
   context->cull_rect = previous_cull_rect;
@@ -55,10 +69,22 @@ void ClipRRectLayer::Paint(PaintContext& context) const {
     TRACE_EVENT_INSTANT0("flutter", "children not inside clip rect, skipping");
     return;
   }
+  if (clip_is_redundant_) {
+    PaintChildrenWithoutClip(context, UsesSaveLayer());
+    return;
+  }
 
   SkAutoCanvasRestore save(context.internal_nodes_canvas, true);
-  context.internal_nodes_canvas->clipRRect(clip_rrect_,
-                                           clip_behavior_ != Clip::hardEdge);
+  if (clip_as_rect_) {
+    context.internal_nodes_canvas->clipRect(clip_rrect_.rect(),
+                                            clip_behavior_ != Clip::hardEdge);
+    if (context.skipped_ops) {
+      context.skipped_ops->simplified_clips++;
+    }
+  } else {
+    context.internal_nodes_canvas->clipRRect(clip_rrect_,
+                                             clip_behavior_ != Clip::hardEdge);
+  }
 
   if (UsesSaveLayer()) {
     context.internal_nodes_canvas->saveLayer(paint_bounds(), nullptr);
@@ -69,4 +95,11 @@ void ClipRRectLayer::Paint(PaintContext& context) const {
   }
 }
 
+void ClipRRectLayer::Serialize(LayerTreeWriter& writer) const {
+  writer.WriteLayerHeader(SerializedLayerType::kClipRRect, *this);
+  writer.WriteRRect(clip_rrect_);
+  writer.WriteUInt32(clip_behavior_);
+  writer.WriteChildren(*this);
+}
+
 }  // namespace flutter
@@ -17,6 +17,8 @@ class ClipRRectLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  void Serialize(LayerTreeWriter& writer) const override;
+
   bool UsesSaveLayer() const {
     return clip_behavior_ == Clip::antiAliasWithSaveLayer;
   }
@@ -29,6 +31,12 @@ class ClipRRectLayer : public ContainerLayer {
   SkRRect clip_rrect_;
   Clip clip_behavior_;
   bool children_inside_clip_ = false;
+  // Whether the children only touch pixels inside the clip, so that neither
+  // the clip nor its saveLayer makes a difference.
+  bool clip_is_redundant_ = false;
+  // Whether the children are clear of the rounded corners, so that the clip
+  // can be made with the bounds of |clip_rrect_| instead.
+  bool clip_as_rect_ = false;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ClipRRectLayer);
 };
@@ -195,6 +195,81 @@ TEST_F(ClipRRectLayerTest, PartiallyContainedChild) {
            MockCanvas::DrawCall{1, MockCanvas::RestoreData{0}}}));
 }
 
+TEST_F(ClipRRectLayerTest, ChildInsideClipIsNotClipped) {
+  const SkRect child_bounds = SkRect::MakeXYWH(10.0, 10.0, 20.0, 20.0);
+  const SkRRect layer_rrect =
+      SkRRect::MakeRectXY(SkRect::MakeWH(40.0, 40.0), 4.0, 4.0);
+  const SkPath child_path = SkPath().addRect(child_bounds);
+  const SkPaint child_paint = SkPaint(SkColors::kYellow);
+  auto mock_layer = std::make_shared<MockLayer>(child_path, child_paint);
+  auto layer = std::make_shared<ClipRRectLayer>(layer_rrect, Clip::antiAlias);
+  layer->Add(mock_layer);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_EQ(mock_layer->parent_mutators(), std::vector({Mutator(layer_rrect)}));
+
+  SkippedPaintOps skipped_ops;
+  paint_context().skipped_ops = &skipped_ops;
+  layer->Paint(paint_context());
+  EXPECT_EQ(mock_canvas().draw_calls(),
+            std::vector({MockCanvas::DrawCall{
+                0, MockCanvas::DrawPathData{child_path, child_paint}}}));
+  EXPECT_EQ(skipped_ops.clips, 1u);
+  EXPECT_EQ(skipped_ops.save_layers, 0u);
+}
+
+TEST_F(ClipRRectLayerTest, ChildClearOfCornersIsClippedToRect) {
+  const SkRect child_bounds = SkRect::MakeLTRB(-5.0, 10.0, 45.0, 20.0);
+  const SkRect layer_bounds = SkRect::MakeWH(40.0, 40.0);
+  const SkRRect layer_rrect = SkRRect::MakeRectXY(layer_bounds, 4.0, 4.0);
+  const SkPath child_path = SkPath().addRect(child_bounds);
+  const SkPaint child_paint = SkPaint(SkColors::kYellow);
+  auto mock_layer = std::make_shared<MockLayer>(child_path, child_paint);
+  auto layer = std::make_shared<ClipRRectLayer>(layer_rrect, Clip::antiAlias);
+  layer->Add(mock_layer);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+
+  SkippedPaintOps skipped_ops;
+  paint_context().skipped_ops = &skipped_ops;
+  layer->Paint(paint_context());
+  EXPECT_EQ(
+      mock_canvas().draw_calls(),
+      std::vector(
+          {MockCanvas::DrawCall{0, MockCanvas::SaveData{1}},
+           MockCanvas::DrawCall{
+               1, MockCanvas::ClipRectData{layer_bounds, SkClipOp::kIntersect,
+                                           MockCanvas::kSoft_ClipEdgeStyle}},
+           MockCanvas::DrawCall{
+               1, MockCanvas::DrawPathData{child_path, child_paint}},
+           MockCanvas::DrawCall{1, MockCanvas::RestoreData{0}}}));
+  EXPECT_EQ(skipped_ops.simplified_clips, 1u);
+}
+
+TEST_F(ClipRRectLayerTest, ChildOverCornersIsClippedToRRect) {
+  const SkRect child_bounds = SkRect::MakeLTRB(-5.0, -5.0, 45.0, 20.0);
+  const SkRRect layer_rrect =
+      SkRRect::MakeRectXY(SkRect::MakeWH(40.0, 40.0), 4.0, 4.0);
+  const SkPath child_path = SkPath().addRect(child_bounds);
+  const SkPaint child_paint = SkPaint(SkColors::kYellow);
+  auto mock_layer = std::make_shared<MockLayer>(child_path, child_paint);
+  auto layer = std::make_shared<ClipRRectLayer>(layer_rrect, Clip::antiAlias);
+  layer->Add(mock_layer);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  layer->Paint(paint_context());
+  EXPECT_EQ(
+      mock_canvas().draw_calls(),
+      std::vector(
+          {MockCanvas::DrawCall{0, MockCanvas::SaveData{1}},
+           MockCanvas::DrawCall{
+               1, MockCanvas::ClipRRectData{layer_rrect, SkClipOp::kIntersect,
+                                            MockCanvas::kSoft_ClipEdgeStyle}},
+           MockCanvas::DrawCall{
+               1, MockCanvas::DrawPathData{child_path, child_paint}},
+           MockCanvas::DrawCall{1, MockCanvas::RestoreData{0}}}));
+}
+
 static bool ReadbackResult(PrerollContext* context,
                            Clip clip_behavior,
                            std::shared_ptr<Layer> child,
@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/color_filter_layer.h"
 
+#include "flutter/flow/layers/layer_tree_serialization.h"
+
 namespace flutter {
 
 ColorFilterLayer::ColorFilterLayer(sk_sp<SkColorFilter> filter)
@@ -14,6 +16,8 @@ void ColorFilterLayer::Preroll(PrerollContext* context,
   Layer::AutoPrerollSaveLayerState save =
       Layer::AutoPrerollSaveLayerState::Create(context);
   ContainerLayer::Preroll(context, matrix);
+  // The color filter applies to the children as a whole.
+  set_layer_can_inherit_opacity(false);
 }
 
 void ColorFilterLayer::Paint(PaintContext& context) const {
@@ -28,4 +32,10 @@ void ColorFilterLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+void ColorFilterLayer::Serialize(LayerTreeWriter& writer) const {
+  writer.WriteLayerHeader(SerializedLayerType::kColorFilter, *this);
+  writer.WriteFlattenable(filter_.get());
+  writer.WriteChildren(*this);
+}
+
 }  // namespace flutter
@@ -4,12 +4,60 @@
 
 #include "flutter/flow/layers/container_layer.h"
 
+#include "flutter/flow/layers/layer_tree_serialization.h"
+
 namespace flutter {
 
+#if defined(OS_FUCHSIA)
+// Whether a layer needs to be system composited depends on the layers
+// prerolled before it, which aren't part of the inputs of |PrerollCache|.
+static constexpr bool kCanSkipPrerollingChildren = false;
+#else
+static constexpr bool kCanSkipPrerollingChildren = true;
+#endif  // defined(OS_FUCHSIA)
+
+ContainerLayer::PrerollCache::PrerollCache(const PrerollContext& context,
+                                           const SkMatrix& matrix)
+    : child_matrix(matrix),
+      cull_rect(context.cull_rect),
+      raster_cache(context.raster_cache),
+      gr_context(context.gr_context),
+      view_embedder(context.view_embedder),
+      dst_color_space(context.dst_color_space),
+      texture_registry(&context.texture_registry),
+      checkerboard_offscreen_layers(context.checkerboard_offscreen_layers),
+      frame_physical_depth(context.frame_physical_depth),
+      frame_device_pixel_ratio(context.frame_device_pixel_ratio),
+      total_elevation(context.total_elevation),
+      is_opaque(context.is_opaque),
+      surface_needed_readback(context.surface_needs_readback),
+      child_paint_bounds(SkRect::MakeEmpty()),
+      child_needs_system_composite(false),
+      surface_needs_readback(false) {}
+
+bool ContainerLayer::PrerollCache::Matches(const PrerollContext& context,
+                                          const SkMatrix& matrix) const {
+  return child_matrix == matrix && cull_rect == context.cull_rect &&
+         raster_cache == context.raster_cache &&
+         gr_context == context.gr_context &&
+         view_embedder == context.view_embedder &&
+         dst_color_space == context.dst_color_space &&
+         texture_registry == &context.texture_registry &&
+         checkerboard_offscreen_layers ==
+             context.checkerboard_offscreen_layers &&
+         frame_physical_depth == context.frame_physical_depth &&
+         frame_device_pixel_ratio == context.frame_device_pixel_ratio &&
+         total_elevation == context.total_elevation &&
+         is_opaque == context.is_opaque &&
+         surface_needed_readback == context.surface_needs_readback;
+}
+
 ContainerLayer::ContainerLayer() {}
 
 void ContainerLayer::Add(std::shared_ptr<Layer> layer) {
   layers_.emplace_back(std::move(layer));
+  preroll_cache_.reset();
+  prerolled_children_ = false;
 }
 
 void ContainerLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
@@ -18,6 +66,7 @@ void ContainerLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   SkRect child_paint_bounds = SkRect::MakeEmpty();
   PrerollChildren(context, matrix, &child_paint_bounds);
   set_paint_bounds(child_paint_bounds);
+  set_layer_can_inherit_opacity(children_can_inherit_opacity());
 }
 
 void ContainerLayer::Paint(PaintContext& context) const {
@@ -37,7 +86,38 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
   // Platform views have no children, so context->has_platform_view should
   // always be false.
   FML_DCHECK(!context->has_platform_view);
+
+  if (preroll_cache_ && preroll_cache_->Matches(*context, child_matrix)) {
+    TRACE_EVENT_INSTANT0("flutter", "children preroll cache hit");
+    for (const auto& preparation : preroll_cache_->raster_cache_preparations) {
+      preparation.Prepare(context);
+    }
+    child_paint_bounds->join(preroll_cache_->child_paint_bounds);
+    if (preroll_cache_->child_needs_system_composite) {
+      set_needs_system_composite(true);
+    }
+    context->surface_needs_readback = preroll_cache_->surface_needs_readback;
+    return;
+  }
+
+  // Record the outputs of prerolling children that have been prerolled
+  // before, which suggests that they are being retained across frames.
+  std::unique_ptr<PrerollCache> preroll_cache;
+  auto* parent_preparations = context->raster_cache_preparations;
+  if (kCanSkipPrerollingChildren && prerolled_children_) {
+    preroll_cache = std::make_unique<PrerollCache>(*context, child_matrix);
+    context->raster_cache_preparations =
+        &preroll_cache->raster_cache_preparations;
+  }
+  prerolled_children_ = true;
+
   bool child_has_platform_view = false;
+  // The device pixels touched by the children painted so far. These are
+  // outset by a pixel, as the children may be painted at a slightly different
+  // translation, e.g. when OpacityLayer snaps it to whole pixels, and
+  // anti-aliased edges that share a pixel must not be counted as disjoint.
+  SkIRect painted_device_bounds = SkIRect::MakeEmpty();
+  children_can_inherit_opacity_ = true;
   for (auto& layer : layers_) {
     // Reset context->has_platform_view to false so that layers aren't treated
     // as if they have a platform view based on one being previously found in a
@@ -51,11 +131,44 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
     }
     child_paint_bounds->join(layer->paint_bounds());
 
+    if (layer->needs_painting()) {
+      const SkIRect device_bounds = child_matrix.mapRect(layer->paint_bounds())
+                                        .makeOutset(1, 1)
+                                        .roundOut();
+      children_can_inherit_opacity_ =
+          children_can_inherit_opacity_ && layer->layer_can_inherit_opacity() &&
+          !SkIRect::Intersects(painted_device_bounds, device_bounds);
+      painted_device_bounds.join(device_bounds);
+    }
+
     child_has_platform_view =
         child_has_platform_view || context->has_platform_view;
   }
 
   context->has_platform_view = child_has_platform_view;
+  children_have_platform_view_ = child_has_platform_view;
+
+  if (preroll_cache) {
+    context->raster_cache_preparations = parent_preparations;
+    if (parent_preparations) {
+      parent_preparations->insert(
+          parent_preparations->end(),
+          preroll_cache->raster_cache_preparations.begin(),
+          preroll_cache->raster_cache_preparations.end());
+    }
+    // Platform views are prerolled with the embedder every frame.
+    if (!child_has_platform_view) {
+      for (auto& layer : layers_) {
+        preroll_cache->child_paint_bounds.join(layer->paint_bounds());
+        preroll_cache->child_needs_system_composite |=
+            layer->needs_system_composite();
+      }
+      preroll_cache->surface_needs_readback = context->surface_needs_readback;
+      preroll_cache_ = std::move(preroll_cache);
+    } else {
+      preroll_cache_.reset();
+    }
+  }
 
 #if defined(OS_FUCHSIA)
   if (child_layer_exists_below_) {
@@ -72,18 +185,95 @@ void ContainerLayer::PaintChildren(PaintContext& context) const {
   // Intentionally not tracing here as there should be no self-time
   // and the trace event on this common function has a small overhead.
   for (auto& layer : layers_) {
-    if (layer->needs_painting()) {
-      layer->Paint(context);
+    if (!layer->needs_painting()) {
+      continue;
+    }
+    // The leaf canvas has the clip of the frame, or of the whole layer when
+    // the raster cache paints it, so entries don't miss culled children.
+    if (!children_have_platform_view_ &&
+        context.leaf_nodes_canvas->quickReject(layer->paint_bounds())) {
+      if (context.skipped_ops) {
+        context.skipped_ops->culled_layers++;
+      }
+      continue;
     }
+    layer->Paint(context);
   }
 }
 
+void ContainerLayer::PaintChildrenWithoutClip(PaintContext& context,
+                                              bool clip_uses_save_layer) const {
+  TRACE_EVENT_INSTANT0("flutter", "children inside clip, not clipping");
+  // The saveLayer composites the children together before blending them
+  // with what is beneath, which painting them directly only matches when
+  // they all paint with source over blending.
+  const bool keep_save_layer =
+      clip_uses_save_layer && !children_can_inherit_opacity();
+  if (context.skipped_ops) {
+    context.skipped_ops->clips++;
+    if (clip_uses_save_layer && !keep_save_layer) {
+      context.skipped_ops->save_layers++;
+    }
+  }
+  if (!keep_save_layer) {
+    PaintChildren(context);
+    return;
+  }
+
+  context.internal_nodes_canvas->saveLayer(paint_bounds(), nullptr);
+  PaintChildren(context);
+  context.internal_nodes_canvas->restore();
+}
+
+SkRect ContainerLayer::ComputeTouchedPixelBounds(const SkRect& bounds,
+                                                 const SkMatrix& matrix) {
+  SkMatrix inverse;
+  if (bounds.isEmpty() || matrix.hasPerspective() || !matrix.invert(&inverse)) {
+    return SkRect::MakeEmpty();
+  }
+  // Content touches the pixels that its device bounds overlap, all of which
+  // lie within those bounds outset by a pixel. That stays true wherever the
+  // content is moved to along with its clip, e.g. when OpacityLayer snaps it
+  // to whole pixels.
+  return inverse.mapRect(matrix.mapRect(bounds).makeOutset(1, 1));
+}
+
+bool ContainerLayer::IsClearOfCorners(const SkRRect& rrect,
+                                      const SkRect& rect) {
+  if (rect.isEmpty()) {
+    return false;
+  }
+  const SkRect& bounds = rrect.rect();
+  const SkVector upper_left = rrect.radii(SkRRect::kUpperLeft_Corner);
+  const SkVector upper_right = rrect.radii(SkRRect::kUpperRight_Corner);
+  const SkVector lower_right = rrect.radii(SkRRect::kLowerRight_Corner);
+  const SkVector lower_left = rrect.radii(SkRRect::kLowerLeft_Corner);
+  const SkRect corners[] = {
+      SkRect::MakeLTRB(bounds.left(), bounds.top(),
+                       bounds.left() + upper_left.x(),
+                       bounds.top() + upper_left.y()),
+      SkRect::MakeLTRB(bounds.right() - upper_right.x(), bounds.top(),
+                       bounds.right(), bounds.top() + upper_right.y()),
+      SkRect::MakeLTRB(bounds.right() - lower_right.x(),
+                       bounds.bottom() - lower_right.y(), bounds.right(),
+                       bounds.bottom()),
+      SkRect::MakeLTRB(bounds.left(), bounds.bottom() - lower_left.y(),
+                       bounds.left() + lower_left.x(), bounds.bottom()),
+  };
+  for (const SkRect& corner : corners) {
+    if (SkRect::Intersects(corner, rect)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void ContainerLayer::TryToPrepareRasterCache(PrerollContext* context,
                                              Layer* layer,
                                              const SkMatrix& matrix) {
   if (!context->has_platform_view && context->raster_cache &&
       SkRect::Intersects(context->cull_rect, layer->paint_bounds())) {
-    context->raster_cache->Prepare(context, layer, matrix);
+    RasterCachePreparation::ForLayer(layer, matrix).Prepare(context);
   }
 }
 
@@ -160,4 +350,9 @@ void ContainerLayer::UpdateSceneChildren(SceneUpdateContext& context) {
 
 #endif  // defined(OS_FUCHSIA)
 
+void ContainerLayer::Serialize(LayerTreeWriter& writer) const {
+  writer.WriteLayerHeader(SerializedLayerType::kContainer, *this);
+  writer.WriteChildren(*this);
+}
+
 }  // namespace flutter
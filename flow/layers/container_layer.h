@@ -18,6 +18,8 @@ class ContainerLayer : public Layer {
 
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
   void Paint(PaintContext& context) const override;
+
+  void Serialize(LayerTreeWriter& writer) const override;
 #if defined(OS_FUCHSIA)
   void CheckForChildLayerBelow(PrerollContext* context) override;
   void UpdateScene(SceneUpdateContext& context) override;
@@ -29,14 +31,44 @@ class ContainerLayer : public Layer {
   void PrerollChildren(PrerollContext* context,
                        const SkMatrix& child_matrix,
                        SkRect* child_paint_bounds);
+  // Paints the children that need painting, leaving out those outside the
+  // clip of the canvas.
   void PaintChildren(PaintContext& context) const;
 
+  // Paints the children of a clip layer without its clip, for when Preroll
+  // found that they only touch pixels entirely inside it. The saveLayer of
+  // the clip is kept unless the children are known to paint with source
+  // over blending.
+  void PaintChildrenWithoutClip(PaintContext& context,
+                                bool clip_uses_save_layer) const;
+
+  // Returns the bounds, in the same space as |bounds|, of the pixels that
+  // content within |bounds| touches when painted with |matrix|. Returns an
+  // empty rect for matrices with perspective, which don't map rects to rects.
+  static SkRect ComputeTouchedPixelBounds(const SkRect& bounds,
+                                          const SkMatrix& matrix);
+
+  // Whether |rect| is clear of the rounded corners of |rrect|, so that
+  // clipping content within |rect| to |rrect| is the same as clipping it to
+  // the bounds of |rrect|.
+  static bool IsClearOfCorners(const SkRRect& rrect, const SkRect& rect);
+
+  // Whether all the children that paint can inherit opacity, and none of
+  // them paints over another. Set by |PrerollChildren|.
+  bool children_can_inherit_opacity() const {
+    return children_can_inherit_opacity_;
+  }
+
 #if defined(OS_FUCHSIA)
   void UpdateSceneChildren(SceneUpdateContext& context);
 #endif  // defined(OS_FUCHSIA)
 
   // For OpacityLayer to restructure to have a single child.
-  void ClearChildren() { layers_.clear(); }
+  void ClearChildren() {
+    layers_.clear();
+    preroll_cache_.reset();
+    prerolled_children_ = false;
+  }
 
   // Try to prepare the raster cache for a given layer.
   //
@@ -53,7 +85,47 @@ class ContainerLayer : public Layer {
                                       const SkMatrix& matrix);
 
  private:
+  // The inputs and outputs of the last call to |PrerollChildren|. The
+  // children of a container can't change once it has been prerolled, so if
+  // they are prerolled with the same inputs again they would produce the same
+  // outputs. This lets subtrees retained across frames, e.g. with
+  // |SceneBuilder.addRetained|, skip prerolling their descendants.
+  struct PrerollCache {
+    // Inputs.
+    SkMatrix child_matrix;
+    SkRect cull_rect;
+    RasterCache* raster_cache;
+    GrContext* gr_context;
+    ExternalViewEmbedder* view_embedder;
+    SkColorSpace* dst_color_space;
+    TextureRegistry* texture_registry;
+    bool checkerboard_offscreen_layers;
+    float frame_physical_depth;
+    float frame_device_pixel_ratio;
+    float total_elevation;
+    bool is_opaque;
+    bool surface_needed_readback;
+
+    // Outputs.
+    SkRect child_paint_bounds;
+    bool child_needs_system_composite;
+    bool surface_needs_readback;
+    std::vector<RasterCachePreparation> raster_cache_preparations;
+
+    PrerollCache(const PrerollContext& context, const SkMatrix& matrix);
+
+    bool Matches(const PrerollContext& context, const SkMatrix& matrix) const;
+  };
+
   std::vector<std::shared_ptr<Layer>> layers_;
+  bool children_can_inherit_opacity_ = false;
+  // Children with platform views are always painted, as the embedder expects
+  // them to composite their views.
+  bool children_have_platform_view_ = false;
+  // Only set once the children have been prerolled more than once, as most
+  // containers are only prerolled for a single frame.
+  std::unique_ptr<PrerollCache> preroll_cache_;
+  bool prerolled_children_ = false;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ContainerLayer);
 };
@@ -4,6 +4,7 @@
 
 #include "flutter/flow/layers/container_layer.h"
 
+#include "flutter/flow/layers/opacity_layer.h"
 #include "flutter/flow/testing/layer_test.h"
 #include "flutter/flow/testing/mock_layer.h"
 #include "flutter/fml/macros.h"
@@ -14,6 +15,25 @@ namespace testing {
 
 using ContainerLayerTest = LayerTest;
 
+namespace {
+
+class PrerollCountingLayer : public MockLayer {
+ public:
+  using MockLayer::MockLayer;
+
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override {
+    preroll_count_++;
+    MockLayer::Preroll(context, matrix);
+  }
+
+  int preroll_count() const { return preroll_count_; }
+
+ private:
+  int preroll_count_ = 0;
+};
+
+}  // namespace
+
 #ifndef NDEBUG
 TEST_F(ContainerLayerTest, LayerWithParentHasPlatformView) {
   auto layer = std::make_shared<ContainerLayer>();
@@ -119,6 +139,43 @@ TEST_F(ContainerLayerTest, Multiple) {
                                                child_path2, child_paint2}}}));
 }
 
+TEST_F(ContainerLayerTest, ChildrenOutsideCanvasClipAreCulled) {
+  const SkPath child_path1 = SkPath().addRect(5.0f, 6.0f, 20.5f, 21.5f);
+  const SkPath child_path2 = SkPath().addRect(70.0f, 6.0f, 80.0f, 21.5f);
+  const SkPaint child_paint(SkColors::kGray);
+  auto mock_layer1 = std::make_shared<MockLayer>(child_path1, child_paint);
+  auto mock_layer2 = std::make_shared<MockLayer>(child_path2, child_paint);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(mock_layer1);
+  layer->Add(mock_layer2);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_TRUE(mock_layer2->needs_painting());
+
+  SkippedPaintOps skipped_ops;
+  paint_context().skipped_ops = &skipped_ops;
+  layer->Paint(paint_context());
+  EXPECT_EQ(mock_canvas().draw_calls(),
+            std::vector({MockCanvas::DrawCall{
+                0, MockCanvas::DrawPathData{child_path1, child_paint}}}));
+  EXPECT_EQ(skipped_ops.culled_layers, 1u);
+}
+
+TEST_F(ContainerLayerTest, ChildrenWithPlatformViewsAreNotCulled) {
+  const SkPath child_path = SkPath().addRect(70.0f, 6.0f, 80.0f, 21.5f);
+  const SkPaint child_paint(SkColors::kGray);
+  auto mock_layer = std::make_shared<MockLayer>(
+      child_path, child_paint, true /* fake_has_platform_view */);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(mock_layer);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  layer->Paint(paint_context());
+  EXPECT_EQ(mock_canvas().draw_calls(),
+            std::vector({MockCanvas::DrawCall{
+                0, MockCanvas::DrawPathData{child_path, child_paint}}}));
+}
+
 TEST_F(ContainerLayerTest, MultipleWithEmpty) {
   SkPath child_path1;
   child_path1.addRect(5.0f, 6.0f, 20.5f, 21.5f);
@@ -198,5 +255,91 @@ TEST_F(ContainerLayerTest, NeedsSystemComposite) {
                                                child_path2, child_paint2}}}));
 }
 
+#if !defined(OS_FUCHSIA)
+TEST_F(ContainerLayerTest, RetainedChildrenSkipPreroll) {
+  SkPath child_path;
+  child_path.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+  SkMatrix initial_transform = SkMatrix::MakeTrans(-0.5f, -0.5f);
+
+  auto mock_layer = std::make_shared<PrerollCountingLayer>(child_path);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(mock_layer);
+
+  // The outputs of prerolling the children are recorded the second time they
+  // are prerolled, and reused after that.
+  for (int i = 0; i < 3; i++) {
+    layer->Preroll(preroll_context(), initial_transform);
+    EXPECT_EQ(layer->paint_bounds(), child_path.getBounds());
+  }
+  EXPECT_EQ(mock_layer->preroll_count(), 2);
+  EXPECT_TRUE(layer->needs_painting());
+
+  // Changing any input prerolls the children again.
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_EQ(mock_layer->preroll_count(), 3);
+  EXPECT_EQ(mock_layer->parent_matrix(), SkMatrix());
+
+  preroll_context()->cull_rect = SkRect::MakeLTRB(0, 0, 10, 10);
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_EQ(mock_layer->preroll_count(), 4);
+  EXPECT_EQ(mock_layer->parent_cull_rect(), SkRect::MakeLTRB(0, 0, 10, 10));
+
+  // Adding a child prerolls all the children again.
+  auto mock_layer2 = std::make_shared<PrerollCountingLayer>(child_path);
+  layer->Add(mock_layer2);
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_EQ(mock_layer->preroll_count(), 5);
+  EXPECT_EQ(mock_layer2->preroll_count(), 1);
+}
+
+TEST_F(ContainerLayerTest, SkippedPrerollRestoresReadback) {
+  auto mock_layer = std::make_shared<PrerollCountingLayer>(
+      SkPath(), SkPaint(), false, false, true);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(mock_layer);
+
+  for (int i = 0; i < 3; i++) {
+    preroll_context()->surface_needs_readback = false;
+    layer->Preroll(preroll_context(), SkMatrix());
+    EXPECT_TRUE(preroll_context()->surface_needs_readback);
+  }
+  EXPECT_EQ(mock_layer->preroll_count(), 2);
+}
+
+TEST_F(ContainerLayerTest, ChildrenWithPlatformViewsAreAlwaysPrerolled) {
+  auto mock_layer =
+      std::make_shared<PrerollCountingLayer>(SkPath(), SkPaint(), true);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(mock_layer);
+
+  for (int i = 0; i < 3; i++) {
+    preroll_context()->has_platform_view = false;
+    layer->Preroll(preroll_context(), SkMatrix());
+    EXPECT_TRUE(preroll_context()->has_platform_view);
+  }
+  EXPECT_EQ(mock_layer->preroll_count(), 3);
+}
+
+TEST_F(ContainerLayerTest, SkippedPrerollPreparesRasterCache) {
+  SkPath child_path;
+  child_path.addRect(5.0f, 6.0f, 20.5f, 21.5f);
+  auto mock_layer = std::make_shared<MockLayer>(child_path);
+  auto opacity_layer = std::make_shared<OpacityLayer>(128, SkPoint());
+  opacity_layer->Add(mock_layer);
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(opacity_layer);
+
+  RasterCache raster_cache;
+  preroll_context()->raster_cache = &raster_cache;
+  for (int i = 0; i < 3; i++) {
+    layer->Preroll(preroll_context(), SkMatrix());
+    // Entries that were not prepared during the frame are evicted.
+    raster_cache.SweepAfterFrame();
+    EXPECT_EQ(raster_cache.GetCachedEntriesCount(), 1u);
+  }
+  preroll_context()->raster_cache = nullptr;
+}
+#endif  // !defined(OS_FUCHSIA)
+
 }  // namespace testing
 }  // namespace flutter
@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/image_filter_layer.h"
 
+#include "flutter/flow/layers/layer_tree_serialization.h"
+
 namespace flutter {
 
 ImageFilterLayer::ImageFilterLayer(sk_sp<SkImageFilter> filter)
@@ -52,4 +54,10 @@ void ImageFilterLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+void ImageFilterLayer::Serialize(LayerTreeWriter& writer) const {
+  writer.WriteLayerHeader(SerializedLayerType::kImageFilter, *this);
+  writer.WriteFlattenable(filter_.get());
+  writer.WriteChildren(*this);
+}
+
 }  // namespace flutter
@@ -19,6 +19,8 @@ class ImageFilterLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  void Serialize(LayerTreeWriter& writer) const override;
+
  private:
   sk_sp<SkImageFilter> filter_;
   SkRect child_paint_bounds_;
@@ -4,6 +4,7 @@
 
 #include "flutter/flow/layers/layer.h"
 
+#include "flutter/flow/layers/layer_tree_serialization.h"
 #include "flutter/flow/paint_utils.h"
 #include "third_party/skia/include/core/SkColorFilter.h"
 
@@ -27,6 +28,59 @@ uint64_t Layer::NextUniqueID() {
 
 void Layer::Preroll(PrerollContext* context, const SkMatrix& matrix) {}
 
+void Layer::Serialize(LayerTreeWriter& writer) const {
+  writer.WriteLayerHeader(SerializedLayerType::kPlaceholder, *this);
+  writer.WriteRect(paint_bounds());
+}
+
+RasterCachePreparation RasterCachePreparation::ForPicture(
+    SkPicture* picture,
+    const SkMatrix& matrix,
+    bool is_complex,
+    bool will_change) {
+  RasterCachePreparation preparation;
+  preparation.picture = picture;
+  preparation.matrix = matrix;
+  preparation.is_complex = is_complex;
+  preparation.will_change = will_change;
+  return preparation;
+}
+
+RasterCachePreparation RasterCachePreparation::ForLayer(
+    Layer* layer,
+    const SkMatrix& matrix) {
+  RasterCachePreparation preparation;
+  preparation.layer = layer;
+  preparation.matrix = matrix;
+  return preparation;
+}
+
+RasterCachePreparation RasterCachePreparation::ForShadow(
+    const ShadowRasterCacheKey& shadow,
+    const SkMatrix& matrix) {
+  RasterCachePreparation preparation;
+  preparation.shadow = shadow;
+  preparation.matrix = matrix;
+  return preparation;
+}
+
+void RasterCachePreparation::Prepare(PrerollContext* context) const {
+  FML_DCHECK(context->raster_cache);
+  if (context->raster_cache_preparations) {
+    context->raster_cache_preparations->push_back(*this);
+  }
+  if (picture) {
+    context->raster_cache->Prepare(context->gr_context, picture, matrix,
+                                   context->dst_color_space, is_complex,
+                                   will_change);
+  } else if (layer) {
+    context->raster_cache->Prepare(context, layer, matrix);
+  } else {
+    context->raster_cache->Prepare(context->gr_context, *shadow, matrix,
+                                   context->dst_color_space);
+  }
+}
+
 Layer::AutoPrerollSaveLayerState::AutoPrerollSaveLayerState(
     PrerollContext* preroll_context,
     bool save_layer_is_active,
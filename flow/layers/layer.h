@@ -6,6 +6,7 @@
 #define FLUTTER_FLOW_LAYERS_LAYER_H_
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "flutter/flow/embedded_views.h"
@@ -42,6 +43,37 @@ static constexpr SkRect kGiantRect = SkRect::MakeLTRB(-1E9F, -1E9F, 1E9F, 1E9F);
 // This should be an exact copy of the Clip enum in painting.dart.
 enum Clip { none, hardEdge, antiAlias, antiAliasWithSaveLayer };
 
+class Layer;
+class LayerTreeWriter;
+struct PrerollContext;
+
+// A request made during Preroll to prepare the raster cache for a picture, a
+// layer or a shadow. Containers record these so that they can be replayed
+// when the containers skip prerolling their unchanged children.
+struct RasterCachePreparation {
+  static RasterCachePreparation ForPicture(SkPicture* picture,
+                                           const SkMatrix& matrix,
+                                           bool is_complex,
+                                           bool will_change);
+
+  static RasterCachePreparation ForLayer(Layer* layer, const SkMatrix& matrix);
+
+  static RasterCachePreparation ForShadow(const ShadowRasterCacheKey& shadow,
+                                          const SkMatrix& matrix);
+
+  // Prepares the raster cache of |context|, which must be present, and
+  // records the preparation if |context| is recording them.
+  void Prepare(PrerollContext* context) const;
+
+  // Exactly one of |picture|, |layer| and |shadow| is set.
+  SkPicture* picture = nullptr;
+  Layer* layer = nullptr;
+  std::optional<ShadowRasterCacheKey> shadow;
+  SkMatrix matrix;
+  bool is_complex = false;
+  bool will_change = false;
+};
+
 struct PrerollContext {
   RasterCache* raster_cache;
   GrContext* gr_context;
@@ -71,6 +103,24 @@ struct PrerollContext {
   // Informs whether a layer needs to be system composited.
   bool child_scene_layer_exists_below = false;
 #endif  // defined(OS_FUCHSIA)
+
+  // When set, raster cache preparations are appended to this as well as
+  // being made.
+  std::vector<RasterCachePreparation>* raster_cache_preparations = nullptr;
+};
+
+// Counts the canvas operations that layers left out of a frame because they
+// would have made no difference to it.
+struct SkippedPaintOps {
+  // Layers not painted because they were outside the clip of the canvas.
+  size_t culled_layers = 0;
+  // Clips left out because Preroll found the children to be inside them.
+  size_t clips = 0;
+  // The saveLayers of Clip::antiAliasWithSaveLayer clips left out with them.
+  size_t save_layers = 0;
+  // Rounded rect and path clips made as rect clips, because Preroll found the
+  // children to be clear of their curves.
+  size_t simplified_clips = 0;
 };
 
 // Represents a single composited layer. Created on the UI thread but then
@@ -132,6 +182,15 @@ class Layer {
     // These allow us to make use of the scene metrics during Paint.
     float frame_physical_depth;
     float frame_device_pixel_ratio;
+
+    // The opacity that layers must apply to everything they paint. This is
+    // only less than 1 while painting the descendants of an OpacityLayer that
+    // folds its opacity into them instead of using a saveLayer, all of which
+    // can inherit opacity.
+    float inherited_opacity = SK_Scalar1;
+
+    // When set, layers count the operations they leave out here.
+    SkippedPaintOps* skipped_ops = nullptr;
   };
 
   // Calls SkCanvas::saveLayer and restores the layer upon destruction. Also
@@ -162,6 +221,11 @@ class Layer {
 
   virtual void Paint(PaintContext& context) const = 0;
 
+  // Writes the record of the layer and its descendants for
+  // |SerializeLayerTree|. Layers that can't be replayed without the platform
+  // are written as placeholders with their paint bounds.
+  virtual void Serialize(LayerTreeWriter& writer) const;
+
 #if defined(OS_FUCHSIA)
   // Updates the system composited scene.
   virtual void UpdateScene(SceneUpdateContext& context);
@@ -183,6 +247,12 @@ class Layer {
 
   bool needs_painting() const { return !paint_bounds_.isEmpty(); }
 
+  // Whether painting the layer with |PaintContext::inherited_opacity| applied
+  // to each of its draws looks the same as painting it into a saveLayer with
+  // that opacity. This is set by Preroll, and lets an OpacityLayer whose
+  // children can inherit opacity skip its saveLayer.
+  bool layer_can_inherit_opacity() const { return layer_can_inherit_opacity_; }
+
   uint64_t unique_id() const { return unique_id_; }
 
  protected:
@@ -190,10 +260,15 @@ class Layer {
   bool child_layer_exists_below_ = false;
 #endif
 
+  void set_layer_can_inherit_opacity(bool value) {
+    layer_can_inherit_opacity_ = value;
+  }
+
  private:
   SkRect paint_bounds_;
   uint64_t unique_id_;
   bool needs_system_composite_;
+  bool layer_can_inherit_opacity_ = false;
 
   static uint64_t NextUniqueID();
 
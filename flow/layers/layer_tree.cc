@@ -41,7 +41,8 @@ bool LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
       frame.canvas() ? frame.canvas()->imageInfo().colorSpace() : nullptr;
   frame.context().raster_cache().SetCheckboardCacheImages(
       checkerboard_raster_cache_images_);
-  MutatorsStack stack;
+  // Containers push a mutator each while they are prerolled.
+  MutatorsStack stack(fml::MakeRefCounted<LayerArena>());
   PrerollContext context = {
       ignore_raster_cache ? nullptr : &frame.context().raster_cache(),
       frame.gr_context(),
@@ -127,9 +128,23 @@ void LayerTree::Paint(CompositorContext::ScopedFrame& frame,
       checkerboard_offscreen_layers_,
       frame_physical_depth_,
       frame_device_pixel_ratio_};
+#if !FLUTTER_RELEASE
+  SkippedPaintOps skipped_ops;
+  context.skipped_ops = &skipped_ops;
+#endif  // !FLUTTER_RELEASE
 
   if (root_layer_->needs_painting())
     root_layer_->Paint(context);
+
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER("flutter", "SkippedPaintOps",
+                    reinterpret_cast<int64_t>(this),                    //
+                    "CulledLayers", skipped_ops.culled_layers,          //
+                    "Clips", skipped_ops.clips,                         //
+                    "SaveLayers", skipped_ops.save_layers,              //
+                    "SimplifiedClips", skipped_ops.simplified_clips     //
+  );
+#endif  // !FLUTTER_RELEASE
 }
 
 sk_sp<SkPicture> LayerTree::Flatten(const SkRect& bounds) {
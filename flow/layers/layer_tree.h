@@ -75,10 +75,18 @@ class LayerTree {
     checkerboard_raster_cache_images_ = checkerboard;
   }
 
+  bool checkerboard_raster_cache_images() const {
+    return checkerboard_raster_cache_images_;
+  }
+
   void set_checkerboard_offscreen_layers(bool checkerboard) {
     checkerboard_offscreen_layers_ = checkerboard;
   }
 
+  bool checkerboard_offscreen_layers() const {
+    return checkerboard_offscreen_layers_;
+  }
+
   double device_pixel_ratio() const { return frame_device_pixel_ratio_; }
 
  private:
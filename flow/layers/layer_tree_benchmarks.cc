@@ -0,0 +1,475 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/flow/compositor_context.h"
+#include "flutter/flow/embedded_views.h"
+#include "flutter/flow/instrumentation.h"
+#include "flutter/flow/layer_arena.h"
+#include "flutter/flow/layers/backdrop_filter_layer.h"
+#include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/clip_rrect_layer.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/physical_shape_layer.h"
+#include "flutter/flow/layers/picture_layer.h"
+#include "flutter/flow/layers/texture_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/flow/skia_gpu_object.h"
+#include "flutter/flow/texture.h"
+#include "flutter/fml/message_loop.h"
+#include "flutter/fml/time/time_point.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/effects/SkImageFilters.h"
+#include "third_party/skia/include/utils/SkNWayCanvas.h"
+
+namespace flutter {
+
+namespace {
+
+// An allocator for `std::allocate_shared` that allocates from the heap and
+// counts its allocations, so that only the allocations of the layers being
+// made are counted.
+template <typename T>
+class CountingAllocator {
+ public:
+  using value_type = T;
+
+  explicit CountingAllocator(size_t* count) : count_(count) {}
+
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U>& other)
+      : count_(other.count_) {}
+
+  T* allocate(size_t count) {
+    (*count_)++;
+    return std::allocator<T>().allocate(count);
+  }
+
+  void deallocate(T* pointer, size_t count) {
+    std::allocator<T>().deallocate(pointer, count);
+  }
+
+  template <typename U>
+  bool operator==(const CountingAllocator<U>& other) const {
+    return count_ == other.count_;
+  }
+
+  template <typename U>
+  bool operator!=(const CountingAllocator<U>& other) const {
+    return count_ != other.count_;
+  }
+
+ private:
+  template <typename U>
+  friend class CountingAllocator;
+
+  size_t* count_;
+};
+
+// Makes layers the way SceneBuilder does, either from the heap or from an
+// arena, and counts the heap allocations this takes.
+class LayerFactory {
+ public:
+  explicit LayerFactory(fml::RefPtr<LayerArena> arena)
+      : arena_(std::move(arena)) {}
+
+  template <typename T, typename... Args>
+  std::shared_ptr<T> Make(Args&&... args) {
+    if (arena_) {
+      return arena_->MakeShared<T>(std::forward<Args>(args)...);
+    }
+    return std::allocate_shared<T>(CountingAllocator<T>(&heap_allocations_),
+                                   std::forward<Args>(args)...);
+  }
+
+  // An arena allocates a block at a time from the heap.
+  size_t heap_allocations() const {
+    return arena_ ? arena_->stats().block_count : heap_allocations_;
+  }
+
+ private:
+  fml::RefPtr<LayerArena> arena_;
+  size_t heap_allocations_ = 0;
+};
+
+// Builds a tree with |count| pairs of nested transform and clip layers, each
+// with a leaf.
+std::shared_ptr<ContainerLayer> BuildLayerTree(LayerFactory& factory,
+                                               size_t count) {
+  auto root = factory.Make<ContainerLayer>();
+  for (size_t i = 0; i < count; i++) {
+    auto transform =
+        factory.Make<TransformLayer>(SkMatrix::MakeTrans(i % 100, i / 100));
+    transform->Add(factory.Make<TextureLayer>(
+        SkPoint::Make(0, 0), SkSize::Make(10, 10), i, false));
+    auto clip = factory.Make<ClipRectLayer>(SkRect::MakeWH(100, 100),
+                                            Clip::hardEdge);
+    clip->Add(factory.Make<TextureLayer>(SkPoint::Make(0, 0),
+                                         SkSize::Make(10, 10), i, false));
+    transform->Add(std::move(clip));
+    root->Add(std::move(transform));
+  }
+  return root;
+}
+
+void BuildLayerTree(benchmark::State& state, bool use_arena) {
+  size_t heap_allocations = 0;
+  while (state.KeepRunning()) {
+    LayerFactory factory(use_arena ? fml::MakeRefCounted<LayerArena>()
+                                   : nullptr);
+    auto root = BuildLayerTree(factory, state.range(0));
+    benchmark::DoNotOptimize(root);
+    heap_allocations += factory.heap_allocations();
+  }
+  state.counters["HeapAllocations"] =
+      static_cast<double>(heap_allocations) / state.iterations();
+}
+
+void PushMutators(benchmark::State& state, bool use_arena) {
+  size_t heap_allocations = 0;
+  while (state.KeepRunning()) {
+    auto arena = use_arena ? fml::MakeRefCounted<LayerArena>() : nullptr;
+    MutatorsStack stack(arena);
+    for (int64_t i = 0; i < state.range(0); i++) {
+      stack.PushTransform(SkMatrix::MakeTrans(i, i));
+      stack.PushClipRect(SkRect::MakeWH(100, 100));
+      stack.Pop();
+      stack.Pop();
+    }
+    benchmark::DoNotOptimize(stack);
+    // Without an arena, each mutator is allocated from the heap.
+    heap_allocations += arena ? arena->stats().block_count
+                              : static_cast<size_t>(2 * state.range(0));
+  }
+  state.counters["HeapAllocations"] =
+      static_cast<double>(heap_allocations) / state.iterations();
+}
+
+// Paints a blurred bar |state.range(0)| pixels high over static content onto
+// a raster surface, as the software backend does. Unless |retain_layer| is
+// set, a new layer is made every frame, so its backdrop is never cached.
+void PaintBackdropFilter(benchmark::State& state, bool retain_layer) {
+  constexpr int kSize = 1024;
+  auto surface = SkSurface::MakeRasterN32Premul(kSize, kSize);
+  SkCanvas* canvas = surface->getCanvas();
+  SkNWayCanvas internal_nodes_canvas(kSize, kSize);
+  internal_nodes_canvas.addCanvas(canvas);
+
+  SkPictureRecorder recorder;
+  SkCanvas* recording_canvas =
+      recorder.beginRecording(SkRect::MakeWH(kSize, kSize));
+  recording_canvas->clear(SK_ColorWHITE);
+  SkPaint stripe_paint;
+  stripe_paint.setColor(SK_ColorBLUE);
+  for (int x = 0; x < kSize; x += 16) {
+    recording_canvas->drawRect(SkRect::MakeXYWH(x, 0, 8, kSize), stripe_paint);
+  }
+  sk_sp<SkPicture> content = recorder.finishRecordingAsPicture();
+
+  MutatorsStack mutators_stack;
+  Stopwatch raster_time;
+  Stopwatch ui_time;
+  TextureRegistry texture_registry;
+  PrerollContext preroll_context = {
+      nullptr, /* raster_cache */
+      nullptr, /* gr_context */
+      nullptr, /* external_view_embedder */
+      mutators_stack,
+      nullptr,    /* dst_color_space */
+      kGiantRect, /* cull_rect */
+      false,      /* layer reads from surface */
+      raster_time,
+      ui_time,
+      texture_registry,
+      false,  /* checkerboard_offscreen_layers */
+      100.0f, /* frame_physical_depth */
+      1.0f,   /* frame_device_pixel_ratio */
+  };
+  Layer::PaintContext paint_context = {
+      &internal_nodes_canvas,
+      canvas,
+      nullptr, /* gr_context */
+      nullptr, /* external_view_embedder */
+      raster_time,
+      ui_time,
+      texture_registry,
+      nullptr, /* raster_cache */
+      false,   /* checkerboard_offscreen_layers */
+      100.0f,  /* frame_physical_depth */
+      1.0f,    /* frame_device_pixel_ratio */
+  };
+
+  auto filter = SkImageFilters::Blur(10.0f, 10.0f, nullptr);
+  std::shared_ptr<BackdropFilterLayer> layer;
+  while (state.KeepRunning()) {
+    if (!layer || !retain_layer) {
+      layer = std::make_shared<BackdropFilterLayer>(filter);
+      layer->Add(std::make_shared<TextureLayer>(
+          SkPoint::Make(0, 0), SkSize::Make(kSize, state.range(0)), 0, false));
+    }
+    layer->Preroll(&preroll_context, SkMatrix());
+    canvas->drawPicture(content);
+    layer->Paint(paint_context);
+  }
+}
+
+// The size of the frames rastered by the raster benchmarks, that of a phone
+// screen at a device pixel ratio of 2.
+constexpr SkISize kRasterFrameSize = SkISize::Make(720, 1280);
+constexpr SkScalar kListItemHeight = 96;
+// How far the content scrolls between frames.
+constexpr SkScalar kScrollStep = 7;
+
+// Records a list item: a card background, an avatar and a few lines of
+// placeholder text. Each item gets its own picture, as it would in an app.
+sk_sp<SkPicture> MakeListItemPicture(size_t index) {
+  const SkRect bounds =
+      SkRect::MakeWH(kRasterFrameSize.width(), kListItemHeight);
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(bounds);
+  SkPaint paint;
+  paint.setAntiAlias(true);
+  paint.setColor(index % 2 ? SK_ColorWHITE : 0xFFF5F5F5);
+  canvas->drawRRect(SkRRect::MakeRectXY(bounds.makeInset(8, 4), 8, 8), paint);
+  paint.setColor(0xFF2196F3 + static_cast<SkColor>(index * 0x1020));
+  canvas->drawCircle(56, kListItemHeight / 2, 28, paint);
+  paint.setColor(0xFF424242);
+  for (int line = 0; line < 3; line++) {
+    const SkScalar width = 240 + (index * 37 + line * 91) % 320;
+    canvas->drawRRect(
+        SkRRect::MakeRectXY(SkRect::MakeXYWH(104, 20 + line * 22, width, 12),
+                            6, 6),
+        paint);
+  }
+  return recorder.finishRecordingAsPicture();
+}
+
+// Builds the content of a frame, which is retained from frame to frame the
+// way the framework retains the layers of repaint boundaries.
+using RasterContentBuilder = std::function<std::shared_ptr<ContainerLayer>(
+    fml::RefPtr<SkiaUnrefQueue> unref_queue,
+    size_t count)>;
+
+std::shared_ptr<PictureLayer> MakeListItemLayer(
+    const fml::RefPtr<SkiaUnrefQueue>& unref_queue,
+    size_t index,
+    const SkPoint& offset) {
+  return std::make_shared<PictureLayer>(
+      offset, SkiaGPUObject(MakeListItemPicture(index), unref_queue), false,
+      false);
+}
+
+// A list of |count| items, one picture each.
+std::shared_ptr<ContainerLayer> BuildPictureList(
+    fml::RefPtr<SkiaUnrefQueue> unref_queue,
+    size_t count) {
+  auto content = std::make_shared<ContainerLayer>();
+  for (size_t i = 0; i < count; i++) {
+    content->Add(MakeListItemLayer(unref_queue, i,
+                                   SkPoint::Make(0, i * kListItemHeight)));
+  }
+  return content;
+}
+
+// A list of |count| items, each clipped to a rounded rectangle and faded, with
+// a second rounded clip and fade inside the first.
+std::shared_ptr<ContainerLayer> BuildNestedClipsAndOpacity(
+    fml::RefPtr<SkiaUnrefQueue> unref_queue,
+    size_t count) {
+  auto content = std::make_shared<ContainerLayer>();
+  for (size_t i = 0; i < count; i++) {
+    const SkRect bounds = SkRect::MakeXYWH(0, i * kListItemHeight,
+                                           kRasterFrameSize.width(),
+                                           kListItemHeight);
+    auto outer_clip = std::make_shared<ClipRRectLayer>(
+        SkRRect::MakeRectXY(bounds, 16, 16), Clip::antiAlias);
+    auto outer_opacity =
+        std::make_shared<OpacityLayer>(224, SkPoint::Make(0, 0));
+    auto inner_clip = std::make_shared<ClipRRectLayer>(
+        SkRRect::MakeRectXY(bounds.makeInset(4, 4), 12, 12), Clip::antiAlias);
+    auto inner_opacity =
+        std::make_shared<OpacityLayer>(192, SkPoint::Make(0, 0));
+    inner_opacity->Add(
+        MakeListItemLayer(unref_queue, i, SkPoint::Make(0, bounds.top())));
+    inner_clip->Add(inner_opacity);
+    outer_opacity->Add(inner_clip);
+    outer_clip->Add(outer_opacity);
+    content->Add(outer_clip);
+  }
+  return content;
+}
+
+// A list of |count| elevated cards, each casting a shadow.
+std::shared_ptr<ContainerLayer> BuildPhysicalShapeShadows(
+    fml::RefPtr<SkiaUnrefQueue> unref_queue,
+    size_t count) {
+  auto content = std::make_shared<ContainerLayer>();
+  for (size_t i = 0; i < count; i++) {
+    const SkRect bounds = SkRect::MakeXYWH(0, i * kListItemHeight,
+                                           kRasterFrameSize.width(),
+                                           kListItemHeight)
+                              .makeInset(8, 8);
+    auto card = std::make_shared<PhysicalShapeLayer>(
+        SK_ColorWHITE, SK_ColorBLACK, 2 + i % 4 * 2,
+        SkPath().addRRect(SkRRect::MakeRectXY(bounds, 8, 8)), Clip::antiAlias);
+    card->Add(
+        MakeListItemLayer(unref_queue, i, SkPoint::Make(0, bounds.top() - 8)));
+    content->Add(card);
+  }
+  return content;
+}
+
+// A blurred app bar for content to scroll under.
+std::shared_ptr<Layer> BuildAppBar() {
+  auto app_bar = std::make_shared<BackdropFilterLayer>(
+      SkImageFilters::Blur(12.0f, 12.0f, nullptr));
+  auto clip = std::make_shared<ClipRectLayer>(
+      SkRect::MakeWH(kRasterFrameSize.width(), 168), Clip::hardEdge);
+  clip->Add(app_bar);
+  app_bar->Add(std::make_shared<TextureLayer>(
+      SkPoint::Make(0, 0), SkSize::Make(kRasterFrameSize.width(), 168), 0,
+      false));
+  return clip;
+}
+
+// Rasters a frame per iteration on the software backend, scrolling content
+// made by |build_content| with |state.range(0)| items under a new transform
+// each frame, as the framework does. Only rastering the frame is timed.
+//
+// Reports the worst frame time and the state of the raster cache after the
+// last frame, along with how many entries it rasterized per frame.
+void RasterFrames(benchmark::State& state,
+                  const RasterContentBuilder& build_content,
+                  bool with_app_bar = false) {
+  fml::MessageLoop::EnsureInitializedForCurrentThread();
+  auto unref_queue = fml::MakeRefCounted<SkiaUnrefQueue>(
+      fml::MessageLoop::GetCurrent().GetTaskRunner(), fml::TimeDelta::Zero());
+  auto surface = SkSurface::MakeRasterN32Premul(kRasterFrameSize.width(),
+                                                kRasterFrameSize.height());
+  auto content = build_content(unref_queue, state.range(0));
+  auto app_bar = with_app_bar ? BuildAppBar() : nullptr;
+  const SkScalar scroll_extent =
+      std::max<SkScalar>(state.range(0) * kListItemHeight, kListItemHeight);
+
+  CompositorContext compositor_context;
+  size_t frame = 0;
+  size_t populated_count = 0;
+  fml::TimeDelta population_time;
+  fml::TimeDelta worst_frame_time;
+  while (state.KeepRunning()) {
+    LayerTree layer_tree(kRasterFrameSize, 100.0f, 2.0f);
+    {
+      benchmarking::ScopedPauseTiming pause(state);
+      auto root = std::make_shared<ContainerLayer>();
+      auto scroll = std::make_shared<TransformLayer>(SkMatrix::MakeTrans(
+          0, -std::fmod(frame++ * kScrollStep, scroll_extent)));
+      scroll->Add(content);
+      root->Add(std::move(scroll));
+      if (app_bar) {
+        root->Add(app_bar);
+      }
+      layer_tree.set_root_layer(std::move(root));
+    }
+
+    const fml::TimePoint start = fml::TimePoint::Now();
+    {
+      auto scoped_frame = compositor_context.AcquireFrame(
+          nullptr, surface->getCanvas(), nullptr, SkMatrix::I(), false, true,
+          nullptr);
+      scoped_frame->Raster(layer_tree, false);
+    }
+    worst_frame_time =
+        std::max(worst_frame_time, fml::TimePoint::Now() - start);
+
+    const RasterCacheFrameStats& stats =
+        compositor_context.raster_cache().GetLastFrameStats();
+    populated_count += stats.populated_count;
+    population_time = population_time + stats.population_time;
+  }
+
+  const RasterCacheFrameStats& stats =
+      compositor_context.raster_cache().GetLastFrameStats();
+  const double frames = state.iterations();
+  state.counters["WorstFrameMs"] = worst_frame_time.ToMillisecondsF();
+  state.counters["CachePopulations"] = populated_count / frames;
+  state.counters["CachePopulationMs"] =
+      population_time.ToMillisecondsF() / frames;
+  state.counters["CachedPictures"] = stats.picture_count;
+  state.counters["CachedLayers"] = stats.layer_count;
+  state.counters["CachedShadows"] = stats.shadow_count;
+  state.counters["CacheMBytes"] =
+      (stats.picture_bytes + stats.layer_bytes + stats.shadow_bytes) * 1e-6;
+
+  content.reset();
+  unref_queue->Drain();
+}
+
+}  // namespace
+
+static void BM_LayerTreeBuildHeap(benchmark::State& state) {
+  BuildLayerTree(state, false);
+}
+
+static void BM_LayerTreeBuildArena(benchmark::State& state) {
+  BuildLayerTree(state, true);
+}
+
+static void BM_MutatorsStackPushHeap(benchmark::State& state) {
+  PushMutators(state, false);
+}
+
+static void BM_MutatorsStackPushArena(benchmark::State& state) {
+  PushMutators(state, true);
+}
+
+static void BM_BackdropFilterLayerPaint(benchmark::State& state) {
+  PaintBackdropFilter(state, false);
+}
+
+static void BM_BackdropFilterLayerPaintRetained(benchmark::State& state) {
+  PaintBackdropFilter(state, true);
+}
+
+static void BM_RasterPictureList(benchmark::State& state) {
+  RasterFrames(state, BuildPictureList);
+}
+
+static void BM_RasterNestedClipsAndOpacity(benchmark::State& state) {
+  RasterFrames(state, BuildNestedClipsAndOpacity);
+}
+
+static void BM_RasterPhysicalShapeShadows(benchmark::State& state) {
+  RasterFrames(state, BuildPhysicalShapeShadows);
+}
+
+static void BM_RasterBackdropFilterOverList(benchmark::State& state) {
+  RasterFrames(state, BuildPictureList, true);
+}
+
+BENCHMARK(BM_LayerTreeBuildHeap)->Range(8, 1 << 12);
+BENCHMARK(BM_LayerTreeBuildArena)->Range(8, 1 << 12);
+BENCHMARK(BM_MutatorsStackPushHeap)->Range(8, 1 << 12);
+BENCHMARK(BM_MutatorsStackPushArena)->Range(8, 1 << 12);
+BENCHMARK(BM_BackdropFilterLayerPaint)->Range(64, 1 << 10);
+BENCHMARK(BM_BackdropFilterLayerPaintRetained)->Range(64, 1 << 10);
+BENCHMARK(BM_RasterPictureList)->Range(8, 256)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RasterNestedClipsAndOpacity)
+    ->Range(8, 256)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RasterPhysicalShapeShadows)
+    ->Range(8, 256)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RasterBackdropFilterOverList)
+    ->Range(8, 256)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace flutter
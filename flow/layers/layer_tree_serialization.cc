@@ -0,0 +1,552 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_tree_serialization.h"
+
+#include <vector>
+
+#include "flutter/flow/layers/backdrop_filter_layer.h"
+#include "flutter/flow/layers/clip_path_layer.h"
+#include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/clip_rrect_layer.h"
+#include "flutter/flow/layers/color_filter_layer.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/image_filter_layer.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/performance_overlay_layer.h"
+#include "flutter/flow/layers/physical_shape_layer.h"
+#include "flutter/flow/layers/picture_layer.h"
+#include "flutter/flow/layers/shader_mask_layer.h"
+#include "flutter/flow/layers/texture_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkColorFilter.h"
+#include "third_party/skia/include/core/SkImageFilter.h"
+#include "third_party/skia/include/core/SkShader.h"
+
+namespace flutter {
+
+namespace {
+
+// "FLTR" followed by the version of the format.
+constexpr uint32_t kMagic = 0x464C5452;
+constexpr uint32_t kVersion = 1;
+
+// Deeper trees are assumed to be malformed rather than recursed into.
+constexpr int kMaxDepth = 1024;
+
+// Layers read back from placeholders have a texture ID no texture has.
+constexpr int64_t kPlaceholderTextureId = -1;
+
+class LayerTreeReader {
+ public:
+  LayerTreeReader(const SkData& data, fml::RefPtr<SkiaUnrefQueue> unref_queue)
+      : stream_(data.data(), data.size()),
+        unref_queue_(std::move(unref_queue)) {}
+
+  std::unique_ptr<LayerTree> ReadLayerTree(
+      const DeserializedLayerCallback& on_layer) {
+    uint32_t magic, version, width, height, tracing_threshold;
+    SkScalar physical_depth, device_pixel_ratio;
+    bool checkerboard_raster_cache_images, checkerboard_offscreen_layers;
+    bool has_root_layer;
+    if (!Read(&magic) || magic != kMagic || !Read(&version) ||
+        version != kVersion) {
+      FML_LOG(ERROR) << "Not a serialized layer tree of a supported version.";
+      return nullptr;
+    }
+    if (!Read(&width) || !Read(&height) || !Read(&physical_depth) ||
+        !Read(&device_pixel_ratio) || !Read(&tracing_threshold) ||
+        !Read(&checkerboard_raster_cache_images) ||
+        !Read(&checkerboard_offscreen_layers) || !Read(&has_root_layer)) {
+      FML_LOG(ERROR) << "Serialized layer tree is truncated.";
+      return nullptr;
+    }
+
+    auto layer_tree = std::make_unique<LayerTree>(
+        SkISize::Make(width, height), physical_depth, device_pixel_ratio);
+    layer_tree->set_rasterizer_tracing_threshold(tracing_threshold);
+    layer_tree->set_checkerboard_raster_cache_images(
+        checkerboard_raster_cache_images);
+    layer_tree->set_checkerboard_offscreen_layers(
+        checkerboard_offscreen_layers);
+    if (has_root_layer) {
+      auto root_layer = ReadLayer(on_layer, 0);
+      if (!root_layer) {
+        FML_LOG(ERROR) << "Serialized layer tree is malformed.";
+        return nullptr;
+      }
+      layer_tree->set_root_layer(std::move(root_layer));
+    }
+    return layer_tree;
+  }
+
+ private:
+  SkMemoryStream stream_;
+  fml::RefPtr<SkiaUnrefQueue> unref_queue_;
+  std::vector<sk_sp<SkPicture>> pictures_;
+
+  template <typename T>
+  bool Read(T* value) {
+    return stream_.read(value, sizeof(T)) == sizeof(T);
+  }
+
+  bool Read(bool* value) {
+    uint8_t byte;
+    if (!Read(&byte) || byte > 1) {
+      return false;
+    }
+    *value = byte == 1;
+    return true;
+  }
+
+  bool Read(std::string* value) {
+    sk_sp<SkData> data;
+    if (!Read(&data)) {
+      return false;
+    }
+    value->assign(static_cast<const char*>(data->data()), data->size());
+    return true;
+  }
+
+  bool Read(SkPoint* point) { return Read(&point->fX) && Read(&point->fY); }
+
+  bool Read(SkSize* size) {
+    return Read(&size->fWidth) && Read(&size->fHeight);
+  }
+
+  bool Read(SkRect* rect) {
+    return Read(&rect->fLeft) && Read(&rect->fTop) && Read(&rect->fRight) &&
+           Read(&rect->fBottom);
+  }
+
+  bool Read(SkRRect* rrect) {
+    char buffer[SkRRect::kSizeInMemory];
+    return stream_.read(buffer, sizeof(buffer)) == sizeof(buffer) &&
+           rrect->readFromMemory(buffer, sizeof(buffer)) == sizeof(buffer);
+  }
+
+  bool Read(SkMatrix* matrix) {
+    SkScalar values[9];
+    if (stream_.read(values, sizeof(values)) != sizeof(values)) {
+      return false;
+    }
+    matrix->set9(values);
+    return true;
+  }
+
+  bool Read(SkPath* path) {
+    sk_sp<SkData> data;
+    return Read(&data) &&
+           path->readFromMemory(data->data(), data->size()) == data->size();
+  }
+
+  bool Read(Clip* clip) {
+    uint32_t value;
+    if (!Read(&value) || value > Clip::antiAliasWithSaveLayer) {
+      return false;
+    }
+    *clip = static_cast<Clip>(value);
+    return true;
+  }
+
+  bool Read(sk_sp<SkData>* data) {
+    uint32_t size;
+    if (!Read(&size) || size > stream_.getLength() - stream_.getPosition()) {
+      return false;
+    }
+    *data = SkData::MakeUninitialized(size);
+    return stream_.read((*data)->writable_data(), size) == size;
+  }
+
+  // Reads a flattenable of |type|, which may be null.
+  template <typename T>
+  bool Read(sk_sp<T>* flattenable, SkFlattenable::Type type) {
+    bool present;
+    if (!Read(&present)) {
+      return false;
+    }
+    if (!present) {
+      flattenable->reset();
+      return true;
+    }
+    sk_sp<SkData> data;
+    if (!Read(&data)) {
+      return false;
+    }
+    flattenable->reset(static_cast<T*>(
+        SkFlattenable::Deserialize(type, data->data(), data->size())
+            .release()));
+    return *flattenable != nullptr;
+  }
+
+  bool Read(sk_sp<SkPicture>* picture) {
+    uint32_t index;
+    if (!Read(&index) || index > pictures_.size()) {
+      return false;
+    }
+    if (index < pictures_.size()) {
+      *picture = pictures_[index];
+      return true;
+    }
+    sk_sp<SkData> data;
+    if (!Read(&data)) {
+      return false;
+    }
+    *picture = SkPicture::MakeFromData(data->data(), data->size());
+    if (!*picture) {
+      return false;
+    }
+    pictures_.push_back(*picture);
+    return true;
+  }
+
+  std::shared_ptr<Layer> ReadLayer(const DeserializedLayerCallback& on_layer,
+                                   int depth) {
+    uint32_t type_value;
+    uint64_t unique_id;
+    if (depth > kMaxDepth || !Read(&type_value) || !Read(&unique_id)) {
+      return nullptr;
+    }
+    const auto type = static_cast<SerializedLayerType>(type_value);
+
+    std::shared_ptr<Layer> layer;
+    std::shared_ptr<ContainerLayer> container;
+    switch (type) {
+      case SerializedLayerType::kPlaceholder: {
+        SkRect bounds;
+        if (!Read(&bounds)) {
+          return nullptr;
+        }
+        layer = std::make_shared<TextureLayer>(
+            SkPoint::Make(bounds.left(), bounds.top()),
+            SkSize::Make(bounds.width(), bounds.height()),
+            kPlaceholderTextureId, false);
+        break;
+      }
+      case SerializedLayerType::kContainer:
+        container = std::make_shared<ContainerLayer>();
+        break;
+      case SerializedLayerType::kBackdropFilter: {
+        sk_sp<SkImageFilter> filter;
+        if (!Read(&filter, SkFlattenable::kSkImageFilter_Type)) {
+          return nullptr;
+        }
+        container = std::make_shared<BackdropFilterLayer>(std::move(filter));
+        break;
+      }
+      case SerializedLayerType::kClipPath: {
+        SkPath path;
+        Clip clip;
+        if (!Read(&path) || !Read(&clip)) {
+          return nullptr;
+        }
+        container = std::make_shared<ClipPathLayer>(path, clip);
+        break;
+      }
+      case SerializedLayerType::kClipRect: {
+        SkRect rect;
+        Clip clip;
+        if (!Read(&rect) || !Read(&clip)) {
+          return nullptr;
+        }
+        container = std::make_shared<ClipRectLayer>(rect, clip);
+        break;
+      }
+      case SerializedLayerType::kClipRRect: {
+        SkRRect rrect;
+        Clip clip;
+        if (!Read(&rrect) || !Read(&clip)) {
+          return nullptr;
+        }
+        container = std::make_shared<ClipRRectLayer>(rrect, clip);
+        break;
+      }
+      case SerializedLayerType::kColorFilter: {
+        sk_sp<SkColorFilter> filter;
+        if (!Read(&filter, SkFlattenable::kSkColorFilter_Type)) {
+          return nullptr;
+        }
+        container = std::make_shared<ColorFilterLayer>(std::move(filter));
+        break;
+      }
+      case SerializedLayerType::kImageFilter: {
+        sk_sp<SkImageFilter> filter;
+        if (!Read(&filter, SkFlattenable::kSkImageFilter_Type)) {
+          return nullptr;
+        }
+        container = std::make_shared<ImageFilterLayer>(std::move(filter));
+        break;
+      }
+      case SerializedLayerType::kOpacity: {
+        uint32_t alpha;
+        SkPoint offset;
+        if (!Read(&alpha) || alpha > SK_AlphaOPAQUE || !Read(&offset)) {
+          return nullptr;
+        }
+        container = std::make_shared<OpacityLayer>(alpha, offset);
+        break;
+      }
+      case SerializedLayerType::kPerformanceOverlay: {
+        int64_t options;
+        std::string font_path;
+        if (!Read(&options) || !Read(&font_path)) {
+          return nullptr;
+        }
+        layer = std::make_shared<PerformanceOverlayLayer>(
+            options, font_path.empty() ? nullptr : font_path.c_str());
+        break;
+      }
+      case SerializedLayerType::kPhysicalShape: {
+        SkColor color, shadow_color;
+        SkScalar elevation;
+        SkPath path;
+        Clip clip;
+        if (!Read(&color) || !Read(&shadow_color) || !Read(&elevation) ||
+            !Read(&path) || !Read(&clip)) {
+          return nullptr;
+        }
+        container = std::make_shared<PhysicalShapeLayer>(
+            color, shadow_color, elevation, path, clip);
+        break;
+      }
+      case SerializedLayerType::kPicture: {
+        SkPoint offset;
+        sk_sp<SkPicture> picture;
+        bool is_complex, will_change;
+        if (!Read(&offset) || !Read(&picture) || !Read(&is_complex) ||
+            !Read(&will_change)) {
+          return nullptr;
+        }
+        layer = std::make_shared<PictureLayer>(
+            offset, SkiaGPUObject<SkPicture>(std::move(picture), unref_queue_),
+            is_complex, will_change);
+        break;
+      }
+      case SerializedLayerType::kShaderMask: {
+        sk_sp<SkShader> shader;
+        SkRect mask_rect;
+        uint32_t blend_mode;
+        if (!Read(&shader, SkFlattenable::kSkShaderBase_Type) ||
+            !Read(&mask_rect) || !Read(&blend_mode) ||
+            blend_mode > static_cast<uint32_t>(SkBlendMode::kLastMode)) {
+          return nullptr;
+        }
+        container = std::make_shared<ShaderMaskLayer>(
+            std::move(shader), mask_rect, static_cast<SkBlendMode>(blend_mode));
+        break;
+      }
+      case SerializedLayerType::kTexture: {
+        SkPoint offset;
+        SkSize size;
+        int64_t texture_id;
+        bool freeze;
+        if (!Read(&offset) || !Read(&size) || !Read(&texture_id) ||
+            !Read(&freeze)) {
+          return nullptr;
+        }
+        layer =
+            std::make_shared<TextureLayer>(offset, size, texture_id, freeze);
+        break;
+      }
+      case SerializedLayerType::kTransform: {
+        SkMatrix transform;
+        if (!Read(&transform)) {
+          return nullptr;
+        }
+        container = std::make_shared<TransformLayer>(transform);
+        break;
+      }
+      default:
+        return nullptr;
+    }
+
+    if (container) {
+      uint32_t child_count;
+      if (!Read(&child_count)) {
+        return nullptr;
+      }
+      for (uint32_t i = 0; i < child_count; i++) {
+        auto child = ReadLayer(on_layer, depth + 1);
+        if (!child) {
+          return nullptr;
+        }
+        container->Add(std::move(child));
+      }
+      layer = std::move(container);
+    }
+
+    return on_layer ? on_layer(std::move(layer), type, unique_id) : layer;
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(LayerTreeReader);
+};
+
+}  // namespace
+
+const char* SerializedLayerTypeName(SerializedLayerType type) {
+  switch (type) {
+    case SerializedLayerType::kPlaceholder:
+      return "Placeholder";
+    case SerializedLayerType::kContainer:
+      return "ContainerLayer";
+    case SerializedLayerType::kBackdropFilter:
+      return "BackdropFilterLayer";
+    case SerializedLayerType::kClipPath:
+      return "ClipPathLayer";
+    case SerializedLayerType::kClipRect:
+      return "ClipRectLayer";
+    case SerializedLayerType::kClipRRect:
+      return "ClipRRectLayer";
+    case SerializedLayerType::kColorFilter:
+      return "ColorFilterLayer";
+    case SerializedLayerType::kImageFilter:
+      return "ImageFilterLayer";
+    case SerializedLayerType::kOpacity:
+      return "OpacityLayer";
+    case SerializedLayerType::kPerformanceOverlay:
+      return "PerformanceOverlayLayer";
+    case SerializedLayerType::kPhysicalShape:
+      return "PhysicalShapeLayer";
+    case SerializedLayerType::kPicture:
+      return "PictureLayer";
+    case SerializedLayerType::kShaderMask:
+      return "ShaderMaskLayer";
+    case SerializedLayerType::kTexture:
+      return "TextureLayer";
+    case SerializedLayerType::kTransform:
+      return "TransformLayer";
+  }
+  return "Unknown";
+}
+
+LayerTreeWriter::LayerTreeWriter() = default;
+
+LayerTreeWriter::~LayerTreeWriter() = default;
+
+void LayerTreeWriter::WriteLayerHeader(SerializedLayerType type,
+                                       const Layer& layer) {
+  WriteUInt32(static_cast<uint32_t>(type));
+  const uint64_t unique_id = layer.unique_id();
+  stream_.write(&unique_id, sizeof(unique_id));
+}
+
+void LayerTreeWriter::WriteChildren(const ContainerLayer& container) {
+  WriteUInt32(container.layers().size());
+  for (const auto& layer : container.layers()) {
+    layer->Serialize(*this);
+  }
+}
+
+void LayerTreeWriter::WriteBool(bool value) {
+  const uint8_t byte = value ? 1 : 0;
+  stream_.write(&byte, sizeof(byte));
+}
+
+void LayerTreeWriter::WriteUInt32(uint32_t value) {
+  stream_.write(&value, sizeof(value));
+}
+
+void LayerTreeWriter::WriteInt64(int64_t value) {
+  stream_.write(&value, sizeof(value));
+}
+
+void LayerTreeWriter::WriteScalar(SkScalar value) {
+  stream_.write(&value, sizeof(value));
+}
+
+void LayerTreeWriter::WriteString(const std::string& value) {
+  WriteData(SkData::MakeWithoutCopy(value.data(), value.size()).get());
+}
+
+void LayerTreeWriter::WritePoint(const SkPoint& point) {
+  WriteScalar(point.x());
+  WriteScalar(point.y());
+}
+
+void LayerTreeWriter::WriteSize(const SkSize& size) {
+  WriteScalar(size.width());
+  WriteScalar(size.height());
+}
+
+void LayerTreeWriter::WriteRect(const SkRect& rect) {
+  WriteScalar(rect.left());
+  WriteScalar(rect.top());
+  WriteScalar(rect.right());
+  WriteScalar(rect.bottom());
+}
+
+void LayerTreeWriter::WriteRRect(const SkRRect& rrect) {
+  char buffer[SkRRect::kSizeInMemory];
+  rrect.writeToMemory(buffer);
+  stream_.write(buffer, sizeof(buffer));
+}
+
+void LayerTreeWriter::WriteMatrix(const SkMatrix& matrix) {
+  SkScalar values[9];
+  matrix.get9(values);
+  stream_.write(values, sizeof(values));
+}
+
+void LayerTreeWriter::WritePath(const SkPath& path) {
+  auto data = SkData::MakeUninitialized(path.writeToMemory(nullptr));
+  path.writeToMemory(data->writable_data());
+  WriteData(data.get());
+}
+
+void LayerTreeWriter::WriteFlattenable(const SkFlattenable* flattenable) {
+  WriteBool(flattenable != nullptr);
+  if (flattenable) {
+    WriteData(flattenable->serialize().get());
+  }
+}
+
+void LayerTreeWriter::WritePicture(const SkPicture& picture) {
+  auto found = picture_indices_.find(picture.uniqueID());
+  if (found != picture_indices_.end()) {
+    WriteUInt32(found->second);
+    return;
+  }
+  const uint32_t index = picture_indices_.size();
+  picture_indices_[picture.uniqueID()] = index;
+  WriteUInt32(index);
+  WriteData(picture.serialize().get());
+}
+
+void LayerTreeWriter::WriteData(const SkData* data) {
+  WriteUInt32(data->size());
+  stream_.write(data->data(), data->size());
+}
+
+sk_sp<SkData> SerializeLayerTree(const LayerTree& layer_tree) {
+  TRACE_EVENT0("flutter", "SerializeLayerTree");
+  LayerTreeWriter writer;
+  writer.WriteUInt32(kMagic);
+  writer.WriteUInt32(kVersion);
+  writer.WriteUInt32(layer_tree.frame_size().width());
+  writer.WriteUInt32(layer_tree.frame_size().height());
+  writer.WriteScalar(layer_tree.frame_physical_depth());
+  writer.WriteScalar(layer_tree.frame_device_pixel_ratio());
+  writer.WriteUInt32(layer_tree.rasterizer_tracing_threshold());
+  writer.WriteBool(layer_tree.checkerboard_raster_cache_images());
+  writer.WriteBool(layer_tree.checkerboard_offscreen_layers());
+  writer.WriteBool(layer_tree.root_layer() != nullptr);
+  if (layer_tree.root_layer()) {
+    layer_tree.root_layer()->Serialize(writer);
+  }
+  return writer.stream_.detachAsData();
+}
+
+std::unique_ptr<LayerTree> DeserializeLayerTree(
+    const SkData& data,
+    fml::RefPtr<SkiaUnrefQueue> unref_queue,
+    const DeserializedLayerCallback& on_layer) {
+  TRACE_EVENT0("flutter", "DeserializeLayerTree");
+  LayerTreeReader reader(data, std::move(unref_queue));
+  return reader.ReadLayerTree(on_layer);
+}
+
+}  // namespace flutter
@@ -0,0 +1,121 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_LAYERS_LAYER_TREE_SERIALIZATION_H_
+#define FLUTTER_FLOW_LAYERS_LAYER_TREE_SERIALIZATION_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "flutter/flow/skia_gpu_object.h"
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkFlattenable.h"
+#include "third_party/skia/include/core/SkMatrix.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkRRect.h"
+#include "third_party/skia/include/core/SkRect.h"
+#include "third_party/skia/include/core/SkSize.h"
+#include "third_party/skia/include/core/SkStream.h"
+
+namespace flutter {
+
+class ContainerLayer;
+class Layer;
+class LayerTree;
+
+// The kinds of layer records in a serialized layer tree. Values are part of
+// the format and must not change.
+enum class SerializedLayerType : uint32_t {
+  // A layer that can't be serialized, such as a platform view, kept as an
+  // empty layer with the same bounds. It is read back as a texture layer that
+  // has no texture.
+  kPlaceholder = 0,
+  kContainer = 1,
+  kBackdropFilter = 2,
+  kClipPath = 3,
+  kClipRect = 4,
+  kClipRRect = 5,
+  kColorFilter = 6,
+  kImageFilter = 7,
+  kOpacity = 8,
+  kPerformanceOverlay = 9,
+  kPhysicalShape = 10,
+  kPicture = 11,
+  kShaderMask = 12,
+  kTexture = 13,
+  kTransform = 14,
+};
+
+const char* SerializedLayerTypeName(SerializedLayerType type);
+
+// Writes the records of the layers of a tree. Layers write their own records
+// from |Layer::Serialize|, starting with |WriteLayerHeader| and followed by
+// the arguments they were constructed with and then, for containers, their
+// children.
+class LayerTreeWriter {
+ public:
+  LayerTreeWriter();
+
+  ~LayerTreeWriter();
+
+  void WriteLayerHeader(SerializedLayerType type, const Layer& layer);
+
+  // Writes the number of children of |container| and then each child.
+  void WriteChildren(const ContainerLayer& container);
+
+  void WriteBool(bool value);
+  void WriteUInt32(uint32_t value);
+  void WriteInt64(int64_t value);
+  void WriteScalar(SkScalar value);
+  void WriteString(const std::string& value);
+  void WritePoint(const SkPoint& point);
+  void WriteSize(const SkSize& size);
+  void WriteRect(const SkRect& rect);
+  void WriteRRect(const SkRRect& rrect);
+  void WriteMatrix(const SkMatrix& matrix);
+  void WritePath(const SkPath& path);
+  // Writes a color filter, image filter or shader, which may be null.
+  void WriteFlattenable(const SkFlattenable* flattenable);
+  // Writes a picture, or a reference to it if it was written before.
+  void WritePicture(const SkPicture& picture);
+
+ private:
+  friend sk_sp<SkData> SerializeLayerTree(const LayerTree& layer_tree);
+
+  SkDynamicMemoryWStream stream_;
+  // The index of each picture written so far, by unique ID.
+  std::unordered_map<uint32_t, uint32_t> picture_indices_;
+
+  void WriteData(const SkData* data);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(LayerTreeWriter);
+};
+
+// Serializes the whole of |layer_tree|: its layers, with the pictures and
+// parameters they draw with, and the frame metrics needed to raster it again.
+// Texture contents and platform views are not captured.
+sk_sp<SkData> SerializeLayerTree(const LayerTree& layer_tree);
+
+// Called with each layer as it is read, along with the unique ID it had when
+// it was serialized, and returns the layer to put in the tree in its place,
+// e.g. a container layer wrapping it.
+using DeserializedLayerCallback =
+    std::function<std::shared_ptr<Layer>(std::shared_ptr<Layer> layer,
+                                         SerializedLayerType type,
+                                         uint64_t serialized_unique_id)>;
+
+// Reads back a layer tree written by |SerializeLayerTree|, with its pictures
+// released on |unref_queue|. Returns null if |data| is malformed.
+std::unique_ptr<LayerTree> DeserializeLayerTree(
+    const SkData& data,
+    fml::RefPtr<SkiaUnrefQueue> unref_queue,
+    const DeserializedLayerCallback& on_layer = nullptr);
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_LAYERS_LAYER_TREE_SERIALIZATION_H_
@@ -0,0 +1,234 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include "flutter/flow/layers/layer_tree_serialization.h"
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "flutter/flow/compositor_context.h"
+#include "flutter/flow/layers/backdrop_filter_layer.h"
+#include "flutter/flow/layers/clip_rrect_layer.h"
+#include "flutter/flow/layers/color_filter_layer.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/physical_shape_layer.h"
+#include "flutter/flow/layers/picture_layer.h"
+#include "flutter/flow/layers/platform_view_layer.h"
+#include "flutter/flow/layers/shader_mask_layer.h"
+#include "flutter/flow/layers/texture_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/flow/testing/skia_gpu_object_layer_test.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/effects/SkGradientShader.h"
+#include "third_party/skia/include/effects/SkImageFilters.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+constexpr SkISize kFrameSize = SkISize::Make(64, 64);
+
+sk_sp<SkPicture> MakePicture() {
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(32, 32));
+  SkPaint paint;
+  paint.setColor(SK_ColorRED);
+  canvas->drawCircle(16, 16, 12, paint);
+  paint.setColor(SK_ColorBLUE);
+  canvas->drawRect(SkRect::MakeLTRB(4, 20, 28, 28), paint);
+  return recorder.finishRecordingAsPicture();
+}
+
+SkBitmap Rasterize(LayerTree& layer_tree) {
+  auto surface = SkSurface::MakeRasterN32Premul(kFrameSize.width(),
+                                                kFrameSize.height());
+  CompositorContext compositor_context;
+  auto frame = compositor_context.AcquireFrame(
+      nullptr, surface->getCanvas(), nullptr, SkMatrix::I(), false, true,
+      nullptr);
+  frame->Raster(layer_tree, true);
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(kFrameSize.width(), kFrameSize.height());
+  surface->readPixels(bitmap, 0, 0);
+  return bitmap;
+}
+
+bool BitmapsEqual(const SkBitmap& a, const SkBitmap& b) {
+  return a.computeByteSize() == b.computeByteSize() &&
+         std::memcmp(a.getPixels(), b.getPixels(), a.computeByteSize()) == 0;
+}
+
+}  // namespace
+
+class LayerTreeSerializationTest : public SkiaGPUObjectLayerTest {
+ public:
+  LayerTreeSerializationTest() : layer_tree_(kFrameSize, 100.0f, 2.0f) {}
+
+  LayerTree& layer_tree() { return layer_tree_; }
+
+  std::shared_ptr<PictureLayer> MakePictureLayer(sk_sp<SkPicture> picture,
+                                                 const SkPoint& offset) {
+    return std::make_shared<PictureLayer>(
+        offset, SkiaGPUObject(std::move(picture), unref_queue()), true, false);
+  }
+
+  // Builds a tree with most kinds of layers, drawing |picture| twice.
+  void BuildLayerTree(sk_sp<SkPicture> picture) {
+    auto root = std::make_shared<ContainerLayer>();
+    auto transform =
+        std::make_shared<TransformLayer>(SkMatrix::MakeScale(1.5f, 1.25f));
+    auto clip = std::make_shared<ClipRRectLayer>(
+        SkRRect::MakeRectXY(SkRect::MakeLTRB(2, 2, 40, 40), 6, 6),
+        Clip::antiAlias);
+    auto opacity = std::make_shared<OpacityLayer>(128, SkPoint::Make(3, 1));
+    opacity->Add(MakePictureLayer(picture, SkPoint::Make(1, 2)));
+    clip->Add(opacity);
+    transform->Add(clip);
+    root->Add(transform);
+
+    auto shape = std::make_shared<PhysicalShapeLayer>(
+        SK_ColorGREEN, SK_ColorBLACK, 4.0f,
+        SkPath().addOval(SkRect::MakeLTRB(30, 30, 60, 60)), Clip::hardEdge);
+    auto color_filter = std::make_shared<ColorFilterLayer>(
+        SkColorFilters::Blend(SK_ColorYELLOW, SkBlendMode::kModulate));
+    color_filter->Add(MakePictureLayer(picture, SkPoint::Make(30, 30)));
+    shape->Add(color_filter);
+    root->Add(shape);
+
+    const SkPoint gradient_points[] = {{0, 0}, {20, 0}};
+    const SkColor gradient_colors[] = {SK_ColorWHITE, SK_ColorTRANSPARENT};
+    auto shader_mask = std::make_shared<ShaderMaskLayer>(
+        SkGradientShader::MakeLinear(gradient_points, gradient_colors, nullptr,
+                                     2, SkTileMode::kClamp),
+        SkRect::MakeLTRB(0, 40, 20, 60), SkBlendMode::kDstIn);
+    auto backdrop_filter = std::make_shared<BackdropFilterLayer>(
+        SkImageFilters::Blur(2.0f, 2.0f, nullptr));
+    backdrop_filter->Add(MakePictureLayer(picture, SkPoint::Make(0, 40)));
+    shader_mask->Add(backdrop_filter);
+    root->Add(shader_mask);
+
+    root->Add(std::make_shared<TextureLayer>(
+        SkPoint::Make(50, 0), SkSize::Make(10, 10), 7, false));
+    layer_tree_.set_root_layer(root);
+  }
+
+ private:
+  LayerTree layer_tree_;
+};
+
+TEST_F(LayerTreeSerializationTest, ReplayedTreeLooksTheSame) {
+  BuildLayerTree(MakePicture());
+  layer_tree().set_rasterizer_tracing_threshold(3);
+  layer_tree().set_checkerboard_offscreen_layers(true);
+  const SkBitmap expected = Rasterize(layer_tree());
+
+  auto data = SerializeLayerTree(layer_tree());
+  ASSERT_TRUE(data);
+  auto replayed = DeserializeLayerTree(*data, unref_queue());
+  ASSERT_TRUE(replayed);
+  EXPECT_EQ(replayed->frame_size(), kFrameSize);
+  EXPECT_EQ(replayed->frame_physical_depth(), 100.0f);
+  EXPECT_EQ(replayed->frame_device_pixel_ratio(), 2.0f);
+  EXPECT_EQ(replayed->rasterizer_tracing_threshold(), 3u);
+  EXPECT_FALSE(replayed->checkerboard_raster_cache_images());
+  EXPECT_TRUE(replayed->checkerboard_offscreen_layers());
+  EXPECT_TRUE(BitmapsEqual(Rasterize(*replayed), expected));
+}
+
+TEST_F(LayerTreeSerializationTest, KeepsLayerTypesAndIds) {
+  auto picture_layer = MakePictureLayer(MakePicture(), SkPoint::Make(0, 0));
+  auto opacity = std::make_shared<OpacityLayer>(128, SkPoint::Make(0, 0));
+  opacity->Add(picture_layer);
+  auto root = std::make_shared<ContainerLayer>();
+  root->Add(opacity);
+  layer_tree().set_root_layer(root);
+
+  std::vector<std::pair<SerializedLayerType, uint64_t>> layers;
+  auto replayed = DeserializeLayerTree(
+      *SerializeLayerTree(layer_tree()), unref_queue(),
+      [&layers](std::shared_ptr<Layer> layer, SerializedLayerType type,
+                uint64_t unique_id) {
+        layers.emplace_back(type, unique_id);
+        return layer;
+      });
+  ASSERT_TRUE(replayed);
+
+  // Layers are read back after their children.
+  EXPECT_EQ(layers,
+            (std::vector<std::pair<SerializedLayerType, uint64_t>>{
+                {SerializedLayerType::kPicture, picture_layer->unique_id()},
+                {SerializedLayerType::kOpacity, opacity->unique_id()},
+                {SerializedLayerType::kContainer, root->unique_id()},
+            }));
+}
+
+TEST_F(LayerTreeSerializationTest, WritesSharedPicturesOnce) {
+  auto picture = MakePicture();
+  auto root = std::make_shared<ContainerLayer>();
+  root->Add(MakePictureLayer(picture, SkPoint::Make(0, 0)));
+  layer_tree().set_root_layer(root);
+  const size_t single_size = SerializeLayerTree(layer_tree())->size();
+  root->Add(MakePictureLayer(picture, SkPoint::Make(10, 10)));
+  const size_t shared_size = SerializeLayerTree(layer_tree())->size();
+  EXPECT_LT(shared_size - single_size, picture->serialize()->size());
+
+  auto replayed =
+      DeserializeLayerTree(*SerializeLayerTree(layer_tree()), unref_queue());
+  ASSERT_TRUE(replayed);
+  const auto& layers =
+      static_cast<ContainerLayer*>(replayed->root_layer())->layers();
+  ASSERT_EQ(layers.size(), 2u);
+  EXPECT_EQ(static_cast<PictureLayer*>(layers[0].get())->picture(),
+            static_cast<PictureLayer*>(layers[1].get())->picture());
+}
+
+TEST_F(LayerTreeSerializationTest, PlatformViewsBecomePlaceholders) {
+  auto platform_view = std::make_shared<PlatformViewLayer>(
+      SkPoint::Make(5, 6), SkSize::Make(20, 30), 0);
+  platform_view->Preroll(preroll_context(), SkMatrix());
+  layer_tree().set_root_layer(platform_view);
+
+  SerializedLayerType replayed_type = SerializedLayerType::kContainer;
+  auto replayed = DeserializeLayerTree(
+      *SerializeLayerTree(layer_tree()), unref_queue(),
+      [&replayed_type](std::shared_ptr<Layer> layer, SerializedLayerType type,
+                       uint64_t unique_id) {
+        replayed_type = type;
+        return layer;
+      });
+  ASSERT_TRUE(replayed);
+  EXPECT_EQ(replayed_type, SerializedLayerType::kPlaceholder);
+  ASSERT_NE(dynamic_cast<TextureLayer*>(replayed->root_layer()), nullptr);
+  replayed->root_layer()->Preroll(preroll_context(), SkMatrix());
+  EXPECT_EQ(replayed->root_layer()->paint_bounds(),
+            SkRect::MakeXYWH(5, 6, 20, 30));
+}
+
+TEST_F(LayerTreeSerializationTest, RejectsMalformedData) {
+  auto root = std::make_shared<TransformLayer>(SkMatrix::MakeTrans(1, 2));
+  root->Add(std::make_shared<ClipRRectLayer>(
+      SkRRect::MakeRectXY(SkRect::MakeWH(10, 10), 2, 2), Clip::antiAlias));
+  layer_tree().set_root_layer(root);
+  auto data = SerializeLayerTree(layer_tree());
+  ASSERT_TRUE(DeserializeLayerTree(*data, unref_queue()));
+
+  for (size_t size = 0; size < data->size(); size++) {
+    EXPECT_FALSE(DeserializeLayerTree(*SkData::MakeSubset(data.get(), 0, size),
+                                      unref_queue()))
+        << "Truncated to " << size << " bytes";
+  }
+
+  auto corrupt = SkData::MakeWithCopy(data->data(), data->size());
+  static_cast<uint8_t*>(corrupt->writable_data())[0] ^= 0xFF;
+  EXPECT_FALSE(DeserializeLayerTree(*corrupt, unref_queue()));
+}
+
+}  // namespace testing
+}  // namespace flutter
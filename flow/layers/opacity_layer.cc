@@ -4,6 +4,7 @@
 
 #include "flutter/flow/layers/opacity_layer.h"
 
+#include "flutter/flow/layers/layer_tree_serialization.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkPaint.h"
 
@@ -58,6 +59,9 @@ void OpacityLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
     TryToPrepareRasterCache(context, container, child_matrix);
   }
 
+  // Any opacity inherited from a parent is combined with this layer's own.
+  set_layer_can_inherit_opacity(true);
+
   // Restore cull_rect
   context->cull_rect = context->cull_rect.makeOffset(offset_.fX, offset_.fY);
 }
@@ -68,6 +72,9 @@ void OpacityLayer::Paint(PaintContext& context) const {
 
   SkPaint paint;
   paint.setAlpha(alpha_);
+  if (context.inherited_opacity < SK_Scalar1) {
+    paint.setAlphaf(paint.getAlphaf() * context.inherited_opacity);
+  }
 
   SkAutoCanvasRestore save(context.internal_nodes_canvas, true);
   context.internal_nodes_canvas->translate(offset_.fX, offset_.fY);
@@ -83,6 +90,17 @@ void OpacityLayer::Paint(PaintContext& context) const {
     return;
   }
 
+  // Children that don't overlap and can each apply the opacity themselves
+  // look the same without the costly saveLayer.
+  const float inherited_opacity = context.inherited_opacity;
+  if (GetChildContainer()->layer_can_inherit_opacity()) {
+    TRACE_EVENT_INSTANT0("flutter", "opacity folded into children");
+    context.inherited_opacity = paint.getAlphaf();
+    PaintChildren(context);
+    context.inherited_opacity = inherited_opacity;
+    return;
+  }
+
   // Skia may clip the content with saveLayerBounds (although it's not a
   // guaranteed clip). So we have to provide a big enough saveLayerBounds. To do
   // so, we first remove the offset from paint bounds since it's already in the
@@ -98,7 +116,9 @@ void OpacityLayer::Paint(PaintContext& context) const {
 
   Layer::AutoSaveLayer save_layer =
       Layer::AutoSaveLayer::Create(context, saveLayerBounds, &paint);
+  context.inherited_opacity = SK_Scalar1;
   PaintChildren(context);
+  context.inherited_opacity = inherited_opacity;
 }
 
 #if defined(OS_FUCHSIA)
@@ -118,4 +138,12 @@ ContainerLayer* OpacityLayer::GetChildContainer() const {
   return static_cast<ContainerLayer*>(layers()[0].get());
 }
 
+void OpacityLayer::Serialize(LayerTreeWriter& writer) const {
+  writer.WriteLayerHeader(SerializedLayerType::kOpacity, *this);
+  writer.WriteUInt32(alpha_);
+  writer.WritePoint(offset_);
+  // The children are read back into a new child container by |Add|.
+  writer.WriteChildren(*GetChildContainer());
+}
+
 }  // namespace flutter
@@ -4,17 +4,74 @@
 
 #include "flutter/flow/layers/opacity_layer.h"
 
+#include <cstdlib>
+#include <functional>
+
+#include "flutter/flow/flow_test_utils.h"
 #include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/picture_layer.h"
 #include "flutter/flow/testing/layer_test.h"
 #include "flutter/flow/testing/mock_layer.h"
 #include "flutter/fml/macros.h"
 #include "flutter/testing/mock_canvas.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkFont.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/core/SkTextBlob.h"
+#include "third_party/skia/include/core/SkTypeface.h"
 
 namespace flutter {
 namespace testing {
 
 using OpacityLayerTest = LayerTest;
 
+namespace {
+
+// Paints |layer| into a raster surface with the settings of |paint_context|,
+// or calls |paint| on the surface's canvas instead if it is given.
+SkBitmap PaintToBitmap(const Layer::PaintContext& paint_context,
+                       const Layer* layer,
+                       std::function<void(SkCanvas*)> paint = nullptr) {
+  auto surface = SkSurface::MakeRasterN32Premul(32, 32);
+  SkCanvas* canvas = surface->getCanvas();
+  canvas->clear(SK_ColorWHITE);
+  if (paint) {
+    paint(canvas);
+  } else {
+    SkNWayCanvas internal_nodes_canvas(32, 32);
+    internal_nodes_canvas.addCanvas(canvas);
+    Layer::PaintContext context = paint_context;
+    context.internal_nodes_canvas = &internal_nodes_canvas;
+    context.leaf_nodes_canvas = canvas;
+    layer->Paint(context);
+  }
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(32, 32);
+  surface->readPixels(bitmap, 0, 0);
+  return bitmap;
+}
+
+// Whether no channel of any pixel differs by more than rounding error.
+bool BitmapsAlmostEqual(const SkBitmap& a, const SkBitmap& b) {
+  for (int y = 0; y < a.height(); y++) {
+    for (int x = 0; x < a.width(); x++) {
+      const SkColor a_color = a.getColor(x, y);
+      const SkColor b_color = b.getColor(x, y);
+      for (int shift = 0; shift < 32; shift += 8) {
+        const int a_channel = (a_color >> shift) & 0xFF;
+        const int b_channel = (b_color >> shift) & 0xFF;
+        if (std::abs(a_channel - b_channel) > 1) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 #ifndef NDEBUG
 TEST_F(OpacityLayerTest, LeafLayer) {
   auto layer =
@@ -341,5 +398,241 @@ TEST_F(OpacityLayerTest, CullRectIsTransformed) {
   EXPECT_EQ(mockLayer->parent_cull_rect().fTop, -20);
 }
 
+TEST_F(OpacityLayerTest, FoldsIntoChildrenThatDontOverlap) {
+  const SkPath child1_path = SkPath().addRect(SkRect::MakeWH(5.0f, 5.0f));
+  const SkPath child2_path =
+      SkPath().addRect(SkRect::MakeXYWH(10.0f, 0.0f, 5.0f, 5.0f));
+  const SkPoint layer_offset = SkPoint::Make(0.5f, 1.5f);
+  const SkMatrix initial_transform = SkMatrix::MakeTrans(0.5f, 0.5f);
+  const SkMatrix layer_transform =
+      SkMatrix::MakeTrans(layer_offset.fX, layer_offset.fY);
+#ifndef SUPPORT_FRACTIONAL_TRANSLATION
+  const SkMatrix integral_layer_transform = RasterCache::GetIntegralTransCTM(
+      SkMatrix::Concat(initial_transform, layer_transform));
+#endif
+  const SkPaint child1_paint = SkPaint(SkColors::kRed);
+  const SkPaint child2_paint = SkPaint(SkColors::kGreen);
+  const SkAlpha alpha = 128;
+  auto mock_layer1 = std::make_shared<MockLayer>(child1_path, child1_paint,
+                                                 false, false, false, true);
+  auto mock_layer2 = std::make_shared<MockLayer>(child2_path, child2_paint,
+                                                 false, false, false, true);
+  auto layer = std::make_shared<OpacityLayer>(alpha, layer_offset);
+  layer->Add(mock_layer1);
+  layer->Add(mock_layer2);
+
+  layer->Preroll(preroll_context(), initial_transform);
+  EXPECT_TRUE(layer->layer_can_inherit_opacity());
+
+  SkPaint opacity_paint;
+  opacity_paint.setAlpha(alpha);
+  SkPaint expected_child1_paint = child1_paint;
+  expected_child1_paint.setAlphaf(opacity_paint.getAlphaf());
+  SkPaint expected_child2_paint = child2_paint;
+  expected_child2_paint.setAlphaf(opacity_paint.getAlphaf());
+  auto expected_draw_calls = std::vector(
+      {MockCanvas::DrawCall{0, MockCanvas::SaveData{1}},
+       MockCanvas::DrawCall{1, MockCanvas::ConcatMatrixData{layer_transform}},
+#ifndef SUPPORT_FRACTIONAL_TRANSLATION
+       MockCanvas::DrawCall{
+           1, MockCanvas::SetMatrixData{integral_layer_transform}},
+#endif
+       MockCanvas::DrawCall{
+           1, MockCanvas::DrawPathData{child1_path, expected_child1_paint}},
+       MockCanvas::DrawCall{
+           1, MockCanvas::DrawPathData{child2_path, expected_child2_paint}},
+       MockCanvas::DrawCall{1, MockCanvas::RestoreData{0}}});
+  layer->Paint(paint_context());
+  EXPECT_EQ(mock_canvas().draw_calls(), expected_draw_calls);
+}
+
+TEST_F(OpacityLayerTest, DoesntFoldIntoOverlappingChildren) {
+  const SkPath child1_path = SkPath().addRect(SkRect::MakeWH(5.0f, 5.0f));
+  const SkPath child2_path =
+      SkPath().addRect(SkRect::MakeXYWH(4.0f, 0.0f, 5.0f, 5.0f));
+  const SkPoint layer_offset = SkPoint::Make(0.5f, 1.5f);
+  const SkMatrix initial_transform = SkMatrix::MakeTrans(0.5f, 0.5f);
+  const SkMatrix layer_transform =
+      SkMatrix::MakeTrans(layer_offset.fX, layer_offset.fY);
+#ifndef SUPPORT_FRACTIONAL_TRANSLATION
+  const SkMatrix integral_layer_transform = RasterCache::GetIntegralTransCTM(
+      SkMatrix::Concat(initial_transform, layer_transform));
+#endif
+  const SkPaint child1_paint = SkPaint(SkColors::kRed);
+  const SkPaint child2_paint = SkPaint(SkColors::kGreen);
+  const SkAlpha alpha = 128;
+  auto mock_layer1 = std::make_shared<MockLayer>(child1_path, child1_paint,
+                                                 false, false, false, true);
+  auto mock_layer2 = std::make_shared<MockLayer>(child2_path, child2_paint,
+                                                 false, false, false, true);
+  auto layer = std::make_shared<OpacityLayer>(alpha, layer_offset);
+  layer->Add(mock_layer1);
+  layer->Add(mock_layer2);
+
+  layer->Preroll(preroll_context(), initial_transform);
+  // The opacity layer can still inherit opacity itself.
+  EXPECT_TRUE(layer->layer_can_inherit_opacity());
+
+  SkPaint opacity_paint;
+  opacity_paint.setAlpha(alpha);
+  SkRect opacity_bounds;
+  layer->paint_bounds()
+      .makeOffset(-layer_offset.fX, -layer_offset.fY)
+      .roundOut(&opacity_bounds);
+  auto expected_draw_calls = std::vector(
+      {MockCanvas::DrawCall{0, MockCanvas::SaveData{1}},
+       MockCanvas::DrawCall{1, MockCanvas::ConcatMatrixData{layer_transform}},
+#ifndef SUPPORT_FRACTIONAL_TRANSLATION
+       MockCanvas::DrawCall{
+           1, MockCanvas::SetMatrixData{integral_layer_transform}},
+#endif
+       MockCanvas::DrawCall{
+           1, MockCanvas::SaveLayerData{opacity_bounds, opacity_paint, nullptr,
+                                        2}},
+       MockCanvas::DrawCall{
+           2, MockCanvas::DrawPathData{child1_path, child1_paint}},
+       MockCanvas::DrawCall{
+           2, MockCanvas::DrawPathData{child2_path, child2_paint}},
+       MockCanvas::DrawCall{2, MockCanvas::RestoreData{1}},
+       MockCanvas::DrawCall{1, MockCanvas::RestoreData{0}}});
+  layer->Paint(paint_context());
+  EXPECT_EQ(mock_canvas().draw_calls(), expected_draw_calls);
+}
+
+TEST_F(OpacityLayerTest, NestedFoldsCombineOpacity) {
+  const SkPath child_path = SkPath().addRect(SkRect::MakeWH(5.0f, 5.0f));
+  const SkPoint layer1_offset = SkPoint::Make(0.5f, 1.5f);
+  const SkPoint layer2_offset = SkPoint::Make(2.5f, 0.5f);
+  const SkMatrix initial_transform = SkMatrix::MakeTrans(0.5f, 0.5f);
+  const SkMatrix layer1_transform =
+      SkMatrix::MakeTrans(layer1_offset.fX, layer1_offset.fY);
+  const SkMatrix layer2_transform =
+      SkMatrix::MakeTrans(layer2_offset.fX, layer2_offset.fY);
+#ifndef SUPPORT_FRACTIONAL_TRANSLATION
+  const SkMatrix integral_layer1_transform = RasterCache::GetIntegralTransCTM(
+      SkMatrix::Concat(initial_transform, layer1_transform));
+  const SkMatrix integral_layer2_transform = RasterCache::GetIntegralTransCTM(
+      SkMatrix::Concat(SkMatrix::Concat(initial_transform, layer1_transform),
+                       layer2_transform));
+#endif
+  const SkPaint child_paint = SkPaint(SkColors::kRed);
+  const SkAlpha alpha1 = 128;
+  const SkAlpha alpha2 = 64;
+  auto mock_layer = std::make_shared<MockLayer>(child_path, child_paint, false,
+                                                false, false, true);
+  auto layer1 = std::make_shared<OpacityLayer>(alpha1, layer1_offset);
+  auto layer2 = std::make_shared<OpacityLayer>(alpha2, layer2_offset);
+  layer2->Add(mock_layer);
+  layer1->Add(layer2);
+
+  layer1->Preroll(preroll_context(), initial_transform);
+
+  SkPaint opacity1_paint;
+  opacity1_paint.setAlpha(alpha1);
+  SkPaint opacity2_paint;
+  opacity2_paint.setAlpha(alpha2);
+  SkPaint expected_child_paint = child_paint;
+  expected_child_paint.setAlphaf(opacity2_paint.getAlphaf() *
+                                 opacity1_paint.getAlphaf());
+  auto expected_draw_calls = std::vector(
+      {MockCanvas::DrawCall{0, MockCanvas::SaveData{1}},
+       MockCanvas::DrawCall{1, MockCanvas::ConcatMatrixData{layer1_transform}},
+#ifndef SUPPORT_FRACTIONAL_TRANSLATION
+       MockCanvas::DrawCall{
+           1, MockCanvas::SetMatrixData{integral_layer1_transform}},
+#endif
+       MockCanvas::DrawCall{1, MockCanvas::SaveData{2}},
+       MockCanvas::DrawCall{2, MockCanvas::ConcatMatrixData{layer2_transform}},
+#ifndef SUPPORT_FRACTIONAL_TRANSLATION
+       MockCanvas::DrawCall{
+           2, MockCanvas::SetMatrixData{integral_layer2_transform}},
+#endif
+       MockCanvas::DrawCall{
+           2, MockCanvas::DrawPathData{child_path, expected_child_paint}},
+       MockCanvas::DrawCall{2, MockCanvas::RestoreData{1}},
+       MockCanvas::DrawCall{1, MockCanvas::RestoreData{0}}});
+  layer1->Paint(paint_context());
+  EXPECT_EQ(mock_canvas().draw_calls(), expected_draw_calls);
+}
+
+TEST_F(OpacityLayerTest, FoldedPaintMatchesSaveLayer) {
+  // Anti-aliased children with fractional edges that are close, but not
+  // close enough to share any pixels.
+  const SkPath child1_path =
+      SkPath().addRect(SkRect::MakeLTRB(2.5f, 2.5f, 12.25f, 20.5f));
+  const SkPath child2_path =
+      SkPath().addOval(SkRect::MakeLTRB(15.5f, 4.5f, 28.5f, 18.25f));
+  SkPaint child1_paint = SkPaint(SkColors::kRed);
+  child1_paint.setAntiAlias(true);
+  SkPaint child2_paint = SkPaint(SkColor4f{0.0f, 0.5f, 1.0f, 0.75f});
+  child2_paint.setAntiAlias(true);
+  const SkAlpha alpha = 100;
+  auto layer = std::make_shared<OpacityLayer>(alpha, SkPoint::Make(0, 0));
+  layer->Add(std::make_shared<MockLayer>(child1_path, child1_paint, false,
+                                         false, false, true));
+  layer->Add(std::make_shared<MockLayer>(child2_path, child2_paint, false,
+                                         false, false, true));
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  const SkBitmap folded = PaintToBitmap(paint_context(), layer.get());
+  const SkBitmap save_layer =
+      PaintToBitmap(paint_context(), layer.get(), [&](SkCanvas* canvas) {
+        canvas->saveLayerAlpha(nullptr, alpha);
+        canvas->drawPath(child1_path, child1_paint);
+        canvas->drawPath(child2_path, child2_paint);
+        canvas->restore();
+      });
+  EXPECT_TRUE(BitmapsAlmostEqual(folded, save_layer));
+
+  // The opacity is really folded into the children.
+  layer->Paint(paint_context());
+  for (const auto& draw_call : mock_canvas().draw_calls()) {
+    EXPECT_FALSE(std::holds_alternative<MockCanvas::SaveLayerData>(
+        draw_call.data));
+  }
+}
+
+TEST_F(OpacityLayerTest, OverlappingGlyphsMatchSaveLayer) {
+  // A single text blob whose two glyphs overlap.
+  const SkFont font(SkTypeface::MakeFromFile(GetFontFile().c_str()), 24);
+  SkTextBlobBuilder builder;
+  const auto& run = builder.allocRunPos(font, 2);
+  run.glyphs[0] = run.glyphs[1] = font.unicharToGlyph('O');
+  run.points()[0] = SkPoint::Make(2.0f, 24.0f);
+  run.points()[1] = SkPoint::Make(8.0f, 24.0f);
+  const sk_sp<SkTextBlob> blob = builder.make();
+  ASSERT_TRUE(blob);
+  const SkPaint text_paint = SkPaint(SkColors::kBlue);
+  SkPictureRecorder recorder;
+  recorder.beginRecording(SkRect::MakeWH(32, 32))
+      ->drawTextBlob(blob, 0, 0, text_paint);
+  const sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+  const SkAlpha alpha = 128;
+  auto layer = std::make_shared<OpacityLayer>(alpha, SkPoint::Make(0, 0));
+  layer->Add(std::make_shared<PictureLayer>(
+      SkPoint::Make(0, 0), SkiaGPUObject<SkPicture>(picture, nullptr), false,
+      false));
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  const SkBitmap painted = PaintToBitmap(paint_context(), layer.get());
+  const SkBitmap save_layer =
+      PaintToBitmap(paint_context(), layer.get(), [&](SkCanvas* canvas) {
+        canvas->saveLayerAlpha(nullptr, alpha);
+        canvas->drawTextBlob(blob, 0, 0, text_paint);
+        canvas->restore();
+      });
+  EXPECT_TRUE(BitmapsAlmostEqual(painted, save_layer));
+
+  // Folding the opacity into the glyphs would darken where they overlap.
+  const SkBitmap folded =
+      PaintToBitmap(paint_context(), layer.get(), [&](SkCanvas* canvas) {
+        SkPaint folded_paint = text_paint;
+        folded_paint.setAlpha(alpha);
+        canvas->drawTextBlob(blob, 0, 0, folded_paint);
+      });
+  EXPECT_FALSE(BitmapsAlmostEqual(folded, save_layer));
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -7,6 +7,7 @@
 #include <string>
 
 #include "flutter/flow/layers/performance_overlay_layer.h"
+#include "flutter/flow/layers/layer_tree_serialization.h"
 #include "third_party/skia/include/core/SkFont.h"
 #include "third_party/skia/include/core/SkTextBlob.h"
 
@@ -97,4 +98,10 @@ void PerformanceOverlayLayer::Paint(PaintContext& context) const {
                      options_ & kDisplayEngineStatistics, "UI", font_path_);
 }
 
+void PerformanceOverlayLayer::Serialize(LayerTreeWriter& writer) const {
+  writer.WriteLayerHeader(SerializedLayerType::kPerformanceOverlay, *this);
+  writer.WriteInt64(options_);
+  writer.WriteString(font_path_);
+}
+
 }  // namespace flutter
@@ -31,6 +31,8 @@ class PerformanceOverlayLayer : public Layer {
 
   void Paint(PaintContext& context) const override;
 
+  void Serialize(LayerTreeWriter& writer) const override;
+
  private:
   int options_;
   std::string font_path_;
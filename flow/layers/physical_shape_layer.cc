@@ -4,6 +4,10 @@
 
 #include "flutter/flow/layers/physical_shape_layer.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "flutter/flow/layers/layer_tree_serialization.h"
 #include "flutter/flow/paint_utils.h"
 #include "third_party/skia/include/utils/SkShadowUtils.h"
 
@@ -66,6 +70,16 @@ void PhysicalShapeLayer::Preroll(PrerollContext* context,
     // children to it so we don't need to join the child paint bounds.
     set_paint_bounds(ComputeShadowBounds(path_.getBounds(), elevation_,
                                          context->frame_device_pixel_ratio));
+
+    if (context->raster_cache &&
+        SkRect::Intersects(context->cull_rect, paint_bounds())) {
+      RasterCachePreparation::ForShadow(
+          ShadowRasterCacheKey(path_, shadow_color_, elevation_,
+                               SkColorGetA(color_) != 0xff,
+                               context->frame_device_pixel_ratio, matrix),
+          matrix)
+          .Prepare(context);
+    }
   }
 }
 
@@ -74,8 +88,19 @@ void PhysicalShapeLayer::Paint(PaintContext& context) const {
   FML_DCHECK(needs_painting());
 
   if (elevation_ != 0) {
-    DrawShadow(context.leaf_nodes_canvas, path_, shadow_color_, elevation_,
-               SkColorGetA(color_) != 0xff, context.frame_device_pixel_ratio);
+    const bool transparent_occluder = SkColorGetA(color_) != 0xff;
+    if (context.raster_cache &&
+        context.raster_cache->Draw(
+            ShadowRasterCacheKey(path_, shadow_color_, elevation_,
+                                 transparent_occluder,
+                                 context.frame_device_pixel_ratio,
+                                 context.leaf_nodes_canvas->getTotalMatrix()),
+            *context.leaf_nodes_canvas)) {
+      TRACE_EVENT_INSTANT0("flutter", "shadow raster cache hit");
+    } else {
+      DrawShadow(context.leaf_nodes_canvas, path_, shadow_color_, elevation_,
+                 transparent_occluder, context.frame_device_pixel_ratio);
+    }
   }
 
   // Call drawPath without clip if possible for better performance.
@@ -159,12 +184,26 @@ SkRect PhysicalShapeLayer::ComputeShadowBounds(const SkRect& bounds,
   return shadow_bounds;
 }
 
+SkScalar PhysicalShapeLayer::ComputeShadowTranslationStep(float elevation) {
+  // The spot shadow is offset from the shape by the shape's offset from the
+  // light, scaled by elevation / (kLightHeight - elevation) for any pixel
+  // ratio. Keep that within half a pixel.
+  const SkScalar kMaxSpotShadowOffsetError = 0.5f;
+  if (elevation <= 0 || elevation >= kLightHeight) {
+    return 1;
+  }
+  return std::max<SkScalar>(
+      1, std::floor(kMaxSpotShadowOffsetError * (kLightHeight - elevation) /
+                    elevation));
+}
+
 void PhysicalShapeLayer::DrawShadow(SkCanvas* canvas,
                                     const SkPath& path,
                                     SkColor color,
                                     float elevation,
                                     bool transparentOccluder,
-                                    SkScalar dpr) {
+                                    SkScalar dpr,
+                                    const SkVector& light_offset) {
   const SkScalar kAmbientAlpha = 0.039f;
   const SkScalar kSpotAlpha = 0.25f;
 
@@ -172,8 +211,8 @@ void PhysicalShapeLayer::DrawShadow(SkCanvas* canvas,
                             ? SkShadowFlags::kTransparentOccluder_ShadowFlag
                             : SkShadowFlags::kNone_ShadowFlag;
   const SkRect& bounds = path.getBounds();
-  SkScalar shadow_x = (bounds.left() + bounds.right()) / 2;
-  SkScalar shadow_y = bounds.top() - 600.0f;
+  SkScalar shadow_x = (bounds.left() + bounds.right()) / 2 + light_offset.x();
+  SkScalar shadow_y = bounds.top() - 600.0f + light_offset.y();
   SkColor inAmbient = SkColorSetA(color, kAmbientAlpha * SkColorGetA(color));
   SkColor inSpot = SkColorSetA(color, kSpotAlpha * SkColorGetA(color));
   SkColor ambientColor, spotColor;
@@ -185,4 +224,14 @@ void PhysicalShapeLayer::DrawShadow(SkCanvas* canvas,
       dpr * kLightRadius, ambientColor, spotColor, flags);
 }
 
+void PhysicalShapeLayer::Serialize(LayerTreeWriter& writer) const {
+  writer.WriteLayerHeader(SerializedLayerType::kPhysicalShape, *this);
+  writer.WriteUInt32(color_);
+  writer.WriteUInt32(shadow_color_);
+  writer.WriteScalar(elevation_);
+  writer.WritePath(path_);
+  writer.WriteUInt32(clip_behavior_);
+  writer.WriteChildren(*this);
+}
+
 }  // namespace flutter
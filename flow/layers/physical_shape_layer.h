@@ -20,17 +20,30 @@ class PhysicalShapeLayer : public ContainerLayer {
   static SkRect ComputeShadowBounds(const SkRect& bounds,
                                     float elevation,
                                     float pixel_ratio);
+  // Shadows of a shape drawn at translations that differ by less than this
+  // many device pixels differ only by a fraction of a pixel. Only the offset
+  // of the spot shadow from the shape depends on the translation, because
+  // the light is positioned in device space.
+  static SkScalar ComputeShadowTranslationStep(float elevation);
+
+  // The light casting the shadow is positioned in device space. Canvases
+  // whose device space is offset from the one the shadow is composited in,
+  // such as that of a raster cache entry, must give the offset as
+  // |light_offset|.
   static void DrawShadow(SkCanvas* canvas,
                          const SkPath& path,
                          SkColor color,
                          float elevation,
                          bool transparentOccluder,
-                         SkScalar dpr);
+                         SkScalar dpr,
+                         const SkVector& light_offset = SkVector::Make(0, 0));
 
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
 
   void Paint(PaintContext& context) const override;
 
+  void Serialize(LayerTreeWriter& writer) const override;
+
   bool UsesSaveLayer() const {
     return clip_behavior_ == Clip::antiAliasWithSaveLayer;
   }
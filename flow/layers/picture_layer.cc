@@ -4,7 +4,10 @@
 
 #include "flutter/flow/layers/picture_layer.h"
 
+#include "flutter/flow/layers/layer_tree_serialization.h"
+#include "flutter/flow/paint_utils.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/time/time_point.h"
 
 namespace flutter {
 
@@ -15,7 +18,12 @@ PictureLayer::PictureLayer(const SkPoint& offset,
     : offset_(offset),
       picture_(std::move(picture)),
       is_complex_(is_complex),
-      will_change_(will_change) {}
+      will_change_(will_change) {
+  // Finding out requires playing the picture back, so it is done once for
+  // the layer rather than in every preroll.
+  set_layer_can_inherit_opacity(picture() &&
+                                PictureCanInheritOpacity(*picture()));
+}
 
 void PictureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   TRACE_EVENT0("flutter", "PictureLayer::Preroll");
@@ -26,7 +34,7 @@ void PictureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
 
   SkPicture* sk_picture = picture();
 
-  if (auto* cache = context->raster_cache) {
+  if (context->raster_cache) {
     TRACE_EVENT0("flutter", "PictureLayer::RasterCache (Preroll)");
 
     SkMatrix ctm = matrix;
@@ -34,8 +42,9 @@ void PictureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
 #ifndef SUPPORT_FRACTIONAL_TRANSLATION
     ctm = RasterCache::GetIntegralTransCTM(ctm);
 #endif
-    cache->Prepare(context->gr_context, sk_picture, ctm,
-                   context->dst_color_space, is_complex_, will_change_);
+    RasterCachePreparation::ForPicture(sk_picture, ctm, is_complex_,
+                                       will_change_)
+        .Prepare(context);
   }
 
   SkRect bounds = sk_picture->cullRect().makeOffset(offset_.x(), offset_.y());
@@ -54,12 +63,39 @@ void PictureLayer::Paint(PaintContext& context) const {
       context.leaf_nodes_canvas->getTotalMatrix()));
 #endif
 
+  const bool has_inherited_opacity = context.inherited_opacity < SK_Scalar1;
+  SkPaint paint;
+  paint.setAlphaf(context.inherited_opacity);
   if (context.raster_cache &&
-      context.raster_cache->Draw(*picture(), *context.leaf_nodes_canvas)) {
+      context.raster_cache->Draw(*picture(), *context.leaf_nodes_canvas,
+                                 has_inherited_opacity ? &paint : nullptr)) {
     TRACE_EVENT_INSTANT0("flutter", "raster cache hit");
     return;
   }
-  picture()->playback(context.leaf_nodes_canvas);
+  // Draw times are only measured where the raster cache uses them, as on the
+  // GPU drawing only records commands.
+  const bool record_draw_time = context.raster_cache && !context.gr_context;
+  const auto start =
+      record_draw_time ? fml::TimePoint::Now() : fml::TimePoint();
+  if (has_inherited_opacity) {
+    DrawPictureWithOpacity(*picture(), context.leaf_nodes_canvas,
+                           context.inherited_opacity);
+  } else {
+    picture()->playback(context.leaf_nodes_canvas);
+  }
+  if (record_draw_time) {
+    context.raster_cache->RecordUncachedDraw(*picture(),
+                                             *context.leaf_nodes_canvas,
+                                             fml::TimePoint::Now() - start);
+  }
+}
+
+void PictureLayer::Serialize(LayerTreeWriter& writer) const {
+  writer.WriteLayerHeader(SerializedLayerType::kPicture, *this);
+  writer.WritePoint(offset_);
+  writer.WritePicture(*picture());
+  writer.WriteBool(is_complex_);
+  writer.WriteBool(will_change_);
 }
 
 }  // namespace flutter
@@ -10,6 +10,7 @@
 #include "flutter/fml/macros.h"
 #include "flutter/testing/mock_canvas.h"
 #include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
 
 #ifndef SUPPORT_FRACTIONAL_TRANSLATION
 #include "flutter/flow/raster_cache.h"
@@ -98,5 +99,73 @@ TEST_F(PictureLayerTest, SimplePicture) {
   EXPECT_EQ(mock_canvas().draw_calls(), expected_draw_calls);
 }
 
+TEST_F(PictureLayerTest, SingleDrawInheritsOpacity) {
+  const SkPoint layer_offset = SkPoint::Make(1.5f, -0.5f);
+  const SkMatrix layer_offset_matrix =
+      SkMatrix::MakeTrans(layer_offset.fX, layer_offset.fY);
+  const SkRect picture_bounds = SkRect::MakeLTRB(5.0f, 6.0f, 20.5f, 21.5f);
+  const SkPaint picture_paint = SkPaint(SkColors::kGreen);
+  SkPictureRecorder recorder;
+  recorder.beginRecording(picture_bounds)
+      ->drawRect(picture_bounds, picture_paint);
+  auto picture = recorder.finishRecordingAsPicture();
+  auto layer = std::make_shared<PictureLayer>(
+      layer_offset, SkiaGPUObject(picture, unref_queue()), false, false);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_TRUE(layer->layer_can_inherit_opacity());
+
+  const float inherited_opacity = 0.5f;
+  paint_context().inherited_opacity = inherited_opacity;
+  layer->Paint(paint_context());
+  paint_context().inherited_opacity = SK_Scalar1;
+  SkPaint expected_paint = picture_paint;
+  expected_paint.setAlphaf(picture_paint.getAlphaf() * inherited_opacity);
+  auto expected_draw_calls = std::vector(
+      {MockCanvas::DrawCall{0, MockCanvas::SaveData{1}},
+       MockCanvas::DrawCall{1,
+                            MockCanvas::ConcatMatrixData{layer_offset_matrix}},
+#ifndef SUPPORT_FRACTIONAL_TRANSLATION
+       MockCanvas::DrawCall{
+           1, MockCanvas::SetMatrixData{RasterCache::GetIntegralTransCTM(
+                  layer_offset_matrix)}},
+#endif
+       MockCanvas::DrawCall{
+           1, MockCanvas::DrawRectData{picture_bounds, expected_paint}},
+       MockCanvas::DrawCall{1, MockCanvas::RestoreData{0}}});
+  EXPECT_EQ(mock_canvas().draw_calls(), expected_draw_calls);
+}
+
+TEST_F(PictureLayerTest, OverlappingDrawsDontInheritOpacity) {
+  const SkRect picture_bounds = SkRect::MakeLTRB(5.0f, 6.0f, 20.5f, 21.5f);
+  SkPictureRecorder recorder;
+  SkCanvas* recording_canvas = recorder.beginRecording(picture_bounds);
+  recording_canvas->drawRect(picture_bounds, SkPaint(SkColors::kGreen));
+  recording_canvas->drawRect(picture_bounds, SkPaint(SkColors::kBlue));
+  auto layer = std::make_shared<PictureLayer>(
+      SkPoint::Make(0.0f, 0.0f),
+      SkiaGPUObject(recorder.finishRecordingAsPicture(), unref_queue()),
+      false, false);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_FALSE(layer->layer_can_inherit_opacity());
+}
+
+TEST_F(PictureLayerTest, SourceBlendDoesntInheritOpacity) {
+  const SkRect picture_bounds = SkRect::MakeLTRB(5.0f, 6.0f, 20.5f, 21.5f);
+  SkPaint picture_paint = SkPaint(SkColors::kGreen);
+  picture_paint.setBlendMode(SkBlendMode::kSrc);
+  SkPictureRecorder recorder;
+  recorder.beginRecording(picture_bounds)
+      ->drawRect(picture_bounds, picture_paint);
+  auto layer = std::make_shared<PictureLayer>(
+      SkPoint::Make(0.0f, 0.0f),
+      SkiaGPUObject(recorder.finishRecordingAsPicture(), unref_queue()),
+      false, false);
+
+  layer->Preroll(preroll_context(), SkMatrix());
+  EXPECT_FALSE(layer->layer_can_inherit_opacity());
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/shader_mask_layer.h"
 
+#include "flutter/flow/layers/layer_tree_serialization.h"
+
 namespace flutter {
 
 ShaderMaskLayer::ShaderMaskLayer(sk_sp<SkShader> shader,
@@ -19,6 +21,8 @@ void ShaderMaskLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   Layer::AutoPrerollSaveLayerState save =
       Layer::AutoPrerollSaveLayerState::Create(context);
   ContainerLayer::Preroll(context, matrix);
+  // The shader mask applies to the children as a whole.
+  set_layer_can_inherit_opacity(false);
 }
 
 void ShaderMaskLayer::Paint(PaintContext& context) const {
@@ -37,4 +41,12 @@ void ShaderMaskLayer::Paint(PaintContext& context) const {
       SkRect::MakeWH(mask_rect_.width(), mask_rect_.height()), paint);
 }
 
+void ShaderMaskLayer::Serialize(LayerTreeWriter& writer) const {
+  writer.WriteLayerHeader(SerializedLayerType::kShaderMask, *this);
+  writer.WriteFlattenable(shader_.get());
+  writer.WriteRect(mask_rect_);
+  writer.WriteUInt32(static_cast<uint32_t>(blend_mode_));
+  writer.WriteChildren(*this);
+}
+
 }  // namespace flutter
@@ -4,6 +4,7 @@
 
 #include "flutter/flow/layers/texture_layer.h"
 
+#include "flutter/flow/layers/layer_tree_serialization.h"
 #include "flutter/flow/texture.h"
 
 namespace flutter {
@@ -38,4 +39,12 @@ void TextureLayer::Paint(PaintContext& context) const {
                  context.gr_context);
 }
 
+void TextureLayer::Serialize(LayerTreeWriter& writer) const {
+  writer.WriteLayerHeader(SerializedLayerType::kTexture, *this);
+  writer.WritePoint(offset_);
+  writer.WriteSize(size_);
+  writer.WriteInt64(texture_id_);
+  writer.WriteBool(freeze_);
+}
+
 }  // namespace flutter
@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/transform_layer.h"
 
+#include "flutter/flow/layers/layer_tree_serialization.h"
+
 namespace flutter {
 
 TransformLayer::TransformLayer(const SkMatrix& transform)
@@ -45,6 +47,7 @@ void TransformLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
 
   transform_.mapRect(&child_paint_bounds);
   set_paint_bounds(child_paint_bounds);
+  set_layer_can_inherit_opacity(children_can_inherit_opacity());
 
   context->cull_rect = previous_cull_rect;
   context->mutators_stack.Pop();
@@ -76,4 +79,10 @@ void TransformLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+void TransformLayer::Serialize(LayerTreeWriter& writer) const {
+  writer.WriteLayerHeader(SerializedLayerType::kTransform, *this);
+  writer.WriteMatrix(transform_);
+  writer.WriteChildren(*this);
+}
+
 }  // namespace flutter
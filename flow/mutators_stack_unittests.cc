@@ -24,6 +24,25 @@ TEST(MutatorsStack, CopyConstructor) {
   ASSERT_TRUE(copy == stack);
 }
 
+TEST(MutatorsStack, ArenaCopyOutlivesArena) {
+  MutatorsStack copy;
+  {
+    auto arena = fml::MakeRefCounted<LayerArena>();
+    MutatorsStack stack(arena);
+    stack.PushTransform(SkMatrix::MakeTrans(1, 2));
+    stack.PushOpacity(128);
+    stack.Pop();
+    stack.PushClipRect(SkRect::MakeWH(10, 10));
+    EXPECT_EQ(arena->stats().allocation_count, 3u);
+    copy = stack;
+  }
+
+  MutatorsStack expected;
+  expected.PushTransform(SkMatrix::MakeTrans(1, 2));
+  expected.PushClipRect(SkRect::MakeWH(10, 10));
+  ASSERT_TRUE(copy == expected);
+}
+
 TEST(MutatorsStack, PushClipRect) {
   MutatorsStack stack;
   auto rect = SkRect::MakeEmpty();
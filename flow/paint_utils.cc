@@ -6,9 +6,13 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
+
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkPaint.h"
 #include "third_party/skia/include/core/SkShader.h"
+#include "third_party/skia/include/utils/SkNoDrawCanvas.h"
+#include "third_party/skia/include/utils/SkPaintFilterCanvas.h"
 
 namespace flutter {
 
@@ -23,6 +27,127 @@ sk_sp<SkShader> CreateCheckerboardShader(SkColor c1, SkColor c2, int size) {
   return bm.makeShader(SkTileMode::kRepeat, SkTileMode::kRepeat);
 }
 
+// Pictures with more ops than this aren't played back to find out whether
+// they can inherit opacity.
+constexpr int kMaxOpsToCheckForOpacity = 16;
+
+// Finds out whether the draws played back into it can inherit opacity,
+// without drawing anything.
+class InheritOpacityCheckCanvas final : public SkPaintFilterCanvas {
+ public:
+  explicit InheritOpacityCheckCanvas(SkCanvas* canvas)
+      : SkPaintFilterCanvas(canvas) {}
+
+  bool can_inherit_opacity() const {
+    return can_inherit_opacity_ && draw_count_ <= 1;
+  }
+
+ protected:
+  // |SkPaintFilterCanvas|
+  bool onFilter(SkPaint& paint) const override {
+    draw_count_++;
+    // Color and image filters don't scale with the alpha of their input, and
+    // other blend modes don't composite like a saveLayer does.
+    if (paint.getColorFilter() || paint.getImageFilter() ||
+        paint.getBlendMode() != SkBlendMode::kSrcOver) {
+      can_inherit_opacity_ = false;
+    }
+    return false;
+  }
+
+  // |SkCanvas|
+  SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override {
+    can_inherit_opacity_ = false;
+    return SkPaintFilterCanvas::getSaveLayerStrategy(rec);
+  }
+
+  // |SkCanvas|
+  void onDrawPicture(const SkPicture* picture,
+                     const SkMatrix* matrix,
+                     const SkPaint* paint) override {
+    can_inherit_opacity_ = false;
+  }
+
+  // |SkCanvas|
+  void onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) override {
+    can_inherit_opacity_ = false;
+  }
+
+  // |SkCanvas|
+  void onDrawShadowRec(const SkPath& path,
+                       const SkDrawShadowRec& rec) override {
+    can_inherit_opacity_ = false;
+  }
+
+  // The glyphs, triangles, sprites, points and patches drawn by each of the
+  // following calls may overlap each other.
+
+  // |SkCanvas|
+  void onDrawTextBlob(const SkTextBlob* blob,
+                      SkScalar x,
+                      SkScalar y,
+                      const SkPaint& paint) override {
+    can_inherit_opacity_ = false;
+  }
+
+  // |SkCanvas|
+  void onDrawVerticesObject(const SkVertices* vertices,
+                            SkBlendMode mode,
+                            const SkPaint& paint) override {
+    can_inherit_opacity_ = false;
+  }
+
+  // |SkCanvas|
+  void onDrawAtlas(const SkImage* image,
+                   const SkRSXform xform[],
+                   const SkRect tex[],
+                   const SkColor colors[],
+                   int count,
+                   SkBlendMode mode,
+                   const SkRect* cull,
+                   const SkPaint* paint) override {
+    can_inherit_opacity_ = false;
+  }
+
+  // |SkCanvas|
+  void onDrawPoints(PointMode mode,
+                    size_t count,
+                    const SkPoint pts[],
+                    const SkPaint& paint) override {
+    can_inherit_opacity_ = false;
+  }
+
+  // |SkCanvas|
+  void onDrawPatch(const SkPoint cubics[12],
+                   const SkColor colors[4],
+                   const SkPoint tex_coords[4],
+                   SkBlendMode mode,
+                   const SkPaint& paint) override {
+    can_inherit_opacity_ = false;
+  }
+
+ private:
+  mutable bool can_inherit_opacity_ = true;
+  mutable int draw_count_ = 0;
+};
+
+// Scales the alpha of the paints drawn into it by an opacity.
+class OpacityCanvas final : public SkPaintFilterCanvas {
+ public:
+  OpacityCanvas(SkCanvas* canvas, float opacity)
+      : SkPaintFilterCanvas(canvas), opacity_(opacity) {}
+
+ protected:
+  // |SkPaintFilterCanvas|
+  bool onFilter(SkPaint& paint) const override {
+    paint.setAlphaf(paint.getAlphaf() * opacity_);
+    return true;
+  }
+
+ private:
+  const float opacity_;
+};
+
 }  // anonymous namespace
 
 void DrawCheckerboard(SkCanvas* canvas, SkColor c1, SkColor c2, int size) {
@@ -50,4 +175,23 @@ void DrawCheckerboard(SkCanvas* canvas, const SkRect& rect) {
   canvas->drawRect(rect, debugPaint);
 }
 
+bool PictureCanInheritOpacity(const SkPicture& picture) {
+  if (picture.approximateOpCount() > kMaxOpsToCheckForOpacity) {
+    return false;
+  }
+  const SkIRect bounds = picture.cullRect().roundOut();
+  SkNoDrawCanvas no_draw_canvas(std::max(bounds.right(), 1),
+                                std::max(bounds.bottom(), 1));
+  InheritOpacityCheckCanvas check_canvas(&no_draw_canvas);
+  picture.playback(&check_canvas);
+  return check_canvas.can_inherit_opacity();
+}
+
+void DrawPictureWithOpacity(const SkPicture& picture,
+                            SkCanvas* canvas,
+                            float opacity) {
+  OpacityCanvas opacity_canvas(canvas, opacity);
+  picture.playback(&opacity_canvas);
+}
+
 }  // namespace flutter
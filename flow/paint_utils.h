@@ -7,6 +7,7 @@
 
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkColor.h"
+#include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/core/SkRect.h"
 
 namespace flutter {
@@ -15,6 +16,18 @@ void DrawCheckerboard(SkCanvas* canvas, SkColor c1, SkColor c2, int size);
 
 void DrawCheckerboard(SkCanvas* canvas, const SkRect& rect);
 
+// Whether playing back |picture| with the alpha of each of its paints scaled
+// by an opacity looks the same as drawing it into a saveLayer with that
+// opacity. This is only known to be the case for pictures of a single draw
+// that blends its source over the destination.
+bool PictureCanInheritOpacity(const SkPicture& picture);
+
+// Plays back |picture| into |canvas| with the alpha of each of its paints
+// scaled by |opacity|.
+void DrawPictureWithOpacity(const SkPicture& picture,
+                            SkCanvas* canvas,
+                            float opacity);
+
 }  // namespace flutter
 
 #endif  // FLUTTER_FLOW_PAINT_UTILS_H_
@@ -4,11 +4,16 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <vector>
 
 #include "flutter/flow/layers/layer.h"
+#include "flutter/flow/layers/physical_shape_layer.h"
 #include "flutter/flow/paint_utils.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkImage.h"
@@ -33,10 +38,33 @@ void RasterCacheResult::draw(SkCanvas& canvas, const SkPaint* paint) const {
   canvas.drawImage(image_, bounds.fLeft, bounds.fTop, paint);
 }
 
+void RasterCacheResult::draw(SkCanvas& canvas,
+                             const SkMatrix& raster_matrix,
+                             const SkPaint* paint) const {
+  TRACE_EVENT0("flutter", "RasterCacheResult::draw");
+  SkMatrix inverse;
+  if (!raster_matrix.invert(&inverse)) {
+    return;
+  }
+  SkAutoCanvasRestore auto_restore(&canvas, true);
+  SkIRect bounds = RasterCache::GetDeviceBounds(logical_rect_, raster_matrix);
+  SkPaint filtered_paint;
+  if (paint) {
+    filtered_paint = *paint;
+  }
+  filtered_paint.setFilterQuality(kLow_SkFilterQuality);
+  canvas.concat(inverse);
+  canvas.drawImage(image_, bounds.fLeft, bounds.fTop, &filtered_paint);
+}
+
 RasterCache::RasterCache(size_t access_threshold,
-                         size_t picture_cache_limit_per_frame)
+                         size_t picture_cache_limit_per_frame,
+                         size_t shadow_cache_max_bytes,
+                         size_t picture_cache_max_bytes)
     : access_threshold_(access_threshold),
       picture_cache_limit_per_frame_(picture_cache_limit_per_frame),
+      shadow_cache_max_bytes_(shadow_cache_max_bytes),
+      picture_cache_max_bytes_(picture_cache_max_bytes),
       checkerboard_images_(false) {}
 
 static bool CanRasterizePicture(SkPicture* picture) {
@@ -59,30 +87,34 @@ static bool CanRasterizePicture(SkPicture* picture) {
   return true;
 }
 
-static bool IsPictureWorthRasterizing(SkPicture* picture,
-                                      bool will_change,
-                                      bool is_complex) {
+static bool IsPictureWorthRasterizing(SkPicture* picture, bool will_change) {
   if (will_change) {
     // If the picture is going to change in the future, there is no point in
     // doing to extra work to rasterize.
     return false;
   }
 
-  if (!CanRasterizePicture(picture)) {
-    // No point in deciding whether the picture is worth rasterizing if it
-    // cannot be rasterized at all.
-    return false;
-  }
+  // Whether rasterizing the picture is worth the memory it takes is decided
+  // by |RasterCache::AdmitPicture|.
+  return CanRasterizePicture(picture);
+}
 
-  if (is_complex) {
-    // The caller seems to have extra information about the picture and thinks
-    // the picture is always worth rasterizing.
-    return true;
-  }
+static size_t GetImageBytes(const RasterCacheResult& image) {
+  const auto dimensions = image.image_dimensions();
+  return static_cast<size_t>(dimensions.width()) * dimensions.height() * 4;
+}
 
-  // TODO(abarth): We should find a better heuristic here that lets us avoid
-  // wasting memory on trivial layers that are easy to re-rasterize every frame.
-  return picture->approximateOpCount() > 5;
+static SkScalar GetScaleLevel(SkScalar scale) {
+  const float levels = RasterCache::kScaleTolerantLevelsPerOctave;
+  const SkScalar level =
+      std::exp2(std::ceil(std::log2(std::abs(scale)) * levels) / levels);
+  return std::copysign(level, scale);
+}
+
+SkMatrix RasterCache::GetScaleLevelMatrix(const SkMatrix& ctm) {
+  FML_DCHECK(ctm.isScaleTranslate());
+  return SkMatrix::MakeScale(GetScaleLevel(ctm.getScaleX()),
+                             GetScaleLevel(ctm.getScaleY()));
 }
 
 /// @note Procedure doesn't copy all closures.
@@ -139,6 +171,15 @@ void RasterCache::Prepare(PrerollContext* context,
   entry.access_count++;
   entry.used_this_frame = true;
   if (!entry.image.is_valid()) {
+    // How long rasterizing a layer takes isn't known up front, so layers are
+    // only deferred once the frame is out of time.
+    if (population_budget_.has_value() &&
+        !HasPopulationTimeLeft(fml::TimeDelta::Zero())) {
+      TRACE_EVENT_INSTANT1("flutter", "RasterCache deferred layer", "reason",
+                           "no time left in the frame");
+      return;
+    }
+    const auto start = fml::TimePoint::Now();
     entry.image = Rasterize(
         context->gr_context, ctm, context->dst_color_space,
         checkerboard_images_, layer->paint_bounds(),
@@ -163,6 +204,7 @@ void RasterCache::Prepare(PrerollContext* context,
             layer->Paint(paintContext);
           }
         });
+    RecordPopulation(fml::TimePoint::Now() - start);
   }
 }
 
@@ -176,10 +218,11 @@ bool RasterCache::Prepare(GrContext* context,
   if (access_threshold_ == 0) {
     return false;
   }
-  if (picture_cached_this_frame_ >= picture_cache_limit_per_frame_) {
-    return false;
+  if (will_change && scale_tolerant_) {
+    return PrepareScaled(context, picture, transformation_matrix,
+                         dst_color_space, is_complex);
   }
-  if (!IsPictureWorthRasterizing(picture, will_change, is_complex)) {
+  if (!IsPictureWorthRasterizing(picture, will_change)) {
     // We only deal with pictures that are worthy of rasterization.
     return false;
   }
@@ -203,17 +246,285 @@ bool RasterCache::Prepare(GrContext* context,
   }
 
   if (!entry.image.is_valid()) {
+    if (!AdmitPicture(entry, picture, transformation_matrix, is_complex,
+                      context != nullptr)) {
+      return false;
+    }
+    const auto start = fml::TimePoint::Now();
     entry.image = RasterizePicture(picture, context, transformation_matrix,
                                    dst_color_space, checkerboard_images_);
+    RecordPopulation(fml::TimePoint::Now() - start);
+    picture_cached_this_frame_++;
+  }
+  return true;
+}
+
+bool RasterCache::PrepareScaled(GrContext* context,
+                                SkPicture* picture,
+                                const SkMatrix& transformation_matrix,
+                                SkColorSpace* dst_color_space,
+                                bool is_complex) {
+  if (!IsPictureWorthRasterizing(picture, false)) {
+    return false;
+  }
+  // Renditions are only scaled, so that they are not distorted when drawn.
+  if (!transformation_matrix.isScaleTranslate() ||
+      !MatrixDecomposition(transformation_matrix).IsValid()) {
+    return false;
+  }
+
+  const SkMatrix level_matrix = GetScaleLevelMatrix(transformation_matrix);
+  PictureRasterCacheKey cache_key(picture->uniqueID(), level_matrix);
+
+  // Creates an entry, if not present prior.
+  Entry& entry = scaled_picture_cache_[cache_key];
+  if (entry.access_count < access_threshold_) {
+    // Frame threshold has not yet been reached.
+    return false;
+  }
+
+  if (!entry.image.is_valid()) {
+    if (!AdmitPicture(entry, picture, level_matrix, is_complex,
+                      context != nullptr)) {
+      return false;
+    }
+    const auto start = fml::TimePoint::Now();
+    entry.image = RasterizePicture(picture, context, level_matrix,
+                                   dst_color_space, checkerboard_images_);
+    RecordPopulation(fml::TimePoint::Now() - start);
     picture_cached_this_frame_++;
   }
   return true;
 }
 
-bool RasterCache::Draw(const SkPicture& picture, SkCanvas& canvas) const {
+bool RasterCache::AdmitPicture(Entry& entry,
+                               SkPicture* picture,
+                               const SkMatrix& matrix,
+                               bool is_complex,
+                               bool is_gpu) {
+  const SkIRect cache_rect = GetDeviceBounds(picture->cullRect(), matrix);
+  const size_t bytes = std::max<size_t>(
+      static_cast<size_t>(cache_rect.width()) * cache_rect.height() * 4, 1);
+  // On the GPU, drawing a picture only records commands that are executed
+  // when the frame is flushed, so the measured time leaves out most of it.
+  const fml::TimeDelta draw_time =
+      entry.uncached_draw_time > fml::TimeDelta::Zero() && !is_gpu
+          ? entry.uncached_draw_time
+          : kEstimatedDrawTimePerOp * picture->approximateOpCount();
+
+  // The caller seems to have extra information about the picture and thinks
+  // the picture is always worth rasterizing, so it is never evicted for
+  // pictures that aren't.
+  const double benefit_per_byte =
+      is_complex ? std::numeric_limits<double>::infinity()
+                 : draw_time.ToNanosecondsF() / bytes;
+  if (is_gpu) {
+    // Without a measured draw time, only pictures with enough ops to be
+    // worth the memory are rasterized.
+    if (!is_complex && picture->approximateOpCount() <= 5) {
+      TRACE_EVENT_INSTANT1("flutter", "RasterCache rejected picture",
+                           "reason", "too few ops");
+      return false;
+    }
+  } else if (benefit_per_byte * (1 << 20) <
+             kMinDrawTimePerMByte.ToNanosecondsF()) {
+    TRACE_EVENT_INSTANT1("flutter", "RasterCache rejected picture", "reason",
+                         "too quick to draw for its size");
+    return false;
+  }
+
+  if (population_budget_.has_value()) {
+    // Rasterizing the picture takes about as long as drawing it.
+    if (!HasPopulationTimeLeft(draw_time)) {
+      TRACE_EVENT_INSTANT1("flutter", "RasterCache deferred picture", "reason",
+                           "no time left in the frame");
+      return false;
+    }
+  } else if (picture_cached_this_frame_ >= picture_cache_limit_per_frame_) {
+    TRACE_EVENT_INSTANT1("flutter", "RasterCache deferred picture", "reason",
+                         "enough pictures rasterized in the frame");
+    return false;
+  }
+
+  if (bytes > picture_cache_max_bytes_) {
+    TRACE_EVENT_INSTANT1("flutter", "RasterCache rejected picture", "reason",
+                         "larger than the budget");
+    return false;
+  }
+  const size_t used_bytes = GetPictureCacheBytes();
+  if (used_bytes + bytes > picture_cache_max_bytes_) {
+    // Make room by evicting the pictures that save the least time per byte,
+    // as long as they save less than this one would.
+    std::vector<Entry*> victims;
+    for (auto* cache : {&picture_cache_, &scaled_picture_cache_}) {
+      for (auto& item : *cache) {
+        if (item.second.image.is_valid() &&
+            item.second.benefit_per_byte < benefit_per_byte) {
+          victims.push_back(&item.second);
+        }
+      }
+    }
+    std::sort(victims.begin(), victims.end(), [](Entry* a, Entry* b) {
+      return a->benefit_per_byte < b->benefit_per_byte;
+    });
+    size_t freed_bytes = 0;
+    size_t victim_count = 0;
+    while (victim_count < victims.size() &&
+           used_bytes - freed_bytes + bytes > picture_cache_max_bytes_) {
+      freed_bytes += GetImageBytes(victims[victim_count]->image);
+      victim_count++;
+    }
+    if (used_bytes - freed_bytes + bytes > picture_cache_max_bytes_) {
+      TRACE_EVENT_INSTANT1("flutter", "RasterCache rejected picture", "reason",
+                           "no room in the budget");
+      return false;
+    }
+    for (size_t i = 0; i < victim_count; i++) {
+      TRACE_EVENT_INSTANT0("flutter", "RasterCache evicted picture");
+      victims[i]->image = RasterCacheResult();
+      victims[i]->benefit_per_byte = 0;
+    }
+  }
+
+  TRACE_EVENT_INSTANT0("flutter", "RasterCache admitted picture");
+  entry.benefit_per_byte = benefit_per_byte;
+  return true;
+}
+
+bool RasterCache::Prepare(GrContext* context,
+                          const ShadowRasterCacheKey& shadow,
+                          const SkMatrix& ctm,
+                          SkColorSpace* dst_color_space) {
+  if (access_threshold_ == 0) {
+    return false;
+  }
+  if (population_budget_.has_value()
+          ? !HasPopulationTimeLeft(fml::TimeDelta::Zero())
+          : shadow_cached_this_frame_ >= picture_cache_limit_per_frame_) {
+    return false;
+  }
+  if (!MatrixDecomposition(ctm).IsValid()) {
+    return false;
+  }
+
+  // Creates an entry, if not present prior.
+  Entry& entry = shadow_cache_[shadow];
+  if (entry.access_count < access_threshold_) {
+    // Frame threshold has not yet been reached.
+    return false;
+  }
+
+  if (!entry.image.is_valid()) {
+    const SkRect logical_rect = PhysicalShapeLayer::ComputeShadowBounds(
+        shadow.path().getBounds(), shadow.elevation(), shadow.dpr());
+    const SkIRect cache_rect = GetDeviceBounds(logical_rect, ctm);
+    const size_t bytes =
+        static_cast<size_t>(cache_rect.width()) * cache_rect.height() * 4;
+    if (GetShadowCacheBytes() + bytes > shadow_cache_max_bytes_) {
+      return false;
+    }
+    const auto start = fml::TimePoint::Now();
+    entry.image = Rasterize(
+        context, ctm, dst_color_space, checkerboard_images_, logical_rect,
+        [&](SkCanvas* canvas) {
+          // The light is positioned in device space, so it must be moved
+          // along with the device space of the cache.
+          PhysicalShapeLayer::DrawShadow(
+              canvas, shadow.path(), shadow.color(), shadow.elevation(),
+              shadow.transparent_occluder(), shadow.dpr(),
+              SkVector::Make(-cache_rect.left(), -cache_rect.top()));
+        });
+    RecordPopulation(fml::TimePoint::Now() - start);
+    shadow_cached_this_frame_++;
+  }
+  return true;
+}
+
+bool RasterCache::Draw(const SkPicture& picture,
+                       SkCanvas& canvas,
+                       SkPaint* paint) const {
   PictureRasterCacheKey cache_key(picture.uniqueID(), canvas.getTotalMatrix());
   auto it = picture_cache_.find(cache_key);
   if (it == picture_cache_.end()) {
+    return scale_tolerant_ && DrawScaled(picture, canvas, paint);
+  }
+
+  Entry& entry = it->second;
+  entry.access_count++;
+  entry.used_this_frame = true;
+
+  if (entry.image.is_valid()) {
+    entry.image.draw(canvas, paint);
+    return true;
+  }
+
+  return false;
+}
+
+void RasterCache::RecordUncachedDraw(const SkPicture& picture,
+                                     const SkCanvas& canvas,
+                                     fml::TimeDelta duration) const {
+  const SkMatrix& ctm = canvas.getTotalMatrix();
+  Entry* entry = nullptr;
+  auto it = picture_cache_.find(PictureRasterCacheKey(picture.uniqueID(), ctm));
+  if (it != picture_cache_.end()) {
+    entry = &it->second;
+  } else if (scale_tolerant_ && ctm.isScaleTranslate()) {
+    auto scaled_it = scaled_picture_cache_.find(
+        PictureRasterCacheKey(picture.uniqueID(), GetScaleLevelMatrix(ctm)));
+    if (scaled_it != scaled_picture_cache_.end()) {
+      entry = &scaled_it->second;
+    }
+  }
+  if (!entry) {
+    return;
+  }
+
+  // Weigh the latest draws most, as how long a draw takes depends on what
+  // was drawn before it.
+  entry->uncached_draw_time =
+      entry->uncached_draw_time == fml::TimeDelta::Zero()
+          ? duration
+          : (entry->uncached_draw_time * 3 + duration) / 4;
+}
+
+bool RasterCache::DrawScaled(const SkPicture& picture,
+                             SkCanvas& canvas,
+                             SkPaint* paint) const {
+  const SkMatrix& ctm = canvas.getTotalMatrix();
+  if (!ctm.isScaleTranslate() || !MatrixDecomposition(ctm).IsValid()) {
+    return false;
+  }
+  const SkMatrix level_matrix = GetScaleLevelMatrix(ctm);
+  PictureRasterCacheKey cache_key(picture.uniqueID(), level_matrix);
+  auto it = scaled_picture_cache_.find(cache_key);
+  if (it == scaled_picture_cache_.end()) {
+    return false;
+  }
+
+  Entry& entry = it->second;
+  entry.access_count++;
+  entry.used_this_frame = true;
+
+  if (!entry.image.is_valid()) {
+    scaled_picture_misses_this_frame_++;
+    return false;
+  }
+
+  entry.image.draw(canvas, level_matrix, paint);
+  scaled_picture_hits_this_frame_++;
+  const double residual_scale =
+      std::min(ctm.getScaleX() / level_matrix.getScaleX(),
+               ctm.getScaleY() / level_matrix.getScaleY());
+  scaled_picture_min_residual_scale_this_frame_ =
+      std::min(scaled_picture_min_residual_scale_this_frame_, residual_scale);
+  return true;
+}
+
+bool RasterCache::Draw(const ShadowRasterCacheKey& shadow,
+                       SkCanvas& canvas) const {
+  auto it = shadow_cache_.find(shadow);
+  if (it == shadow_cache_.end()) {
     return false;
   }
 
@@ -252,18 +563,25 @@ bool RasterCache::Draw(const Layer* layer,
 
 void RasterCache::SweepAfterFrame() {
   SweepOneCacheAfterFrame(picture_cache_);
+  SweepOneCacheAfterFrame(scaled_picture_cache_);
   SweepOneCacheAfterFrame(layer_cache_);
+  SweepOneCacheAfterFrame(shadow_cache_);
   picture_cached_this_frame_ = 0;
+  shadow_cached_this_frame_ = 0;
+  UpdateLastFrameStats();
   TraceStatsToTimeline();
 }
 
 void RasterCache::Clear() {
   picture_cache_.clear();
+  scaled_picture_cache_.clear();
   layer_cache_.clear();
+  shadow_cache_.clear();
 }
 
 size_t RasterCache::GetCachedEntriesCount() const {
-  return layer_cache_.size() + picture_cache_.size();
+  return layer_cache_.size() + picture_cache_.size() +
+         scaled_picture_cache_.size() + shadow_cache_.size();
 }
 
 void RasterCache::SetCheckboardCacheImages(bool checkerboard) {
@@ -278,32 +596,101 @@ void RasterCache::SetCheckboardCacheImages(bool checkerboard) {
   Clear();
 }
 
-void RasterCache::TraceStatsToTimeline() const {
-#if !FLUTTER_RELEASE
+void RasterCache::SetScaleTolerant(bool scale_tolerant) {
+  if (scale_tolerant_ == scale_tolerant) {
+    return;
+  }
+
+  scale_tolerant_ = scale_tolerant;
+  scaled_picture_cache_.clear();
+}
+
+void RasterCache::SetPopulationBudget(fml::TimeDelta budget) {
+  population_budget_ = budget;
+}
+
+bool RasterCache::HasPopulationTimeLeft(fml::TimeDelta estimate) const {
+  FML_DCHECK(population_budget_.has_value());
+  return populated_this_frame_ == 0 ||
+         population_time_this_frame_ + estimate < population_budget_.value();
+}
 
-  size_t layer_cache_count = 0;
-  size_t layer_cache_bytes = 0;
-  size_t picture_cache_count = 0;
-  size_t picture_cache_bytes = 0;
+void RasterCache::RecordPopulation(fml::TimeDelta duration) {
+  populated_this_frame_++;
+  population_time_this_frame_ = population_time_this_frame_ + duration;
+}
+
+size_t RasterCache::GetPictureCacheBytes() const {
+  size_t bytes = 0;
+  for (const auto* cache : {&picture_cache_, &scaled_picture_cache_}) {
+    for (const auto& item : *cache) {
+      bytes += GetImageBytes(item.second.image);
+    }
+  }
+  return bytes;
+}
+
+size_t RasterCache::GetShadowCacheBytes() const {
+  size_t bytes = 0;
+  for (const auto& item : shadow_cache_) {
+    bytes += GetImageBytes(item.second.image);
+  }
+  return bytes;
+}
+
+void RasterCache::UpdateLastFrameStats() {
+  RasterCacheFrameStats stats;
 
   for (const auto& item : layer_cache_) {
     const auto dimensions = item.second.image.image_dimensions();
-    layer_cache_count++;
-    layer_cache_bytes += dimensions.width() * dimensions.height() * 4;
+    stats.layer_count++;
+    stats.layer_bytes +=
+        static_cast<size_t>(dimensions.width()) * dimensions.height() * 4;
   }
 
-  for (const auto& item : picture_cache_) {
-    const auto dimensions = item.second.image.image_dimensions();
-    picture_cache_count++;
-    picture_cache_bytes += dimensions.width() * dimensions.height() * 4;
+  for (const auto* cache : {&picture_cache_, &scaled_picture_cache_}) {
+    for (const auto& item : *cache) {
+      const auto dimensions = item.second.image.image_dimensions();
+      stats.picture_count++;
+      stats.picture_bytes +=
+          static_cast<size_t>(dimensions.width()) * dimensions.height() * 4;
+    }
   }
 
-  FML_TRACE_COUNTER("flutter", "RasterCache",
-                    reinterpret_cast<int64_t>(this),             //
-                    "LayerCount", layer_cache_count,             //
-                    "LayerMBytes", layer_cache_bytes * 1e-6,     //
-                    "PictureCount", picture_cache_count,         //
-                    "PictureMBytes", picture_cache_bytes * 1e-6  //
+  stats.shadow_count = shadow_cache_.size();
+  stats.shadow_bytes = GetShadowCacheBytes();
+
+  stats.populated_count = populated_this_frame_;
+  stats.population_time = population_time_this_frame_;
+  populated_this_frame_ = 0;
+  population_time_this_frame_ = fml::TimeDelta::Zero();
+
+  stats.scaled_picture_hits = scaled_picture_hits_this_frame_;
+  stats.scaled_picture_misses = scaled_picture_misses_this_frame_;
+  stats.scaled_picture_min_residual_scale =
+      scaled_picture_min_residual_scale_this_frame_;
+  scaled_picture_hits_this_frame_ = 0;
+  scaled_picture_misses_this_frame_ = 0;
+  scaled_picture_min_residual_scale_this_frame_ = 1.0;
+
+  last_frame_stats_ = stats;
+}
+
+void RasterCache::TraceStatsToTimeline() const {
+#if !FLUTTER_RELEASE
+
+  FML_TRACE_COUNTER(
+      "flutter", "RasterCache", reinterpret_cast<int64_t>(this),           //
+      "LayerCount", last_frame_stats_.layer_count,                         //
+      "LayerMBytes", last_frame_stats_.layer_bytes * 1e-6,                 //
+      "PictureCount", last_frame_stats_.picture_count,                     //
+      "PictureMBytes", last_frame_stats_.picture_bytes * 1e-6,             //
+      "ShadowCount", last_frame_stats_.shadow_count,                       //
+      "ShadowMBytes", last_frame_stats_.shadow_bytes * 1e-6,               //
+      "ScaledPictureHits", last_frame_stats_.scaled_picture_hits,          //
+      "ScaledPictureMisses", last_frame_stats_.scaled_picture_misses,      //
+      "ScaledPictureMinResidualScale",                                     //
+      last_frame_stats_.scaled_picture_min_residual_scale                  //
   );
 
 #endif  // !FLUTTER_RELEASE
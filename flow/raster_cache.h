@@ -6,8 +6,10 @@
 #define FLUTTER_FLOW_RASTER_CACHE_H_
 
 #include <memory>
+#include <optional>
 #include <unordered_map>
 
+#include "flutter/common/settings.h"
 #include "flutter/flow/instrumentation.h"
 #include "flutter/flow/raster_cache_key.h"
 #include "flutter/fml/macros.h"
@@ -31,6 +33,12 @@ class RasterCacheResult {
 
   void draw(SkCanvas& canvas, const SkPaint* paint = nullptr) const;
 
+  // Draws an image rasterized with |raster_matrix| under the total matrix of
+  // |canvas|, filtering it by the transform between the two.
+  void draw(SkCanvas& canvas,
+            const SkMatrix& raster_matrix,
+            const SkPaint* paint = nullptr) const;
+
   SkISize image_dimensions() const {
     return image_ ? image_->dimensions() : SkISize::Make(0, 0);
   };
@@ -50,9 +58,38 @@ class RasterCache {
   // multiple frames.
   static constexpr int kDefaultPictureCacheLimitPerFrame = 3;
 
+  // The default max number of bytes taken by rasterized shadows. Shadows
+  // extend far beyond their shapes, so their images are larger than those of
+  // pictures of the same shapes.
+  static constexpr size_t kDefaultShadowCacheMaxBytes = 16 << 20;
+
+  // The number of scales per doubling at which pictures are rasterized when
+  // the cache is scale tolerant. Renditions are drawn scaled down by at most
+  // this root of two.
+  static constexpr int kScaleTolerantLevelsPerOctave = 2;
+
+  // The default max number of bytes taken by rasterized pictures. When a
+  // picture doesn't fit, pictures that save less draw time per byte than it
+  // would are evicted to make room for it.
+  static constexpr size_t kDefaultPictureCacheMaxBytes = 64 << 20;
+
+  // Pictures not marked complex are only rasterized if drawing them takes at
+  // least this long for each megabyte their images would take. Only applied
+  // without a GrContext, as GPU draw times measure recording alone; with one,
+  // pictures not marked complex need more than five ops.
+  static constexpr fml::TimeDelta kMinDrawTimePerMByte =
+      fml::TimeDelta::FromMicroseconds(50);
+
+  // The draw time assumed for each op of pictures that haven't been drawn
+  // uncached in a frame yet, or that are drawn with a GrContext.
+  static constexpr fml::TimeDelta kEstimatedDrawTimePerOp =
+      fml::TimeDelta::FromMicroseconds(2);
+
   explicit RasterCache(
       size_t access_threshold = 3,
-      size_t picture_cache_limit_per_frame = kDefaultPictureCacheLimitPerFrame);
+      size_t picture_cache_limit_per_frame = kDefaultPictureCacheLimitPerFrame,
+      size_t shadow_cache_max_bytes = kDefaultShadowCacheMaxBytes,
+      size_t picture_cache_max_bytes = kDefaultPictureCacheMaxBytes);
 
   static SkIRect GetDeviceBounds(const SkRect& rect, const SkMatrix& ctm) {
     SkRect device_rect;
@@ -83,14 +120,41 @@ class RasterCache {
     return result;
   }
 
+  // Returns the matrix that a picture drawn with |ctm| is rasterized with when
+  // the cache is scale tolerant: |ctm|'s scales, each rounded up in magnitude
+  // to the next of |kScaleTolerantLevelsPerOctave| levels per doubling, and no
+  // translation. |ctm| must be a scale and translate matrix.
+  static SkMatrix GetScaleLevelMatrix(const SkMatrix& ctm);
+
+  // When |scale_tolerant| is set, pictures hinted to change are cached at the
+  // scale levels of |GetScaleLevelMatrix| rather than not at all, and drawn
+  // from the level at or above the scale they are drawn at. Other pictures
+  // are cached as before.
+  void SetScaleTolerant(bool scale_tolerant);
+
+  bool IsScaleTolerant() const { return scale_tolerant_; }
+
+  // Limits the time spent rasterizing pictures, layers and shadows in the
+  // following frames to |budget|, instead of limiting the number of pictures
+  // and shadows rasterized to |picture_cache_limit_per_frame|. At least one of
+  // them is rasterized per frame so that the cache fills up even when frames
+  // have no time to spare.
+  void SetPopulationBudget(fml::TimeDelta budget);
+
   // Return true if the cache is generated.
   //
   // We may return false and not generate the cache if
-  // 1. The picture is not worth rasterizing
+  // 1. The picture is not worth rasterizing, which includes pictures that
+  //    will change unless the cache is scale tolerant
   // 2. The matrix is singular
   // 3. The picture is accessed too few times
-  // 4. There are too many pictures to be cached in the current frame.
-  //    (See also kDefaultPictureCacheLimitPerFrame.)
+  // 4. There are too many pictures to be cached in the current frame, or not
+  //    enough time left for it. (See also kDefaultPictureCacheLimitPerFrame
+  //    and SetPopulationBudget.)
+  // 5. The time drawing the picture takes is too little for the memory its
+  //    image would take (or, with a GrContext, it has five ops or fewer),
+  //    or there isn't room for it in the picture budget. (See also
+  //    kMinDrawTimePerMByte and kDefaultPictureCacheMaxBytes.)
   bool Prepare(GrContext* context,
                SkPicture* picture,
                const SkMatrix& transformation_matrix,
@@ -100,10 +164,42 @@ class RasterCache {
 
   void Prepare(PrerollContext* context, Layer* layer, const SkMatrix& ctm);
 
-  // Find the raster cache for the picture and draw it to the canvas.
+  // Return true if the cache is generated.
+  //
+  // Like pictures, shadows are only rasterized once they have been drawn with
+  // the same parameters for enough frames, and only a few of them are
+  // rasterized per frame. They are also not rasterized if they would take the
+  // shadow cache over its byte budget.
+  bool Prepare(GrContext* context,
+               const ShadowRasterCacheKey& shadow,
+               const SkMatrix& ctm,
+               SkColorSpace* dst_color_space);
+
+  // Find the raster cache for the picture and draw it to the canvas. If the
+  // cache is scale tolerant, this falls back to drawing a rendition of the
+  // picture at a nearby scale.
+  //
+  // Addional paint can be given to change how the raster cache is drawn (e.g.,
+  // draw the raster cache with some opacity).
+  //
+  // Return true if it's found and drawn.
+  bool Draw(const SkPicture& picture,
+            SkCanvas& canvas,
+            SkPaint* paint = nullptr) const;
+
+  // Records how long drawing the picture with the total matrix of the canvas
+  // took without the cache, which |Prepare| weighs against the memory caching
+  // it would take. Only draws without a GrContext need to be recorded, as the
+  // times measured with one are ignored.
+  void RecordUncachedDraw(const SkPicture& picture,
+                          const SkCanvas& canvas,
+                          fml::TimeDelta duration) const;
+
+  // Find the raster cache for the shadow and draw it to the canvas. The
+  // shadow must have been identified with the canvas's total matrix.
   //
   // Return true if it's found and drawn.
-  bool Draw(const SkPicture& picture, SkCanvas& canvas) const;
+  bool Draw(const ShadowRasterCacheKey& shadow, SkCanvas& canvas) const;
 
   // Find the raster cache for the layer and draw it to the canvas.
   //
@@ -123,11 +219,21 @@ class RasterCache {
 
   size_t GetCachedEntriesCount() const;
 
+  // The state of the cache as of the last call to |SweepAfterFrame|.
+  const RasterCacheFrameStats& GetLastFrameStats() const {
+    return last_frame_stats_;
+  }
+
  private:
   struct Entry {
     bool used_this_frame = false;
     size_t access_count = 0;
     RasterCacheResult image;
+    // For pictures, the average time that the draws recorded with
+    // |RecordUncachedDraw| took, or zero if none were.
+    fml::TimeDelta uncached_draw_time;
+    // For rasterized pictures, the draw time saved per byte of the image.
+    double benefit_per_byte = 0;
   };
 
   template <class Cache>
@@ -149,10 +255,57 @@ class RasterCache {
 
   const size_t access_threshold_;
   const size_t picture_cache_limit_per_frame_;
+  const size_t shadow_cache_max_bytes_;
+  const size_t picture_cache_max_bytes_;
+  std::optional<fml::TimeDelta> population_budget_;
   size_t picture_cached_this_frame_ = 0;
+  size_t shadow_cached_this_frame_ = 0;
+  size_t populated_this_frame_ = 0;
+  fml::TimeDelta population_time_this_frame_;
+  RasterCacheFrameStats last_frame_stats_;
   mutable PictureRasterCacheKey::Map<Entry> picture_cache_;
   mutable LayerRasterCacheKey::Map<Entry> layer_cache_;
+  mutable ShadowRasterCacheKey::Map<Entry> shadow_cache_;
   bool checkerboard_images_;
+  bool scale_tolerant_ = false;
+  // Pictures hinted to change, keyed by their scale level matrices.
+  mutable PictureRasterCacheKey::Map<Entry> scaled_picture_cache_;
+  mutable size_t scaled_picture_hits_this_frame_ = 0;
+  mutable size_t scaled_picture_misses_this_frame_ = 0;
+  mutable double scaled_picture_min_residual_scale_this_frame_ = 1.0;
+
+  bool PrepareScaled(GrContext* context,
+                     SkPicture* picture,
+                     const SkMatrix& transformation_matrix,
+                     SkColorSpace* dst_color_space,
+                     bool is_complex);
+
+  // Returns whether a picture that has been accessed often enough should be
+  // rasterized into |entry| with |matrix|, evicting other pictures to make
+  // room for it if needed. Decisions are traced to the timeline. Measured
+  // draw times are ignored when |is_gpu|.
+  bool AdmitPicture(Entry& entry,
+                    SkPicture* picture,
+                    const SkMatrix& matrix,
+                    bool is_complex,
+                    bool is_gpu);
+
+  size_t GetPictureCacheBytes() const;
+
+  bool DrawScaled(const SkPicture& picture,
+                  SkCanvas& canvas,
+                  SkPaint* paint) const;
+
+  void RecordPopulation(fml::TimeDelta duration);
+
+  // Whether the population budget leaves time in this frame to rasterize
+  // something expected to take |estimate|. A frame that hasn't rasterized
+  // anything yet always has time left.
+  bool HasPopulationTimeLeft(fml::TimeDelta estimate) const;
+
+  size_t GetShadowCacheBytes() const;
+
+  void UpdateLastFrameStats();
 
   void TraceStatsToTimeline() const;
 
@@ -4,8 +4,43 @@
 
 #include "flutter/flow/raster_cache_key.h"
 
+#include <cmath>
+
+#include "flutter/flow/layers/physical_shape_layer.h"
+#include "flutter/fml/hash_combine.h"
+
 namespace flutter {
 
-//
+ShadowRasterCacheKey::ShadowRasterCacheKey(const SkPath& path,
+                                           SkColor color,
+                                           float elevation,
+                                           bool transparent_occluder,
+                                           float dpr,
+                                           const SkMatrix& ctm)
+    : path_(path),
+      color_(color),
+      elevation_(elevation),
+      transparent_occluder_(transparent_occluder),
+      dpr_(dpr),
+      matrix_(ctm) {
+  // Shadows of scrolling shapes are only drawn again once they moved far
+  // enough to look different.
+  const SkScalar step =
+      PhysicalShapeLayer::ComputeShadowTranslationStep(elevation);
+  matrix_[SkMatrix::kMTransX] = std::floor(ctm.getTranslateX() / step) * step;
+  matrix_[SkMatrix::kMTransY] = std::floor(ctm.getTranslateY() / step) * step;
+
+  // The matrix and the geometry of the path are enough to tell most shadows
+  // apart, and are what is most likely to change between frames.
+  hash_ = fml::HashCombine(path.countPoints(), path.countVerbs(),
+                           static_cast<int>(path.getFillType()));
+  for (int i = 0; i < path.countPoints(); i++) {
+    const SkPoint point = path.getPoint(i);
+    fml::HashCombineSeed(hash_, point.x(), point.y());
+  }
+  for (int i = 0; i < SkMatrix::kMPersp2 + 1; i++) {
+    fml::HashCombineSeed(hash_, matrix_[i]);
+  }
+}
 
 }  // namespace flutter
@@ -8,6 +8,8 @@
 #include <unordered_map>
 #include "flutter/flow/matrix_decomposition.h"
 #include "flutter/fml/logging.h"
+#include "third_party/skia/include/core/SkColor.h"
+#include "third_party/skia/include/core/SkPath.h"
 
 namespace flutter {
 
@@ -56,6 +58,61 @@ class Layer;
 // The ID is the uint64_t layer unique_id
 using LayerRasterCacheKey = RasterCacheKey<uint64_t>;
 
+// Identifies a shadow drawn by |PhysicalShapeLayer::DrawShadow| by its
+// parameters, as the paths of physical shapes are usually rebuilt every
+// frame. Unlike |RasterCacheKey|, the translation is kept, because the light
+// that casts shadows is positioned in device space. It is rounded down to a
+// multiple of |PhysicalShapeLayer::ComputeShadowTranslationStep|, so that
+// shadows that only moved a little look alike.
+class ShadowRasterCacheKey {
+ public:
+  ShadowRasterCacheKey(const SkPath& path,
+                       SkColor color,
+                       float elevation,
+                       bool transparent_occluder,
+                       float dpr,
+                       const SkMatrix& ctm);
+
+  const SkPath& path() const { return path_; }
+  SkColor color() const { return color_; }
+  float elevation() const { return elevation_; }
+  bool transparent_occluder() const { return transparent_occluder_; }
+  float dpr() const { return dpr_; }
+  const SkMatrix& matrix() const { return matrix_; }
+
+  struct Hash {
+    std::size_t operator()(ShadowRasterCacheKey const& key) const {
+      return key.hash_;
+    }
+  };
+
+  struct Equal {
+    bool operator()(const ShadowRasterCacheKey& lhs,
+                    const ShadowRasterCacheKey& rhs) const {
+      return lhs.hash_ == rhs.hash_ && lhs.color_ == rhs.color_ &&
+             lhs.elevation_ == rhs.elevation_ &&
+             lhs.transparent_occluder_ == rhs.transparent_occluder_ &&
+             lhs.dpr_ == rhs.dpr_ && lhs.matrix_ == rhs.matrix_ &&
+             lhs.path_ == rhs.path_;
+    }
+  };
+
+  template <class Value>
+  using Map = std::unordered_map<ShadowRasterCacheKey, Value, Hash, Equal>;
+
+ private:
+  SkPath path_;
+  SkColor color_;
+  float elevation_;
+  bool transparent_occluder_;
+  float dpr_;
+
+  // ctm with its translation rounded down to the shadow's translation step.
+  SkMatrix matrix_;
+
+  std::size_t hash_;
+};
+
 }  // namespace flutter
 
 #endif  // FLUTTER_FLOW_RASTER_CACHE_KEY_H_
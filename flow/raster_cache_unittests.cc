@@ -4,9 +4,15 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <cmath>
+#include <cstdlib>
+
+#include "flutter/flow/layers/physical_shape_layer.h"
 #include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
 
 namespace flutter {
 namespace testing {
@@ -22,6 +28,13 @@ sk_sp<SkPicture> GetSamplePicture() {
   return recorder.finishRecordingAsPicture();
 }
 
+ShadowRasterCacheKey GetSampleShadow(const SkMatrix& ctm,
+                                     float elevation = 4.0f) {
+  SkPath path;
+  path.addRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(20, 20, 60, 40), 8, 8));
+  return ShadowRasterCacheKey(path, SK_ColorBLACK, elevation, false, 1.0f, ctm);
+}
+
 }  // namespace
 
 TEST(RasterCache, SimpleInitialization) {
@@ -162,5 +175,473 @@ TEST(RasterCache, DeviceRectRoundOut) {
   ASSERT_TRUE(cache.Draw(*picture, canvas));
 }
 
+TEST(RasterCache, ReportsLastFrameStats) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.GetLastFrameStats().picture_count, 1u);
+  ASSERT_EQ(cache.GetLastFrameStats().picture_bytes, 0u);
+  ASSERT_EQ(cache.GetLastFrameStats().populated_count, 0u);
+
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+  const auto& stats = cache.GetLastFrameStats();
+  ASSERT_EQ(stats.picture_count, 1u);
+  // The cull rect of the sample picture is 150x100.
+  ASSERT_EQ(stats.picture_bytes, 150u * 100u * 4u);
+  ASSERT_EQ(stats.populated_count, 1u);
+  ASSERT_EQ(stats.layer_count, 0u);
+
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.GetLastFrameStats().picture_count, 0u);
+  ASSERT_EQ(cache.GetLastFrameStats().populated_count, 0u);
+}
+
+TEST(RasterCache, PictureIsCachedOnceItsDrawTimeIsWorthItsMemory) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), false, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+
+  // The sample picture has a single op, so it is assumed to be too quick to
+  // draw to be worth caching.
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), false, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  cache.RecordUncachedDraw(*picture, dummy_canvas,
+                           fml::TimeDelta::FromMilliseconds(1));
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), false, false));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+}
+
+TEST(RasterCache, PictureBudgetEvictsPicturesThatSaveLessTimePerByte) {
+  // The budget fits one sample picture.
+  flutter::RasterCache cache(1, 3, RasterCache::kDefaultShadowCacheMaxBytes,
+                             150 * 100 * 4);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto quick_picture = GetSamplePicture();
+  auto slow_picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  for (const auto& picture : {quick_picture, slow_picture}) {
+    ASSERT_FALSE(
+        cache.Prepare(NULL, picture.get(), matrix, srgb.get(), false, false));
+    ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  }
+  cache.RecordUncachedDraw(*quick_picture, dummy_canvas,
+                           fml::TimeDelta::FromMilliseconds(1));
+  cache.RecordUncachedDraw(*slow_picture, dummy_canvas,
+                           fml::TimeDelta::FromMilliseconds(2));
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(cache.Prepare(NULL, quick_picture.get(), matrix, srgb.get(),
+                            false, false));
+  ASSERT_TRUE(cache.Prepare(NULL, slow_picture.get(), matrix, srgb.get(),
+                            false, false));
+  ASSERT_FALSE(cache.Draw(*quick_picture, dummy_canvas));
+  ASSERT_TRUE(cache.Draw(*slow_picture, dummy_canvas));
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.GetLastFrameStats().picture_bytes, 150u * 100u * 4u);
+
+  // The evicted picture can't evict the one that saves more.
+  ASSERT_FALSE(cache.Prepare(NULL, quick_picture.get(), matrix, srgb.get(),
+                             false, false));
+  ASSERT_TRUE(cache.Prepare(NULL, slow_picture.get(), matrix, srgb.get(),
+                            false, false));
+}
+
+TEST(RasterCache, PopulationBudgetLimitsPicturesPerFrame) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetPopulationBudget(fml::TimeDelta::Zero());
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture1 = GetSamplePicture();
+  auto picture2 = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  for (const auto& picture : {picture1, picture2}) {
+    ASSERT_FALSE(
+        cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+    ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  }
+  cache.SweepAfterFrame();
+
+  // Without time to spare, one picture is still cached per frame.
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture1.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture2.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture1, dummy_canvas));
+  ASSERT_FALSE(cache.Draw(*picture2, dummy_canvas));
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture2.get(), matrix, srgb.get(), true, false));
+
+  // With time to spare, more than |picture_cache_limit_per_frame| pictures
+  // can be cached.
+  flutter::RasterCache budgeted_cache(threshold, 0);
+  budgeted_cache.SetPopulationBudget(fml::TimeDelta::FromSeconds(1));
+  for (const auto& picture : {picture1, picture2}) {
+    ASSERT_FALSE(budgeted_cache.Prepare(NULL, picture.get(), matrix,
+                                        srgb.get(), true, false));
+    ASSERT_FALSE(budgeted_cache.Draw(*picture, dummy_canvas));
+  }
+  budgeted_cache.SweepAfterFrame();
+  for (const auto& picture : {picture1, picture2}) {
+    ASSERT_TRUE(budgeted_cache.Prepare(NULL, picture.get(), matrix,
+                                       srgb.get(), true, false));
+  }
+}
+
+TEST(RasterCache, WillChangePictureIsCachedAtScaleLevelsWhenScaleTolerant) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  auto picture = GetSamplePicture();
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  // Not cached unless the cache is scale tolerant.
+  ASSERT_FALSE(cache.Prepare(NULL, picture.get(), SkMatrix::MakeScale(1.1f),
+                             srgb.get(), true, true));
+  cache.SetScaleTolerant(true);
+
+  SkCanvas canvas(300, 200);
+  canvas.setMatrix(SkMatrix::MakeScale(1.1f));
+  ASSERT_FALSE(cache.Prepare(NULL, picture.get(), SkMatrix::MakeScale(1.1f),
+                             srgb.get(), true, true));
+  ASSERT_FALSE(cache.Draw(*picture, canvas));
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.GetLastFrameStats().scaled_picture_misses, 1u);
+
+  // 1.1 and 1.3 share the level of the square root of two.
+  const SkMatrix level_matrix =
+      RasterCache::GetScaleLevelMatrix(SkMatrix::MakeScale(1.1f));
+  ASSERT_FLOAT_EQ(level_matrix.getScaleX(), std::sqrt(2.0f));
+  ASSERT_EQ(RasterCache::GetScaleLevelMatrix(SkMatrix::MakeScale(1.3f)),
+            level_matrix);
+  canvas.setMatrix(SkMatrix::MakeAll(1.3f, 0, 10.5f, 0, 1.3f, 20.25f, 0, 0, 1));
+  ASSERT_TRUE(cache.Prepare(NULL, picture.get(), canvas.getTotalMatrix(),
+                            srgb.get(), true, true));
+  ASSERT_TRUE(cache.Draw(*picture, canvas));
+  canvas.setMatrix(SkMatrix::MakeScale(1.2f));
+  ASSERT_TRUE(cache.Draw(*picture, canvas));
+  cache.SweepAfterFrame();
+
+  const auto& stats = cache.GetLastFrameStats();
+  ASSERT_EQ(stats.picture_count, 1u);
+  const SkIRect level_rect = RasterCache::GetDeviceBounds(
+      picture->cullRect(), level_matrix);
+  ASSERT_EQ(stats.picture_bytes,
+            static_cast<size_t>(level_rect.width() * level_rect.height() * 4));
+  ASSERT_EQ(stats.scaled_picture_hits, 2u);
+  ASSERT_EQ(stats.scaled_picture_misses, 0u);
+  ASSERT_NEAR(stats.scaled_picture_min_residual_scale, 1.2 / std::sqrt(2.0),
+              1e-5);
+
+  // Moving to the next level needs the picture to be rasterized again.
+  canvas.setMatrix(SkMatrix::MakeScale(1.5f));
+  ASSERT_FALSE(cache.Draw(*picture, canvas));
+}
+
+TEST(RasterCache, ScaleTolerantCacheOnlyScalesWillChangePictures) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetScaleTolerant(true);
+
+  auto picture = GetSamplePicture();
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  SkCanvas canvas(300, 200);
+
+  const SkMatrix matrix = SkMatrix::MakeScale(1.1f);
+  canvas.setMatrix(matrix);
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, canvas));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture, canvas));
+  canvas.setMatrix(SkMatrix::MakeScale(1.2f));
+  ASSERT_FALSE(cache.Draw(*picture, canvas));
+
+  // Renditions aren't rotated.
+  SkMatrix rotation = SkMatrix::MakeScale(1.1f);
+  rotation.preRotate(30);
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), rotation, srgb.get(), true, true));
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.GetLastFrameStats().picture_count, 1u);
+  ASSERT_EQ(cache.GetLastFrameStats().scaled_picture_hits, 0u);
+}
+
+TEST(RasterCache, ScaledRenditionIsDrawnInPlace) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetScaleTolerant(true);
+
+  auto picture = GetSamplePicture();
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  const SkMatrix matrix =
+      SkMatrix::MakeAll(1.2f, 0, 30.5f, 0, 1.2f, 10.0f, 0, 0, 1);
+
+  SkCanvas dummy_canvas;
+  dummy_canvas.setMatrix(matrix);
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, true));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, true));
+
+  auto surface = SkSurface::MakeRasterN32Premul(300, 200);
+  SkCanvas* canvas = surface->getCanvas();
+  canvas->clear(SK_ColorWHITE);
+  canvas->setMatrix(matrix);
+  ASSERT_TRUE(cache.Draw(*picture, *canvas));
+
+  // The sample picture draws a red rect from 10, 10 to 90, 90.
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(300, 200);
+  surface->readPixels(bitmap, 0, 0);
+  SkIRect red_rect;
+  matrix.mapRect(SkRect::MakeLTRB(10, 10, 90, 90)).round(&red_rect);
+  EXPECT_EQ(bitmap.getColor((red_rect.left() + red_rect.right()) / 2,
+                            (red_rect.top() + red_rect.bottom()) / 2),
+            SK_ColorRED);
+  EXPECT_EQ(bitmap.getColor(red_rect.left() + 2, red_rect.top() + 2),
+            SK_ColorRED);
+  EXPECT_EQ(bitmap.getColor(red_rect.right() - 3, red_rect.bottom() - 3),
+            SK_ColorRED);
+  EXPECT_EQ(bitmap.getColor(red_rect.left() - 3, red_rect.top() - 3),
+            SK_ColorWHITE);
+  EXPECT_EQ(bitmap.getColor(red_rect.right() + 2, red_rect.bottom() + 2),
+            SK_ColorWHITE);
+}
+
+TEST(RasterCache, ShadowThresholdIsRespected) {
+  size_t threshold = 2;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  ASSERT_FALSE(
+      cache.Prepare(NULL, GetSampleShadow(matrix), matrix, srgb.get()));
+  // 1st access.
+  ASSERT_FALSE(cache.Draw(GetSampleShadow(matrix), dummy_canvas));
+
+  cache.SweepAfterFrame();
+
+  ASSERT_FALSE(
+      cache.Prepare(NULL, GetSampleShadow(matrix), matrix, srgb.get()));
+  // 2nd access.
+  ASSERT_FALSE(cache.Draw(GetSampleShadow(matrix), dummy_canvas));
+
+  cache.SweepAfterFrame();
+
+  // Now Prepare should cache it, even though the paths of the shadows are
+  // distinct objects.
+  ASSERT_TRUE(
+      cache.Prepare(NULL, GetSampleShadow(matrix), matrix, srgb.get()));
+  ASSERT_TRUE(cache.Draw(GetSampleShadow(matrix), dummy_canvas));
+
+  // Shadows that differ aren't drawn from the cache.
+  ASSERT_FALSE(cache.Draw(GetSampleShadow(matrix, 8.0f), dummy_canvas));
+  const SkMatrix translated = SkMatrix::MakeTrans(100, 0);
+  ASSERT_FALSE(cache.Draw(GetSampleShadow(translated), dummy_canvas));
+}
+
+TEST(RasterCache, ShadowsThatMovedALittleShareEntries) {
+  const SkScalar step = PhysicalShapeLayer::ComputeShadowTranslationStep(4.0f);
+  ASSERT_GT(step, 2.0f);
+  // Higher shapes move their spot shadows further.
+  ASSERT_LT(PhysicalShapeLayer::ComputeShadowTranslationStep(24.0f), step);
+
+  const ShadowRasterCacheKey::Equal equal;
+  const auto shadow = GetSampleShadow(SkMatrix::MakeTrans(step, 2 * step));
+  EXPECT_TRUE(equal(
+      shadow, GetSampleShadow(SkMatrix::MakeTrans(step + 1.5f, 2 * step))));
+  EXPECT_TRUE(equal(
+      shadow, GetSampleShadow(SkMatrix::MakeTrans(step, 3 * step - 0.5f))));
+  EXPECT_FALSE(equal(
+      shadow, GetSampleShadow(SkMatrix::MakeTrans(step - 0.5f, 2 * step))));
+  EXPECT_FALSE(
+      equal(shadow, GetSampleShadow(SkMatrix::MakeTrans(step, 3 * step))));
+}
+
+TEST(RasterCache, ShadowBudgetIsRespected) {
+  size_t threshold = 1;
+  // Less than the shadow of the sample shape takes.
+  size_t shadow_cache_max_bytes = 10 * 10 * 4;
+  flutter::RasterCache cache(threshold,
+                             RasterCache::kDefaultPictureCacheLimitPerFrame,
+                             shadow_cache_max_bytes);
+
+  SkMatrix matrix = SkMatrix::I();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  ASSERT_FALSE(
+      cache.Prepare(NULL, GetSampleShadow(matrix), matrix, srgb.get()));
+  ASSERT_FALSE(cache.Draw(GetSampleShadow(matrix), dummy_canvas));
+  cache.SweepAfterFrame();
+
+  ASSERT_FALSE(
+      cache.Prepare(NULL, GetSampleShadow(matrix), matrix, srgb.get()));
+  ASSERT_FALSE(cache.Draw(GetSampleShadow(matrix), dummy_canvas));
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.GetLastFrameStats().shadow_bytes, 0u);
+}
+
+TEST(RasterCache, PopulationBudgetIsSharedWithShadows) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetPopulationBudget(fml::TimeDelta::Zero());
+
+  SkMatrix matrix = SkMatrix::I();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  auto picture = GetSamplePicture();
+
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_FALSE(
+      cache.Prepare(NULL, GetSampleShadow(matrix), matrix, srgb.get()));
+  ASSERT_FALSE(cache.Draw(GetSampleShadow(matrix), dummy_canvas));
+  cache.SweepAfterFrame();
+
+  // Without time to spare, the shadow waits for a frame in which nothing else
+  // is rasterized.
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_FALSE(
+      cache.Prepare(NULL, GetSampleShadow(matrix), matrix, srgb.get()));
+  ASSERT_FALSE(cache.Draw(GetSampleShadow(matrix), dummy_canvas));
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_TRUE(
+      cache.Prepare(NULL, GetSampleShadow(matrix), matrix, srgb.get()));
+  ASSERT_TRUE(cache.Draw(GetSampleShadow(matrix), dummy_canvas));
+}
+
+TEST(RasterCache, ReportsShadowStats) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+  SkCanvas dummy_canvas;
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  ASSERT_FALSE(
+      cache.Prepare(NULL, GetSampleShadow(matrix), matrix, srgb.get()));
+  ASSERT_FALSE(cache.Draw(GetSampleShadow(matrix), dummy_canvas));
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.GetLastFrameStats().shadow_count, 1u);
+  ASSERT_EQ(cache.GetLastFrameStats().shadow_bytes, 0u);
+
+  ASSERT_TRUE(
+      cache.Prepare(NULL, GetSampleShadow(matrix), matrix, srgb.get()));
+  ASSERT_TRUE(cache.Draw(GetSampleShadow(matrix), dummy_canvas));
+  cache.SweepAfterFrame();
+  const auto& stats = cache.GetLastFrameStats();
+  const SkIRect shadow_rect = RasterCache::GetDeviceBounds(
+      PhysicalShapeLayer::ComputeShadowBounds(
+          GetSampleShadow(matrix).path().getBounds(), 4.0f, 1.0f),
+      matrix);
+  ASSERT_EQ(stats.shadow_count, 1u);
+  ASSERT_EQ(stats.shadow_bytes, static_cast<size_t>(shadow_rect.width() *
+                                                    shadow_rect.height() * 4));
+  ASSERT_EQ(stats.populated_count, 1u);
+  ASSERT_EQ(stats.picture_count, 0u);
+}
+
+TEST(RasterCache, CachedShadowLooksLikeDrawnShadow) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  // The light is positioned in device space, so the shadow depends on where
+  // the shape is drawn.
+  const SkMatrix matrix = SkMatrix::MakeTrans(130, 70);
+  const auto shadow = GetSampleShadow(matrix);
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  auto draw = [&](bool from_cache) {
+    auto surface = SkSurface::MakeRasterN32Premul(300, 200);
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+    canvas->setMatrix(matrix);
+    if (from_cache) {
+      EXPECT_TRUE(cache.Draw(shadow, *canvas));
+    } else {
+      PhysicalShapeLayer::DrawShadow(canvas, shadow.path(), shadow.color(),
+                                     shadow.elevation(),
+                                     shadow.transparent_occluder(),
+                                     shadow.dpr());
+    }
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(300, 200);
+    surface->readPixels(bitmap, 0, 0);
+    return bitmap;
+  };
+
+  SkCanvas dummy_canvas;
+  ASSERT_FALSE(cache.Prepare(NULL, shadow, matrix, srgb.get()));
+  ASSERT_FALSE(cache.Draw(shadow, dummy_canvas));
+  ASSERT_TRUE(cache.Prepare(NULL, shadow, matrix, srgb.get()));
+
+  const SkBitmap drawn = draw(false);
+  const SkBitmap cached = draw(true);
+  for (int y = 0; y < drawn.height(); y++) {
+    for (int x = 0; x < drawn.width(); x++) {
+      const SkColor drawn_color = drawn.getColor(x, y);
+      const SkColor cached_color = cached.getColor(x, y);
+      for (int shift = 0; shift < 32; shift += 8) {
+        ASSERT_LE(std::abs(static_cast<int>((drawn_color >> shift) & 0xFF) -
+                           static_cast<int>((cached_color >> shift) & 0xFF)),
+                  1)
+            << "at " << x << ", " << y;
+      }
+    }
+  }
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -11,12 +11,14 @@ MockLayer::MockLayer(SkPath path,
                      SkPaint paint,
                      bool fake_has_platform_view,
                      bool fake_needs_system_composite,
-                     bool fake_reads_surface)
+                     bool fake_reads_surface,
+                     bool fake_can_inherit_opacity)
     : fake_paint_path_(path),
       fake_paint_(paint),
       fake_has_platform_view_(fake_has_platform_view),
       fake_needs_system_composite_(fake_needs_system_composite),
-      fake_reads_surface_(fake_reads_surface) {}
+      fake_reads_surface_(fake_reads_surface),
+      fake_can_inherit_opacity_(fake_can_inherit_opacity) {}
 
 void MockLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   parent_mutators_ = context->mutators_stack;
@@ -28,6 +30,7 @@ void MockLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   context->has_platform_view = fake_has_platform_view_;
   set_paint_bounds(fake_paint_path_.getBounds());
   set_needs_system_composite(fake_needs_system_composite_);
+  set_layer_can_inherit_opacity(fake_can_inherit_opacity_);
   if (fake_reads_surface_) {
     context->surface_needs_readback = true;
   }
@@ -36,7 +39,9 @@ void MockLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
 void MockLayer::Paint(PaintContext& context) const {
   FML_DCHECK(needs_painting());
 
-  context.leaf_nodes_canvas->drawPath(fake_paint_path_, fake_paint_);
+  SkPaint paint = fake_paint_;
+  paint.setAlphaf(paint.getAlphaf() * context.inherited_opacity);
+  context.leaf_nodes_canvas->drawPath(fake_paint_path_, paint);
 }
 
 }  // namespace testing
@@ -11,16 +11,18 @@ namespace flutter {
 namespace testing {
 
 // Mock implementation of the |Layer| interface that does nothing but paint
-// the specified |path| into the canvas.  It records the |PrerollContext| and
-// |PaintContext| data passed in by its parent |Layer|, so the test can later
-// verify the data against expected values.
+// the specified |path| into the canvas, with any inherited opacity applied
+// to |paint|.  It records the |PrerollContext| and |PaintContext| data passed
+// in by its parent |Layer|, so the test can later verify the data against
+// expected values.
 class MockLayer : public Layer {
  public:
   MockLayer(SkPath path,
             SkPaint paint = SkPaint(),
             bool fake_has_platform_view = false,
             bool fake_needs_system_composite = false,
-            bool fake_reads_surface = false);
+            bool fake_reads_surface = false,
+            bool fake_can_inherit_opacity = false);
 
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
   void Paint(PaintContext& context) const override;
@@ -42,6 +44,7 @@ class MockLayer : public Layer {
   bool fake_has_platform_view_ = false;
   bool fake_needs_system_composite_ = false;
   bool fake_reads_surface_ = false;
+  bool fake_can_inherit_opacity_ = false;
 
   FML_DISALLOW_COPY_AND_ASSIGN(MockLayer);
 };
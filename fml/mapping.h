@@ -145,6 +145,14 @@ class SymbolMapping final : public Mapping {
   FML_DISALLOW_COPY_AND_ASSIGN(SymbolMapping);
 };
 
+//------------------------------------------------------------------------------
+/// @brief      Hints to the system that the pages of the given mapping will be
+///             accessed soon, so that they can be read in before their first
+///             use instead of on demand. This does not block and does nothing
+///             on platforms that do not support the hint.
+///
+void PrefetchMapping(const Mapping& mapping);
+
 }  // namespace fml
 
 #endif  // FLUTTER_FML_MAPPING_H_
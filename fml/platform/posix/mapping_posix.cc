@@ -104,4 +104,17 @@ bool FileMapping::IsValid() const {
   return valid_;
 }
 
+void PrefetchMapping(const Mapping& mapping) {
+  const auto* data = mapping.GetMapping();
+  if (data == nullptr || mapping.GetSize() == 0) {
+    return;
+  }
+
+  // The advice has to start on a page boundary.
+  static const uintptr_t page_size = ::sysconf(_SC_PAGESIZE);
+  const auto start = reinterpret_cast<uintptr_t>(data) / page_size * page_size;
+  const auto end = reinterpret_cast<uintptr_t>(data) + mapping.GetSize();
+  ::madvise(reinterpret_cast<void*>(start), end - start, MADV_WILLNEED);
+}
+
 }  // namespace fml
@@ -119,4 +119,8 @@ bool FileMapping::IsValid() const {
   return valid_;
 }
 
+void PrefetchMapping(const Mapping& mapping) {
+  // Prefetching is only a hint and is not supported on Windows yet.
+}
+
 }  // namespace fml
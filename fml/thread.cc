@@ -19,6 +19,7 @@
 
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/trace_recorder.h"
 
 namespace fml {
 
@@ -70,6 +71,7 @@ void Thread::SetCurrentThreadName(const std::string& name) {
   if (name == "") {
     return;
   }
+  tracing::TraceRecorder::GetInstance().SetCurrentThreadName(name);
 #if OS_MACOSX
   pthread_setname_np(name.c_str());
 #elif OS_LINUX || OS_ANDROID
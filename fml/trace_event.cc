@@ -11,6 +11,7 @@
 #include "flutter/fml/ascii_trie.h"
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/trace_recorder.h"
 
 #if (FLUTTER_RELEASE && !defined(OS_FUCHSIA))
 #define TIMELINE_ENABLED 0
@@ -21,18 +22,28 @@
 namespace fml {
 namespace tracing {
 
+size_t TraceNonce() {
+  static std::atomic_size_t gLastItem;
+  return ++gLastItem;
+}
+
 #if TIMELINE_ENABLED
 
 namespace {
 AsciiTrie gWhitelist;
 
-inline void FlutterTimelineEvent(const char* label,
+inline void FlutterTimelineEvent(const char* category,
+                                 const char* label,
                                  int64_t timestamp0,
                                  int64_t timestamp1_or_async_id,
                                  Dart_Timeline_Event_Type type,
                                  intptr_t argument_count,
                                  const char** argument_names,
                                  const char** argument_values) {
+  if (TraceRecorder::IsRecording()) {
+    TraceRecorder::GetInstance().Record(category, label, timestamp0,
+                                        timestamp1_or_async_id, type);
+  }
   if (gWhitelist.Query(label)) {
     Dart_TimelineEvent(label, timestamp0, timestamp1_or_async_id, type,
                        argument_count, argument_names, argument_values);
@@ -44,11 +55,6 @@ void TraceSetWhitelist(const std::vector<std::string>& whitelist) {
   gWhitelist.Fill(whitelist);
 }
 
-size_t TraceNonce() {
-  static std::atomic_size_t gLastItem;
-  return ++gLastItem;
-}
-
 void TraceTimelineEvent(TraceArg category_group,
                         TraceArg name,
                         int64_t timestamp_micros,
@@ -66,6 +72,7 @@ void TraceTimelineEvent(TraceArg category_group,
   }
 
   FlutterTimelineEvent(
+      category_group,                            // category
       name,                                      // label
       timestamp_micros,                          // timestamp0
       identifier,                                // timestamp1_or_async_id
@@ -93,7 +100,8 @@ void TraceTimelineEvent(TraceArg category_group,
 }
 
 void TraceEvent0(TraceArg category_group, TraceArg name) {
-  FlutterTimelineEvent(name,                       // label
+  FlutterTimelineEvent(category_group,             // category
+                       name,                       // label
                        Dart_TimelineGetMicros(),   // timestamp0
                        0,                          // timestamp1_or_async_id
                        Dart_Timeline_Event_Begin,  // event type
@@ -109,7 +117,8 @@ void TraceEvent1(TraceArg category_group,
                  TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
-  FlutterTimelineEvent(name,                       // label
+  FlutterTimelineEvent(category_group,             // category
+                       name,                       // label
                        Dart_TimelineGetMicros(),   // timestamp0
                        0,                          // timestamp1_or_async_id
                        Dart_Timeline_Event_Begin,  // event type
@@ -127,7 +136,8 @@ void TraceEvent2(TraceArg category_group,
                  TraceArg arg2_val) {
   const char* arg_names[] = {arg1_name, arg2_name};
   const char* arg_values[] = {arg1_val, arg2_val};
-  FlutterTimelineEvent(name,                       // label
+  FlutterTimelineEvent(category_group,             // category
+                       name,                       // label
                        Dart_TimelineGetMicros(),   // timestamp0
                        0,                          // timestamp1_or_async_id
                        Dart_Timeline_Event_Begin,  // event type
@@ -138,7 +148,8 @@ void TraceEvent2(TraceArg category_group,
 }
 
 void TraceEventEnd(TraceArg name) {
-  FlutterTimelineEvent(name,                      // label
+  FlutterTimelineEvent(nullptr,                   // category
+                       name,                      // label
                        Dart_TimelineGetMicros(),  // timestamp0
                        0,                         // timestamp1_or_async_id
                        Dart_Timeline_Event_End,   // event type
@@ -151,7 +162,8 @@ void TraceEventEnd(TraceArg name) {
 void TraceEventAsyncBegin0(TraceArg category_group,
                            TraceArg name,
                            TraceIDArg id) {
-  FlutterTimelineEvent(name,                      // label
+  FlutterTimelineEvent(category_group,            // category
+                       name,                      // label
                        Dart_TimelineGetMicros(),  // timestamp0
                        id,                        // timestamp1_or_async_id
                        Dart_Timeline_Event_Async_Begin,  // event type
@@ -164,7 +176,8 @@ void TraceEventAsyncBegin0(TraceArg category_group,
 void TraceEventAsyncEnd0(TraceArg category_group,
                          TraceArg name,
                          TraceIDArg id) {
-  FlutterTimelineEvent(name,                           // label
+  FlutterTimelineEvent(category_group,                 // category
+                       name,                           // label
                        Dart_TimelineGetMicros(),       // timestamp0
                        id,                             // timestamp1_or_async_id
                        Dart_Timeline_Event_Async_End,  // event type
@@ -181,7 +194,8 @@ void TraceEventAsyncBegin1(TraceArg category_group,
                            TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
-  FlutterTimelineEvent(name,                      // label
+  FlutterTimelineEvent(category_group,            // category
+                       name,                      // label
                        Dart_TimelineGetMicros(),  // timestamp0
                        id,                        // timestamp1_or_async_id
                        Dart_Timeline_Event_Async_Begin,  // event type
@@ -198,7 +212,8 @@ void TraceEventAsyncEnd1(TraceArg category_group,
                          TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
-  FlutterTimelineEvent(name,                           // label
+  FlutterTimelineEvent(category_group,                 // category
+                       name,                           // label
                        Dart_TimelineGetMicros(),       // timestamp0
                        id,                             // timestamp1_or_async_id
                        Dart_Timeline_Event_Async_End,  // event type
@@ -209,7 +224,8 @@ void TraceEventAsyncEnd1(TraceArg category_group,
 }
 
 void TraceEventInstant0(TraceArg category_group, TraceArg name) {
-  FlutterTimelineEvent(name,                         // label
+  FlutterTimelineEvent(category_group,               // category
+                       name,                         // label
                        Dart_TimelineGetMicros(),     // timestamp0
                        0,                            // timestamp1_or_async_id
                        Dart_Timeline_Event_Instant,  // event type
@@ -225,7 +241,8 @@ void TraceEventInstant1(TraceArg category_group,
                         TraceArg arg1_val) {
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
-  FlutterTimelineEvent(name,                         // label
+  FlutterTimelineEvent(category_group,               // category
+                       name,                         // label
                        Dart_TimelineGetMicros(),     // timestamp0
                        0,                            // timestamp1_or_async_id
                        Dart_Timeline_Event_Instant,  // event type
@@ -243,7 +260,8 @@ void TraceEventInstant2(TraceArg category_group,
                         TraceArg arg2_val) {
   const char* arg_names[] = {arg1_name, arg2_name};
   const char* arg_values[] = {arg1_val, arg2_val};
-  FlutterTimelineEvent(name,                         // label
+  FlutterTimelineEvent(category_group,               // category
+                       name,                         // label
                        Dart_TimelineGetMicros(),     // timestamp0
                        0,                            // timestamp1_or_async_id
                        Dart_Timeline_Event_Instant,  // event type
@@ -256,7 +274,8 @@ void TraceEventInstant2(TraceArg category_group,
 void TraceEventFlowBegin0(TraceArg category_group,
                           TraceArg name,
                           TraceIDArg id) {
-  FlutterTimelineEvent(name,                      // label
+  FlutterTimelineEvent(category_group,            // category
+                       name,                      // label
                        Dart_TimelineGetMicros(),  // timestamp0
                        id,                        // timestamp1_or_async_id
                        Dart_Timeline_Event_Flow_Begin,  // event type
@@ -269,7 +288,8 @@ void TraceEventFlowBegin0(TraceArg category_group,
 void TraceEventFlowStep0(TraceArg category_group,
                          TraceArg name,
                          TraceIDArg id) {
-  FlutterTimelineEvent(name,                           // label
+  FlutterTimelineEvent(category_group,                 // category
+                       name,                           // label
                        Dart_TimelineGetMicros(),       // timestamp0
                        id,                             // timestamp1_or_async_id
                        Dart_Timeline_Event_Flow_Step,  // event type
@@ -280,7 +300,8 @@ void TraceEventFlowStep0(TraceArg category_group,
 }
 
 void TraceEventFlowEnd0(TraceArg category_group, TraceArg name, TraceIDArg id) {
-  FlutterTimelineEvent(name,                          // label
+  FlutterTimelineEvent(category_group,                // category
+                       name,                          // label
                        Dart_TimelineGetMicros(),      // timestamp0
                        id,                            // timestamp1_or_async_id
                        Dart_Timeline_Event_Flow_End,  // event type
@@ -292,11 +313,22 @@ void TraceEventFlowEnd0(TraceArg category_group, TraceArg name, TraceIDArg id) {
 
 #else  // TIMELINE_ENABLED
 
-void TraceSetWhitelist(const std::vector<std::string>& whitelist) {}
-
-size_t TraceNonce() {
-  return 0;
+// The Dart VM timeline is not available in release builds, but the trace
+// recorder is.
+namespace {
+inline void RecordEvent(const char* category,
+                        const char* name,
+                        int64_t id,
+                        Dart_Timeline_Event_Type type,
+                        int64_t timestamp_micros = -1) {
+  if (TraceRecorder::IsRecording()) {
+    TraceRecorder::GetInstance().Record(category, name, timestamp_micros, id,
+                                        type);
+  }
 }
+}  // namespace
+
+void TraceSetWhitelist(const std::vector<std::string>& whitelist) {}
 
 void TraceTimelineEvent(TraceArg category_group,
                         TraceArg name,
@@ -304,79 +336,122 @@ void TraceTimelineEvent(TraceArg category_group,
                         TraceIDArg identifier,
                         Dart_Timeline_Event_Type type,
                         const std::vector<const char*>& c_names,
-                        const std::vector<std::string>& values) {}
+                        const std::vector<std::string>& values) {
+  RecordEvent(category_group, name, identifier, type, timestamp_micros);
+}
 
 void TraceTimelineEvent(TraceArg category_group,
                         TraceArg name,
                         TraceIDArg identifier,
                         Dart_Timeline_Event_Type type,
                         const std::vector<const char*>& c_names,
-                        const std::vector<std::string>& values) {}
+                        const std::vector<std::string>& values) {
+  RecordEvent(category_group, name, identifier, type);
+}
 
-void TraceEvent0(TraceArg category_group, TraceArg name) {}
+void TraceEvent0(TraceArg category_group, TraceArg name) {
+  RecordEvent(category_group, name, 0, Dart_Timeline_Event_Begin);
+}
 
 void TraceEvent1(TraceArg category_group,
                  TraceArg name,
                  TraceArg arg1_name,
-                 TraceArg arg1_val) {}
+                 TraceArg arg1_val) {
+  RecordEvent(category_group, name, 0, Dart_Timeline_Event_Begin);
+}
 
 void TraceEvent2(TraceArg category_group,
                  TraceArg name,
                  TraceArg arg1_name,
                  TraceArg arg1_val,
                  TraceArg arg2_name,
-                 TraceArg arg2_val) {}
+                 TraceArg arg2_val) {
+  RecordEvent(category_group, name, 0, Dart_Timeline_Event_Begin);
+}
 
-void TraceEventEnd(TraceArg name) {}
+void TraceEventEnd(TraceArg name) {
+  RecordEvent(nullptr, name, 0, Dart_Timeline_Event_End);
+}
 
 void TraceEventAsyncComplete(TraceArg category_group,
                              TraceArg name,
                              TimePoint begin,
-                             TimePoint end) {}
+                             TimePoint end) {
+  if (!TraceRecorder::IsRecording()) {
+    return;
+  }
+  if (begin > end) {
+    std::swap(begin, end);
+  }
+  const auto id = TraceNonce();
+  RecordEvent(category_group, name, id, Dart_Timeline_Event_Async_Begin,
+              begin.ToEpochDelta().ToMicroseconds());
+  RecordEvent(category_group, name, id, Dart_Timeline_Event_Async_End,
+              end.ToEpochDelta().ToMicroseconds());
+}
 
 void TraceEventAsyncBegin0(TraceArg category_group,
                            TraceArg name,
-                           TraceIDArg id) {}
+                           TraceIDArg id) {
+  RecordEvent(category_group, name, id, Dart_Timeline_Event_Async_Begin);
+}
 
 void TraceEventAsyncEnd0(TraceArg category_group,
                          TraceArg name,
-                         TraceIDArg id) {}
+                         TraceIDArg id) {
+  RecordEvent(category_group, name, id, Dart_Timeline_Event_Async_End);
+}
 
 void TraceEventAsyncBegin1(TraceArg category_group,
                            TraceArg name,
                            TraceIDArg id,
                            TraceArg arg1_name,
-                           TraceArg arg1_val) {}
+                           TraceArg arg1_val) {
+  RecordEvent(category_group, name, id, Dart_Timeline_Event_Async_Begin);
+}
 
 void TraceEventAsyncEnd1(TraceArg category_group,
                          TraceArg name,
                          TraceIDArg id,
                          TraceArg arg1_name,
-                         TraceArg arg1_val) {}
+                         TraceArg arg1_val) {
+  RecordEvent(category_group, name, id, Dart_Timeline_Event_Async_End);
+}
 
-void TraceEventInstant0(TraceArg category_group, TraceArg name) {}
+void TraceEventInstant0(TraceArg category_group, TraceArg name) {
+  RecordEvent(category_group, name, 0, Dart_Timeline_Event_Instant);
+}
 
 void TraceEventInstant1(TraceArg category_group,
                         TraceArg name,
                         TraceArg arg1_name,
-                        TraceArg arg1_val) {}
+                        TraceArg arg1_val) {
+  RecordEvent(category_group, name, 0, Dart_Timeline_Event_Instant);
+}
 
 void TraceEventInstant2(TraceArg category_group,
                         TraceArg name,
                         TraceArg arg1_name,
                         TraceArg arg1_val,
                         TraceArg arg2_name,
-                        TraceArg arg2_val) {}
+                        TraceArg arg2_val) {
+  RecordEvent(category_group, name, 0, Dart_Timeline_Event_Instant);
+}
 
 void TraceEventFlowBegin0(TraceArg category_group,
                           TraceArg name,
-                          TraceIDArg id) {}
+                          TraceIDArg id) {
+  RecordEvent(category_group, name, id, Dart_Timeline_Event_Flow_Begin);
+}
 
 void TraceEventFlowStep0(TraceArg category_group,
                          TraceArg name,
-                         TraceIDArg id) {}
+                         TraceIDArg id) {
+  RecordEvent(category_group, name, id, Dart_Timeline_Event_Flow_Step);
+}
 
 void TraceEventFlowEnd0(TraceArg category_group, TraceArg name, TraceIDArg id) {
+  RecordEvent(category_group, name, id, Dart_Timeline_Event_Flow_End);
 }
 
 #endif  // TIMELINE_ENABLED
@@ -0,0 +1,497 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_recorder.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+#include "flutter/fml/thread_local.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace fml {
+namespace tracing {
+
+namespace {
+
+// Index zero of both intern tables is the empty string. Names that do not fit
+// in the table are recorded with it.
+constexpr uint16_t kEmptyStringIndex = 0;
+
+constexpr size_t kMaxNames = std::numeric_limits<uint16_t>::max() + 1;
+
+// The low 32 bits of a slot header hold the name in bits 0-15, the category
+// in bits 16-23, the event type in bits 24-30 and a bit that is set once the
+// slot is written. The high 32 bits hold the low bits of the write number.
+constexpr uint64_t kSlotWrittenBit = uint64_t{1} << 31;
+
+uint64_t PackSlotHeader(uint64_t write_number,
+                        uint16_t name,
+                        uint16_t category,
+                        int32_t type) {
+  return (write_number << 32) | kSlotWrittenBit |
+         (static_cast<uint64_t>(type & 0x7f) << 24) |
+         (static_cast<uint64_t>(category & 0xff) << 16) | name;
+}
+
+bool IsSlotHeaderOfWrite(uint64_t header, uint64_t write_number) {
+  return (header & kSlotWrittenBit) != 0 &&
+         (header >> 32) == (write_number & 0xffffffff);
+}
+
+void AppendJSONString(std::string& out, const std::string& string) {
+  out.push_back('"');
+  for (const char c : string) {
+    switch (c) {
+      case '"':
+        out.append("\\\"");
+        break;
+      case '\\':
+        out.append("\\\\");
+        break;
+      case '\n':
+        out.append("\\n");
+        break;
+      case '\r':
+        out.append("\\r");
+        break;
+      case '\t':
+        out.append("\\t");
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[8];
+          snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          out.append(escaped);
+        } else {
+          out.push_back(c);
+        }
+        break;
+    }
+  }
+  out.push_back('"');
+}
+
+// Returns the Chrome trace event phase of the event type, or null if events of
+// the type are not recorded.
+const char* GetPhase(int32_t type) {
+  switch (type) {
+    case Dart_Timeline_Event_Begin:
+      return "B";
+    case Dart_Timeline_Event_End:
+      return "E";
+    case Dart_Timeline_Event_Instant:
+      return "i";
+    case Dart_Timeline_Event_Async_Begin:
+      return "b";
+    case Dart_Timeline_Event_Async_End:
+      return "e";
+    case Dart_Timeline_Event_Async_Instant:
+      return "n";
+    case Dart_Timeline_Event_Flow_Begin:
+      return "s";
+    case Dart_Timeline_Event_Flow_Step:
+      return "t";
+    case Dart_Timeline_Event_Flow_End:
+      return "f";
+    default:
+      return nullptr;
+  }
+}
+
+bool HasID(int32_t type) {
+  switch (type) {
+    case Dart_Timeline_Event_Async_Begin:
+    case Dart_Timeline_Event_Async_End:
+    case Dart_Timeline_Event_Async_Instant:
+    case Dart_Timeline_Event_Flow_Begin:
+    case Dart_Timeline_Event_Flow_Step:
+    case Dart_Timeline_Event_Flow_End:
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+struct TraceRecorder::ThreadState {
+  struct CachedString {
+    uint16_t index;
+    const std::string* interned;
+  };
+
+  ~ThreadState() {
+    if (buffer) {
+      TraceRecorder::GetInstance().ReleaseBuffer(std::move(buffer));
+    }
+  }
+
+  // Acquired when the thread records its first event and released when the
+  // thread exits.
+  std::shared_ptr<ThreadBuffer> buffer;
+
+  std::string thread_name;
+
+  // Trace event names and categories are almost always string literals, so
+  // lookups are cached by address. Entries are verified against the interned
+  // string since the same address may be reused for a different string.
+  std::unordered_map<const char*, CachedString> names;
+  std::unordered_map<const char*, CachedString> categories;
+
+  // For each open begin event on this thread, whether it was recorded.
+  std::vector<bool> open_scopes;
+
+  uint32_t generation = 0;
+};
+
+std::atomic<bool> TraceRecorder::recording_;
+
+TraceRecorder::ThreadBuffer::ThreadBuffer(uint32_t thread_index)
+    : slots(new Slot[kEventsPerThread]()),
+      write_count(0),
+      clear_count(0),
+      thread_index(thread_index) {}
+
+TraceRecorder& TraceRecorder::GetInstance() {
+  // Threads may record events during process shutdown, so the recorder is
+  // intentionally leaked.
+  static TraceRecorder* recorder = new TraceRecorder();
+  return *recorder;
+}
+
+TraceRecorder::TraceRecorder() : enabled_category_mask_(0), generation_(0) {
+  const std::string* interned = nullptr;
+  InternLocked(names_, kMaxNames, "", &interned);
+  InternLocked(categories_, kMaxCategories, "", &interned);
+}
+
+TraceRecorder::~TraceRecorder() = default;
+
+void TraceRecorder::SetEnabledCategories(
+    const std::vector<std::string>& categories) {
+  std::scoped_lock lock(mutex_);
+  enabled_categories_ = categories;
+
+  uint64_t mask = 0;
+  for (size_t i = 0; i < categories_.strings.size(); i++) {
+    if (IsCategoryEnabledLocked(*categories_.strings[i])) {
+      mask |= uint64_t{1} << i;
+    }
+  }
+  enabled_category_mask_.store(mask, std::memory_order_relaxed);
+  generation_.fetch_add(1, std::memory_order_relaxed);
+  recording_.store(!enabled_categories_.empty(), std::memory_order_relaxed);
+}
+
+void TraceRecorder::Record(const char* category,
+                           const char* name,
+                           int64_t timestamp_micros,
+                           int64_t id,
+                           Dart_Timeline_Event_Type type) {
+  if (!IsRecording() || name == nullptr) {
+    return;
+  }
+
+  ThreadState& state = GetThreadState();
+
+  const uint32_t generation = generation_.load(std::memory_order_relaxed);
+  if (state.generation != generation) {
+    // Begin events recorded under the old categories may never see their end
+    // events. Viewers close such scopes at the end of the trace.
+    state.open_scopes.clear();
+    state.generation = generation;
+  }
+
+  uint16_t category_index = kEmptyStringIndex;
+  if (type == Dart_Timeline_Event_End) {
+    if (state.open_scopes.empty()) {
+      return;
+    }
+    const bool recorded = state.open_scopes.back();
+    state.open_scopes.pop_back();
+    if (!recorded) {
+      return;
+    }
+  } else {
+    if (GetPhase(type) == nullptr || category == nullptr) {
+      return;
+    }
+    category_index = InternCategory(state, category);
+    const uint64_t mask =
+        enabled_category_mask_.load(std::memory_order_relaxed);
+    const bool enabled = (mask >> category_index) & 1;
+    if (type == Dart_Timeline_Event_Begin) {
+      state.open_scopes.push_back(enabled);
+    }
+    if (!enabled) {
+      return;
+    }
+  }
+
+  if (timestamp_micros < 0) {
+    timestamp_micros = TimePoint::Now().ToEpochDelta().ToMicroseconds();
+  }
+
+  if (!state.buffer) {
+    state.buffer = AcquireBuffer(state.thread_name);
+  }
+
+  const uint16_t name_index = InternName(state, name);
+  ThreadBuffer& buffer = *state.buffer;
+  const uint64_t count = buffer.write_count.load(std::memory_order_relaxed);
+  Slot& slot = buffer.slots[count % kEventsPerThread];
+  slot.header.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.timestamp_micros.store(timestamp_micros, std::memory_order_relaxed);
+  slot.id.store(id, std::memory_order_relaxed);
+  slot.header.store(PackSlotHeader(count, name_index, category_index, type),
+                    std::memory_order_release);
+  buffer.write_count.store(count + 1, std::memory_order_release);
+}
+
+std::shared_ptr<TraceRecorder::ThreadBuffer> TraceRecorder::AcquireBuffer(
+    const std::string& thread_name) {
+  std::scoped_lock lock(mutex_);
+  std::shared_ptr<ThreadBuffer> buffer;
+  if (free_buffers_.empty()) {
+    buffer = std::make_shared<ThreadBuffer>(next_thread_index_++);
+    buffers_.push_back(buffer);
+  } else {
+    // Reuse the buffer of the thread that exited most recently. Its events are
+    // discarded rather than attributed to this thread.
+    buffer = std::move(free_buffers_.back());
+    free_buffers_.pop_back();
+    buffer->clear_count.store(
+        buffer->write_count.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    buffer->thread_index = next_thread_index_++;
+  }
+  buffer->thread_name = thread_name;
+  return buffer;
+}
+
+void TraceRecorder::ReleaseBuffer(std::shared_ptr<ThreadBuffer> buffer) {
+  std::scoped_lock lock(mutex_);
+  free_buffers_.push_back(std::move(buffer));
+}
+
+void TraceRecorder::SetCurrentThreadName(const std::string& name) {
+  ThreadState& state = GetThreadState();
+  state.thread_name = name;
+  if (state.buffer) {
+    std::scoped_lock lock(mutex_);
+    state.buffer->thread_name = name;
+  }
+}
+
+std::string TraceRecorder::ExportChromeJSON() const {
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  std::vector<uint32_t> thread_indices;
+  std::vector<std::string> thread_names;
+  std::vector<const std::string*> names;
+  std::vector<const std::string*> categories;
+  {
+    std::scoped_lock lock(mutex_);
+    buffers = buffers_;
+    for (const auto& buffer : buffers_) {
+      thread_indices.push_back(buffer->thread_index);
+      thread_names.push_back(buffer->thread_name);
+    }
+    for (const auto& name : names_.strings) {
+      names.push_back(name.get());
+    }
+    for (const auto& category : categories_.strings) {
+      categories.push_back(category.get());
+    }
+  }
+
+  std::string out = "{\"traceEvents\":[";
+  bool first = true;
+  auto begin_event = [&]() {
+    if (!first) {
+      out.push_back(',');
+    }
+    first = false;
+  };
+
+  char number[128];
+  for (size_t i = 0; i < buffers.size(); i++) {
+    const ThreadBuffer& buffer = *buffers[i];
+    const uint32_t thread_index = thread_indices[i];
+
+    if (!thread_names[i].empty()) {
+      begin_event();
+      snprintf(number, sizeof(number),
+               "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,"
+               "\"args\":{\"name\":",
+               thread_index);
+      out.append(number);
+      AppendJSONString(out, thread_names[i]);
+      out.append("}}");
+    }
+
+    // The owning thread may overwrite the oldest events while they are being
+    // read. Such slots no longer carry the header of the expected write and
+    // are skipped.
+    const uint64_t end = buffer.write_count.load(std::memory_order_acquire);
+    const uint64_t begin =
+        std::max(end > kEventsPerThread ? end - kEventsPerThread : 0,
+                 buffer.clear_count.load(std::memory_order_relaxed));
+
+    for (uint64_t n = begin; n < end; n++) {
+      const Slot& slot = buffer.slots[n % kEventsPerThread];
+      const uint64_t header = slot.header.load(std::memory_order_acquire);
+      if (!IsSlotHeaderOfWrite(header, n)) {
+        continue;
+      }
+      const int64_t timestamp_micros =
+          slot.timestamp_micros.load(std::memory_order_relaxed);
+      const int64_t id = slot.id.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.header.load(std::memory_order_relaxed) != header) {
+        continue;
+      }
+
+      const uint16_t name = header & 0xffff;
+      const uint16_t category = (header >> 16) & 0xff;
+      const int32_t type = (header >> 24) & 0x7f;
+      const char* phase = GetPhase(type);
+      if (phase == nullptr || name >= names.size() ||
+          category >= categories.size()) {
+        continue;
+      }
+      begin_event();
+      out.append("{\"name\":");
+      AppendJSONString(out, *names[name]);
+      out.append(",\"cat\":");
+      AppendJSONString(out, *categories[category]);
+      snprintf(number, sizeof(number),
+               ",\"ph\":\"%s\",\"ts\":%" PRId64 ",\"pid\":0,\"tid\":%u", phase,
+               timestamp_micros, thread_index);
+      out.append(number);
+      if (HasID(type)) {
+        snprintf(number, sizeof(number), ",\"id\":\"0x%" PRIx64 "\"",
+                 static_cast<uint64_t>(id));
+        out.append(number);
+      }
+      if (type == Dart_Timeline_Event_Instant) {
+        out.append(",\"s\":\"t\"");
+      } else if (type == Dart_Timeline_Event_Flow_End) {
+        out.append(",\"bp\":\"e\"");
+      }
+      out.push_back('}');
+    }
+  }
+
+  out.append("]}");
+  return out;
+}
+
+void TraceRecorder::Clear() {
+  std::scoped_lock lock(mutex_);
+  for (const auto& buffer : buffers_) {
+    buffer->clear_count.store(
+        buffer->write_count.load(std::memory_order_acquire),
+        std::memory_order_relaxed);
+  }
+}
+
+TraceRecorder::ThreadState& TraceRecorder::GetThreadState() {
+  FML_THREAD_LOCAL ThreadLocalUniquePtr<ThreadState> tls_state;
+
+  ThreadState* state = tls_state.get();
+  if (state != nullptr) {
+    return *state;
+  }
+
+  state = new ThreadState();
+  state->generation = generation_.load(std::memory_order_relaxed);
+  tls_state.reset(state);
+  return *state;
+}
+
+uint16_t TraceRecorder::InternName(ThreadState& state, const char* name) {
+  auto found = state.names.find(name);
+  if (found != state.names.end() && *found->second.interned == name) {
+    return found->second.index;
+  }
+
+  const std::string* interned = nullptr;
+  uint16_t index;
+  {
+    std::scoped_lock lock(mutex_);
+    index = InternLocked(names_, kMaxNames, name, &interned);
+  }
+  if (interned != nullptr) {
+    state.names[name] = {index, interned};
+  }
+  return index;
+}
+
+uint16_t TraceRecorder::InternCategory(ThreadState& state,
+                                       const char* category) {
+  auto found = state.categories.find(category);
+  if (found != state.categories.end() &&
+      *found->second.interned == category) {
+    return found->second.index;
+  }
+
+  const std::string* interned = nullptr;
+  uint16_t index;
+  {
+    std::scoped_lock lock(mutex_);
+    const size_t size = categories_.strings.size();
+    index = InternLocked(categories_, kMaxCategories, category, &interned);
+    if (categories_.strings.size() != size &&
+        IsCategoryEnabledLocked(*interned)) {
+      enabled_category_mask_.fetch_or(uint64_t{1} << index,
+                                      std::memory_order_relaxed);
+    }
+  }
+  if (interned != nullptr) {
+    state.categories[category] = {index, interned};
+  }
+  return index;
+}
+
+uint16_t TraceRecorder::InternLocked(InternTable& table,
+                                     size_t max_size,
+                                     const char* string,
+                                     const std::string** interned) {
+  auto found = table.indices.find(string);
+  if (found != table.indices.end()) {
+    *interned = table.strings[found->second].get();
+    return found->second;
+  }
+  if (table.strings.size() >= max_size) {
+    // Not cached by the caller so that the string is not confused with the
+    // empty string.
+    *interned = nullptr;
+    return kEmptyStringIndex;
+  }
+  const uint16_t index = table.strings.size();
+  table.strings.push_back(std::make_unique<std::string>(string));
+  table.indices[*table.strings.back()] = index;
+  *interned = table.strings.back().get();
+  return index;
+}
+
+bool TraceRecorder::IsCategoryEnabledLocked(const std::string& category) const {
+  if (category.empty()) {
+    return false;
+  }
+  for (const auto& enabled : enabled_categories_) {
+    if (enabled == kAllCategories || enabled == category) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace tracing
+}  // namespace fml
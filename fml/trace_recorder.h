@@ -0,0 +1,185 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_TRACE_RECORDER_H_
+#define FLUTTER_FML_TRACE_RECORDER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "third_party/dart/runtime/include/dart_tools_api.h"
+
+namespace fml {
+namespace tracing {
+
+//------------------------------------------------------------------------------
+/// @brief      An in-process recorder for the events of the `TRACE_EVENT*`
+///             and `TRACE_FLOW*` macros that does not depend on the Dart VM
+///             timeline and is available in release builds.
+///
+///             Each thread records into its own fixed size ring buffer without
+///             taking locks, so the most recent events are always available.
+///             Event names and categories are interned and arguments are not
+///             recorded, so every event is a small fixed size record. The
+///             buffer of a thread that exits is kept for export until a new
+///             thread reuses it, so memory is bounded by the peak number of
+///             threads that recorded events at the same time.
+///
+///             Recording is off until a category is enabled via
+///             `SetEnabledCategories`. While it is off, each trace event costs
+///             a single relaxed atomic load.
+///
+///             The recorded events can be exported at any time in the Chrome
+///             JSON trace event format, which is understood by both
+///             chrome://tracing and the Perfetto UI.
+///
+class TraceRecorder {
+ public:
+  // The number of events retained per thread.
+  static constexpr size_t kEventsPerThread = 16384;
+
+  // The maximum number of distinct categories that can be enabled.
+  static constexpr size_t kMaxCategories = 64;
+
+  // The category that enables recording of all categories.
+  static constexpr const char* kAllCategories = "*";
+
+  static TraceRecorder& GetInstance();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether any category is enabled. This is the only check made
+  ///             on the fast path of every trace event.
+  ///
+  static bool IsRecording() {
+    return recording_.load(std::memory_order_relaxed);
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Set the categories whose events are recorded. An empty list
+  ///             stops recording. Already recorded events are kept.
+  ///
+  void SetEnabledCategories(const std::vector<std::string>& categories);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Record an event on the current thread if its category is
+  ///             enabled. End events are recorded if the matching begin event
+  ///             on the same thread was.
+  ///
+  /// @param[in]  category          The category of the event. May be null for
+  ///                               end events.
+  /// @param[in]  name              The name of the event.
+  /// @param[in]  timestamp_micros  The time of the event, or -1 for now.
+  /// @param[in]  id                The async or flow identifier, if any.
+  /// @param[in]  type              The type of the event. Only begin, end,
+  ///                               instant, async and flow events are
+  ///                               recorded.
+  ///
+  void Record(const char* category,
+              const char* name,
+              int64_t timestamp_micros,
+              int64_t id,
+              Dart_Timeline_Event_Type type);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Name the current thread in exported traces.
+  ///
+  void SetCurrentThreadName(const std::string& name);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Export the recorded events of all threads in the Chrome JSON
+  ///             trace event format. This may be called from any thread while
+  ///             events are being recorded.
+  ///
+  std::string ExportChromeJSON() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Discard all recorded events.
+  ///
+  void Clear();
+
+ private:
+  // An event in a ring buffer. Slots are read while the owning thread may be
+  // overwriting them, so each slot is a sequence lock: the header is cleared
+  // before the other fields are written and then stores the packed name,
+  // category and type along with the number of the write. Readers discard
+  // slots whose header is not the same before and after reading the fields.
+  struct Slot {
+    std::atomic<int64_t> timestamp_micros;
+    std::atomic<int64_t> id;
+    std::atomic<uint64_t> header;
+  };
+
+  struct ThreadBuffer {
+    explicit ThreadBuffer(uint32_t thread_index);
+
+    std::unique_ptr<Slot[]> slots;
+    // The total number of events ever written. Only the owning thread writes
+    // to |slots| and stores to this.
+    std::atomic<uint64_t> write_count;
+    // Events before this count have been discarded by |Clear| or by the reuse
+    // of the buffer.
+    std::atomic<uint64_t> clear_count;
+    // Guarded by |TraceRecorder::mutex_|.
+    uint32_t thread_index;
+    // Guarded by |TraceRecorder::mutex_|.
+    std::string thread_name;
+  };
+
+  struct ThreadState;
+
+  // Interned strings are never freed, so references to them stay valid.
+  struct InternTable {
+    std::unordered_map<std::string, uint16_t> indices;
+    std::vector<std::unique_ptr<std::string>> strings;
+  };
+
+  static std::atomic<bool> recording_;
+
+  mutable std::mutex mutex_;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+  // The buffers of exited threads, in the order the threads exited.
+  std::vector<std::shared_ptr<ThreadBuffer>> free_buffers_;
+  uint32_t next_thread_index_ = 0;
+  InternTable names_;
+  InternTable categories_;
+  std::vector<std::string> enabled_categories_;
+  std::atomic<uint64_t> enabled_category_mask_;
+  // Incremented whenever the enabled categories change so threads can discard
+  // their record of open scopes.
+  std::atomic<uint32_t> generation_;
+
+  TraceRecorder();
+
+  ~TraceRecorder();
+
+  ThreadState& GetThreadState();
+
+  std::shared_ptr<ThreadBuffer> AcquireBuffer(const std::string& thread_name);
+
+  void ReleaseBuffer(std::shared_ptr<ThreadBuffer> buffer);
+
+  uint16_t InternName(ThreadState& state, const char* name);
+
+  uint16_t InternCategory(ThreadState& state, const char* category);
+
+  static uint16_t InternLocked(InternTable& table,
+                               size_t max_size,
+                               const char* string,
+                               const std::string** interned);
+
+  bool IsCategoryEnabledLocked(const std::string& category) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TraceRecorder);
+};
+
+}  // namespace tracing
+}  // namespace fml
+
+#endif  // FLUTTER_FML_TRACE_RECORDER_H_
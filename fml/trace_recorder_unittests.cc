@@ -0,0 +1,168 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "flutter/fml/trace_recorder.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace tracing {
+namespace testing {
+
+namespace {
+
+size_t CountOccurrences(const std::string& haystack,
+                        const std::string& needle) {
+  size_t count = 0;
+  for (size_t pos = haystack.find(needle); pos != std::string::npos;
+       pos = haystack.find(needle, pos + needle.size())) {
+    count++;
+  }
+  return count;
+}
+
+class TraceRecorderTest : public ::testing::Test {
+ protected:
+  void SetUp() override { Reset(); }
+
+  void TearDown() override { Reset(); }
+
+  static void Reset() {
+    auto& recorder = TraceRecorder::GetInstance();
+    recorder.SetEnabledCategories({});
+    recorder.Clear();
+  }
+};
+
+}  // namespace
+
+TEST_F(TraceRecorderTest, DoesNotRecordWhenNoCategoryIsEnabled) {
+  auto& recorder = TraceRecorder::GetInstance();
+  ASSERT_FALSE(TraceRecorder::IsRecording());
+  recorder.Record("test", "NotRecorded", 1, 0, Dart_Timeline_Event_Instant);
+  ASSERT_EQ(recorder.ExportChromeJSON().find("NotRecorded"),
+            std::string::npos);
+}
+
+TEST_F(TraceRecorderTest, RecordsOnlyEnabledCategories) {
+  auto& recorder = TraceRecorder::GetInstance();
+  recorder.SetEnabledCategories({"enabled"});
+  ASSERT_TRUE(TraceRecorder::IsRecording());
+
+  recorder.Record("enabled", "Scope", 10, 0, Dart_Timeline_Event_Begin);
+  recorder.Record("disabled", "Hidden", 11, 0, Dart_Timeline_Event_Begin);
+  recorder.Record(nullptr, "Hidden", 12, 0, Dart_Timeline_Event_End);
+  recorder.Record(nullptr, "Scope", 13, 0, Dart_Timeline_Event_End);
+
+  const auto json = recorder.ExportChromeJSON();
+  ASSERT_EQ(json.find("Hidden"), std::string::npos);
+  ASSERT_NE(json.find("{\"name\":\"Scope\",\"cat\":\"enabled\",\"ph\":\"B\","
+                      "\"ts\":10"),
+            std::string::npos);
+  ASSERT_NE(json.find("{\"name\":\"Scope\",\"cat\":\"\",\"ph\":\"E\","
+                      "\"ts\":13"),
+            std::string::npos);
+}
+
+TEST_F(TraceRecorderTest, WildcardEnablesAllCategories) {
+  auto& recorder = TraceRecorder::GetInstance();
+  recorder.SetEnabledCategories({TraceRecorder::kAllCategories});
+  recorder.Record("any", "Flow", 20, 0xabc, Dart_Timeline_Event_Flow_End);
+
+  const auto json = recorder.ExportChromeJSON();
+  ASSERT_NE(json.find("\"ph\":\"f\",\"ts\":20"), std::string::npos);
+  ASSERT_NE(json.find("\"id\":\"0xabc\",\"bp\":\"e\""), std::string::npos);
+}
+
+TEST_F(TraceRecorderTest, RetainsOnlyTheMostRecentEvents) {
+  auto& recorder = TraceRecorder::GetInstance();
+  recorder.SetEnabledCategories({"ring"});
+
+  std::thread thread([&recorder]() {
+    recorder.Record("ring", "Oldest", 1, 0, Dart_Timeline_Event_Instant);
+    for (size_t i = 0; i < TraceRecorder::kEventsPerThread; i++) {
+      recorder.Record("ring", "Recent", 2, 0, Dart_Timeline_Event_Instant);
+    }
+  });
+  thread.join();
+
+  const auto json = recorder.ExportChromeJSON();
+  ASSERT_EQ(json.find("Oldest"), std::string::npos);
+  ASSERT_EQ(CountOccurrences(json, "\"Recent\""),
+            TraceRecorder::kEventsPerThread);
+}
+
+TEST_F(TraceRecorderTest, ExportsOnlyIntactEventsWhileRecording) {
+  auto& recorder = TraceRecorder::GetInstance();
+  recorder.SetEnabledCategories({"concurrent"});
+
+  std::atomic<bool> done = false;
+  std::thread thread([&recorder, &done]() {
+    for (size_t i = 0; i < 4 * TraceRecorder::kEventsPerThread; i++) {
+      recorder.Record("concurrent", "Written", 1, 0,
+                      Dart_Timeline_Event_Instant);
+    }
+    done = true;
+  });
+  while (!done) {
+    const auto json = recorder.ExportChromeJSON();
+    ASSERT_EQ(CountOccurrences(json, "{\"name\":\"Written\""),
+              CountOccurrences(json, "\"ph\":\"i\",\"ts\":1,"));
+  }
+  thread.join();
+}
+
+TEST_F(TraceRecorderTest, ClearDiscardsRecordedEvents) {
+  auto& recorder = TraceRecorder::GetInstance();
+  recorder.SetEnabledCategories({"clear"});
+  recorder.Record("clear", "Before", 1, 0, Dart_Timeline_Event_Instant);
+  recorder.Clear();
+  recorder.Record("clear", "After", 2, 0, Dart_Timeline_Event_Instant);
+
+  const auto json = recorder.ExportChromeJSON();
+  ASSERT_EQ(json.find("Before"), std::string::npos);
+  ASSERT_NE(json.find("After"), std::string::npos);
+}
+
+TEST_F(TraceRecorderTest, ExportsThreadNames) {
+  auto& recorder = TraceRecorder::GetInstance();
+  recorder.SetEnabledCategories({"names"});
+
+  std::thread thread([&recorder]() {
+    recorder.SetCurrentThreadName("recorder \"test\" thread");
+    recorder.Record("names", "Named", 1, 0, Dart_Timeline_Event_Instant);
+  });
+  thread.join();
+
+  const auto json = recorder.ExportChromeJSON();
+  ASSERT_NE(json.find("\"args\":{\"name\":\"recorder \\\"test\\\" thread\"}"),
+            std::string::npos);
+}
+
+TEST_F(TraceRecorderTest, ReusesTheBuffersOfExitedThreads) {
+  auto& recorder = TraceRecorder::GetInstance();
+  recorder.SetEnabledCategories({"reuse"});
+
+  std::thread exited([&recorder]() {
+    recorder.Record("reuse", "Exited", 1, 0, Dart_Timeline_Event_Instant);
+  });
+  exited.join();
+  ASSERT_NE(recorder.ExportChromeJSON().find("Exited"), std::string::npos);
+
+  std::thread reusing([&recorder]() {
+    recorder.Record("reuse", "Reusing", 2, 0, Dart_Timeline_Event_Instant);
+  });
+  reusing.join();
+
+  const auto json = recorder.ExportChromeJSON();
+  ASSERT_EQ(json.find("Exited"), std::string::npos);
+  ASSERT_NE(json.find("Reusing"), std::string::npos);
+}
+
+}  // namespace testing
+}  // namespace tracing
+}  // namespace fml
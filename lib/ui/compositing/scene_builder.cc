@@ -81,10 +81,10 @@ void SceneBuilder::RegisterNatives(tonic::DartLibraryNatives* natives) {
   });
 }
 
-SceneBuilder::SceneBuilder() {
+SceneBuilder::SceneBuilder() : arena_(fml::MakeRefCounted<LayerArena>()) {
   // Add a ContainerLayer as the root layer, so that AddLayer operations are
   // always valid.
-  PushLayer(std::make_shared<flutter::ContainerLayer>());
+  PushLayer(arena_->MakeShared<flutter::ContainerLayer>());
 }
 
 SceneBuilder::~SceneBuilder() = default;
@@ -92,7 +92,7 @@ SceneBuilder::~SceneBuilder() = default;
 void SceneBuilder::pushTransform(Dart_Handle layer_handle,
                                  tonic::Float64List& matrix4) {
   SkMatrix sk_matrix = ToSkMatrix(matrix4);
-  auto layer = std::make_shared<flutter::TransformLayer>(sk_matrix);
+  auto layer = arena_->MakeShared<flutter::TransformLayer>(sk_matrix);
   PushLayer(layer);
   // matrix4 has to be released before we can return another Dart object
   matrix4.Release();
@@ -101,7 +101,7 @@ void SceneBuilder::pushTransform(Dart_Handle layer_handle,
 
 void SceneBuilder::pushOffset(Dart_Handle layer_handle, double dx, double dy) {
   SkMatrix sk_matrix = SkMatrix::MakeTrans(dx, dy);
-  auto layer = std::make_shared<flutter::TransformLayer>(sk_matrix);
+  auto layer = arena_->MakeShared<flutter::TransformLayer>(sk_matrix);
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 }
@@ -115,7 +115,7 @@ void SceneBuilder::pushClipRect(Dart_Handle layer_handle,
   SkRect clipRect = SkRect::MakeLTRB(left, top, right, bottom);
   flutter::Clip clip_behavior = static_cast<flutter::Clip>(clipBehavior);
   auto layer =
-      std::make_shared<flutter::ClipRectLayer>(clipRect, clip_behavior);
+      arena_->MakeShared<flutter::ClipRectLayer>(clipRect, clip_behavior);
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 }
@@ -124,8 +124,8 @@ void SceneBuilder::pushClipRRect(Dart_Handle layer_handle,
                                  const RRect& rrect,
                                  int clipBehavior) {
   flutter::Clip clip_behavior = static_cast<flutter::Clip>(clipBehavior);
-  auto layer =
-      std::make_shared<flutter::ClipRRectLayer>(rrect.sk_rrect, clip_behavior);
+  auto layer = arena_->MakeShared<flutter::ClipRRectLayer>(rrect.sk_rrect,
+                                                           clip_behavior);
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 }
@@ -136,7 +136,7 @@ void SceneBuilder::pushClipPath(Dart_Handle layer_handle,
   flutter::Clip clip_behavior = static_cast<flutter::Clip>(clipBehavior);
   FML_DCHECK(clip_behavior != flutter::Clip::none);
   auto layer =
-      std::make_shared<flutter::ClipPathLayer>(path->path(), clip_behavior);
+      arena_->MakeShared<flutter::ClipPathLayer>(path->path(), clip_behavior);
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 }
@@ -146,7 +146,7 @@ void SceneBuilder::pushOpacity(Dart_Handle layer_handle,
                                double dx,
                                double dy) {
   auto layer =
-      std::make_shared<flutter::OpacityLayer>(alpha, SkPoint::Make(dx, dy));
+      arena_->MakeShared<flutter::OpacityLayer>(alpha, SkPoint::Make(dx, dy));
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 }
@@ -154,7 +154,7 @@ void SceneBuilder::pushOpacity(Dart_Handle layer_handle,
 void SceneBuilder::pushColorFilter(Dart_Handle layer_handle,
                                    const ColorFilter* color_filter) {
   auto layer =
-      std::make_shared<flutter::ColorFilterLayer>(color_filter->filter());
+      arena_->MakeShared<flutter::ColorFilterLayer>(color_filter->filter());
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 }
@@ -162,14 +162,15 @@ void SceneBuilder::pushColorFilter(Dart_Handle layer_handle,
 void SceneBuilder::pushImageFilter(Dart_Handle layer_handle,
                                    const ImageFilter* image_filter) {
   auto layer =
-      std::make_shared<flutter::ImageFilterLayer>(image_filter->filter());
+      arena_->MakeShared<flutter::ImageFilterLayer>(image_filter->filter());
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 }
 
 void SceneBuilder::pushBackdropFilter(Dart_Handle layer_handle,
                                       ImageFilter* filter) {
-  auto layer = std::make_shared<flutter::BackdropFilterLayer>(filter->filter());
+  auto layer =
+      arena_->MakeShared<flutter::BackdropFilterLayer>(filter->filter());
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
 }
@@ -183,7 +184,7 @@ void SceneBuilder::pushShaderMask(Dart_Handle layer_handle,
                                   int blendMode) {
   SkRect rect = SkRect::MakeLTRB(maskRectLeft, maskRectTop, maskRectRight,
                                  maskRectBottom);
-  auto layer = std::make_shared<flutter::ShaderMaskLayer>(
+  auto layer = arena_->MakeShared<flutter::ShaderMaskLayer>(
       shader->shader(), rect, static_cast<SkBlendMode>(blendMode));
   PushLayer(layer);
   EngineLayer::MakeRetained(layer_handle, layer);
@@ -195,7 +196,7 @@ void SceneBuilder::pushPhysicalShape(Dart_Handle layer_handle,
                                      int color,
                                      int shadow_color,
                                      int clipBehavior) {
-  auto layer = std::make_shared<flutter::PhysicalShapeLayer>(
+  auto layer = arena_->MakeShared<flutter::PhysicalShapeLayer>(
       static_cast<SkColor>(color), static_cast<SkColor>(shadow_color),
       static_cast<float>(elevation), path->path(),
       static_cast<flutter::Clip>(clipBehavior));
@@ -218,7 +219,7 @@ void SceneBuilder::addPicture(double dx,
   SkPoint offset = SkPoint::Make(dx, dy);
   SkRect pictureRect = picture->picture()->cullRect();
   pictureRect.offset(offset.x(), offset.y());
-  auto layer = std::make_unique<flutter::PictureLayer>(
+  auto layer = arena_->MakeShared<flutter::PictureLayer>(
       offset, UIDartState::CreateGPUObject(picture->picture()), !!(hints & 1),
       !!(hints & 2));
   AddLayer(std::move(layer));
@@ -230,7 +231,7 @@ void SceneBuilder::addTexture(double dx,
                               double height,
                               int64_t textureId,
                               bool freeze) {
-  auto layer = std::make_unique<flutter::TextureLayer>(
+  auto layer = arena_->MakeShared<flutter::TextureLayer>(
       SkPoint::Make(dx, dy), SkSize::Make(width, height), textureId, freeze);
   AddLayer(std::move(layer));
 }
@@ -240,7 +241,7 @@ void SceneBuilder::addPlatformView(double dx,
                                    double width,
                                    double height,
                                    int64_t viewId) {
-  auto layer = std::make_unique<flutter::PlatformViewLayer>(
+  auto layer = arena_->MakeShared<flutter::PlatformViewLayer>(
       SkPoint::Make(dx, dy), SkSize::Make(width, height), viewId);
   AddLayer(std::move(layer));
 }
@@ -252,7 +253,7 @@ void SceneBuilder::addChildScene(double dx,
                                  double height,
                                  SceneHost* sceneHost,
                                  bool hitTestable) {
-  auto layer = std::make_unique<flutter::ChildSceneLayer>(
+  auto layer = arena_->MakeShared<flutter::ChildSceneLayer>(
       sceneHost->id(), SkPoint::Make(dx, dy), SkSize::Make(width, height),
       hitTestable);
   AddLayer(std::move(layer));
@@ -266,7 +267,7 @@ void SceneBuilder::addPerformanceOverlay(uint64_t enabledOptions,
                                          double bottom) {
   SkRect rect = SkRect::MakeLTRB(left, top, right, bottom);
   auto layer =
-      std::make_unique<flutter::PerformanceOverlayLayer>(enabledOptions);
+      arena_->MakeShared<flutter::PerformanceOverlayLayer>(enabledOptions);
   layer->set_paint_bounds(rect);
   AddLayer(std::move(layer));
 }
@@ -10,6 +10,7 @@
 #include <memory>
 #include <vector>
 
+#include "flutter/flow/layer_arena.h"
 #include "flutter/flow/layers/container_layer.h"
 #include "flutter/lib/ui/compositing/scene.h"
 #include "flutter/lib/ui/dart_wrapper.h"
@@ -124,6 +125,9 @@ class SceneBuilder : public RefCountedDartWrappable<SceneBuilder> {
   void PushLayer(std::shared_ptr<ContainerLayer> layer);
   void PopLayer();
 
+  // The layers of the scene are allocated together. Layers retained for later
+  // scenes keep only the arena blocks they were allocated from alive.
+  fml::RefPtr<LayerArena> arena_;
   std::vector<std::shared_ptr<ContainerLayer>> layer_stack_;
   int rasterizer_tracing_threshold_ = 0;
   bool checkerboard_raster_cache_images_ = false;
@@ -6,42 +6,76 @@
 
 namespace flutter {
 
-IsolateNameServer::IsolateNameServer() {}
+IsolateNameServer::LookupCache::LookupCache() = default;
+
+IsolateNameServer::LookupCache::~LookupCache() = default;
+
+IsolateNameServer::IsolateNameServer()
+    : port_mapping_(std::make_shared<PortMapping>()) {}
 
 IsolateNameServer::~IsolateNameServer() = default;
 
+std::shared_ptr<const IsolateNameServer::PortMapping>
+IsolateNameServer::GetPortMapping() const {
+  return std::atomic_load_explicit(&port_mapping_, std::memory_order_acquire);
+}
+
 Dart_Port IsolateNameServer::LookupIsolatePortByName(const std::string& name) {
-  std::scoped_lock lock(mutex_);
-  return LookupIsolatePortByNameUnprotected(name);
+  auto port_mapping = GetPortMapping();
+  auto port_iterator = port_mapping->find(name);
+  if (port_iterator != port_mapping->end()) {
+    return port_iterator->second;
+  }
+  return ILLEGAL_PORT;
 }
 
-Dart_Port IsolateNameServer::LookupIsolatePortByNameUnprotected(
-    const std::string& name) {
-  auto port_iterator = port_mapping_.find(name);
-  if (port_iterator != port_mapping_.end()) {
+Dart_Port IsolateNameServer::LookupIsolatePortByName(const std::string& name,
+                                                     LookupCache* cache) {
+  // Changes are published before the version is incremented, so the cached
+  // snapshot is current as long as the version is unchanged.
+  const uint64_t version = version_.load(std::memory_order_acquire);
+  if (cache->version_ != version) {
+    cache->port_mapping_ = GetPortMapping();
+    cache->version_ = version;
+  }
+
+  auto port_iterator = cache->port_mapping_->find(name);
+  if (port_iterator != cache->port_mapping_->end()) {
     return port_iterator->second;
   }
   return ILLEGAL_PORT;
 }
 
+void IsolateNameServer::SetPortMapping(
+    std::shared_ptr<const PortMapping> port_mapping) {
+  std::atomic_store_explicit(&port_mapping_, std::move(port_mapping),
+                             std::memory_order_release);
+  version_.fetch_add(1, std::memory_order_release);
+}
+
 bool IsolateNameServer::RegisterIsolatePortWithName(Dart_Port port,
                                                     const std::string& name) {
   std::scoped_lock lock(mutex_);
-  if (LookupIsolatePortByNameUnprotected(name) != ILLEGAL_PORT) {
+  auto port_mapping = GetPortMapping();
+  if (port_mapping->count(name) != 0) {
     // Name is already registered.
     return false;
   }
-  port_mapping_[name] = port;
+  auto new_port_mapping = std::make_shared<PortMapping>(*port_mapping);
+  new_port_mapping->emplace(name, port);
+  SetPortMapping(std::move(new_port_mapping));
   return true;
 }
 
 bool IsolateNameServer::RemoveIsolateNameMapping(const std::string& name) {
   std::scoped_lock lock(mutex_);
-  auto port_iterator = port_mapping_.find(name);
-  if (port_iterator == port_mapping_.end()) {
+  auto port_mapping = GetPortMapping();
+  if (port_mapping->count(name) == 0) {
     return false;
   }
-  port_mapping_.erase(port_iterator);
+  auto new_port_mapping = std::make_shared<PortMapping>(*port_mapping);
+  new_port_mapping->erase(name);
+  SetPortMapping(std::move(new_port_mapping));
   return true;
 }
 
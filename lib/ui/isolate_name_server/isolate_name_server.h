@@ -5,17 +5,48 @@
 #ifndef FLUTTER_LIB_UI_ISOLATE_NAME_SERVER_H_
 #define FLUTTER_LIB_UI_ISOLATE_NAME_SERVER_H_
 
-#include <map>
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 
 #include "flutter/fml/macros.h"
 #include "third_party/dart/runtime/include/dart_api.h"
 
 namespace flutter {
 
+// Maps names to the ports of the isolates that registered them.
+//
+// Lookups are far more frequent than changes, so lookups read an immutable
+// snapshot of the mapping, and changes copy the mapping and publish a new
+// snapshot. Isolates keep the last snapshot they saw in a LookupCache, so
+// that their lookups only read a version number shared with other isolates.
 class IsolateNameServer {
+ private:
+  using PortMapping = std::unordered_map<std::string, Dart_Port>;
+
  public:
+  // Holds on to the snapshot of the mapping last seen by a single isolate,
+  // so that its lookups don't touch any state shared with other isolates
+  // until the mapping changes.
+  //
+  // A cache is not thread safe, and must only be used with one name server.
+  class LookupCache {
+   public:
+    LookupCache();
+
+    ~LookupCache();
+
+   private:
+    friend class IsolateNameServer;
+
+    uint64_t version_ = 0;
+    std::shared_ptr<const PortMapping> port_mapping_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(LookupCache);
+  };
+
   IsolateNameServer();
 
   ~IsolateNameServer();
@@ -24,6 +55,12 @@ class IsolateNameServer {
   // if the name does not exist.
   Dart_Port LookupIsolatePortByName(const std::string& name);
 
+  // Looks up the Dart_Port associated with a given name in the snapshot held
+  // by |cache|, which is updated if the mapping changed. Returns ILLEGAL_PORT
+  // if the name does not exist.
+  Dart_Port LookupIsolatePortByName(const std::string& name,
+                                    LookupCache* cache);
+
   // Registers a Dart_Port with a given name. Returns true if registration is
   // successful, false if the name entry already exists.
   bool RegisterIsolatePortWithName(Dart_Port port, const std::string& name);
@@ -33,10 +70,16 @@ class IsolateNameServer {
   bool RemoveIsolateNameMapping(const std::string& name);
 
  private:
-  Dart_Port LookupIsolatePortByNameUnprotected(const std::string& name);
+  std::shared_ptr<const PortMapping> GetPortMapping() const;
+
+  void SetPortMapping(std::shared_ptr<const PortMapping> port_mapping);
 
+  // Serializes changes. Lookups don't take it.
   mutable std::mutex mutex_;
-  std::map<std::string, Dart_Port> port_mapping_;
+  // Only accessed with the std::atomic_* functions for shared_ptr.
+  std::shared_ptr<const PortMapping> port_mapping_;
+  // Incremented after each change is published, to invalidate caches.
+  std::atomic<uint64_t> version_ = {1};
 
   FML_DISALLOW_COPY_AND_ASSIGN(IsolateNameServer);
 };
@@ -0,0 +1,92 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/lib/ui/isolate_name_server/isolate_name_server.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr size_t kNameCount = 64;
+
+const std::vector<std::string>& GetNames() {
+  static const std::vector<std::string> names = []() {
+    std::vector<std::string> names;
+    for (size_t i = 0; i < kNameCount; i++) {
+      names.push_back("background_isolate_port_" + std::to_string(i));
+    }
+    return names;
+  }();
+  return names;
+}
+
+// Shared by all the threads of a benchmark, like the name server of a VM is
+// shared by all its isolates.
+IsolateNameServer& GetNameServer() {
+  static IsolateNameServer* name_server = []() {
+    auto* name_server = new IsolateNameServer();
+    const auto& names = GetNames();
+    for (size_t i = 0; i < names.size(); i++) {
+      name_server->RegisterIsolatePortWithName(i + 1, names[i]);
+    }
+    return name_server;
+  }();
+  return *name_server;
+}
+
+}  // namespace
+
+static void BM_IsolateNameServerLookup(benchmark::State& state) {
+  auto& name_server = GetNameServer();
+  const auto& names = GetNames();
+  size_t i = state.thread_index;
+  while (state.KeepRunning()) {
+    auto port = name_server.LookupIsolatePortByName(names[i++ % kNameCount]);
+    benchmark::DoNotOptimize(port);
+  }
+}
+
+static void BM_IsolateNameServerLookupCached(benchmark::State& state) {
+  auto& name_server = GetNameServer();
+  const auto& names = GetNames();
+  IsolateNameServer::LookupCache cache;
+  size_t i = state.thread_index;
+  while (state.KeepRunning()) {
+    auto port =
+        name_server.LookupIsolatePortByName(names[i++ % kNameCount], &cache);
+    benchmark::DoNotOptimize(port);
+  }
+}
+
+// One thread repeatedly registers and removes a name while the others look
+// up names, so that their caches keep being invalidated.
+static void BM_IsolateNameServerLookupCachedWithRemovals(
+    benchmark::State& state) {
+  auto& name_server = GetNameServer();
+  const auto& names = GetNames();
+  IsolateNameServer::LookupCache cache;
+  size_t i = state.thread_index;
+  while (state.KeepRunning()) {
+    if (state.thread_index == 0 && state.threads > 1) {
+      name_server.RegisterIsolatePortWithName(kNameCount + 1, "churn");
+      name_server.RemoveIsolateNameMapping("churn");
+      continue;
+    }
+    auto port =
+        name_server.LookupIsolatePortByName(names[i++ % kNameCount], &cache);
+    benchmark::DoNotOptimize(port);
+  }
+}
+
+BENCHMARK(BM_IsolateNameServerLookup)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_IsolateNameServerLookupCached)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_IsolateNameServerLookupCachedWithRemovals)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
+}  // namespace flutter
@@ -14,11 +14,13 @@ namespace flutter {
 
 Dart_Handle IsolateNameServerNatives::LookupPortByName(
     const std::string& name) {
-  auto name_server = UIDartState::Current()->GetIsolateNameServer();
+  auto* state = UIDartState::Current();
+  auto name_server = state->GetIsolateNameServer();
   if (!name_server) {
     return Dart_Null();
   }
-  Dart_Port port = name_server->LookupIsolatePortByName(name);
+  Dart_Port port = name_server->LookupIsolatePortByName(
+      name, state->GetIsolateNameServerCache());
   if (port == ILLEGAL_PORT) {
     return Dart_Null();
   }
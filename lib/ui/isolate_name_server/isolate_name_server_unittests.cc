@@ -0,0 +1,84 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/isolate_name_server/isolate_name_server.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+TEST(IsolateNameServerTest, RegisterLookupAndRemove) {
+  IsolateNameServer name_server;
+  EXPECT_EQ(name_server.LookupIsolatePortByName("foo"), ILLEGAL_PORT);
+  EXPECT_TRUE(name_server.RegisterIsolatePortWithName(1, "foo"));
+  EXPECT_FALSE(name_server.RegisterIsolatePortWithName(2, "foo"));
+  EXPECT_TRUE(name_server.RegisterIsolatePortWithName(3, "bar"));
+  EXPECT_EQ(name_server.LookupIsolatePortByName("foo"), 1);
+  EXPECT_EQ(name_server.LookupIsolatePortByName("bar"), 3);
+  EXPECT_TRUE(name_server.RemoveIsolateNameMapping("foo"));
+  EXPECT_FALSE(name_server.RemoveIsolateNameMapping("foo"));
+  EXPECT_EQ(name_server.LookupIsolatePortByName("foo"), ILLEGAL_PORT);
+  EXPECT_EQ(name_server.LookupIsolatePortByName("bar"), 3);
+}
+
+TEST(IsolateNameServerTest, CachedLookupSeesRegistration) {
+  IsolateNameServer name_server;
+  IsolateNameServer::LookupCache cache;
+  EXPECT_EQ(name_server.LookupIsolatePortByName("foo", &cache), ILLEGAL_PORT);
+  EXPECT_TRUE(name_server.RegisterIsolatePortWithName(1, "foo"));
+  EXPECT_EQ(name_server.LookupIsolatePortByName("foo", &cache), 1);
+  EXPECT_EQ(name_server.LookupIsolatePortByName("foo", &cache), 1);
+}
+
+TEST(IsolateNameServerTest, CachedLookupInvalidatedByRemoval) {
+  IsolateNameServer name_server;
+  IsolateNameServer::LookupCache cache;
+  EXPECT_TRUE(name_server.RegisterIsolatePortWithName(1, "foo"));
+  EXPECT_TRUE(name_server.RegisterIsolatePortWithName(2, "bar"));
+  EXPECT_EQ(name_server.LookupIsolatePortByName("foo", &cache), 1);
+  EXPECT_EQ(name_server.LookupIsolatePortByName("bar", &cache), 2);
+
+  EXPECT_TRUE(name_server.RemoveIsolateNameMapping("foo"));
+  EXPECT_EQ(name_server.LookupIsolatePortByName("foo", &cache), ILLEGAL_PORT);
+  EXPECT_EQ(name_server.LookupIsolatePortByName("bar", &cache), 2);
+
+  EXPECT_TRUE(name_server.RegisterIsolatePortWithName(3, "foo"));
+  EXPECT_EQ(name_server.LookupIsolatePortByName("foo", &cache), 3);
+}
+
+TEST(IsolateNameServerTest, ConcurrentLookups) {
+  IsolateNameServer name_server;
+  EXPECT_TRUE(name_server.RegisterIsolatePortWithName(1, "stable"));
+
+  std::atomic<bool> done = false;
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; i++) {
+    readers.emplace_back([&name_server, &done]() {
+      IsolateNameServer::LookupCache cache;
+      while (!done.load()) {
+        ASSERT_EQ(name_server.LookupIsolatePortByName("stable", &cache), 1);
+        Dart_Port port = name_server.LookupIsolatePortByName("churn", &cache);
+        ASSERT_TRUE(port == ILLEGAL_PORT || port == 2);
+      }
+    });
+  }
+
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_TRUE(name_server.RegisterIsolatePortWithName(2, "churn"));
+    EXPECT_TRUE(name_server.RemoveIsolateNameMapping("churn"));
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(name_server.LookupIsolatePortByName("churn"), ILLEGAL_PORT);
+}
+
+}  // namespace testing
+}  // namespace flutter
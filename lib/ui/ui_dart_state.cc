@@ -146,6 +146,10 @@ std::shared_ptr<IsolateNameServer> UIDartState::GetIsolateNameServer() const {
   return isolate_name_server_;
 }
 
+IsolateNameServer::LookupCache* UIDartState::GetIsolateNameServerCache() {
+  return &isolate_name_server_cache_;
+}
+
 tonic::DartErrorHandleType UIDartState::GetLastError() {
   tonic::DartErrorHandleType error = message_handler().isolate_last_error();
   if (error == tonic::kNoError) {
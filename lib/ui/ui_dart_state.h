@@ -64,6 +64,12 @@ class UIDartState : public tonic::DartState {
 
   std::shared_ptr<IsolateNameServer> GetIsolateNameServer() const;
 
+  // This isolate's snapshot of the whole name to port mapping of the isolate
+  // name server, with the version it was taken at. Lookups through it refresh
+  // the snapshot only when the name server's version has changed since, i.e.
+  // after a name was registered or removed.
+  IsolateNameServer::LookupCache* GetIsolateNameServerCache();
+
   tonic::DartErrorHandleType GetLastError();
 
   void ReportUnhandledException(const std::string& error,
@@ -123,6 +129,7 @@ class UIDartState : public tonic::DartState {
   tonic::DartMicrotaskQueue microtask_queue_;
   UnhandledExceptionCallback unhandled_exception_callback_;
   const std::shared_ptr<IsolateNameServer> isolate_name_server_;
+  IsolateNameServer::LookupCache isolate_name_server_cache_;
 
   void AddOrRemoveTaskObserver(bool add);
 };
@@ -128,6 +128,10 @@ std::unique_ptr<RuntimeController> RuntimeController::Clone() const {
       ));
 }
 
+fml::RefPtr<const DartSnapshot> RuntimeController::GetIsolateSnapshot() const {
+  return isolate_snapshot_;
+}
+
 bool RuntimeController::FlushRuntimeStateToIsolate() {
   return SetViewportMetrics(window_data_.viewport_metrics) &&
          SetLocales(window_data_.locale_data) &&
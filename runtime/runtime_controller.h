@@ -135,6 +135,12 @@ class RuntimeController final : public WindowClient {
   ///
   std::unique_ptr<RuntimeController> Clone() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      The snapshot used to create the root isolate of this runtime
+  ///             controller.
+  ///
+  fml::RefPtr<const DartSnapshot> GetIsolateSnapshot() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Forward the specified window metrics to the running isolate.
   ///             If the isolate is not running, these metrics will be saved and
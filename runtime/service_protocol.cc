@@ -25,6 +25,8 @@ const std::string_view ServiceProtocol::kScreenshotExtensionName =
     "_flutter.screenshot";
 const std::string_view ServiceProtocol::kScreenshotSkpExtensionName =
     "_flutter.screenshotSkp";
+const std::string_view ServiceProtocol::kScreenshotLayerTreeExtensionName =
+    "_flutter.screenshotLayerTree";
 const std::string_view ServiceProtocol::kRunInViewExtensionName =
     "_flutter.runInView";
 const std::string_view ServiceProtocol::kFlushUIThreadTasksExtensionName =
@@ -35,6 +37,16 @@ const std::string_view ServiceProtocol::kGetDisplayRefreshRateExtensionName =
     "_flutter.getDisplayRefreshRate";
 const std::string_view ServiceProtocol::kGetSkSLsExtensionName =
     "_flutter.getSkSLs";
+const std::string_view ServiceProtocol::kGetTraceRecorderDumpExtensionName =
+    "_flutter.getTraceRecorderDump";
+const std::string_view ServiceProtocol::kGetFrameTimingHistogramsExtensionName =
+    "_flutter.getFrameTimingHistograms";
+const std::string_view ServiceProtocol::kGetStartupTimingsExtensionName =
+    "_flutter.getStartupTimings";
+const std::string_view ServiceProtocol::kGetShaderWarmUpProgressExtensionName =
+    "_flutter.getShaderWarmUpProgress";
+const std::string_view ServiceProtocol::kGetResourceCacheUsageExtensionName =
+    "_flutter.getResourceCacheUsage";
 
 static constexpr std::string_view kViewIdPrefx = "_flutterView/";
 static constexpr std::string_view kListViewsExtensionName =
@@ -48,11 +60,17 @@ ServiceProtocol::ServiceProtocol()
           // Public
           kScreenshotExtensionName,
           kScreenshotSkpExtensionName,
+          kScreenshotLayerTreeExtensionName,
           kRunInViewExtensionName,
           kFlushUIThreadTasksExtensionName,
           kSetAssetBundlePathExtensionName,
           kGetDisplayRefreshRateExtensionName,
           kGetSkSLsExtensionName,
+          kGetTraceRecorderDumpExtensionName,
+          kGetFrameTimingHistogramsExtensionName,
+          kGetStartupTimingsExtensionName,
+          kGetShaderWarmUpProgressExtensionName,
+          kGetResourceCacheUsageExtensionName,
       }),
       handlers_mutex_(fml::SharedMutex::Create()) {}
 
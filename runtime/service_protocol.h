@@ -23,11 +23,17 @@ class ServiceProtocol {
  public:
   static const std::string_view kScreenshotExtensionName;
   static const std::string_view kScreenshotSkpExtensionName;
+  static const std::string_view kScreenshotLayerTreeExtensionName;
   static const std::string_view kRunInViewExtensionName;
   static const std::string_view kFlushUIThreadTasksExtensionName;
   static const std::string_view kSetAssetBundlePathExtensionName;
   static const std::string_view kGetDisplayRefreshRateExtensionName;
   static const std::string_view kGetSkSLsExtensionName;
+  static const std::string_view kGetTraceRecorderDumpExtensionName;
+  static const std::string_view kGetFrameTimingHistogramsExtensionName;
+  static const std::string_view kGetStartupTimingsExtensionName;
+  static const std::string_view kGetShaderWarmUpProgressExtensionName;
+  static const std::string_view kGetResourceCacheUsageExtensionName;
 
   class Handler {
    public:
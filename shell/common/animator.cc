@@ -254,4 +254,8 @@ void Animator::ScheduleSecondaryVsyncCallback(const fml::closure& callback) {
   waiter_->ScheduleSecondaryCallback(callback);
 }
 
+fml::TimePoint Animator::GetLastFrameTargetTime() const {
+  return last_frame_target_time_;
+}
+
 }  // namespace flutter
@@ -70,6 +70,14 @@ class Animator final {
   /// @see      `PointerDataDispatcher::ScheduleSecondaryVsyncCallback`.
   void ScheduleSecondaryVsyncCallback(const fml::closure& callback);
 
+  //--------------------------------------------------------------------------
+  /// @brief    The target time of the most recent frame begun by this
+  ///           animator, or the default-constructed `TimePoint` if no frame
+  ///           has been begun yet.
+  ///
+  /// @see      `PointerDataDispatcher::Delegate::GetLastFrameTargetTime`.
+  fml::TimePoint GetLastFrameTargetTime() const;
+
   void Start();
 
   void Stop();
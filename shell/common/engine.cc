@@ -46,11 +46,37 @@ Engine::Engine(Delegate& delegate,
                fml::WeakPtr<IOManager> io_manager,
                fml::RefPtr<SkiaUnrefQueue> unref_queue,
                fml::WeakPtr<SnapshotDelegate> snapshot_delegate)
+    : Engine(delegate,
+             dispatcher_maker,
+             vm,
+             std::move(isolate_snapshot),
+             std::move(task_runners),
+             window_data,
+             std::move(settings),
+             std::move(animator),
+             std::move(io_manager),
+             std::move(unref_queue),
+             std::move(snapshot_delegate),
+             std::make_shared<FontCollection>()) {}
+
+Engine::Engine(Delegate& delegate,
+               const PointerDataDispatcherMaker& dispatcher_maker,
+               DartVM& vm,
+               fml::RefPtr<const DartSnapshot> isolate_snapshot,
+               TaskRunners task_runners,
+               const WindowData window_data,
+               Settings settings,
+               std::unique_ptr<Animator> animator,
+               fml::WeakPtr<IOManager> io_manager,
+               fml::RefPtr<SkiaUnrefQueue> unref_queue,
+               fml::WeakPtr<SnapshotDelegate> snapshot_delegate,
+               std::shared_ptr<FontCollection> font_collection)
     : delegate_(delegate),
       settings_(std::move(settings)),
       animator_(std::move(animator)),
       activity_running_(true),
       have_surface_(false),
+      font_collection_(std::move(font_collection)),
       image_decoder_(task_runners,
                      vm.GetConcurrentWorkerTaskRunner(),
                      io_manager),
@@ -80,6 +106,37 @@ Engine::Engine(Delegate& delegate,
   pointer_data_dispatcher_ = dispatcher_maker(*this);
 }
 
+std::unique_ptr<Engine> Engine::Spawn(
+    Delegate& delegate,
+    const PointerDataDispatcherMaker& dispatcher_maker,
+    DartVM& vm,
+    Settings settings,
+    std::unique_ptr<Animator> animator,
+    fml::WeakPtr<IOManager> io_manager,
+    fml::RefPtr<SkiaUnrefQueue> unref_queue,
+    fml::WeakPtr<SnapshotDelegate> snapshot_delegate) const {
+  TRACE_EVENT0("flutter", "Engine::Spawn");
+  FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  auto engine = std::make_unique<Engine>(
+      delegate,                                   //
+      dispatcher_maker,                           //
+      vm,                                         //
+      runtime_controller_->GetIsolateSnapshot(),  //
+      task_runners_,                              //
+      WindowData{/* default window data */},      //
+      std::move(settings),                        //
+      std::move(animator),                        //
+      std::move(io_manager),                      //
+      std::move(unref_queue),                     //
+      std::move(snapshot_delegate),               //
+      font_collection_                            //
+  );
+  // The fonts of these assets are already registered with the shared font
+  // collection.
+  engine->asset_manager_ = asset_manager_;
+  return engine;
+}
+
 Engine::~Engine() = default;
 
 float Engine::GetDisplayRefreshRate() const {
@@ -103,15 +160,19 @@ bool Engine::UpdateAssetManager(
   }
 
   // Using libTXT as the text engine.
-  font_collection_.RegisterFonts(asset_manager_);
+  font_collection_->RegisterFonts(asset_manager_);
 
   if (settings_.use_test_fonts) {
-    font_collection_.RegisterTestFonts();
+    font_collection_->RegisterTestFonts();
   }
 
   return true;
 }
 
+std::shared_ptr<AssetManager> Engine::GetAssetManager() const {
+  return asset_manager_;
+}
+
 bool Engine::Restart(RunConfiguration configuration) {
   TRACE_EVENT0("flutter", "Engine::Restart");
   if (!configuration.IsValid()) {
@@ -492,7 +553,7 @@ void Engine::SetNeedsReportTimings(bool needs_reporting) {
 }
 
 FontCollection& Engine::GetFontCollection() {
-  return font_collection_;
+  return *font_collection_;
 }
 
 void Engine::DoDispatchPacket(std::unique_ptr<PointerDataPacket> packet,
@@ -507,6 +568,10 @@ void Engine::ScheduleSecondaryVsyncCallback(const fml::closure& callback) {
   animator_->ScheduleSecondaryVsyncCallback(callback);
 }
 
+fml::TimePoint Engine::GetLastFrameTargetTime() {
+  return animator_->GetLastFrameTargetTime();
+}
+
 void Engine::HandleAssetPlatformMessage(fml::RefPtr<PlatformMessage> message) {
   fml::RefPtr<PlatformMessageResponse> response = message->response();
   if (!response) {
@@ -516,16 +581,21 @@ void Engine::HandleAssetPlatformMessage(fml::RefPtr<PlatformMessage> message) {
   std::string asset_name(reinterpret_cast<const char*>(data.data()),
                          data.size());
 
-  if (asset_manager_) {
-    std::unique_ptr<fml::Mapping> asset_mapping =
-        asset_manager_->GetAsMapping(asset_name);
-    if (asset_mapping) {
-      response->Complete(std::move(asset_mapping));
-      return;
-    }
+  if (!asset_manager_) {
+    response->CompleteEmpty();
+    return;
   }
 
-  response->CompleteEmpty();
+  // Resolving the asset may block on storage, so keep it off the UI thread.
+  asset_manager_->GetAsMappingAsync(
+      asset_name, task_runners_.GetIOTaskRunner(),
+      [response](std::unique_ptr<fml::Mapping> asset_mapping) {
+        if (asset_mapping) {
+          response->Complete(std::move(asset_mapping));
+        } else {
+          response->CompleteEmpty();
+        }
+      });
 }
 
 const std::string& Engine::GetLastEntrypoint() const {
@@ -283,6 +283,62 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
          fml::RefPtr<SkiaUnrefQueue> unref_queue,
          fml::WeakPtr<SnapshotDelegate> snapshot_delegate);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Creates an engine that uses the specified font collection
+  ///             instead of creating its own. All other arguments are as
+  ///             described in the constructor above.
+  ///
+  /// @param[in]  font_collection  The font collection used by the root
+  ///                              isolate. It may be shared with other
+  ///                              engines running on the same UI task runner.
+  ///
+  Engine(Delegate& delegate,
+         const PointerDataDispatcherMaker& dispatcher_maker,
+         DartVM& vm,
+         fml::RefPtr<const DartSnapshot> isolate_snapshot,
+         TaskRunners task_runners,
+         const WindowData window_data,
+         Settings settings,
+         std::unique_ptr<Animator> animator,
+         fml::WeakPtr<IOManager> io_manager,
+         fml::RefPtr<SkiaUnrefQueue> unref_queue,
+         fml::WeakPtr<SnapshotDelegate> snapshot_delegate,
+         std::shared_ptr<FontCollection> font_collection);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a new engine for another view that shares the isolate
+  ///             snapshot, font collection and asset manager of this engine.
+  ///             The new root isolate is created from the same snapshot but
+  ///             does not share its heap with the root isolate of this
+  ///             engine. Must be called on the UI task runner, which the new
+  ///             engine shares with this one.
+  ///
+  /// @param[in]  delegate           The delegate of the new engine. This is
+  ///                                the spawned shell.
+  /// @param[in]  dispatcher_maker   The pointer data dispatcher maker of the
+  ///                                platform view of the new engine.
+  /// @param[in]  vm                 The running Dart VM.
+  /// @param[in]  settings           The settings of the new engine.
+  /// @param[in]  animator           The animator of the new engine.
+  /// @param[in]  io_manager         The IO manager of the new root isolate.
+  /// @param[in]  unref_queue        The Skia unref queue of the new root
+  ///                                isolate.
+  /// @param[in]  snapshot_delegate  The snapshot delegate of the new root
+  ///                                isolate.
+  ///
+  /// @return     The spawned engine. Running it with the asset manager of this
+  ///             engine does not register the fonts again.
+  ///
+  std::unique_ptr<Engine> Spawn(
+      Delegate& delegate,
+      const PointerDataDispatcherMaker& dispatcher_maker,
+      DartVM& vm,
+      Settings settings,
+      std::unique_ptr<Animator> animator,
+      fml::WeakPtr<IOManager> io_manager,
+      fml::RefPtr<SkiaUnrefQueue> unref_queue,
+      fml::WeakPtr<SnapshotDelegate> snapshot_delegate) const;
+
   //----------------------------------------------------------------------------
   /// @brief      Destroys the engine engine. Called by the shell on the UI task
   ///             runner. The running root isolate is terminated and will no
@@ -385,6 +441,11 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   ///
   bool UpdateAssetManager(std::shared_ptr<AssetManager> asset_manager);
 
+  //----------------------------------------------------------------------------
+  /// @brief      The asset manager of the running root isolate, if any.
+  ///
+  std::shared_ptr<AssetManager> GetAssetManager() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Notifies the engine that it is time to begin working on a new
   ///             frame previously scheduled via a call to
@@ -715,6 +776,9 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   // |PointerDataDispatcher::Delegate|
   void ScheduleSecondaryVsyncCallback(const fml::closure& callback) override;
 
+  // |PointerDataDispatcher::Delegate|
+  fml::TimePoint GetLastFrameTargetTime() override;
+
   //----------------------------------------------------------------------------
   /// @brief      Get the last Entrypoint that was used in the RunConfiguration
   ///             when |Engine::Run| was called.
@@ -745,7 +809,7 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
   std::shared_ptr<AssetManager> asset_manager_;
   bool activity_running_;
   bool have_surface_;
-  FontCollection font_collection_;
+  std::shared_ptr<FontCollection> font_collection_;
   ImageDecoder image_decoder_;
   TaskRunners task_runners_;
   fml::WeakPtrFactory<Engine> weak_factory_;
@@ -0,0 +1,153 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_timing_histograms.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+namespace {
+
+// The nearest-rank percentile of sorted values.
+int64_t Percentile(const std::vector<int64_t>& sorted, double percentile) {
+  FML_DCHECK(!sorted.empty());
+  const size_t rank =
+      static_cast<size_t>(std::ceil(percentile / 100.0 * sorted.size()));
+  return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+}  // namespace
+
+FrameTimingHistograms::FrameTimingHistograms(size_t window_size)
+    : window_size_(std::max<size_t>(window_size, 1)) {}
+
+FrameTimingHistograms::~FrameTimingHistograms() = default;
+
+void FrameTimingHistograms::AddFrame(const FrameTiming& timing) {
+  std::scoped_lock lock(mutex_);
+  frame_count_++;
+
+  AddDurationLocked(kBuild, timing.Get(FrameTiming::kBuildStart),
+                    timing.Get(FrameTiming::kBuildFinish));
+  AddDurationLocked(kRaster, timing.Get(FrameTiming::kRasterStart),
+                    timing.Get(FrameTiming::kRasterFinish));
+  AddDurationLocked(kPreroll, timing.GetRasterPhase(FrameTiming::kPrerollStart),
+                    timing.GetRasterPhase(FrameTiming::kPrerollFinish));
+  AddDurationLocked(kPaint, timing.GetRasterPhase(FrameTiming::kPaintStart),
+                    timing.GetRasterPhase(FrameTiming::kPaintFinish));
+  AddDurationLocked(kFlush, timing.GetRasterPhase(FrameTiming::kFlushStart),
+                    timing.GetRasterPhase(FrameTiming::kFlushFinish));
+  AddDurationLocked(kPresent, timing.GetRasterPhase(FrameTiming::kPresentStart),
+                    timing.GetRasterPhase(FrameTiming::kPresentFinish));
+  AddDurationLocked(kTotal, timing.Get(FrameTiming::kBuildStart),
+                    timing.Get(FrameTiming::kRasterFinish));
+
+  const auto& cache = timing.GetRasterCacheStats();
+  AddSampleLocked(kRasterCachePopulation,
+                  cache.population_time.ToMicroseconds());
+  AddSampleLocked(kRasterCacheEntries,
+                  cache.layer_count + cache.picture_count + cache.shadow_count);
+  AddSampleLocked(kRasterCacheBytes,
+                  cache.layer_bytes + cache.picture_bytes + cache.shadow_bytes);
+}
+
+FrameTimingHistograms::Histogram FrameTimingHistograms::GetHistogram(
+    Metric metric) const {
+  Histogram histogram;
+  if (metric < 0 || metric >= kMetricCount) {
+    return histogram;
+  }
+
+  std::vector<int64_t> sorted;
+  {
+    std::scoped_lock lock(mutex_);
+    sorted = samples_[metric].values;
+  }
+  if (sorted.empty()) {
+    return histogram;
+  }
+  std::sort(sorted.begin(), sorted.end());
+
+  double sum = 0;
+  for (auto value : sorted) {
+    sum += value;
+  }
+
+  histogram.sample_count = sorted.size();
+  histogram.p50 = Percentile(sorted, 50);
+  histogram.p90 = Percentile(sorted, 90);
+  histogram.p99 = Percentile(sorted, 99);
+  histogram.max = sorted.back();
+  histogram.mean = sum / sorted.size();
+  return histogram;
+}
+
+size_t FrameTimingHistograms::GetFrameCount() const {
+  std::scoped_lock lock(mutex_);
+  return frame_count_;
+}
+
+void FrameTimingHistograms::Reset() {
+  std::scoped_lock lock(mutex_);
+  for (auto& samples : samples_) {
+    samples.values.clear();
+    samples.next = 0;
+  }
+  frame_count_ = 0;
+}
+
+const char* FrameTimingHistograms::GetMetricName(Metric metric) {
+  switch (metric) {
+    case kBuild:
+      return "build";
+    case kRaster:
+      return "raster";
+    case kPreroll:
+      return "preroll";
+    case kRasterCachePopulation:
+      return "rasterCachePopulation";
+    case kPaint:
+      return "paint";
+    case kFlush:
+      return "flush";
+    case kPresent:
+      return "present";
+    case kTotal:
+      return "total";
+    case kRasterCacheEntries:
+      return "rasterCacheEntries";
+    case kRasterCacheBytes:
+      return "rasterCacheBytes";
+    case kMetricCount:
+      break;
+  }
+  return "unknown";
+}
+
+void FrameTimingHistograms::AddSampleLocked(Metric metric, int64_t value) {
+  Samples& samples = samples_[metric];
+  if (samples.values.size() < window_size_) {
+    samples.values.push_back(value);
+  } else {
+    samples.values[samples.next] = value;
+  }
+  samples.next = (samples.next + 1) % window_size_;
+}
+
+void FrameTimingHistograms::AddDurationLocked(Metric metric,
+                                              fml::TimePoint start,
+                                              fml::TimePoint finish) {
+  // Steps that did not happen in a frame are left unset.
+  if (start == fml::TimePoint() || finish == fml::TimePoint() ||
+      finish < start) {
+    return;
+  }
+  AddSampleLocked(metric, (finish - start).ToMicroseconds());
+}
+
+}  // namespace flutter
@@ -0,0 +1,96 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_FRAME_TIMING_HISTOGRAMS_H_
+#define FLUTTER_SHELL_COMMON_FRAME_TIMING_HISTOGRAMS_H_
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "flutter/common/settings.h"
+#include "flutter/fml/macros.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Aggregates the timings of the most recently rasterized frames
+///             into percentiles for each phase of a frame, along with the
+///             state of the raster cache.
+///
+///             Frames are added on the raster thread. Histograms may be
+///             queried from any thread.
+///
+class FrameTimingHistograms {
+ public:
+  enum Metric {
+    // Durations, in microseconds.
+    kBuild,
+    kRaster,
+    kPreroll,
+    kRasterCachePopulation,
+    kPaint,
+    kFlush,
+    kPresent,
+    // The time from the start of the build to the end of the raster phase, in
+    // microseconds.
+    kTotal,
+    // The state of the raster cache at the end of each frame.
+    kRasterCacheEntries,
+    kRasterCacheBytes,
+    kMetricCount
+  };
+
+  struct Histogram {
+    size_t sample_count = 0;
+    int64_t p50 = 0;
+    int64_t p90 = 0;
+    int64_t p99 = 0;
+    int64_t max = 0;
+    double mean = 0;
+  };
+
+  // The number of most recent frames aggregated.
+  static constexpr size_t kDefaultWindowSize = 240;
+
+  explicit FrameTimingHistograms(size_t window_size = kDefaultWindowSize);
+
+  ~FrameTimingHistograms();
+
+  void AddFrame(const FrameTiming& timing);
+
+  Histogram GetHistogram(Metric metric) const;
+
+  // The total number of frames added, including those no longer in the window.
+  size_t GetFrameCount() const;
+
+  void Reset();
+
+  static const char* GetMetricName(Metric metric);
+
+ private:
+  // A ring buffer of the most recent samples of a metric.
+  struct Samples {
+    std::vector<int64_t> values;
+    size_t next = 0;
+  };
+
+  const size_t window_size_;
+  mutable std::mutex mutex_;
+  std::array<Samples, kMetricCount> samples_;
+  size_t frame_count_ = 0;
+
+  void AddSampleLocked(Metric metric, int64_t value);
+
+  void AddDurationLocked(Metric metric,
+                         fml::TimePoint start,
+                         fml::TimePoint finish);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameTimingHistograms);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_FRAME_TIMING_HISTOGRAMS_H_
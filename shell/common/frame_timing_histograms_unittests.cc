@@ -0,0 +1,118 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_timing_histograms.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+fml::TimePoint Millis(int64_t millis) {
+  return fml::TimePoint::FromEpochDelta(
+      fml::TimeDelta::FromMilliseconds(millis));
+}
+
+FrameTiming MakeTiming(int64_t raster_millis) {
+  FrameTiming timing;
+  timing.Set(FrameTiming::kBuildStart, Millis(1));
+  timing.Set(FrameTiming::kBuildFinish, Millis(5));
+  timing.Set(FrameTiming::kRasterStart, Millis(10));
+  timing.Set(FrameTiming::kRasterFinish, Millis(10 + raster_millis));
+  timing.SetRasterPhase(FrameTiming::kPrerollStart, Millis(10));
+  timing.SetRasterPhase(FrameTiming::kPrerollFinish, Millis(12));
+  return timing;
+}
+
+}  // namespace
+
+TEST(FrameTimingHistogramsTest, EmptyHistogramHasNoSamples) {
+  FrameTimingHistograms histograms;
+  const auto histogram = histograms.GetHistogram(FrameTimingHistograms::kBuild);
+  ASSERT_EQ(histogram.sample_count, 0u);
+  ASSERT_EQ(histogram.max, 0);
+  ASSERT_EQ(histograms.GetFrameCount(), 0u);
+}
+
+TEST(FrameTimingHistogramsTest, ComputesPercentilesOfPhases) {
+  FrameTimingHistograms histograms;
+  for (int64_t i = 1; i <= 100; i++) {
+    histograms.AddFrame(MakeTiming(i));
+  }
+  ASSERT_EQ(histograms.GetFrameCount(), 100u);
+
+  const auto raster = histograms.GetHistogram(FrameTimingHistograms::kRaster);
+  ASSERT_EQ(raster.sample_count, 100u);
+  ASSERT_EQ(raster.p50, 50000);
+  ASSERT_EQ(raster.p90, 90000);
+  ASSERT_EQ(raster.p99, 99000);
+  ASSERT_EQ(raster.max, 100000);
+  ASSERT_DOUBLE_EQ(raster.mean, 50500);
+
+  const auto build = histograms.GetHistogram(FrameTimingHistograms::kBuild);
+  ASSERT_EQ(build.p99, 4000);
+
+  const auto preroll =
+      histograms.GetHistogram(FrameTimingHistograms::kPreroll);
+  ASSERT_EQ(preroll.sample_count, 100u);
+  ASSERT_EQ(preroll.max, 2000);
+}
+
+TEST(FrameTimingHistogramsTest, SkipsStepsThatDidNotHappen) {
+  FrameTimingHistograms histograms;
+  histograms.AddFrame(MakeTiming(8));
+  ASSERT_EQ(histograms.GetHistogram(FrameTimingHistograms::kPaint).sample_count,
+            0u);
+  ASSERT_EQ(
+      histograms.GetHistogram(FrameTimingHistograms::kPresent).sample_count,
+      0u);
+}
+
+TEST(FrameTimingHistogramsTest, OnlyKeepsTheMostRecentFrames) {
+  FrameTimingHistograms histograms(10);
+  for (int64_t i = 1; i <= 20; i++) {
+    histograms.AddFrame(MakeTiming(i));
+  }
+  const auto raster = histograms.GetHistogram(FrameTimingHistograms::kRaster);
+  ASSERT_EQ(raster.sample_count, 10u);
+  ASSERT_EQ(raster.p50, 15000);
+  ASSERT_EQ(raster.max, 20000);
+  ASSERT_EQ(histograms.GetFrameCount(), 20u);
+
+  histograms.Reset();
+  ASSERT_EQ(
+      histograms.GetHistogram(FrameTimingHistograms::kRaster).sample_count, 0u);
+  ASSERT_EQ(histograms.GetFrameCount(), 0u);
+}
+
+TEST(FrameTimingHistogramsTest, RecordsRasterCacheStats) {
+  FrameTimingHistograms histograms;
+  FrameTiming timing = MakeTiming(4);
+  RasterCacheFrameStats stats;
+  stats.layer_count = 2;
+  stats.layer_bytes = 400;
+  stats.picture_count = 3;
+  stats.picture_bytes = 600;
+  stats.shadow_count = 1;
+  stats.shadow_bytes = 200;
+  stats.populated_count = 1;
+  stats.population_time = fml::TimeDelta::FromMicroseconds(250);
+  timing.SetRasterCacheStats(stats);
+  histograms.AddFrame(timing);
+
+  ASSERT_EQ(
+      histograms.GetHistogram(FrameTimingHistograms::kRasterCacheEntries).max,
+      6);
+  ASSERT_EQ(
+      histograms.GetHistogram(FrameTimingHistograms::kRasterCacheBytes).max,
+      1200);
+  ASSERT_EQ(
+      histograms.GetHistogram(FrameTimingHistograms::kRasterCachePopulation)
+          .max,
+      250);
+}
+
+}  // namespace testing
+}  // namespace flutter
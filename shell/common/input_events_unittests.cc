@@ -412,5 +412,185 @@ TEST_F(ShellTest, CanCorrectlySynthesizePointerPacket) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
 }
 
+class FakePointerDataDispatcherDelegate
+    : public PointerDataDispatcher::Delegate {
+ public:
+  // |PointerDataDispatcher::Delegate|
+  void DoDispatchPacket(std::unique_ptr<PointerDataPacket> packet,
+                        uint64_t trace_flow_id) override {
+    const auto& data = packet->data();
+    std::vector<PointerData> events(data.size() / sizeof(PointerData));
+    memcpy(events.data(), data.data(), data.size());
+    dispatched_packets.push_back(std::move(events));
+  }
+
+  // |PointerDataDispatcher::Delegate|
+  void ScheduleSecondaryVsyncCallback(const fml::closure& callback) override {
+    vsync_callback = callback;
+  }
+
+  // |PointerDataDispatcher::Delegate|
+  fml::TimePoint GetLastFrameTargetTime() override { return frame_target_time; }
+
+  void FireVsync() {
+    auto callback = std::move(vsync_callback);
+    vsync_callback = nullptr;
+    ASSERT_TRUE(callback);
+    callback();
+  }
+
+  std::vector<std::vector<PointerData>> dispatched_packets;
+  fml::closure vsync_callback;
+  fml::TimePoint frame_target_time;
+};
+
+static void DispatchSimulatedPointerData(PointerDataDispatcher& dispatcher,
+                                         PointerData::Change change,
+                                         int64_t time_stamp,
+                                         double x) {
+  auto packet = std::make_unique<PointerDataPacket>(1);
+  PointerData data;
+  CreateSimulatedPointerData(data, change, x, 0.0);
+  data.time_stamp = time_stamp;
+  packet->SetPointerData(0, data);
+  dispatcher.DispatchPacket(std::move(packet), 0);
+}
+
+TEST(ResamplingPointerDataDispatcherTest,
+     DispatchesOneInterpolatedMovePerFrame) {
+  FakePointerDataDispatcherDelegate delegate;
+  ResamplingPointerDataDispatcher dispatcher(delegate, fml::TimeDelta::Zero());
+
+  // Use time stamps in the future so that the target time is not clamped to
+  // now.
+  const int64_t base =
+      (fml::TimePoint::Now() + fml::TimeDelta::FromSeconds(60))
+          .ToEpochDelta()
+          .ToMicroseconds();
+  DispatchSimulatedPointerData(dispatcher, PointerData::Change::kDown, base,
+                               0.0);
+  ASSERT_EQ(delegate.dispatched_packets.size(), 1u);
+
+  for (int i = 1; i <= 4; i++) {
+    DispatchSimulatedPointerData(dispatcher, PointerData::Change::kMove,
+                                 base + i * 4000, i * 4.0);
+  }
+  // Moves are buffered until VSYNC.
+  ASSERT_EQ(delegate.dispatched_packets.size(), 1u);
+
+  delegate.frame_target_time = fml::TimePoint::FromEpochDelta(
+      fml::TimeDelta::FromMicroseconds(base + 10000));
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.dispatched_packets.size(), 2u);
+  ASSERT_EQ(delegate.dispatched_packets[1].size(), 1u);
+  const PointerData& resampled = delegate.dispatched_packets[1][0];
+  EXPECT_EQ(resampled.change, PointerData::Change::kMove);
+  EXPECT_EQ(resampled.time_stamp, base + 10000);
+  EXPECT_DOUBLE_EQ(resampled.physical_x, 10.0);
+  EXPECT_DOUBLE_EQ(resampled.physical_delta_x, 10.0);
+
+  // The sample at 16ms is still pending, so the next frame is scheduled.
+  delegate.frame_target_time = fml::TimePoint::FromEpochDelta(
+      fml::TimeDelta::FromMicroseconds(base + 16000));
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.dispatched_packets.size(), 3u);
+  EXPECT_DOUBLE_EQ(delegate.dispatched_packets[2][0].physical_x, 16.0);
+  EXPECT_DOUBLE_EQ(delegate.dispatched_packets[2][0].physical_delta_x, 6.0);
+  EXPECT_FALSE(delegate.vsync_callback);
+}
+
+TEST(ResamplingPointerDataDispatcherTest, ClampsToNewestSample) {
+  FakePointerDataDispatcherDelegate delegate;
+  ResamplingPointerDataDispatcher dispatcher(delegate, fml::TimeDelta::Zero());
+
+  const int64_t base =
+      (fml::TimePoint::Now() + fml::TimeDelta::FromSeconds(60))
+          .ToEpochDelta()
+          .ToMicroseconds();
+  DispatchSimulatedPointerData(dispatcher, PointerData::Change::kDown, base,
+                               0.0);
+  DispatchSimulatedPointerData(dispatcher, PointerData::Change::kMove,
+                               base + 4000, 4.0);
+  DispatchSimulatedPointerData(dispatcher, PointerData::Change::kMove,
+                               base + 8000, 8.0);
+
+  // Positions past the newest sample are not predicted, so the pointer never
+  // moves back.
+  delegate.frame_target_time = fml::TimePoint::FromEpochDelta(
+      fml::TimeDelta::FromMicroseconds(base + 30000));
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.dispatched_packets.size(), 2u);
+  EXPECT_DOUBLE_EQ(delegate.dispatched_packets[1][0].physical_x, 8.0);
+  EXPECT_DOUBLE_EQ(delegate.dispatched_packets[1][0].physical_delta_x, 8.0);
+  EXPECT_FALSE(delegate.vsync_callback);
+
+  // A newer sample is interpolated towards from the clamped position.
+  DispatchSimulatedPointerData(dispatcher, PointerData::Change::kMove,
+                               base + 40000, 18.0);
+  delegate.frame_target_time = fml::TimePoint::FromEpochDelta(
+      fml::TimeDelta::FromMicroseconds(base + 32000));
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.dispatched_packets.size(), 3u);
+  EXPECT_DOUBLE_EQ(delegate.dispatched_packets[2][0].physical_x, 15.5);
+  EXPECT_DOUBLE_EQ(delegate.dispatched_packets[2][0].physical_delta_x, 7.5);
+}
+
+TEST(ResamplingPointerDataDispatcherTest, HoldsSamplesNewerThanSampleTime) {
+  FakePointerDataDispatcherDelegate delegate;
+  ResamplingPointerDataDispatcher dispatcher(delegate, fml::TimeDelta::Zero());
+
+  const int64_t base =
+      (fml::TimePoint::Now() + fml::TimeDelta::FromSeconds(60))
+          .ToEpochDelta()
+          .ToMicroseconds();
+  DispatchSimulatedPointerData(dispatcher, PointerData::Change::kDown, base,
+                               0.0);
+  DispatchSimulatedPointerData(dispatcher, PointerData::Change::kMove,
+                               base + 20000, 20.0);
+  DispatchSimulatedPointerData(dispatcher, PointerData::Change::kMove,
+                               base + 24000, 24.0);
+
+  // No sample is at or before the sample time, so nothing is dispatched, and
+  // the samples are held for the next frame.
+  for (int i = 0; i < 2; i++) {
+    delegate.frame_target_time = fml::TimePoint::FromEpochDelta(
+        fml::TimeDelta::FromMicroseconds(base + 10000));
+    delegate.FireVsync();
+    EXPECT_EQ(delegate.dispatched_packets.size(), 1u);
+  }
+
+  delegate.frame_target_time = fml::TimePoint::FromEpochDelta(
+      fml::TimeDelta::FromMicroseconds(base + 22000));
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.dispatched_packets.size(), 2u);
+  EXPECT_DOUBLE_EQ(delegate.dispatched_packets[1][0].physical_x, 22.0);
+  EXPECT_DOUBLE_EQ(delegate.dispatched_packets[1][0].physical_delta_x, 22.0);
+}
+
+TEST(ResamplingPointerDataDispatcherTest, FlushesMovesBeforeOtherEvents) {
+  FakePointerDataDispatcherDelegate delegate;
+  ResamplingPointerDataDispatcher dispatcher(delegate, fml::TimeDelta::Zero());
+
+  DispatchSimulatedPointerData(dispatcher, PointerData::Change::kDown, 0, 0.0);
+  DispatchSimulatedPointerData(dispatcher, PointerData::Change::kMove, 4000,
+                               4.0);
+  DispatchSimulatedPointerData(dispatcher, PointerData::Change::kMove, 8000,
+                               8.0);
+  DispatchSimulatedPointerData(dispatcher, PointerData::Change::kUp, 9000,
+                               8.0);
+
+  ASSERT_EQ(delegate.dispatched_packets.size(), 2u);
+  ASSERT_EQ(delegate.dispatched_packets[1].size(), 2u);
+  EXPECT_EQ(delegate.dispatched_packets[1][0].change,
+            PointerData::Change::kMove);
+  EXPECT_DOUBLE_EQ(delegate.dispatched_packets[1][0].physical_x, 8.0);
+  EXPECT_DOUBLE_EQ(delegate.dispatched_packets[1][0].physical_delta_x, 8.0);
+  EXPECT_EQ(delegate.dispatched_packets[1][1].change, PointerData::Change::kUp);
+
+  // Nothing is left to resample.
+  delegate.FireVsync();
+  EXPECT_EQ(delegate.dispatched_packets.size(), 2u);
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -30,6 +30,17 @@ static void WaitForIO(Shell* shell) {
   io_task_finished.get_future().wait();
 }
 
+static void WaitForShaderWarmUp(Shell* shell) {
+  // Each warm-up batch is posted to the raster task runner by the previous
+  // one, so flush it until the warm-up is finished.
+  do {
+    std::promise<bool> raster_task_finished;
+    shell->GetTaskRunners().GetRasterTaskRunner()->PostTask(
+        [&raster_task_finished]() { raster_task_finished.set_value(true); });
+    raster_task_finished.get_future().wait();
+  } while (!shell->GetShaderWarmUpProgress().IsFinished());
+}
+
 TEST_F(ShellTest, CacheSkSLWorks) {
   // Create a temp dir to store the persistent cache
   fml::ScopedTemporaryDirectory dir;
@@ -94,6 +105,7 @@ TEST_F(ShellTest, CacheSkSLWorks) {
   shell = CreateShell(settings);
   PlatformViewNotifyCreated(shell.get());
   RunEngine(shell.get(), std::move(normal_config));
+  WaitForShaderWarmUp(shell.get());
   firstFrameLatch.Reset();
   PumpOneFrame(shell.get(), 100, 100, builder);
   firstFrameLatch.Wait();
@@ -4,6 +4,10 @@
 
 #include "flutter/shell/common/pointer_data_dispatcher.h"
 
+#include <algorithm>
+
+#include "flutter/fml/trace_event.h"
+
 namespace flutter {
 
 PointerDataDispatcher::~PointerDataDispatcher() = default;
@@ -13,6 +17,14 @@ SmoothPointerDataDispatcher::SmoothPointerDataDispatcher(Delegate& delegate)
     : DefaultPointerDataDispatcher(delegate), weak_factory_(this) {}
 SmoothPointerDataDispatcher::~SmoothPointerDataDispatcher() = default;
 
+ResamplingPointerDataDispatcher::ResamplingPointerDataDispatcher(
+    Delegate& delegate,
+    fml::TimeDelta sampling_offset)
+    : DefaultPointerDataDispatcher(delegate),
+      sampling_offset_(sampling_offset),
+      weak_factory_(this) {}
+ResamplingPointerDataDispatcher::~ResamplingPointerDataDispatcher() = default;
+
 void DefaultPointerDataDispatcher::DispatchPacket(
     std::unique_ptr<PointerDataPacket> packet,
     uint64_t trace_flow_id) {
@@ -60,4 +72,199 @@ void SmoothPointerDataDispatcher::DispatchPendingPacket() {
   ScheduleSecondaryVsyncCallback();
 }
 
+static bool IsResampledChange(const PointerData& data) {
+  return data.signal_kind == PointerData::SignalKind::kNone &&
+         (data.change == PointerData::Change::kMove ||
+          data.change == PointerData::Change::kHover);
+}
+
+static bool CompareTimeStamp(int64_t time_stamp, const PointerData& data) {
+  return time_stamp < data.time_stamp;
+}
+
+void ResamplingPointerDataDispatcher::DispatchPacket(
+    std::unique_ptr<PointerDataPacket> packet,
+    uint64_t trace_flow_id) {
+  const auto& data = packet->data();
+  const size_t count = data.size() / sizeof(PointerData);
+
+  std::vector<PointerData> immediate_events;
+  bool has_buffered_events = false;
+  for (size_t i = 0; i < count; i++) {
+    PointerData pointer_data;
+    memcpy(&pointer_data, &data[i * sizeof(PointerData)], sizeof(PointerData));
+
+    auto [iter, inserted] = pointers_.try_emplace(pointer_data.device);
+    PointerState& state = iter->second;
+    if (inserted) {
+      state.last_x = pointer_data.physical_x - pointer_data.physical_delta_x;
+      state.last_y = pointer_data.physical_y - pointer_data.physical_delta_y;
+    }
+
+    if (IsResampledChange(pointer_data)) {
+      // Platforms deliver samples in order, but keep the buffer sorted anyway
+      // since resampling relies on it.
+      auto position =
+          std::upper_bound(state.samples.begin(), state.samples.end(),
+                           pointer_data.time_stamp, CompareTimeStamp);
+      state.samples.insert(position, pointer_data);
+      has_buffered_events = true;
+      continue;
+    }
+
+    // Flush the newest buffered move so that this event is observed at the
+    // position the device actually reached.
+    if (state.HasPendingSamples()) {
+      PointerData flushed = state.samples.back();
+      flushed.physical_delta_x = flushed.physical_x - state.last_x;
+      flushed.physical_delta_y = flushed.physical_y - state.last_y;
+      immediate_events.push_back(flushed);
+    }
+    state.samples.clear();
+    state.last_x = pointer_data.physical_x;
+    state.last_y = pointer_data.physical_y;
+    state.dispatched_time_stamp =
+        std::max(state.dispatched_time_stamp, pointer_data.time_stamp);
+    immediate_events.push_back(pointer_data);
+
+    if (pointer_data.change == PointerData::Change::kRemove) {
+      pointers_.erase(iter);
+    }
+  }
+
+  if (!immediate_events.empty()) {
+    DispatchEvents(immediate_events, trace_flow_id);
+  } else if (has_buffered_events) {
+    pending_trace_flow_ids_.push_back(trace_flow_id);
+  }
+
+  if (has_buffered_events) {
+    ScheduleSecondaryVsyncCallback();
+  }
+}
+
+void ResamplingPointerDataDispatcher::ScheduleSecondaryVsyncCallback() {
+  if (is_vsync_scheduled_) {
+    return;
+  }
+  is_vsync_scheduled_ = true;
+  delegate_.ScheduleSecondaryVsyncCallback(
+      [dispatcher = weak_factory_.GetWeakPtr()]() {
+        if (dispatcher) {
+          dispatcher->OnVsync();
+        }
+      });
+}
+
+void ResamplingPointerDataDispatcher::OnVsync() {
+  TRACE_EVENT0("flutter", "ResamplingPointerDataDispatcher::OnVsync");
+  is_vsync_scheduled_ = false;
+
+  // A frame target time in the past means no frame has been begun for this
+  // VSYNC. Sample relative to now instead of lagging behind.
+  const fml::TimePoint frame_target_time =
+      std::max(delegate_.GetLastFrameTargetTime(), fml::TimePoint::Now());
+  const int64_t sample_time =
+      (frame_target_time - sampling_offset_).ToEpochDelta().ToMicroseconds();
+
+  std::vector<PointerData> events;
+  bool has_pending_samples = false;
+  for (auto& [device, state] : pointers_) {
+    if (!state.HasPendingSamples()) {
+      continue;
+    }
+    if (state.samples.front().time_stamp > sample_time) {
+      // No sample is old enough to be dispatched yet. Hold them until the
+      // sample time reaches them, rather than dispatching the oldest one
+      // again every frame.
+      has_pending_samples = true;
+      continue;
+    }
+    PointerData resampled = Resample(state.samples, sample_time);
+    state.dispatched_time_stamp =
+        std::min(sample_time, state.samples.back().time_stamp);
+
+    // Only the newest sample at or before the sample time is needed to
+    // interpolate in the next frame.
+    auto next = std::upper_bound(state.samples.begin(), state.samples.end(),
+                                 sample_time, CompareTimeStamp);
+    if (next != state.samples.begin()) {
+      state.samples.erase(state.samples.begin(), next - 1);
+    }
+
+    resampled.physical_delta_x = resampled.physical_x - state.last_x;
+    resampled.physical_delta_y = resampled.physical_y - state.last_y;
+    state.last_x = resampled.physical_x;
+    state.last_y = resampled.physical_y;
+    events.push_back(resampled);
+
+    has_pending_samples |= state.HasPendingSamples();
+  }
+
+  if (!events.empty()) {
+    uint64_t trace_flow_id = last_trace_flow_id_;
+    if (!pending_trace_flow_ids_.empty()) {
+      trace_flow_id = pending_trace_flow_ids_.back();
+      pending_trace_flow_ids_.pop_back();
+      // The events of these flows have been folded into the resampled ones.
+      for (uint64_t folded_trace_flow_id : pending_trace_flow_ids_) {
+        TRACE_FLOW_END("flutter", "PointerEvent", folded_trace_flow_id);
+      }
+      pending_trace_flow_ids_.clear();
+    }
+    DispatchEvents(events, trace_flow_id);
+  }
+
+  if (has_pending_samples) {
+    ScheduleSecondaryVsyncCallback();
+  }
+}
+
+void ResamplingPointerDataDispatcher::DispatchEvents(
+    const std::vector<PointerData>& events,
+    uint64_t trace_flow_id) {
+  auto packet = std::make_unique<PointerDataPacket>(events.size());
+  for (size_t i = 0; i < events.size(); i++) {
+    packet->SetPointerData(i, events[i]);
+  }
+  last_trace_flow_id_ = trace_flow_id;
+  DefaultPointerDataDispatcher::DispatchPacket(std::move(packet),
+                                               trace_flow_id);
+}
+
+PointerData ResamplingPointerDataDispatcher::Resample(
+    const std::vector<PointerData>& samples,
+    int64_t sample_time) {
+  FML_DCHECK(!samples.empty());
+  FML_DCHECK(samples.front().time_stamp <= sample_time);
+
+  auto next = std::upper_bound(samples.begin(), samples.end(), sample_time,
+                               CompareTimeStamp);
+
+  if (next == samples.end()) {
+    // No sample newer than the sample time yet. Stay at the newest one rather
+    // than predicting a position the pointer may have to move back from.
+    PointerData clamped = samples.back();
+    clamped.time_stamp = sample_time;
+    return clamped;
+  }
+
+  const PointerData* prev = &*(next - 1);
+  const PointerData* last = &*next;
+  const int64_t interval = last->time_stamp - prev->time_stamp;
+  if (interval <= 0) {
+    return *last;
+  }
+  const double alpha =
+      static_cast<double>(sample_time - prev->time_stamp) / interval;
+
+  PointerData resampled = *last;
+  resampled.time_stamp = sample_time;
+  resampled.physical_x =
+      prev->physical_x + (last->physical_x - prev->physical_x) * alpha;
+  resampled.physical_y =
+      prev->physical_y + (last->physical_y - prev->physical_y) * alpha;
+  return resampled;
+}
+
 }  // namespace flutter
@@ -5,6 +5,9 @@
 #ifndef POINTER_DATA_DISPATCHER_H_
 #define POINTER_DATA_DISPATCHER_H_
 
+#include <map>
+#include <vector>
+
 #include "flutter/runtime/runtime_controller.h"
 #include "flutter/shell/common/animator.h"
 
@@ -62,6 +65,15 @@ class PointerDataDispatcher {
     ///           `SmoothPointerDataDispatcher`.
     virtual void ScheduleSecondaryVsyncCallback(
         const fml::closure& callback) = 0;
+
+    //--------------------------------------------------------------------------
+    /// @brief    The target time of the most recent frame begun by the
+    ///           `Animator`. This is the default-constructed `TimePoint` if no
+    ///           frame has been begun yet.
+    ///
+    ///           This is used by `ResamplingPointerDataDispatcher` to choose
+    ///           the time at which pointer positions are sampled.
+    virtual fml::TimePoint GetLastFrameTargetTime() = 0;
   };
 
   //----------------------------------------------------------------------------
@@ -162,6 +174,100 @@ class SmoothPointerDataDispatcher : public DefaultPointerDataDispatcher {
   FML_DISALLOW_COPY_AND_ASSIGN(SmoothPointerDataDispatcher);
 };
 
+//------------------------------------------------------------------------------
+/// A dispatcher that resamples move events to the frame cadence.
+///
+/// Input devices often sample at a rate that is different from (and not in
+/// phase with) VSYNC. Dispatching every raw move event makes the framework do
+/// redundant hit testing and gesture work, and the number of events consumed
+/// per frame alternates between frames which shows up as uneven scrolling.
+///
+/// It works as follows:
+///
+/// Move and hover events are buffered per device instead of being dispatched.
+/// At the next VSYNC (through `ScheduleSecondaryVsyncCallback`), exactly one
+/// move is dispatched per device that has received new samples. Its position
+/// is interpolated between the two buffered samples surrounding the sample
+/// time, or clamped to the newest sample if no sample newer than the sample
+/// time has been received yet. Positions are never extrapolated, so the
+/// pointer never has to move back from a predicted position. Samples that are
+/// all newer than the sample time are held until a later frame. The sample time
+/// is `sampling_offset` before the target time of the last frame begun by the
+/// `Animator`, or before now if that frame is already in the past.
+///
+/// All other events (down, up, cancel, add, remove and pointer signals) are
+/// dispatched right away. Before such an event is dispatched, the newest
+/// buffered move of the same device is flushed unmodified so the framework
+/// never observes a position that is out of order with respect to the event.
+///
+/// Time stamps of `PointerData` are expected to be in microseconds on the
+/// same clock as `fml::TimePoint::Now`.
+///
+/// Platform views select this dispatcher through
+/// `PlatformView::GetDispatcherMaker`, as Android does for touch screens that
+/// sample out of phase with VSYNC.
+///
+/// See also input_events_unittests.cc.
+class ResamplingPointerDataDispatcher : public DefaultPointerDataDispatcher {
+ public:
+  // Samples are taken this long before the frame target time by default. The
+  // frame target time is one frame interval after VSYNC, so on a 60Hz display
+  // this samples about 5ms before VSYNC, which is almost always between two
+  // received events.
+  static constexpr fml::TimeDelta kDefaultSamplingOffset =
+      fml::TimeDelta::FromMilliseconds(21);
+
+  explicit ResamplingPointerDataDispatcher(
+      Delegate& delegate,
+      fml::TimeDelta sampling_offset = kDefaultSamplingOffset);
+
+  // |PointerDataDispatcer|
+  void DispatchPacket(std::unique_ptr<PointerDataPacket> packet,
+                      uint64_t trace_flow_id) override;
+
+  virtual ~ResamplingPointerDataDispatcher();
+
+ private:
+  struct PointerState {
+    // Received move events that have not been consumed by resampling yet,
+    // ordered by time stamp. The newest sample at or before the last sample
+    // time is kept so the next frame can interpolate from it.
+    std::vector<PointerData> samples;
+    // The position last dispatched to the framework for this device, used to
+    // compute the deltas of resampled events.
+    double last_x = 0.0;
+    double last_y = 0.0;
+    // Buffered samples with a time stamp at or before this have already been
+    // accounted for by a dispatched event.
+    int64_t dispatched_time_stamp = 0;
+
+    bool HasPendingSamples() const {
+      return !samples.empty() &&
+             samples.back().time_stamp > dispatched_time_stamp;
+    }
+  };
+
+  const fml::TimeDelta sampling_offset_;
+  std::map<int64_t, PointerState> pointers_;
+  std::vector<uint64_t> pending_trace_flow_ids_;
+  uint64_t last_trace_flow_id_ = 0;
+  bool is_vsync_scheduled_ = false;
+
+  fml::WeakPtrFactory<ResamplingPointerDataDispatcher> weak_factory_;
+
+  void OnVsync();
+
+  void ScheduleSecondaryVsyncCallback();
+
+  void DispatchEvents(const std::vector<PointerData>& events,
+                      uint64_t trace_flow_id);
+
+  static PointerData Resample(const std::vector<PointerData>& samples,
+                              int64_t sample_time);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ResamplingPointerDataDispatcher);
+};
+
 //--------------------------------------------------------------------------
 /// @brief      Signature for constructing PointerDataDispatcher.
 ///
@@ -8,6 +8,7 @@
 
 #include <utility>
 
+#include "flutter/flow/layers/layer_tree_serialization.h"
 #include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/time/time_point.h"
 #include "third_party/skia/include/core/SkEncodedImageFormat.h"
@@ -24,6 +25,11 @@ namespace flutter {
 // used within this interval.
 static constexpr std::chrono::milliseconds kSkiaCleanupExpiration(15000);
 
+// The time spent compiling shaders in each warm-up batch before yielding to
+// other raster tasks, such as rendering frames.
+static constexpr fml::TimeDelta kShaderWarmUpBatchBudget =
+    fml::TimeDelta::FromMilliseconds(8);
+
 // TODO(dnfield): Remove this once internal embedders have caught up.
 static Rasterizer::DummyDelegate dummy_delegate_;
 Rasterizer::Rasterizer(
@@ -64,6 +70,9 @@ fml::TaskRunnerAffineWeakPtr<SnapshotDelegate> Rasterizer::GetSnapshotDelegate()
 
 void Rasterizer::Setup(std::unique_ptr<Surface> surface) {
   surface_ = std::move(surface);
+  resource_cache_budget_ = ResourceCacheBudget::GetInstance().AddParticipant(
+      task_runners_.GetLabel(),
+      ResourceCacheBudget::ParticipantType::kRasterizer);
   if (max_cache_bytes_.has_value()) {
     SetResourceCacheMaxBytes(max_cache_bytes_.value(),
                              user_override_resource_cache_bytes_);
@@ -79,11 +88,68 @@ void Rasterizer::Setup(std::unique_ptr<Surface> surface) {
 }
 
 void Rasterizer::Teardown() {
+  shader_warm_up_generation_++;
   compositor_context_->OnGrContextDestroyed();
   surface_.reset();
+  resource_cache_budget_.reset();
   last_layer_tree_.reset();
 }
 
+bool Rasterizer::CanWarmUpShaders() const {
+  // Only the GL backend supports precompiling SkSL shaders.
+  return surface_ && surface_->GetContext() &&
+         surface_->GetContext()->backend() == GrBackend::kOpenGL_GrBackend;
+}
+
+void Rasterizer::WarmUpShaders(std::shared_ptr<ShaderWarmUp> warm_up) {
+  TRACE_EVENT0("flutter", "Rasterizer::WarmUpShaders");
+  if (!warm_up || !CanWarmUpShaders()) {
+    return;
+  }
+  shader_warm_up_generation_++;
+  warm_up->Start(PersistentCache::GetCacheForProcess()->LoadSkSLs());
+  PostShaderWarmUpBatch(std::move(warm_up));
+}
+
+void Rasterizer::WarmUpAddedShaders(std::shared_ptr<ShaderWarmUp> warm_up) {
+  TRACE_EVENT0("flutter", "Rasterizer::WarmUpAddedShaders");
+  if (!warm_up || !CanWarmUpShaders()) {
+    return;
+  }
+  // Pending batches pick up the added shaders. Otherwise compiling resumes.
+  if (warm_up->Add(PersistentCache::GetCacheForProcess()->LoadSkSLs())) {
+    PostShaderWarmUpBatch(std::move(warm_up));
+  }
+}
+
+void Rasterizer::PostShaderWarmUpBatch(std::shared_ptr<ShaderWarmUp> warm_up) {
+  task_runners_.GetRasterTaskRunner()->PostTask(
+      [rasterizer = weak_factory_.GetWeakPtr(),
+       generation = shader_warm_up_generation_, warm_up]() {
+        if (!rasterizer || !rasterizer->surface_ ||
+            rasterizer->shader_warm_up_generation_ != generation) {
+          return;
+        }
+        auto* context = rasterizer->surface_->GetContext();
+        if (!context || !rasterizer->surface_->MakeRenderContextCurrent()) {
+          return;
+        }
+        const bool has_more = warm_up->CompileBatch(
+            [context](const PersistentCache::SkSLCache& sksl) {
+              return context->precompileShader(*sksl.first, *sksl.second);
+            },
+            kShaderWarmUpBatchBudget);
+        if (has_more) {
+          rasterizer->PostShaderWarmUpBatch(warm_up);
+          return;
+        }
+        const auto progress = warm_up->GetProgress();
+        FML_LOG(INFO) << "Found " << progress.total
+                      << " SkSL shaders; precompiled " << progress.compiled
+                      << " in " << progress.elapsed.ToMilliseconds() << "ms";
+      });
+}
+
 void Rasterizer::NotifyLowMemoryWarning() const {
   if (!surface_) {
     FML_DLOG(INFO) << "Rasterizer::PurgeCaches called with no surface.";
@@ -95,6 +161,7 @@ void Rasterizer::NotifyLowMemoryWarning() const {
     return;
   }
   context->freeGpuResources();
+  UpdateResourceCacheBudget();
 }
 
 flutter::TextureRegistry* Rasterizer::GetTextureRegistry() {
@@ -109,7 +176,7 @@ void Rasterizer::DrawLastLayerTree() {
   if (!last_layer_tree_ || !surface_) {
     return;
   }
-  DrawToSurface(*last_layer_tree_);
+  DrawToSurface(*last_layer_tree_, nullptr);
 }
 
 void Rasterizer::Draw(fml::RefPtr<Pipeline<flutter::LayerTree>> pipeline) {
@@ -267,9 +334,14 @@ RasterStatus Rasterizer::DoDraw(
   PersistentCache* persistent_cache = PersistentCache::GetCacheForProcess();
   persistent_cache->ResetStoredNewShaders();
 
-  RasterStatus raster_status = DrawToSurface(*layer_tree);
+  RasterStatus raster_status = DrawToSurface(*layer_tree, &timing);
+  // The compositor frame sweeps the raster cache when it is collected at the
+  // end of |DrawToSurface|.
+  timing.SetRasterCacheStats(
+      compositor_context_->raster_cache().GetLastFrameStats());
   if (raster_status == RasterStatus::kSuccess) {
     last_layer_tree_ = std::move(layer_tree);
+    UpdateResourceCacheBudget();
   } else if (raster_status == RasterStatus::kResubmit) {
     resubmitted_layer_tree_ = std::move(layer_tree);
     return raster_status;
@@ -345,7 +417,8 @@ RasterStatus Rasterizer::DoDraw(
   return raster_status;
 }
 
-RasterStatus Rasterizer::DrawToSurface(flutter::LayerTree& layer_tree) {
+RasterStatus Rasterizer::DrawToSurface(flutter::LayerTree& layer_tree,
+                                       FrameTiming* frame_timing) {
   TRACE_EVENT0("flutter", "Rasterizer::DrawToSurface");
   FML_DCHECK(surface_);
 
@@ -389,7 +462,14 @@ RasterStatus Rasterizer::DrawToSurface(flutter::LayerTree& layer_tree) {
       raster_thread_merger_         // thread merger
   );
 
+  auto record_phase = [frame_timing](FrameTiming::RasterPhase phase) {
+    if (frame_timing) {
+      frame_timing->SetRasterPhase(phase, fml::TimePoint::Now());
+    }
+  };
+
   if (compositor_frame) {
+    compositor_frame->set_frame_timing(frame_timing);
     RasterStatus raster_status = compositor_frame->Raster(layer_tree, false);
     if (raster_status == RasterStatus::kFailed) {
       return raster_status;
@@ -397,15 +477,24 @@ RasterStatus Rasterizer::DrawToSurface(flutter::LayerTree& layer_tree) {
     if (external_view_embedder != nullptr) {
       external_view_embedder->SubmitFrame(surface_->GetContext(),
                                           root_surface_canvas);
-      // The external view embedder may mutate the root surface canvas while
-      // submitting the frame.
-      // Therefore, submit the final frame after asking the external view
-      // embedder to submit the frame.
-      frame->Submit();
+    }
+
+    // Surfaces flush the frame canvas as part of submitting the frame and
+    // report when the flush finished so that the time spent flushing and
+    // presenting can be told apart. If a surface does not, the whole
+    // submission is attributed to presenting.
+    record_phase(FrameTiming::kFlushStart);
+    record_phase(FrameTiming::kFlushFinish);
+    record_phase(FrameTiming::kPresentStart);
+    frame->set_flushed_callback([&record_phase]() {
+      record_phase(FrameTiming::kFlushFinish);
+      record_phase(FrameTiming::kPresentStart);
+    });
+    frame->Submit();
+    if (external_view_embedder != nullptr) {
       external_view_embedder->FinishFrame();
-    } else {
-      frame->Submit();
     }
+    record_phase(FrameTiming::kPresentFinish);
 
     FireNextFrameCallbackIfPresent();
 
@@ -556,6 +645,9 @@ Rasterizer::Screenshot Rasterizer::ScreenshotLastLayerTree(
       data = ScreenshotLayerTreeAsImage(layer_tree, *compositor_context_,
                                         surface_context, true);
       break;
+    case ScreenshotType::LayerTree:
+      data = SerializeLayerTree(*layer_tree);
+      break;
   }
 
   if (data == nullptr) {
@@ -601,11 +693,35 @@ void Rasterizer::SetResourceCacheMaxBytes(size_t max_bytes, bool from_user) {
     return;
   }
 
+  resource_cache_budget_->SetRequestedBytes(max_bytes);
   GrContext* context = surface_->GetContext();
   if (context) {
     int max_resources;
     context->getResourceCacheLimits(&max_resources, nullptr);
-    context->setResourceCacheLimits(max_resources, max_bytes);
+    context->setResourceCacheLimits(
+        max_resources, resource_cache_budget_->GetLimit().value_or(max_bytes));
+  }
+}
+
+void Rasterizer::UpdateResourceCacheBudget() const {
+  GrContext* context = surface_->GetContext();
+  if (!context) {
+    return;
+  }
+  size_t usage_bytes;
+  context->getResourceCacheUsage(nullptr, &usage_bytes);
+  resource_cache_budget_->ReportUsage(usage_bytes);
+
+  // Other engines may have changed the limit since the last report.
+  auto limit = resource_cache_budget_->GetLimit();
+  if (!limit.has_value()) {
+    return;
+  }
+  int max_resources;
+  size_t max_bytes;
+  context->getResourceCacheLimits(&max_resources, &max_bytes);
+  if (max_bytes != limit.value()) {
+    context->setResourceCacheLimits(max_resources, limit.value());
   }
 }
 
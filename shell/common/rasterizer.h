@@ -20,6 +20,8 @@
 #include "flutter/fml/time/time_point.h"
 #include "flutter/lib/ui/snapshot_delegate.h"
 #include "flutter/shell/common/pipeline.h"
+#include "flutter/shell/common/resource_cache_budget.h"
+#include "flutter/shell/common/shader_warm_up.h"
 #include "flutter/shell/common/surface.h"
 
 namespace flutter {
@@ -170,11 +172,37 @@ class Rasterizer final : public SnapshotDelegate {
   ///
   void Teardown();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Precompiles the recorded SkSL shaders of the process for the
+  ///             context of the on-screen surface, so that they are not
+  ///             compiled when first used in a frame. Shaders are compiled in
+  ///             budgeted batches posted to the raster task runner, so that
+  ///             frames can be rendered between batches. The warm-up stops
+  ///             when the surface is torn down and must be started again for
+  ///             the next surface. Shaders are compiled in the order the
+  ///             persistent cache loads them, which is not the order they
+  ///             were recorded in. Only the GL backend supports this.
+  ///
+  /// @param[in]  warm_up  Tracks the progress of the warm-up.
+  ///
+  void WarmUpShaders(std::shared_ptr<ShaderWarmUp> warm_up);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Precompiles the recorded SkSL shaders that were not available
+  ///             when the warm-up for the current surface was started, such
+  ///             as those bundled with the assets of an application run after
+  ///             the surface was created. Does nothing without a surface.
+  ///
+  /// @param[in]  warm_up  Tracks the progress of the warm-up.
+  ///
+  void WarmUpAddedShaders(std::shared_ptr<ShaderWarmUp> warm_up);
+
   //----------------------------------------------------------------------------
   /// @brief      Notifies the rasterizer that there is a low memory situation
   ///             and it must purge as many unnecessary resources as possible.
   ///             Currently, the Skia context associated with onscreen rendering
-  ///             is told to free GPU resources.
+  ///             is told to free GPU resources, and its share of the
+  ///             process-wide resource cache budget is rebalanced.
   ///
   void NotifyLowMemoryWarning() const;
 
@@ -288,6 +316,14 @@ class Rasterizer final : public SnapshotDelegate {
     /// container is used.
     ///
     CompressedImage,
+
+    //--------------------------------------------------------------------------
+    /// A format used to denote the whole layer tree, with its layers and the
+    /// pictures they draw, as written by `SerializeLayerTree`. Unlike a Skia
+    /// picture, the tree can be prerolled and painted again, e.g. to
+    /// benchmark rasterization offline.
+    ///
+    LayerTree,
   };
 
   //----------------------------------------------------------------------------
@@ -430,6 +466,12 @@ class Rasterizer final : public SnapshotDelegate {
   fml::closure next_frame_callback_;
   bool user_override_resource_cache_bytes_;
   std::optional<size_t> max_cache_bytes_;
+  // The share of the process-wide resource cache budget held by the context
+  // of |surface_|. Only present while there is a surface.
+  std::unique_ptr<ResourceCacheBudget::Participant> resource_cache_budget_;
+  // Incremented whenever the surface changes to stop pending shader warm-up
+  // batches for the previous surface.
+  size_t shader_warm_up_generation_ = 0;
   fml::TaskRunnerAffineWeakPtrFactory<Rasterizer> weak_factory_;
   fml::RefPtr<fml::RasterThreadMerger> raster_thread_merger_;
 
@@ -446,10 +488,21 @@ class Rasterizer final : public SnapshotDelegate {
 
   RasterStatus DoDraw(std::unique_ptr<flutter::LayerTree> layer_tree);
 
-  RasterStatus DrawToSurface(flutter::LayerTree& layer_tree);
+  // Reports the bytes held by the surface's context to the resource cache
+  // budget and applies the limit the budget gives back.
+  void UpdateResourceCacheBudget() const;
+
+  // If |frame_timing| is not null, the timestamps of the steps of the raster
+  // phase and the raster cache stats are recorded into it.
+  RasterStatus DrawToSurface(flutter::LayerTree& layer_tree,
+                             FrameTiming* frame_timing);
 
   void FireNextFrameCallbackIfPresent();
 
+  bool CanWarmUpShaders() const;
+
+  void PostShaderWarmUpBatch(std::shared_ptr<ShaderWarmUp> warm_up);
+
   FML_DISALLOW_COPY_AND_ASSIGN(Rasterizer);
 };
 
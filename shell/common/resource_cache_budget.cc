@@ -0,0 +1,178 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/resource_cache_budget.h"
+
+#include <algorithm>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+ResourceCacheBudget::Participant::Participant(ResourceCacheBudget* budget,
+                                              std::string label,
+                                              ParticipantType type)
+    : budget_(budget), label_(std::move(label)), type_(type) {}
+
+ResourceCacheBudget::Participant::~Participant() {
+  std::scoped_lock lock(budget_->mutex_);
+  auto& participants = budget_->participants_;
+  participants.erase(
+      std::find(participants.begin(), participants.end(), this));
+  budget_->Rebalance();
+}
+
+void ResourceCacheBudget::Participant::SetRequestedBytes(
+    size_t requested_bytes) {
+  std::scoped_lock lock(budget_->mutex_);
+  if (requested_bytes_ == requested_bytes) {
+    return;
+  }
+  requested_bytes_ = requested_bytes;
+  budget_->Rebalance();
+}
+
+void ResourceCacheBudget::Participant::ReportUsage(size_t usage_bytes) {
+  std::scoped_lock lock(budget_->mutex_);
+  usage_bytes_ = usage_bytes;
+  if (budget_->max_bytes_ != 0 &&
+      fml::TimePoint::Now() - budget_->last_rebalance_ >= kRebalanceInterval) {
+    budget_->Rebalance();
+  }
+}
+
+std::optional<size_t> ResourceCacheBudget::Participant::GetLimit() const {
+  std::scoped_lock lock(budget_->mutex_);
+  return limit_bytes_;
+}
+
+ResourceCacheBudget& ResourceCacheBudget::GetInstance() {
+  // Never destroyed, so that participants may outlive static destructors.
+  static ResourceCacheBudget* budget = new ResourceCacheBudget();
+  return *budget;
+}
+
+ResourceCacheBudget::ResourceCacheBudget() = default;
+
+ResourceCacheBudget::~ResourceCacheBudget() {
+  FML_DCHECK(participants_.empty());
+}
+
+std::unique_ptr<ResourceCacheBudget::Participant>
+ResourceCacheBudget::AddParticipant(std::string label, ParticipantType type) {
+  std::unique_ptr<Participant> participant(
+      new Participant(this, std::move(label), type));
+  std::scoped_lock lock(mutex_);
+  participants_.push_back(participant.get());
+  Rebalance();
+  return participant;
+}
+
+void ResourceCacheBudget::SetMaxBytes(size_t max_bytes) {
+  std::scoped_lock lock(mutex_);
+  max_bytes_ = max_bytes;
+  Rebalance();
+}
+
+size_t ResourceCacheBudget::GetMaxBytes() const {
+  std::scoped_lock lock(mutex_);
+  return max_bytes_;
+}
+
+void ResourceCacheBudget::NotifyLowMemoryWarning() {
+  std::scoped_lock lock(mutex_);
+  for (auto* participant : participants_) {
+    if (participant->type_ == ParticipantType::kRasterizer) {
+      participant->usage_bytes_ = 0;
+    }
+  }
+  Rebalance();
+}
+
+std::vector<ResourceCacheBudget::ParticipantUsage>
+ResourceCacheBudget::GetUsage() const {
+  std::scoped_lock lock(mutex_);
+  std::vector<ParticipantUsage> usage;
+  usage.reserve(participants_.size());
+  for (const auto* participant : participants_) {
+    usage.push_back({participant->label_, participant->type_,
+                     participant->usage_bytes_, participant->limit_bytes_});
+  }
+  return usage;
+}
+
+void ResourceCacheBudget::Rebalance() {
+  TRACE_EVENT0("flutter", "ResourceCacheBudget::Rebalance");
+  last_rebalance_ = fml::TimePoint::Now();
+
+  // The weight of each rasterizer is taken once, so that every pass below
+  // splits the same snapshot of usages.
+  struct Share {
+    Participant* rasterizer;
+    double weight;
+  };
+  std::vector<Share> shares;
+  size_t resource_context_bytes = 0;
+  for (auto* participant : participants_) {
+    if (participant->type_ == ParticipantType::kRasterizer) {
+      shares.push_back({participant,
+                        static_cast<double>(std::max(
+                            participant->usage_bytes_, kMinimumWeightBytes))});
+    } else {
+      resource_context_bytes += participant->usage_bytes_;
+      // Resource contexts don't cache resources.
+      participant->limit_bytes_ = std::nullopt;
+    }
+  }
+
+  if (max_bytes_ == 0) {
+    for (const auto& share : shares) {
+      share.rasterizer->limit_bytes_ = share.rasterizer->requested_bytes_;
+    }
+    return;
+  }
+
+  // Split what the resource contexts leave in proportion to each rasterizer's
+  // weight. Rasterizers whose share would exceed their request get exactly
+  // their request, and the rest is split again among the others.
+  size_t available = max_bytes_ > resource_context_bytes
+                         ? max_bytes_ - resource_context_bytes
+                         : 0;
+  auto total_weight = [&shares]() {
+    double total = 0;
+    for (const auto& share : shares) {
+      total += share.weight;
+    }
+    return total;
+  };
+  bool capped = true;
+  while (capped && !shares.empty()) {
+    capped = false;
+    const double weight = total_weight();
+    size_t capped_bytes = 0;
+    for (auto it = shares.begin(); it != shares.end();) {
+      auto* rasterizer = it->rasterizer;
+      if (rasterizer->requested_bytes_.has_value() &&
+          available * it->weight / weight >=
+              rasterizer->requested_bytes_.value()) {
+        rasterizer->limit_bytes_ = rasterizer->requested_bytes_;
+        capped_bytes += rasterizer->requested_bytes_.value();
+        it = shares.erase(it);
+        capped = true;
+      } else {
+        ++it;
+      }
+    }
+    available -= capped_bytes;
+  }
+
+  const double weight = total_weight();
+  for (const auto& share : shares) {
+    share.rasterizer->limit_bytes_ =
+        static_cast<size_t>(available * share.weight / weight);
+  }
+}
+
+}  // namespace flutter
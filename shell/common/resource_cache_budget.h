@@ -0,0 +1,161 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_RESOURCE_CACHE_BUDGET_H_
+#define FLUTTER_SHELL_COMMON_RESOURCE_CACHE_BUDGET_H_
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Splits a process-wide limit on the bytes held by Skia resource
+///             caches among the GrContexts of all the engines in a process.
+///
+///             Each rasterizer asks for a resource cache limit derived from
+///             its own view, so without a shared budget several engines on
+///             one device can hold far more than any of them would alone.
+///             Rasterizers get a share of the limit weighted by the bytes
+///             their caches recently held, and never more than they asked
+///             for. The bytes held by resource contexts, which upload images
+///             but don't cache them, are taken out of the limit first.
+///
+///             Participants report their usage from the threads their
+///             contexts live on, and apply their limit there. All methods
+///             are thread safe.
+///
+class ResourceCacheBudget {
+ public:
+  enum class ParticipantType {
+    // The onscreen GrContext of a rasterizer.
+    kRasterizer,
+    // The GrContext an IO manager uploads images with.
+    kResourceContext,
+  };
+
+  struct ParticipantUsage {
+    // The label of the engine the participant belongs to.
+    std::string label;
+    ParticipantType type;
+    // The bytes last reported as held by the participant's context.
+    size_t usage_bytes = 0;
+    // The limit the participant should apply to its resource cache, if any.
+    std::optional<size_t> limit_bytes;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      A GrContext whose resource cache is limited by the budget.
+  ///             Destroying the participant removes it from the budget.
+  ///
+  class Participant {
+   public:
+    ~Participant();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Sets the most bytes the participant wants its cache to hold,
+    ///             e.g. derived from its view size or set by the user.
+    ///
+    void SetRequestedBytes(size_t requested_bytes);
+
+    //--------------------------------------------------------------------------
+    /// @brief      Records the bytes currently held by the participant's
+    ///             context. The budget is rebalanced at most once per
+    ///             rebalance interval because of reports.
+    ///
+    void ReportUsage(size_t usage_bytes);
+
+    //--------------------------------------------------------------------------
+    /// @return     The limit the participant should apply to its resource
+    ///             cache, or std::nullopt if it should leave it unchanged.
+    ///
+    std::optional<size_t> GetLimit() const;
+
+   private:
+    friend class ResourceCacheBudget;
+
+    ResourceCacheBudget* budget_;
+    std::string label_;
+    ParticipantType type_;
+    std::optional<size_t> requested_bytes_;
+    size_t usage_bytes_ = 0;
+    std::optional<size_t> limit_bytes_;
+
+    Participant(ResourceCacheBudget* budget,
+                std::string label,
+                ParticipantType type);
+
+    FML_DISALLOW_COPY_AND_ASSIGN(Participant);
+  };
+
+  // Cache usage below this is treated as this when weighting shares, so that
+  // idle participants still get a useful share.
+  static constexpr size_t kMinimumWeightBytes = 1 << 20;
+
+  // The shortest time between rebalances caused by usage reports.
+  static constexpr fml::TimeDelta kRebalanceInterval =
+      fml::TimeDelta::FromSeconds(1);
+
+  //----------------------------------------------------------------------------
+  /// @brief      The budget shared by all the engines in the process. It is
+  ///             unlimited until a limit is set.
+  ///
+  static ResourceCacheBudget& GetInstance();
+
+  ResourceCacheBudget();
+
+  ~ResourceCacheBudget();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds a participant to the budget. The budget must outlive
+  ///             the participant.
+  ///
+  /// @param[in]  label  The label of the engine the participant belongs to.
+  /// @param[in]  type   The kind of context the participant owns.
+  ///
+  std::unique_ptr<Participant> AddParticipant(std::string label,
+                                              ParticipantType type);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the most bytes all the participants' contexts may hold
+  ///             together, or 0 for no limit, in which case participants
+  ///             get the limits they request.
+  ///
+  void SetMaxBytes(size_t max_bytes);
+
+  size_t GetMaxBytes() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Forgets the usage recorded for rasterizers, which purge
+  ///             their caches on low memory, so that their shares are
+  ///             rebalanced evenly until they report their usage again.
+  ///
+  void NotifyLowMemoryWarning();
+
+  //----------------------------------------------------------------------------
+  /// @return     The usage and limit of every participant.
+  ///
+  std::vector<ParticipantUsage> GetUsage() const;
+
+ private:
+  mutable std::mutex mutex_;
+  size_t max_bytes_ = 0;
+  std::vector<Participant*> participants_;
+  fml::TimePoint last_rebalance_;
+
+  // Recomputes the limits of all the participants. |mutex_| must be held.
+  void Rebalance();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ResourceCacheBudget);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_RESOURCE_CACHE_BUDGET_H_
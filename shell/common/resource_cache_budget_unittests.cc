@@ -0,0 +1,131 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/resource_cache_budget.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+constexpr size_t kMB = 1 << 20;
+
+using ParticipantType = ResourceCacheBudget::ParticipantType;
+
+}  // namespace
+
+TEST(ResourceCacheBudgetTest, UnlimitedBudgetGivesRequestedBytes) {
+  ResourceCacheBudget budget;
+  auto rasterizer =
+      budget.AddParticipant("engine", ParticipantType::kRasterizer);
+  ASSERT_FALSE(rasterizer->GetLimit().has_value());
+
+  rasterizer->SetRequestedBytes(24 * kMB);
+  ASSERT_EQ(rasterizer->GetLimit(), 24 * kMB);
+}
+
+TEST(ResourceCacheBudgetTest, SplitsIdleRasterizersEvenly) {
+  ResourceCacheBudget budget;
+  budget.SetMaxBytes(30 * kMB);
+  auto first = budget.AddParticipant("first", ParticipantType::kRasterizer);
+  auto second = budget.AddParticipant("second", ParticipantType::kRasterizer);
+  first->SetRequestedBytes(24 * kMB);
+  second->SetRequestedBytes(24 * kMB);
+
+  ASSERT_EQ(first->GetLimit(), 15 * kMB);
+  ASSERT_EQ(second->GetLimit(), 15 * kMB);
+}
+
+TEST(ResourceCacheBudgetTest, SplitsByUsageAndCapsAtRequestedBytes) {
+  ResourceCacheBudget budget;
+  auto small = budget.AddParticipant("small", ParticipantType::kRasterizer);
+  auto large = budget.AddParticipant("large", ParticipantType::kRasterizer);
+  auto busy = budget.AddParticipant("busy", ParticipantType::kRasterizer);
+  small->SetRequestedBytes(4 * kMB);
+  large->SetRequestedBytes(100 * kMB);
+  busy->SetRequestedBytes(100 * kMB);
+  small->ReportUsage(4 * kMB);
+  large->ReportUsage(10 * kMB);
+  busy->ReportUsage(30 * kMB);
+
+  // Weighted by usage |small| would get 16MB, more than it asked for, so the
+  // other 60MB are split between the others.
+  budget.SetMaxBytes(64 * kMB);
+  ASSERT_EQ(small->GetLimit(), 4 * kMB);
+  ASSERT_EQ(large->GetLimit(), 15 * kMB);
+  ASSERT_EQ(busy->GetLimit(), 45 * kMB);
+}
+
+TEST(ResourceCacheBudgetTest, CapsSeveralRasterizersInOnePass) {
+  ResourceCacheBudget budget;
+  auto small = budget.AddParticipant("small", ParticipantType::kRasterizer);
+  auto medium = budget.AddParticipant("medium", ParticipantType::kRasterizer);
+  auto large = budget.AddParticipant("large", ParticipantType::kRasterizer);
+  small->SetRequestedBytes(10 * kMB);
+  medium->SetRequestedBytes(30 * kMB);
+  large->SetRequestedBytes(100 * kMB);
+  small->ReportUsage(10 * kMB);
+  medium->ReportUsage(30 * kMB);
+  large->ReportUsage(60 * kMB);
+
+  // Both |small| and |medium| get exactly their request out of the same
+  // split, and |large| gets everything they leave.
+  budget.SetMaxBytes(100 * kMB);
+  ASSERT_EQ(small->GetLimit(), 10 * kMB);
+  ASSERT_EQ(medium->GetLimit(), 30 * kMB);
+  ASSERT_EQ(large->GetLimit(), 60 * kMB);
+}
+
+TEST(ResourceCacheBudgetTest, ResourceContextUsageIsTakenOutFirst) {
+  ResourceCacheBudget budget;
+  auto rasterizer =
+      budget.AddParticipant("engine", ParticipantType::kRasterizer);
+  auto resource_context =
+      budget.AddParticipant("engine", ParticipantType::kResourceContext);
+  rasterizer->SetRequestedBytes(64 * kMB);
+  resource_context->ReportUsage(8 * kMB);
+
+  budget.SetMaxBytes(32 * kMB);
+  ASSERT_EQ(rasterizer->GetLimit(), 24 * kMB);
+  ASSERT_FALSE(resource_context->GetLimit().has_value());
+}
+
+TEST(ResourceCacheBudgetTest, RemovingParticipantRebalances) {
+  ResourceCacheBudget budget;
+  budget.SetMaxBytes(32 * kMB);
+  auto first = budget.AddParticipant("first", ParticipantType::kRasterizer);
+  auto second = budget.AddParticipant("second", ParticipantType::kRasterizer);
+  ASSERT_EQ(first->GetLimit(), 16 * kMB);
+
+  second.reset();
+  ASSERT_EQ(first->GetLimit(), 32 * kMB);
+}
+
+TEST(ResourceCacheBudgetTest, LowMemoryWarningForgetsRasterizerUsage) {
+  ResourceCacheBudget budget;
+  auto idle = budget.AddParticipant("idle", ParticipantType::kRasterizer);
+  auto busy = budget.AddParticipant("busy", ParticipantType::kRasterizer);
+  auto resource_context =
+      budget.AddParticipant("busy", ParticipantType::kResourceContext);
+  busy->ReportUsage(7 * kMB);
+  resource_context->ReportUsage(2 * kMB);
+  budget.SetMaxBytes(18 * kMB);
+  ASSERT_EQ(idle->GetLimit(), 2 * kMB);
+  ASSERT_EQ(busy->GetLimit(), 14 * kMB);
+
+  budget.NotifyLowMemoryWarning();
+  ASSERT_EQ(idle->GetLimit(), 8 * kMB);
+  ASSERT_EQ(busy->GetLimit(), 8 * kMB);
+
+  auto usage = budget.GetUsage();
+  ASSERT_EQ(usage.size(), 3u);
+  ASSERT_EQ(usage[1].label, "busy");
+  ASSERT_EQ(usage[1].usage_bytes, 0u);
+  ASSERT_EQ(usage[2].type, ParticipantType::kResourceContext);
+  ASSERT_EQ(usage[2].usage_bytes, 2 * kMB);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -7,6 +7,7 @@
 #include <sstream>
 
 #include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/assets/packed_asset_bundle.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/unique_fd.h"
 #include "flutter/runtime/dart_vm.h"
@@ -14,19 +15,36 @@
 
 namespace flutter {
 
+// Adds the packed archive in the assets directory, if there is one, followed
+// by the directory itself for assets that are not in the archive.
+static void PushBackAssetsDirectory(AssetManager& asset_manager,
+                                    fml::UniqueFD directory) {
+  if (!directory.is_valid()) {
+    return;
+  }
+  if (fml::FileExists(directory, PackedAssetBundle::kArchiveFileName)) {
+    asset_manager.PushBack(std::make_unique<PackedAssetBundle>(
+        fml::FileMapping::CreateReadOnly(
+            directory, PackedAssetBundle::kArchiveFileName)));
+  }
+  asset_manager.PushBack(
+      std::make_unique<DirectoryAssetBundle>(std::move(directory)));
+}
+
 RunConfiguration RunConfiguration::InferFromSettings(
     const Settings& settings,
     fml::RefPtr<fml::TaskRunner> io_worker) {
   auto asset_manager = std::make_shared<AssetManager>();
 
   if (fml::UniqueFD::traits_type::IsValid(settings.assets_dir)) {
-    asset_manager->PushBack(std::make_unique<DirectoryAssetBundle>(
-        fml::Duplicate(settings.assets_dir)));
+    PushBackAssetsDirectory(*asset_manager,
+                            fml::Duplicate(settings.assets_dir));
   }
 
-  asset_manager->PushBack(
-      std::make_unique<DirectoryAssetBundle>(fml::OpenDirectory(
-          settings.assets_path.c_str(), false, fml::FilePermission::kRead)));
+  PushBackAssetsDirectory(
+      *asset_manager,
+      fml::OpenDirectory(settings.assets_path.c_str(), false,
+                         fml::FilePermission::kRead));
 
   return {IsolateConfiguration::InferFromSettings(settings, asset_manager,
                                                   io_worker),
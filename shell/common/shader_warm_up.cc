@@ -0,0 +1,84 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/shader_warm_up.h"
+
+#include "flutter/fml/time/time_point.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+ShaderWarmUp::ShaderWarmUp() = default;
+
+ShaderWarmUp::~ShaderWarmUp() = default;
+
+void ShaderWarmUp::Start(std::vector<PersistentCache::SkSLCache> sksls) {
+  std::scoped_lock lock(mutex_);
+  pending_.clear();
+  keys_.clear();
+  progress_ = {};
+  Enqueue(std::move(sksls));
+}
+
+bool ShaderWarmUp::Add(std::vector<PersistentCache::SkSLCache> sksls) {
+  std::scoped_lock lock(mutex_);
+  const bool was_finished = progress_.IsFinished();
+  return Enqueue(std::move(sksls)) > 0 && was_finished;
+}
+
+size_t ShaderWarmUp::Enqueue(std::vector<PersistentCache::SkSLCache> sksls) {
+  size_t count = 0;
+  for (auto& sksl : sksls) {
+    std::string key(static_cast<const char*>(sksl.first->data()),
+                    sksl.first->size());
+    if (keys_.insert(std::move(key)).second) {
+      pending_.push_back(std::move(sksl));
+      count++;
+    }
+  }
+  progress_.total += count;
+  return count;
+}
+
+bool ShaderWarmUp::CompileBatch(const CompileCallback& compile,
+                                fml::TimeDelta budget) {
+  TRACE_EVENT0("flutter", "ShaderWarmUp::CompileBatch");
+  const auto deadline = fml::TimePoint::Now() + budget;
+
+  // Compiling happens outside the lock so that progress can be queried
+  // while a shader is being compiled. Only this thread advances the
+  // warm-up.
+  do {
+    PersistentCache::SkSLCache sksl;
+    {
+      std::scoped_lock lock(mutex_);
+      if (progress_.IsFinished()) {
+        return false;
+      }
+      sksl = std::move(pending_.front());
+      pending_.pop_front();
+    }
+
+    const auto start = fml::TimePoint::Now();
+    const bool compiled = compile(sksl);
+    const auto elapsed = fml::TimePoint::Now() - start;
+
+    std::scoped_lock lock(mutex_);
+    progress_.attempted++;
+    progress_.compiled += compiled ? 1 : 0;
+    progress_.elapsed = progress_.elapsed + elapsed;
+    if (progress_.IsFinished()) {
+      return false;
+    }
+  } while (fml::TimePoint::Now() < deadline);
+
+  return true;
+}
+
+ShaderWarmUp::Progress ShaderWarmUp::GetProgress() const {
+  std::scoped_lock lock(mutex_);
+  return progress_;
+}
+
+}  // namespace flutter
@@ -0,0 +1,104 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_SHADER_WARM_UP_H_
+#define FLUTTER_SHELL_COMMON_SHADER_WARM_UP_H_
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/shell/common/persistent_cache.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Tracks the precompilation of recorded SkSL shaders so that they
+///             do not have to be compiled when they are first used in a frame.
+///
+///             Shaders are compiled in the order they are given, in batches
+///             limited by a time budget, so that frames can be rendered
+///             between batches. Batches are compiled on the thread that owns
+///             the context the shaders are compiled for. Progress may be
+///             queried from any thread.
+///
+class ShaderWarmUp {
+ public:
+  using CompileCallback =
+      std::function<bool(const PersistentCache::SkSLCache& sksl)>;
+
+  struct Progress {
+    // The number of shaders to compile.
+    size_t total = 0;
+    // The number of shaders compilation has been attempted for.
+    size_t attempted = 0;
+    // The number of shaders compiled successfully.
+    size_t compiled = 0;
+    // The time spent compiling shaders.
+    fml::TimeDelta elapsed;
+
+    bool IsFinished() const { return attempted == total; }
+  };
+
+  ShaderWarmUp();
+
+  ~ShaderWarmUp();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Discards any shaders not yet compiled and starts warming up
+  ///             the given shaders instead. This is needed whenever the
+  ///             context the shaders were compiled for is recreated.
+  ///
+  /// @param[in]  sksls  The shaders to compile.
+  ///
+  void Start(std::vector<PersistentCache::SkSLCache> sksls);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds the given shaders to the current warm-up, skipping those
+  ///             that were already given since it was started. This is needed
+  ///             when more shaders become available after the warm-up was
+  ///             started, such as the shaders bundled with the assets of an
+  ///             application that is run after its surface was created.
+  ///
+  /// @param[in]  sksls  The shaders to compile.
+  ///
+  /// @return     If the warm-up had finished and there are new shaders to
+  ///             compile, in which case compiling must be resumed.
+  ///
+  bool Add(std::vector<PersistentCache::SkSLCache> sksls);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Compiles the next shaders until the budget is exhausted. At
+  ///             least one shader is compiled per batch.
+  ///
+  /// @param[in]  compile  Compiles a shader and returns if it succeeded.
+  /// @param[in]  budget   The time available for this batch.
+  ///
+  /// @return     If there are shaders left to compile.
+  ///
+  bool CompileBatch(const CompileCallback& compile, fml::TimeDelta budget);
+
+  Progress GetProgress() const;
+
+ private:
+  mutable std::mutex mutex_;
+  std::deque<PersistentCache::SkSLCache> pending_;
+  // The keys of all shaders given since the warm-up was started.
+  std::unordered_set<std::string> keys_;
+  Progress progress_;
+
+  // Queues the shaders not given before. Returns the number queued.
+  size_t Enqueue(std::vector<PersistentCache::SkSLCache> sksls);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ShaderWarmUp);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_SHADER_WARM_UP_H_
@@ -0,0 +1,116 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "flutter/shell/common/shader_warm_up.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+std::vector<PersistentCache::SkSLCache> CreateSkSLs(size_t count) {
+  std::vector<PersistentCache::SkSLCache> sksls;
+  for (size_t i = 0; i < count; i++) {
+    const auto key = std::to_string(i);
+    sksls.push_back({SkData::MakeWithCString(key.c_str()),
+                     SkData::MakeWithCString("sksl")});
+  }
+  return sksls;
+}
+
+std::string GetKey(const PersistentCache::SkSLCache& sksl) {
+  return static_cast<const char*>(sksl.first->data());
+}
+
+}  // namespace
+
+TEST(ShaderWarmUpTest, NothingToCompileIsFinished) {
+  ShaderWarmUp warm_up;
+  ASSERT_TRUE(warm_up.GetProgress().IsFinished());
+
+  warm_up.Start({});
+  bool called = false;
+  ASSERT_FALSE(warm_up.CompileBatch(
+      [&called](const PersistentCache::SkSLCache&) {
+        called = true;
+        return true;
+      },
+      fml::TimeDelta::FromSeconds(1)));
+  ASSERT_FALSE(called);
+  ASSERT_TRUE(warm_up.GetProgress().IsFinished());
+}
+
+TEST(ShaderWarmUpTest, CompilesInOrderInBatches) {
+  ShaderWarmUp warm_up;
+  warm_up.Start(CreateSkSLs(3));
+  ASSERT_EQ(warm_up.GetProgress().total, 3u);
+
+  std::vector<std::string> compiled;
+  const auto compile = [&compiled](const PersistentCache::SkSLCache& sksl) {
+    compiled.push_back(GetKey(sksl));
+    // Fail one shader to check that it is still counted as attempted.
+    return compiled.size() != 2;
+  };
+
+  // An exhausted budget still compiles one shader per batch.
+  ASSERT_TRUE(warm_up.CompileBatch(compile, fml::TimeDelta::Zero()));
+  ASSERT_EQ(compiled.size(), 1u);
+  ASSERT_FALSE(warm_up.GetProgress().IsFinished());
+
+  ASSERT_FALSE(warm_up.CompileBatch(compile, fml::TimeDelta::FromSeconds(1)));
+  ASSERT_EQ(compiled, (std::vector<std::string>{"0", "1", "2"}));
+
+  const auto progress = warm_up.GetProgress();
+  ASSERT_TRUE(progress.IsFinished());
+  ASSERT_EQ(progress.attempted, 3u);
+  ASSERT_EQ(progress.compiled, 2u);
+}
+
+TEST(ShaderWarmUpTest, StartingAgainDiscardsProgress) {
+  ShaderWarmUp warm_up;
+  warm_up.Start(CreateSkSLs(4));
+  warm_up.CompileBatch([](const PersistentCache::SkSLCache&) { return true; },
+                       fml::TimeDelta::Zero());
+  ASSERT_EQ(warm_up.GetProgress().compiled, 1u);
+
+  warm_up.Start(CreateSkSLs(2));
+  const auto progress = warm_up.GetProgress();
+  ASSERT_EQ(progress.total, 2u);
+  ASSERT_EQ(progress.attempted, 0u);
+  ASSERT_EQ(progress.compiled, 0u);
+}
+
+TEST(ShaderWarmUpTest, AddsOnlyNewShaders) {
+  ShaderWarmUp warm_up;
+  warm_up.Start(CreateSkSLs(2));
+
+  std::vector<std::string> compiled;
+  const auto compile = [&compiled](const PersistentCache::SkSLCache& sksl) {
+    compiled.push_back(GetKey(sksl));
+    return true;
+  };
+
+  // Shaders added while the warm-up is running are compiled by the pending
+  // batches.
+  ASSERT_TRUE(warm_up.CompileBatch(compile, fml::TimeDelta::Zero()));
+  ASSERT_FALSE(warm_up.Add(CreateSkSLs(3)));
+  ASSERT_EQ(warm_up.GetProgress().total, 3u);
+  ASSERT_FALSE(warm_up.CompileBatch(compile, fml::TimeDelta::FromSeconds(1)));
+  ASSERT_EQ(compiled, (std::vector<std::string>{"0", "1", "2"}));
+
+  // Shaders added after the warm-up finished must resume it.
+  ASSERT_FALSE(warm_up.Add(CreateSkSLs(3)));
+  ASSERT_TRUE(warm_up.Add(CreateSkSLs(4)));
+  ASSERT_FALSE(warm_up.GetProgress().IsFinished());
+  ASSERT_FALSE(warm_up.CompileBatch(compile, fml::TimeDelta::FromSeconds(1)));
+  ASSERT_EQ(compiled, (std::vector<std::string>{"0", "1", "2", "3"}));
+  ASSERT_EQ(warm_up.GetProgress().compiled, 4u);
+}
+
+}  // namespace testing
+}  // namespace flutter
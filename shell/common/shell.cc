@@ -5,8 +5,10 @@
 #define RAPIDJSON_HAS_STDSTRING 1
 #include "flutter/shell/common/shell.h"
 
+#include <future>
 #include <memory>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 #include "flutter/assets/directory_asset_bundle.h"
@@ -18,10 +20,12 @@
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
+#include "flutter/fml/trace_recorder.h"
 #include "flutter/fml/unique_fd.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/engine.h"
 #include "flutter/shell/common/persistent_cache.h"
+#include "flutter/shell/common/resource_cache_budget.h"
 #include "flutter/shell/common/skia_event_tracer_impl.h"
 #include "flutter/shell/common/switches.h"
 #include "flutter/shell/common/vsync_waiter.h"
@@ -39,6 +43,85 @@ constexpr char kSystemChannel[] = "flutter/system";
 constexpr char kTypeKey[] = "type";
 constexpr char kFontChange[] = "fontsChange";
 
+namespace {
+
+// Startup state shared by all shells in the process.
+struct ProcessStartup {
+  std::mutex mutex;
+  // The process-wide steps, as they were last performed.
+  StartupTimings timings;
+  // Initialization tasks that run concurrently with the creation of the VM and
+  // the shell. These must be complete before an engine is created.
+  std::shared_future<void> concurrent_tasks;
+  // The thread running the concurrent tasks. It is joined before the shell
+  // that started it is returned.
+  std::thread concurrent_tasks_thread;
+};
+
+ProcessStartup& GetProcessStartup() {
+  static ProcessStartup* startup = new ProcessStartup();
+  return *startup;
+}
+
+void RecordProcessStartupStep(StartupTimings::Step step,
+                              fml::TimePoint start,
+                              fml::TimePoint finish) {
+  auto& startup = GetProcessStartup();
+  std::scoped_lock lock(startup.mutex);
+  startup.timings.Record(step, start, finish);
+}
+
+void WaitForConcurrentInitializationTasks() {
+  std::shared_future<void> tasks;
+  {
+    auto& startup = GetProcessStartup();
+    std::scoped_lock lock(startup.mutex);
+    tasks = startup.concurrent_tasks;
+  }
+  if (tasks.valid()) {
+    TRACE_EVENT0("flutter", "WaitForConcurrentInitializationTasks");
+    tasks.wait();
+  }
+}
+
+void JoinConcurrentInitializationTasks() {
+  std::thread thread;
+  {
+    auto& startup = GetProcessStartup();
+    std::scoped_lock lock(startup.mutex);
+    thread = std::move(startup.concurrent_tasks_thread);
+  }
+  if (thread.joinable()) {
+    thread.join();
+  }
+}
+
+void CopyProcessStartupTimings(StartupTimings& timings) {
+  auto& startup = GetProcessStartup();
+  std::scoped_lock lock(startup.mutex);
+  for (int i = StartupTimings::kInitializationTasks;
+       i <= StartupTimings::kDartVMCreation; i++) {
+    const auto step = static_cast<StartupTimings::Step>(i);
+    if (startup.timings.HasStep(step)) {
+      timings.Record(step, startup.timings.GetStart(step),
+                     startup.timings.GetFinish(step));
+    }
+  }
+}
+
+// Subsystems that were created for a shell that failed to be set up must still
+// be collected on the thread they were created on.
+template <typename T>
+void CollectOnTaskRunner(fml::RefPtr<fml::TaskRunner> task_runner,
+                         T subsystem) {
+  fml::TaskRunner::RunNowOrPostTask(
+      task_runner,
+      fml::MakeCopyable(
+          [subsystem = std::move(subsystem)]() mutable { subsystem.reset(); }));
+}
+
+}  // namespace
+
 std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
     DartVMRef vm,
     TaskRunners task_runners,
@@ -46,7 +129,8 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
     Settings settings,
     fml::RefPtr<const DartSnapshot> isolate_snapshot,
     const Shell::CreateCallback<PlatformView>& on_create_platform_view,
-    const Shell::CreateCallback<Rasterizer>& on_create_rasterizer) {
+    const Shell::CreateCallback<Rasterizer>& on_create_rasterizer,
+    const Shell* spawner) {
   if (!task_runners.IsValid()) {
     FML_LOG(ERROR) << "Task runners to run the shell were invalid.";
     return nullptr;
@@ -55,6 +139,19 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
   auto shell =
       std::unique_ptr<Shell>(new Shell(std::move(vm), task_runners, settings));
 
+  // A spawned shell gets an IO manager that shares the resource context and
+  // the unref queue of its spawner. Disabling the GPU for one of them must also
+  // prevent the other from using the shared resource context.
+  fml::WeakPtr<ShellIOManager> spawner_io_manager;
+  fml::WeakPtr<Engine> spawner_engine;
+  if (spawner) {
+    shell->is_spawned_ = true;
+    spawner_io_manager = spawner->io_manager_->GetWeakPtr();
+    spawner_engine = spawner->weak_engine_;
+    shell->is_gpu_disabled_sync_switch_ =
+        spawner->is_gpu_disabled_sync_switch_;
+  }
+
   // Create the rasterizer on the raster thread.
   std::promise<std::unique_ptr<Rasterizer>> rasterizer_promise;
   auto rasterizer_future = rasterizer_promise.get_future();
@@ -67,28 +164,34 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
                                            shell = shell.get()    //
   ]() {
         TRACE_EVENT0("flutter", "ShellSetupGPUSubsystem");
+        StartupTimings::ScopedStep step(shell->startup_timings_,
+                                        StartupTimings::kRasterizerCreation);
         std::unique_ptr<Rasterizer> rasterizer(on_create_rasterizer(*shell));
+        rasterizer->compositor_context()->raster_cache().SetScaleTolerant(
+            shell->GetSettings().scale_tolerant_raster_cache);
         snapshot_delegate_promise.set_value(rasterizer->GetSnapshotDelegate());
         rasterizer_promise.set_value(std::move(rasterizer));
       });
 
   // Create the platform view on the platform thread (this thread).
-  auto platform_view = on_create_platform_view(*shell.get());
-  if (!platform_view || !platform_view->GetWeakPtr()) {
-    return nullptr;
+  std::unique_ptr<PlatformView> platform_view;
+  {
+    StartupTimings::ScopedStep step(shell->startup_timings_,
+                                    StartupTimings::kPlatformViewCreation);
+    platform_view = on_create_platform_view(*shell.get());
   }
-
-  // Ask the platform view for the vsync waiter. This will be used by the engine
-  // to create the animator.
-  auto vsync_waiter = platform_view->CreateVSyncWaiter();
-  if (!vsync_waiter) {
+  if (!platform_view || !platform_view->GetWeakPtr()) {
+    // The pending rasterizer task refers to promises on this stack.
+    CollectOnTaskRunner(task_runners.GetRasterTaskRunner(),
+                        rasterizer_future.get());
     return nullptr;
   }
 
   // Create the IO manager on the IO thread. The IO manager must be initialized
   // first because it has state that the other subsystems depend on. It must
   // first be booted and the necessary references obtained to initialize the
-  // other subsystems.
+  // other subsystems. It only needs the platform view, so it is created while
+  // the vsync waiter is created on this thread.
   std::promise<std::unique_ptr<ShellIOManager>> io_manager_promise;
   auto io_manager_future = io_manager_promise.get_future();
   std::promise<fml::WeakPtr<ShellIOManager>> weak_io_manager_promise;
@@ -110,20 +213,48 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
        &unref_queue_promise,                                              //
        platform_view = platform_view->GetWeakPtr(),                       //
        io_task_runner,                                                    //
-       is_backgrounded_sync_switch = shell->GetIsGpuDisabledSyncSwitch()  //
+       is_backgrounded_sync_switch = shell->GetIsGpuDisabledSyncSwitch(),  //
+       shell = shell.get(),                                               //
+       spawner_io_manager                                                 //
   ]() {
         TRACE_EVENT0("flutter", "ShellSetupIOSubsystem");
-        auto io_manager = std::make_unique<ShellIOManager>(
-            platform_view.getUnsafe()->CreateResourceContext(),
-            is_backgrounded_sync_switch, io_task_runner);
+        StartupTimings::ScopedStep step(shell->startup_timings_,
+                                        StartupTimings::kIOManagerCreation);
+        std::unique_ptr<ShellIOManager> io_manager;
+        if (spawner_io_manager) {
+          io_manager =
+              spawner_io_manager->Spawn(shell->GetTaskRunners().GetLabel());
+        } else {
+          io_manager = std::make_unique<ShellIOManager>(
+              platform_view.getUnsafe()->CreateResourceContext(),
+              is_backgrounded_sync_switch, io_task_runner,
+              shell->GetTaskRunners().GetLabel());
+        }
         weak_io_manager_promise.set_value(io_manager->GetWeakPtr());
         unref_queue_promise.set_value(io_manager->GetSkiaUnrefQueue());
         io_manager_promise.set_value(std::move(io_manager));
       });
 
+  // Ask the platform view for the vsync waiter. This will be used by the engine
+  // to create the animator.
+  std::unique_ptr<VsyncWaiter> vsync_waiter;
+  {
+    StartupTimings::ScopedStep step(shell->startup_timings_,
+                                    StartupTimings::kVsyncWaiterCreation);
+    vsync_waiter = platform_view->CreateVSyncWaiter();
+  }
+  if (!vsync_waiter) {
+    // The pending rasterizer and IO tasks refer to promises on this stack.
+    CollectOnTaskRunner(task_runners.GetRasterTaskRunner(),
+                        rasterizer_future.get());
+    CollectOnTaskRunner(io_task_runner, io_manager_future.get());
+    return nullptr;
+  }
+
   // Send dispatcher_maker to the engine constructor because shell won't have
   // platform_view set until Shell::Setup is called later.
-  auto dispatcher_maker = platform_view->GetDispatcherMaker();
+  PointerDataDispatcherMaker dispatcher_maker =
+      platform_view->GetDispatcherMaker();
 
   // Create the engine on the UI thread.
   std::promise<std::unique_ptr<Engine>> engine_promise;
@@ -138,39 +269,80 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
                          vsync_waiter = std::move(vsync_waiter),          //
                          &weak_io_manager_future,                         //
                          &snapshot_delegate_future,                       //
-                         &unref_queue_future                              //
+                         &unref_queue_future,                             //
+                         spawned = spawner != nullptr,                    //
+                         spawner_engine                                   //
   ]() mutable {
         TRACE_EVENT0("flutter", "ShellSetupUISubsystem");
         const auto& task_runners = shell->GetTaskRunners();
 
+        // The text engine needs the ICU data, which may still be loading.
+        WaitForConcurrentInitializationTasks();
+        auto weak_io_manager = weak_io_manager_future.get();
+        auto unref_queue = unref_queue_future.get();
+        auto snapshot_delegate = snapshot_delegate_future.get();
+
+        StartupTimings::ScopedStep step(shell->startup_timings_,
+                                        StartupTimings::kEngineCreation);
+
         // The animator is owned by the UI thread but it gets its vsync pulses
         // from the platform.
         auto animator = std::make_unique<Animator>(*shell, task_runners,
                                                    std::move(vsync_waiter));
 
+        if (spawned) {
+          if (!spawner_engine) {
+            FML_LOG(ERROR) << "The engine of the spawning shell is gone.";
+            engine_promise.set_value(nullptr);
+            return;
+          }
+          engine_promise.set_value(spawner_engine->Spawn(
+              *shell,                       //
+              dispatcher_maker,             //
+              *shell->GetDartVM(),          //
+              shell->GetSettings(),         //
+              std::move(animator),          //
+              std::move(weak_io_manager),   //
+              std::move(unref_queue),       //
+              std::move(snapshot_delegate)  //
+              ));
+          return;
+        }
+
         engine_promise.set_value(std::make_unique<Engine>(
-            *shell,                         //
-            dispatcher_maker,               //
-            *shell->GetDartVM(),            //
-            std::move(isolate_snapshot),    //
-            task_runners,                   //
-            window_data,                    //
-            shell->GetSettings(),           //
-            std::move(animator),            //
-            weak_io_manager_future.get(),   //
-            unref_queue_future.get(),       //
-            snapshot_delegate_future.get()  //
+            *shell,                       //
+            dispatcher_maker,             //
+            *shell->GetDartVM(),          //
+            std::move(isolate_snapshot),  //
+            task_runners,                 //
+            window_data,                  //
+            shell->GetSettings(),         //
+            std::move(animator),          //
+            std::move(weak_io_manager),   //
+            std::move(unref_queue),       //
+            std::move(snapshot_delegate)  //
             ));
       }));
 
-  if (!shell->Setup(std::move(platform_view),  //
-                    engine_future.get(),       //
-                    rasterizer_future.get(),   //
-                    io_manager_future.get())   //
-  ) {
+  auto engine = engine_future.get();
+  auto rasterizer = rasterizer_future.get();
+  auto io_manager = io_manager_future.get();
+
+  bool setup = false;
+  {
+    StartupTimings::ScopedStep step(shell->startup_timings_,
+                                    StartupTimings::kShellSetup);
+    setup = shell->Setup(std::move(platform_view),  //
+                         std::move(engine),         //
+                         std::move(rasterizer),     //
+                         std::move(io_manager)      //
+    );
+  }
+  if (!setup) {
     return nullptr;
   }
 
+  CopyProcessStartupTimings(shell->startup_timings_);
   return shell;
 }
 
@@ -200,6 +372,8 @@ static void PerformInitializationTasks(Settings& settings) {
 
   static std::once_flag gShellSettingsInitialization = {};
   std::call_once(gShellSettingsInitialization, [&settings] {
+    const auto start = fml::TimePoint::Now();
+
     if (settings.engine_start_timestamp.count() == 0) {
       settings.engine_start_timestamp =
           std::chrono::microseconds(Dart_TimelineGetMicros());
@@ -218,6 +392,13 @@ static void PerformInitializationTasks(Settings& settings) {
       fml::tracing::TraceSetWhitelist(prefixes);
     }
 
+    if (!settings.trace_recorder_categories.empty()) {
+      std::vector<std::string> categories;
+      Tokenize(settings.trace_recorder_categories, &categories, ',');
+      fml::tracing::TraceRecorder::GetInstance().SetEnabledCategories(
+          categories);
+    }
+
     if (!settings.skia_deterministic_rendering_on_cpu) {
       SkGraphics::Init();
     } else {
@@ -225,14 +406,31 @@ static void PerformInitializationTasks(Settings& settings) {
     }
 
     if (settings.icu_initialization_required) {
-      if (settings.icu_data_path.size() != 0) {
-        fml::icu::InitializeICU(settings.icu_data_path);
-      } else if (settings.icu_mapper) {
-        fml::icu::InitializeICUFromMapping(settings.icu_mapper());
-      } else {
-        FML_DLOG(WARNING) << "Skipping ICU initialization in the shell.";
-      }
+      // Nothing before the creation of the engine depends on ICU. Map its data
+      // on a separate thread while the VM and the shell are created.
+      std::packaged_task<void()> initialize_icu(
+          [icu_data_path = settings.icu_data_path,
+           icu_mapper = settings.icu_mapper]() {
+            TRACE_EVENT0("flutter", "InitializeICU");
+            const auto start = fml::TimePoint::Now();
+            if (icu_data_path.size() != 0) {
+              fml::icu::InitializeICU(icu_data_path);
+            } else if (icu_mapper) {
+              fml::icu::InitializeICUFromMapping(icu_mapper());
+            } else {
+              FML_DLOG(WARNING) << "Skipping ICU initialization in the shell.";
+            }
+            RecordProcessStartupStep(StartupTimings::kICUInitialization,
+                                     start, fml::TimePoint::Now());
+          });
+      auto& startup = GetProcessStartup();
+      std::scoped_lock lock(startup.mutex);
+      startup.concurrent_tasks = initialize_icu.get_future().share();
+      startup.concurrent_tasks_thread = std::thread(std::move(initialize_icu));
     }
+
+    RecordProcessStartupStep(StartupTimings::kInitializationTasks, start,
+                             fml::TimePoint::Now());
   });
 }
 
@@ -260,8 +458,14 @@ std::unique_ptr<Shell> Shell::Create(
 
   TRACE_EVENT0("flutter", "Shell::Create");
 
+  const bool vm_was_running = DartVMRef::IsInstanceRunning();
+  const auto vm_start = fml::TimePoint::Now();
   auto vm = DartVMRef::Create(settings);
   FML_CHECK(vm) << "Must be able to initialize the VM.";
+  if (!vm_was_running) {
+    RecordProcessStartupStep(StartupTimings::kDartVMCreation, vm_start,
+                             fml::TimePoint::Now());
+  }
 
   auto vm_data = vm->GetVMData();
 
@@ -318,6 +522,81 @@ std::unique_ptr<Shell> Shell::Create(
         latch.Signal();
       }));
   latch.Wait();
+  // The engine has waited for the concurrent initialization tasks already, or
+  // shell creation failed before it was created.
+  JoinConcurrentInitializationTasks();
+  return shell;
+}
+
+std::unique_ptr<Shell> Shell::Spawn(
+    std::string entrypoint,
+    std::string entrypoint_library,
+    const CreateCallback<PlatformView>& on_create_platform_view,
+    const CreateCallback<Rasterizer>& on_create_rasterizer) const {
+  TRACE_EVENT0("flutter", "Shell::Spawn");
+  if (!on_create_platform_view || !on_create_rasterizer) {
+    return nullptr;
+  }
+
+  fml::AutoResetWaitableEvent latch;
+  std::unique_ptr<Shell> shell;
+  fml::TaskRunner::RunNowOrPostTask(
+      task_runners_.GetPlatformTaskRunner(),
+      [this, &latch, &shell, &entrypoint, &entrypoint_library,
+       &on_create_platform_view, &on_create_rasterizer]() {
+        if (!is_setup_) {
+          latch.Signal();
+          return;
+        }
+        // The isolate snapshot is that of the engine of this shell.
+        shell = CreateShellOnPlatformThread(
+            DartVMRef::Create(settings_), task_runners_,
+            WindowData{/* default window data */}, settings_, nullptr,
+            on_create_platform_view, on_create_rasterizer, this);
+        if (!shell) {
+          latch.Signal();
+          return;
+        }
+
+        // The spawned engine starts with the asset manager of the spawner.
+        // Running it with the same asset manager does not register its fonts
+        // again.
+        std::shared_ptr<AssetManager> asset_manager;
+        fml::AutoResetWaitableEvent ui_latch;
+        fml::TaskRunner::RunNowOrPostTask(
+            task_runners_.GetUITaskRunner(),
+            [engine = shell->weak_engine_, &asset_manager, &ui_latch]() {
+              if (engine) {
+                asset_manager = engine->GetAssetManager();
+              }
+              ui_latch.Signal();
+            });
+        ui_latch.Wait();
+        if (!asset_manager) {
+          FML_LOG(ERROR) << "The spawning engine was not running.";
+          shell.reset();
+          latch.Signal();
+          return;
+        }
+
+        RunConfiguration configuration(
+            IsolateConfiguration::InferFromSettings(
+                settings_, asset_manager, task_runners_.GetIOTaskRunner()),
+            asset_manager);
+        if (!entrypoint.empty()) {
+          configuration.SetEntrypointAndLibrary(std::move(entrypoint),
+                                                std::move(entrypoint_library));
+        }
+        shell->RunEngine(std::move(configuration));
+        latch.Signal();
+      });
+  latch.Wait();
+
+  if (!shell) {
+    FML_LOG(ERROR) << "Could not spawn a shell.";
+    return nullptr;
+  }
+
   return shell;
 }
 
@@ -351,6 +630,11 @@ Shell::Shell(DartVMRef vm, TaskRunners task_runners, Settings settings)
       task_runners_.GetRasterTaskRunner(),
       std::bind(&Shell::OnServiceProtocolScreenshotSKP, this,
                 std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kScreenshotLayerTreeExtensionName] = {
+          task_runners_.GetRasterTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolScreenshotLayerTree, this,
+                    std::placeholders::_1, std::placeholders::_2)};
   service_protocol_handlers_[ServiceProtocol::kRunInViewExtensionName] = {
       task_runners_.GetUITaskRunner(),
       std::bind(&Shell::OnServiceProtocolRunInView, this, std::placeholders::_1,
@@ -374,6 +658,36 @@ Shell::Shell(DartVMRef vm, TaskRunners task_runners, Settings settings)
       task_runners_.GetIOTaskRunner(),
       std::bind(&Shell::OnServiceProtocolGetSkSLs, this, std::placeholders::_1,
                 std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetTraceRecorderDumpExtensionName] = {
+          task_runners_.GetIOTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetTraceRecorderDump, this,
+                    std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetFrameTimingHistogramsExtensionName] = {
+          task_runners_.GetIOTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetFrameTimingHistograms, this,
+                    std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetStartupTimingsExtensionName] = {
+          task_runners_.GetIOTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetStartupTimings, this,
+                    std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetShaderWarmUpProgressExtensionName] = {
+          task_runners_.GetIOTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetShaderWarmUpProgress, this,
+                    std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetResourceCacheUsageExtensionName] = {
+          task_runners_.GetIOTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetResourceCacheUsage, this,
+                    std::placeholders::_1, std::placeholders::_2)};
+
+  if (settings_.resource_cache_budget_bytes != 0) {
+    ResourceCacheBudget::GetInstance().SetMaxBytes(
+        settings_.resource_cache_budget_bytes);
+  }
 }
 
 Shell::~Shell() {
@@ -408,8 +722,12 @@ Shell::~Shell() {
       fml::MakeCopyable([io_manager = std::move(io_manager_),
                          platform_view = platform_view_.get(),
                          &io_latch]() mutable {
+        // The platform view of a spawned shell did not create the resource
+        // context it shares with its spawner.
+        const bool release_resource_context =
+            !io_manager->IsResourceContextShared();
         io_manager.reset();
-        if (platform_view) {
+        if (platform_view && release_resource_context) {
           platform_view->ReleaseResourceContext();
         }
         io_latch.Signal();
@@ -437,6 +755,10 @@ void Shell::NotifyLowMemoryWarning() const {
   // running.
   ::Dart_NotifyLowMemory();
 
+  // Every engine's rasterizer is about to purge its cache, so split the
+  // process-wide resource cache budget evenly until they report again.
+  ResourceCacheBudget::GetInstance().NotifyLowMemoryWarning();
+
   task_runners_.GetRasterTaskRunner()->PostTask(
       [rasterizer = rasterizer_->GetWeakPtr()]() {
         if (rasterizer) {
@@ -444,7 +766,14 @@ void Shell::NotifyLowMemoryWarning() const {
         }
       });
   // The IO Manager uses resource cache limits of 0, so it is not necessary
-  // to purge them.
+  // to purge them. Textures it uploaded may have been collected since it last
+  // reported its usage though.
+  task_runners_.GetIOTaskRunner()->PostTask(
+      [io_manager = io_manager_->GetWeakPtr()]() {
+        if (io_manager) {
+          io_manager->UpdateResourceCacheUsage();
+        }
+      });
 }
 
 void Shell::RunEngine(RunConfiguration run_configuration) {
@@ -465,6 +794,30 @@ void Shell::RunEngine(
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
 
+  // Start reading the assets needed right after launch while the isolate is
+  // being set up. The font manifest is read on the UI thread and the SkSL
+  // bundle on the raster thread. Spawned shells run with the assets of their
+  // spawner, which have been read already.
+  auto asset_manager = run_configuration.GetAssetManager();
+  if (asset_manager && !is_spawned_) {
+    asset_manager->Prefetch(
+        {"FontManifest.json", PersistentCache::kAssetFileName},
+        task_runners_.GetIOTaskRunner());
+  }
+
+  // The shaders bundled with the assets are not available to a warm-up
+  // started before the run configuration set the asset manager of the
+  // persistent cache.
+  if (asset_manager) {
+    task_runners_.GetRasterTaskRunner()->PostTask(
+        [rasterizer = rasterizer_->GetWeakPtr(),
+         shader_warm_up = shader_warm_up_]() {
+          if (rasterizer) {
+            rasterizer->WarmUpAddedShaders(std::move(shader_warm_up));
+          }
+        });
+  }
+
   fml::TaskRunner::RunNowOrPostTask(
       task_runners_.GetUITaskRunner(),
       fml::MakeCopyable(
@@ -605,6 +958,7 @@ void Shell::OnPlatformViewCreated(std::unique_ptr<Surface> surface) {
       fml::MakeCopyable([&waiting_for_first_frame = waiting_for_first_frame_,
                          rasterizer = rasterizer_->GetWeakPtr(),  //
                          surface = std::move(surface),            //
+                         shader_warm_up = shader_warm_up_,        //
                          &latch]() mutable {
         if (rasterizer) {
           rasterizer->Setup(std::move(surface));
@@ -615,6 +969,12 @@ void Shell::OnPlatformViewCreated(std::unique_ptr<Surface> surface) {
         // Step 3: All done. Signal the latch that the platform thread is
         // waiting on.
         latch.Signal();
+
+        // Compiling the recorded shaders is not needed to unblock the
+        // platform thread and happens in batches after this task.
+        if (rasterizer) {
+          rasterizer->WarmUpShaders(std::move(shader_warm_up));
+        }
       });
 
   // The normal flow executed by this method is that the platform thread is
@@ -663,6 +1023,9 @@ void Shell::OnPlatformViewCreated(std::unique_ptr<Surface> surface) {
       io_manager->NotifyResourceContextAvailable(
           platform_view->CreateResourceContext());
     }
+    if (io_manager) {
+      io_manager->UpdateResourceCacheUsage();
+    }
     // Step 1: Next, post a task on the UI thread to tell the engine that it has
     // an output surface.
     fml::TaskRunner::RunNowOrPostTask(ui_task_runner, ui_task);
@@ -698,6 +1061,7 @@ void Shell::OnPlatformViewDestroyed() {
     io_manager->GetIsGpuDisabledSyncSwitch()->Execute(
         fml::SyncSwitch::Handlers().SetIfFalse(
             [&] { io_manager->GetSkiaUnrefQueue()->Drain(); }));
+    io_manager->UpdateResourceCacheUsage();
     // Step 3: All done. Signal the latch that the platform thread is waiting
     // on.
     latch.Signal();
@@ -1120,6 +1484,8 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
     settings_.frame_rasterized_callback(timing);
   }
 
+  frame_timing_histograms_.AddFrame(timing);
+
   if (!needs_report_timings_) {
     return;
   }
@@ -1281,6 +1647,28 @@ bool Shell::OnServiceProtocolScreenshotSKP(
   return false;
 }
 
+// Service protocol handler
+bool Shell::OnServiceProtocolScreenshotLayerTree(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
+  auto screenshot = rasterizer_->ScreenshotLastLayerTree(
+      Rasterizer::ScreenshotType::LayerTree, true);
+  if (screenshot.data) {
+    response.SetObject();
+    auto& allocator = response.GetAllocator();
+    response.AddMember("type", "ScreenshotLayerTree", allocator);
+    rapidjson::Value layer_tree;
+    layer_tree.SetString(static_cast<const char*>(screenshot.data->data()),
+                         screenshot.data->size(), allocator);
+    response.AddMember("layerTree", layer_tree, allocator);
+    return true;
+  }
+  ServiceProtocolFailureError(response,
+                              "Could not capture layer tree screenshot.");
+  return false;
+}
+
 // Service protocol handler
 bool Shell::OnServiceProtocolRunInView(
     const ServiceProtocol::Handler::ServiceProtocolMap& params,
@@ -1393,6 +1781,153 @@ bool Shell::OnServiceProtocolGetSkSLs(
   return true;
 }
 
+bool Shell::OnServiceProtocolGetTraceRecorderDump(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  FML_DCHECK(task_runners_.GetIOTaskRunner()->RunsTasksOnCurrentThread());
+  auto& recorder = fml::tracing::TraceRecorder::GetInstance();
+  const std::string trace = recorder.ExportChromeJSON();
+
+  auto found = params.find("clear");
+  if (found != params.end() && found->second == "true") {
+    recorder.Clear();
+  }
+
+  response.SetObject();
+  response.AddMember("type", "TraceRecorderDump", response.GetAllocator());
+  response.AddMember("recording", fml::tracing::TraceRecorder::IsRecording(),
+                     response.GetAllocator());
+  rapidjson::Value trace_value(trace.c_str(), trace.size(),
+                               response.GetAllocator());
+  response.AddMember("trace", trace_value, response.GetAllocator());
+  return true;
+}
+
+bool Shell::OnServiceProtocolGetFrameTimingHistograms(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  FML_DCHECK(task_runners_.GetIOTaskRunner()->RunsTasksOnCurrentThread());
+  auto& allocator = response.GetAllocator();
+  response.SetObject();
+  response.AddMember("type", "FrameTimingHistograms", allocator);
+  response.AddMember(
+      "frameCount",
+      static_cast<uint64_t>(frame_timing_histograms_.GetFrameCount()),
+      allocator);
+
+  rapidjson::Value metrics(rapidjson::kObjectType);
+  for (int i = 0; i < FrameTimingHistograms::kMetricCount; i++) {
+    const auto metric = static_cast<FrameTimingHistograms::Metric>(i);
+    const auto histogram = frame_timing_histograms_.GetHistogram(metric);
+    rapidjson::Value value(rapidjson::kObjectType);
+    value.AddMember("samples", static_cast<uint64_t>(histogram.sample_count),
+                    allocator);
+    value.AddMember("p50", histogram.p50, allocator);
+    value.AddMember("p90", histogram.p90, allocator);
+    value.AddMember("p99", histogram.p99, allocator);
+    value.AddMember("max", histogram.max, allocator);
+    value.AddMember("mean", histogram.mean, allocator);
+    metrics.AddMember(
+        rapidjson::StringRef(FrameTimingHistograms::GetMetricName(metric)),
+        value, allocator);
+  }
+  response.AddMember("metrics", metrics, allocator);
+
+  auto found = params.find("reset");
+  if (found != params.end() && found->second == "true") {
+    frame_timing_histograms_.Reset();
+  }
+  return true;
+}
+
+bool Shell::OnServiceProtocolGetStartupTimings(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  FML_DCHECK(task_runners_.GetIOTaskRunner()->RunsTasksOnCurrentThread());
+  auto& allocator = response.GetAllocator();
+  response.SetObject();
+  response.AddMember("type", "StartupTimings", allocator);
+  response.AddMember("total", startup_timings_.GetTotal().ToMicroseconds(),
+                     allocator);
+
+  rapidjson::Value steps(rapidjson::kObjectType);
+  for (int i = 0; i < StartupTimings::kStepCount; i++) {
+    const auto step = static_cast<StartupTimings::Step>(i);
+    if (!startup_timings_.HasStep(step)) {
+      continue;
+    }
+    rapidjson::Value value(rapidjson::kObjectType);
+    value.AddMember(
+        "start",
+        startup_timings_.GetStart(step).ToEpochDelta().ToMicroseconds(),
+        allocator);
+    value.AddMember("duration",
+                    startup_timings_.GetDuration(step).ToMicroseconds(),
+                    allocator);
+    steps.AddMember(rapidjson::StringRef(StartupTimings::GetStepName(step)),
+                    value, allocator);
+  }
+  response.AddMember("steps", steps, allocator);
+  return true;
+}
+
+// Service protocol handler
+bool Shell::OnServiceProtocolGetShaderWarmUpProgress(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  FML_DCHECK(task_runners_.GetIOTaskRunner()->RunsTasksOnCurrentThread());
+  const auto progress = shader_warm_up_->GetProgress();
+
+  auto& allocator = response.GetAllocator();
+  response.SetObject();
+  response.AddMember("type", "ShaderWarmUpProgress", allocator);
+  response.AddMember("total", static_cast<uint64_t>(progress.total),
+                     allocator);
+  response.AddMember("attempted", static_cast<uint64_t>(progress.attempted),
+                     allocator);
+  response.AddMember("compiled", static_cast<uint64_t>(progress.compiled),
+                     allocator);
+  response.AddMember("elapsed", progress.elapsed.ToMicroseconds(), allocator);
+  response.AddMember("finished", progress.IsFinished(), allocator);
+  return true;
+}
+
+// Service protocol handler
+bool Shell::OnServiceProtocolGetResourceCacheUsage(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document& response) {
+  FML_DCHECK(task_runners_.GetIOTaskRunner()->RunsTasksOnCurrentThread());
+  const auto& budget = ResourceCacheBudget::GetInstance();
+
+  auto& allocator = response.GetAllocator();
+  response.SetObject();
+  response.AddMember("type", "ResourceCacheUsage", allocator);
+  response.AddMember("maxBytes", static_cast<uint64_t>(budget.GetMaxBytes()),
+                     allocator);
+  rapidjson::Value participants(rapidjson::kArrayType);
+  for (const auto& usage : budget.GetUsage()) {
+    rapidjson::Value participant(rapidjson::kObjectType);
+    participant.AddMember(
+        "engine", rapidjson::Value(usage.label.c_str(), allocator), allocator);
+    participant.AddMember(
+        "context",
+        usage.type == ResourceCacheBudget::ParticipantType::kRasterizer
+            ? "rasterizer"
+            : "resource",
+        allocator);
+    participant.AddMember("usageBytes",
+                          static_cast<uint64_t>(usage.usage_bytes), allocator);
+    if (usage.limit_bytes.has_value()) {
+      participant.AddMember("limitBytes",
+                            static_cast<uint64_t>(usage.limit_bytes.value()),
+                            allocator);
+    }
+    participants.PushBack(participant, allocator);
+  }
+  response.AddMember("participants", participants, allocator);
+  return true;
+}
+
 // Service protocol handler
 bool Shell::OnServiceProtocolSetAssetBundlePath(
     const ServiceProtocol::Handler::ServiceProtocolMap& params,
@@ -1511,4 +2046,16 @@ std::shared_ptr<fml::SyncSwitch> Shell::GetIsGpuDisabledSyncSwitch() const {
   return is_gpu_disabled_sync_switch_;
 }
 
+FrameTimingHistograms& Shell::GetFrameTimingHistograms() {
+  return frame_timing_histograms_;
+}
+
+const StartupTimings& Shell::GetStartupTimings() const {
+  return startup_timings_;
+}
+
+ShaderWarmUp::Progress Shell::GetShaderWarmUpProgress() const {
+  return shader_warm_up_->GetProgress();
+}
+
 }  // namespace flutter
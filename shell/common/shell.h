@@ -30,9 +30,12 @@
 #include "flutter/runtime/service_protocol.h"
 #include "flutter/shell/common/animator.h"
 #include "flutter/shell/common/engine.h"
+#include "flutter/shell/common/frame_timing_histograms.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/rasterizer.h"
+#include "flutter/shell/common/shader_warm_up.h"
 #include "flutter/shell/common/shell_io_manager.h"
+#include "flutter/shell/common/startup_timings.h"
 #include "flutter/shell/common/surface.h"
 
 namespace flutter {
@@ -218,6 +221,43 @@ class Shell final : public PlatformView::Delegate,
   ///
   ~Shell();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Creates and runs a shell for another view in the same process.
+  ///             The spawned shell runs on the task runners of this shell and
+  ///             uses its settings, Dart VM and isolate snapshot. It shares
+  ///             the font collection and asset manager of the running engine
+  ///             of this shell, as well as the resource context and Skia unref
+  ///             queue of its IO manager. The process-wide persistent cache is
+  ///             used by both shells. The root isolate of the spawned shell is
+  ///             launched through `RunEngine`.
+  ///
+  ///             The spawned engine gets its own root isolate, created from
+  ///             the shared snapshot. Unlike a shell created with
+  ///             `Shell::Create`, it does not create a new font collection,
+  ///             asset manager or resource context. Raster caches are owned by
+  ///             each rasterizer and are not shared.
+  ///
+  ///             This shell must be set up and its engine must be running. The
+  ///             spawned shell holds its own references to everything it
+  ///             shares, so the two shells may be collected in any order.
+  ///
+  /// @param[in]  entrypoint               The entrypoint of the spawned root
+  ///                                      isolate. Defaults to "main" if
+  ///                                      empty.
+  /// @param[in]  entrypoint_library       The library of the entrypoint.
+  /// @param[in]  on_create_platform_view  The callback used to create the
+  ///                                      platform view of the spawned shell.
+  /// @param[in]  on_create_rasterizer     The callback used to create the
+  ///                                      rasterizer of the spawned shell.
+  ///
+  /// @return     The spawned shell, or nullptr if it could not be created.
+  ///
+  std::unique_ptr<Shell> Spawn(
+      std::string entrypoint,
+      std::string entrypoint_library,
+      const CreateCallback<PlatformView>& on_create_platform_view,
+      const CreateCallback<Rasterizer>& on_create_rasterizer) const;
+
   //----------------------------------------------------------------------------
   /// @brief      Starts an isolate for the given RunConfiguration.
   ///
@@ -354,6 +394,33 @@ class Shell final : public PlatformView::Delegate,
   /// @brief     Accessor for the disable GPU SyncSwitch
   std::shared_ptr<fml::SyncSwitch> GetIsGpuDisabledSyncSwitch() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Percentiles of the phases of the most recently rasterized
+  ///             frames, and of the state of the raster cache. This call has
+  ///             no threading restrictions.
+  ///
+  /// @return     The frame timing histograms of this shell.
+  ///
+  FrameTimingHistograms& GetFrameTimingHistograms();
+
+  //----------------------------------------------------------------------------
+  /// @brief      The durations of the steps performed to create this shell,
+  ///             including the process-wide steps performed before the first
+  ///             shell was created.
+  ///
+  /// @return     The startup timings of this shell.
+  ///
+  const StartupTimings& GetStartupTimings() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The progress of precompiling the recorded SkSL shaders for the
+  ///             current on-screen surface. This call has no threading
+  ///             restrictions.
+  ///
+  /// @return     The shader warm-up progress of this shell.
+  ///
+  ShaderWarmUp::Progress GetShaderWarmUpProgress() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Get a pointer to the Dart VM used by this running shell
   ///             instance.
@@ -391,6 +458,8 @@ class Shell final : public PlatformView::Delegate,
                      >
       service_protocol_handlers_;
   bool is_setup_ = false;
+  // Whether this shell was created by |Spawn|.
+  bool is_spawned_ = false;
   uint64_t next_pointer_flow_id_ = 0;
 
   bool first_frame_rasterized_ = false;
@@ -411,6 +480,15 @@ class Shell final : public PlatformView::Delegate,
   // here for easier conversions to Dart objects.
   std::vector<int64_t> unreported_timings_;
 
+  FrameTimingHistograms frame_timing_histograms_;
+
+  // Written while the shell is being created and read-only afterwards.
+  StartupTimings startup_timings_;
+
+  // Advanced on the raster thread and read by the service protocol.
+  const std::shared_ptr<ShaderWarmUp> shader_warm_up_ =
+      std::make_shared<ShaderWarmUp>();
+
   // A cache of `Engine::GetDisplayRefreshRate` (only callable in the UI thread)
   // so we can access it from `Rasterizer` (in the raster thread).
   //
@@ -430,7 +508,8 @@ class Shell final : public PlatformView::Delegate,
       Settings settings,
       fml::RefPtr<const DartSnapshot> isolate_snapshot,
       const Shell::CreateCallback<PlatformView>& on_create_platform_view,
-      const Shell::CreateCallback<Rasterizer>& on_create_rasterizer);
+      const Shell::CreateCallback<Rasterizer>& on_create_rasterizer,
+      const Shell* spawner = nullptr);
 
   bool Setup(std::unique_ptr<PlatformView> platform_view,
              std::unique_ptr<Engine> engine,
@@ -549,6 +628,11 @@ class Shell final : public PlatformView::Delegate,
       const ServiceProtocol::Handler::ServiceProtocolMap& params,
       rapidjson::Document& response);
 
+  // Service protocol handler
+  bool OnServiceProtocolScreenshotLayerTree(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
   // Service protocol handler
   bool OnServiceProtocolRunInView(
       const ServiceProtocol::Handler::ServiceProtocolMap& params,
@@ -576,6 +660,45 @@ class Shell final : public PlatformView::Delegate,
       const ServiceProtocol::Handler::ServiceProtocolMap& params,
       rapidjson::Document& response);
 
+  // Service protocol handler
+  //
+  // The returned trace is a string in the Chrome JSON trace event format.
+  // Pass "clear": "true" to discard the recorded events after dumping them.
+  bool OnServiceProtocolGetTraceRecorderDump(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
+  // Service protocol handler
+  //
+  // Durations are in microseconds. Pass "reset": "true" to discard the
+  // aggregated frames after reporting them.
+  bool OnServiceProtocolGetFrameTimingHistograms(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
+  // Service protocol handler
+  //
+  // Start times are in microseconds since the epoch of fml::TimePoint and
+  // durations are in microseconds.
+  bool OnServiceProtocolGetStartupTimings(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
+  // Service protocol handler
+  //
+  // The elapsed time is the time spent compiling shaders, in microseconds.
+  bool OnServiceProtocolGetShaderWarmUpProgress(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
+  // Service protocol handler
+  //
+  // Reports the process-wide resource cache limit and the usage and limit of
+  // the GPU contexts of every engine in the process, in bytes.
+  bool OnServiceProtocolGetResourceCacheUsage(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document& response);
+
   fml::WeakPtrFactory<Shell> weak_factory_;
 
   // For accessing the Shell via the raster thread, necessary for various
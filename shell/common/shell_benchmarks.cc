@@ -12,6 +12,63 @@
 
 namespace flutter {
 
+static Settings CreateSettingsForBenchmark(
+    const fml::UniqueFD& assets_dir,
+    testing::ELFAOTSymbols& aot_symbols) {
+  Settings settings = {};
+  settings.task_observer_add = [](intptr_t, fml::closure) {};
+  settings.task_observer_remove = [](intptr_t) {};
+
+  if (DartVM::IsRunningPrecompiledCode()) {
+    aot_symbols = testing::LoadELFSymbolFromFixturesIfNeccessary();
+    FML_CHECK(testing::PrepareSettingsForAOTWithSymbols(settings, aot_symbols))
+        << "Could not setup settings with AOT symbols.";
+  } else {
+    settings.application_kernels = [&assets_dir]() {
+      std::vector<std::unique_ptr<const fml::Mapping>> kernel_mappings;
+      kernel_mappings.emplace_back(
+          fml::FileMapping::CreateReadOnly(assets_dir, "kernel_blob.bin"));
+      return kernel_mappings;
+    };
+  }
+  return settings;
+}
+
+static std::unique_ptr<ThreadHost> CreateThreadHostForBenchmark() {
+  return std::make_unique<ThreadHost>(
+      "io.flutter.bench.", ThreadHost::Type::Platform | ThreadHost::Type::GPU |
+                               ThreadHost::Type::IO | ThreadHost::Type::UI);
+}
+
+static TaskRunners GetTaskRunners(const ThreadHost& thread_host) {
+  return TaskRunners("test",                                       //
+                     thread_host.platform_thread->GetTaskRunner(),  //
+                     thread_host.raster_thread->GetTaskRunner(),    //
+                     thread_host.ui_thread->GetTaskRunner(),        //
+                     thread_host.io_thread->GetTaskRunner()         //
+  );
+}
+
+static std::unique_ptr<PlatformView> CreatePlatformView(Shell& shell) {
+  return std::make_unique<PlatformView>(shell, shell.GetTaskRunners());
+}
+
+static std::unique_ptr<Rasterizer> CreateRasterizer(Shell& shell) {
+  return std::make_unique<Rasterizer>(shell, shell.GetTaskRunners());
+}
+
+// Shutdown must occur synchronously on the platform thread.
+static void DestroyShell(std::unique_ptr<Shell> shell) {
+  fml::AutoResetWaitableEvent latch;
+  fml::TaskRunner::RunNowOrPostTask(
+      shell->GetTaskRunners().GetPlatformTaskRunner(),
+      [&shell, &latch]() mutable {
+        shell.reset();
+        latch.Signal();
+      });
+  latch.Wait();
+}
+
 static void StartupAndShutdownShell(benchmark::State& state,
                                     bool measure_startup,
                                     bool measure_shutdown) {
@@ -23,58 +80,28 @@ static void StartupAndShutdownShell(benchmark::State& state,
 
   {
     benchmarking::ScopedPauseTiming pause(state, !measure_startup);
-    Settings settings = {};
-    settings.task_observer_add = [](intptr_t, fml::closure) {};
-    settings.task_observer_remove = [](intptr_t) {};
-
-    if (DartVM::IsRunningPrecompiledCode()) {
-      aot_symbols = testing::LoadELFSymbolFromFixturesIfNeccessary();
-      FML_CHECK(
-          testing::PrepareSettingsForAOTWithSymbols(settings, aot_symbols))
-          << "Could not setup settings with AOT symbols.";
-    } else {
-      settings.application_kernels = [&]() {
-        std::vector<std::unique_ptr<const fml::Mapping>> kernel_mappings;
-        kernel_mappings.emplace_back(
-            fml::FileMapping::CreateReadOnly(assets_dir, "kernel_blob.bin"));
-        return kernel_mappings;
-      };
-    }
-
-    thread_host = std::make_unique<ThreadHost>(
-        "io.flutter.bench.", ThreadHost::Type::Platform |
-                                 ThreadHost::Type::GPU | ThreadHost::Type::IO |
-                                 ThreadHost::Type::UI);
-
-    TaskRunners task_runners("test",
-                             thread_host->platform_thread->GetTaskRunner(),
-                             thread_host->raster_thread->GetTaskRunner(),
-                             thread_host->ui_thread->GetTaskRunner(),
-                             thread_host->io_thread->GetTaskRunner());
-
-    shell = Shell::Create(
-        std::move(task_runners), settings,
-        [](Shell& shell) {
-          return std::make_unique<PlatformView>(shell, shell.GetTaskRunners());
-        },
-        [](Shell& shell) {
-          return std::make_unique<Rasterizer>(shell, shell.GetTaskRunners());
-        });
+    Settings settings = CreateSettingsForBenchmark(assets_dir, aot_symbols);
+    thread_host = CreateThreadHostForBenchmark();
+    shell = Shell::Create(GetTaskRunners(*thread_host), settings,
+                          CreatePlatformView, CreateRasterizer);
   }
 
   FML_CHECK(shell);
 
+  if (measure_startup) {
+    // Report where the startup time goes. Steps run concurrently, so these
+    // add up to more than the total.
+    const auto& timings = shell->GetStartupTimings();
+    for (int i = 0; i < StartupTimings::kStepCount; i++) {
+      const auto step = static_cast<StartupTimings::Step>(i);
+      state.counters[StartupTimings::GetStepName(step)] +=
+          timings.GetDuration(step).ToMicroseconds();
+    }
+  }
+
   {
     benchmarking::ScopedPauseTiming pause(state, !measure_shutdown);
-    // Shutdown must occur synchronously on the platform thread.
-    fml::AutoResetWaitableEvent latch;
-    fml::TaskRunner::RunNowOrPostTask(
-        thread_host->platform_thread->GetTaskRunner(),
-        [&shell, &latch]() mutable {
-          shell.reset();
-          latch.Signal();
-        });
-    latch.Wait();
+    DestroyShell(std::move(shell));
     thread_host.reset();
   }
 
@@ -85,6 +112,10 @@ static void BM_ShellInitialization(benchmark::State& state) {
   while (state.KeepRunning()) {
     StartupAndShutdownShell(state, true, false);
   }
+  // Per step durations in microseconds, averaged over the iterations.
+  for (auto& counter : state.counters) {
+    counter.second.flags = benchmark::Counter::kAvgIterations;
+  }
 }
 
 BENCHMARK(BM_ShellInitialization);
@@ -105,4 +136,55 @@ static void BM_ShellInitializationAndShutdown(benchmark::State& state) {
 
 BENCHMARK(BM_ShellInitializationAndShutdown);
 
+// Measures the creation of a shell for another view from a running shell.
+// Compare with BM_ShellInitialization.
+static void BM_ShellSpawn(benchmark::State& state) {
+  auto assets_dir = fml::OpenDirectory(testing::GetFixturesPath(), false,
+                                       fml::FilePermission::kRead);
+  testing::ELFAOTSymbols aot_symbols;
+  Settings settings = CreateSettingsForBenchmark(assets_dir, aot_symbols);
+  auto thread_host = CreateThreadHostForBenchmark();
+  auto task_runners = GetTaskRunners(*thread_host);
+
+  auto shell = Shell::Create(task_runners, settings, CreatePlatformView,
+                             CreateRasterizer);
+  FML_CHECK(shell);
+
+  // The spawned shells share the assets of the running engine.
+  fml::AutoResetWaitableEvent run_latch;
+  fml::TaskRunner::RunNowOrPostTask(
+      task_runners.GetPlatformTaskRunner(), [&]() {
+        shell->RunEngine(RunConfiguration::InferFromSettings(settings),
+                         [&run_latch](Engine::RunStatus status) {
+                           FML_CHECK(status != Engine::RunStatus::Failure);
+                           run_latch.Signal();
+                         });
+      });
+  run_latch.Wait();
+
+  while (state.KeepRunning()) {
+    auto spawn = shell->Spawn("", "", CreatePlatformView, CreateRasterizer);
+    FML_CHECK(spawn);
+
+    // The spawned engine is run on the UI thread. Measure until its root
+    // isolate has been launched.
+    fml::AutoResetWaitableEvent launch_latch;
+    fml::TaskRunner::RunNowOrPostTask(
+        task_runners.GetUITaskRunner(), [&spawn, &launch_latch]() {
+          FML_CHECK(spawn->GetEngine());
+          FML_CHECK(spawn->GetEngine()->GetUIIsolateMainPort() !=
+                    ILLEGAL_PORT);
+          launch_latch.Signal();
+        });
+    launch_latch.Wait();
+
+    benchmarking::ScopedPauseTiming pause(state, true);
+    DestroyShell(std::move(spawn));
+  }
+
+  DestroyShell(std::move(shell));
+}
+
+BENCHMARK(BM_ShellSpawn);
+
 }  // namespace flutter
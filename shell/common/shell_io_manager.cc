@@ -54,12 +54,16 @@ sk_sp<GrContext> ShellIOManager::CreateCompatibleResourceLoadingContext(
 ShellIOManager::ShellIOManager(
     sk_sp<GrContext> resource_context,
     std::shared_ptr<fml::SyncSwitch> is_gpu_disabled_sync_switch,
-    fml::RefPtr<fml::TaskRunner> unref_queue_task_runner)
+    fml::RefPtr<fml::TaskRunner> unref_queue_task_runner,
+    std::string label)
     : resource_context_(std::move(resource_context)),
       resource_context_weak_factory_(
           resource_context_ ? std::make_unique<fml::WeakPtrFactory<GrContext>>(
                                   resource_context_.get())
                             : nullptr),
+      resource_cache_budget_(ResourceCacheBudget::GetInstance().AddParticipant(
+          std::move(label),
+          ResourceCacheBudget::ParticipantType::kResourceContext)),
       unref_queue_(fml::MakeRefCounted<flutter::SkiaUnrefQueue>(
           std::move(unref_queue_task_runner),
           fml::TimeDelta::FromMilliseconds(8),
@@ -75,6 +79,24 @@ ShellIOManager::ShellIOManager(
   }
 }
 
+ShellIOManager::ShellIOManager(
+    sk_sp<GrContext> resource_context,
+    std::shared_ptr<fml::SyncSwitch> is_gpu_disabled_sync_switch,
+    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
+    std::string label)
+    : resource_context_(std::move(resource_context)),
+      is_resource_context_shared_(resource_context_ != nullptr),
+      resource_context_weak_factory_(
+          resource_context_ ? std::make_unique<fml::WeakPtrFactory<GrContext>>(
+                                  resource_context_.get())
+                            : nullptr),
+      resource_cache_budget_(ResourceCacheBudget::GetInstance().AddParticipant(
+          std::move(label),
+          ResourceCacheBudget::ParticipantType::kResourceContext)),
+      unref_queue_(std::move(unref_queue)),
+      weak_factory_(this),
+      is_gpu_disabled_sync_switch_(is_gpu_disabled_sync_switch) {}
+
 ShellIOManager::~ShellIOManager() {
   // Last chance to drain the IO queue as the platform side reference to the
   // underlying OpenGL context may be going away.
@@ -82,6 +104,16 @@ ShellIOManager::~ShellIOManager() {
       fml::SyncSwitch::Handlers().SetIfFalse([&] { unref_queue_->Drain(); }));
 }
 
+std::unique_ptr<ShellIOManager> ShellIOManager::Spawn(std::string label) const {
+  return std::unique_ptr<ShellIOManager>(
+      new ShellIOManager(resource_context_, is_gpu_disabled_sync_switch_,
+                         unref_queue_, std::move(label)));
+}
+
+bool ShellIOManager::IsResourceContextShared() const {
+  return is_resource_context_shared_;
+}
+
 void ShellIOManager::NotifyResourceContextAvailable(
     sk_sp<GrContext> resource_context) {
   // The resource context needs to survive as long as we have Dart objects
@@ -94,12 +126,22 @@ void ShellIOManager::NotifyResourceContextAvailable(
 
 void ShellIOManager::UpdateResourceContext(sk_sp<GrContext> resource_context) {
   resource_context_ = std::move(resource_context);
+  is_resource_context_shared_ = false;
   resource_context_weak_factory_ =
       resource_context_ ? std::make_unique<fml::WeakPtrFactory<GrContext>>(
                               resource_context_.get())
                         : nullptr;
 }
 
+void ShellIOManager::UpdateResourceCacheUsage() {
+  size_t usage_bytes = 0;
+  // A shared resource context is reported by the IO manager that created it.
+  if (resource_context_ && !is_resource_context_shared_) {
+    resource_context_->getResourceCacheUsage(nullptr, &usage_bytes);
+  }
+  resource_cache_budget_->ReportUsage(usage_bytes);
+}
+
 fml::WeakPtr<ShellIOManager> ShellIOManager::GetWeakPtr() {
   return weak_factory_.GetWeakPtr();
 }
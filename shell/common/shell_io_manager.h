@@ -6,11 +6,13 @@
 #define FLUTTER_SHELL_COMMON_SHELL_IO_MANAGER_H_
 
 #include <memory>
+#include <string>
 
 #include "flutter/flow/skia_gpu_object.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/lib/ui/io_manager.h"
+#include "flutter/shell/common/resource_cache_budget.h"
 #include "third_party/skia/include/gpu/GrContext.h"
 
 namespace flutter {
@@ -26,10 +28,22 @@ class ShellIOManager final : public IOManager {
 
   ShellIOManager(sk_sp<GrContext> resource_context,
                  std::shared_ptr<fml::SyncSwitch> is_gpu_disabled_sync_switch,
-                 fml::RefPtr<fml::TaskRunner> unref_queue_task_runner);
+                 fml::RefPtr<fml::TaskRunner> unref_queue_task_runner,
+                 std::string label);
 
   ~ShellIOManager() override;
 
+  // Creates an IO manager for a spawned shell that shares the resource context
+  // and the Skia unref queue of this one. The spawned IO manager holds its own
+  // references to both, so either of them may be collected first. This must
+  // be called on the IO task runner.
+  std::unique_ptr<ShellIOManager> Spawn(std::string label) const;
+
+  // Whether the resource context was shared by the IO manager this one was
+  // spawned from. The platform view of a shell only releases the resource
+  // context it created.
+  bool IsResourceContextShared() const;
+
   // This method should be called when a resource_context first becomes
   // available. It is safe to call multiple times, and will only update
   // the held resource context if it has not already been set.
@@ -41,6 +55,10 @@ class ShellIOManager final : public IOManager {
   // resource context, but may be called if the Dart VM is restarted.
   void UpdateResourceContext(sk_sp<GrContext> resource_context);
 
+  // Reports the bytes held by the resource context to the process-wide
+  // resource cache budget. This must be called on the IO task runner.
+  void UpdateResourceCacheUsage();
+
   fml::WeakPtr<ShellIOManager> GetWeakPtr();
 
   // |IOManager|
@@ -56,10 +74,17 @@ class ShellIOManager final : public IOManager {
   std::shared_ptr<fml::SyncSwitch> GetIsGpuDisabledSyncSwitch() override;
 
  private:
+  ShellIOManager(sk_sp<GrContext> resource_context,
+                 std::shared_ptr<fml::SyncSwitch> is_gpu_disabled_sync_switch,
+                 fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
+                 std::string label);
+
   // Resource context management.
   sk_sp<GrContext> resource_context_;
+  bool is_resource_context_shared_ = false;
   std::unique_ptr<fml::WeakPtrFactory<GrContext>>
       resource_context_weak_factory_;
+  std::unique_ptr<ResourceCacheBudget::Participant> resource_cache_budget_;
 
   // Unref queue management.
   fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue_;
@@ -221,6 +221,9 @@ void ShellTest::OnServiceProtocol(
           case ServiceProtocolEnum::kRunInView:
             shell->OnServiceProtocolRunInView(params, response);
             break;
+          case ServiceProtocolEnum::kGetResourceCacheUsage:
+            shell->OnServiceProtocolGetResourceCacheUsage(params, response);
+            break;
         }
         finished.set_value(true);
       });
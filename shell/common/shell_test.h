@@ -84,6 +84,7 @@ class ShellTest : public ThreadTest {
     kGetSkSLs,
     kSetAssetBundlePath,
     kRunInView,
+    kGetResourceCacheUsage,
   };
 
   // Helper method to test private method Shell::OnServiceProtocolGetSkSLs.
@@ -161,9 +161,10 @@ ShellTestPlatformViewVulkan::OffScreenSurface::AcquireFrame(
                                       SkAlphaType::kOpaque_SkAlphaType);
   auto surface = SkSurface::MakeRenderTarget(context_.get(), SkBudgeted::kNo,
                                              image_info, 0, nullptr);
-  SurfaceFrame::SubmitCallback callback = [](const SurfaceFrame&,
-                                             SkCanvas* canvas) -> bool {
+  SurfaceFrame::SubmitCallback callback =
+      [](const SurfaceFrame& surface_frame, SkCanvas* canvas) -> bool {
     canvas->flush();
+    surface_frame.NotifyFlushed();
     return true;
   };
 
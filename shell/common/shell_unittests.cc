@@ -5,10 +5,12 @@
 #define FML_USED_ON_EMBEDDER
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
 #include <future>
 #include <memory>
 
+#include "flutter/assets/packed_asset_bundle.h"
 #include "flutter/flow/layers/layer_tree.h"
 #include "flutter/flow/layers/picture_layer.h"
 #include "flutter/flow/layers/transform_layer.h"
@@ -22,6 +24,7 @@
 #include "flutter/shell/common/persistent_cache.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/rasterizer.h"
+#include "flutter/shell/common/resource_cache_budget.h"
 #include "flutter/shell/common/shell_test.h"
 #include "flutter/shell/common/shell_test_external_view_embedder.h"
 #include "flutter/shell/common/shell_test_platform_view.h"
@@ -171,6 +174,173 @@ TEST_F(ShellTest, InitializeWithGPUAndPlatformThreadsTheSame) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
 }
 
+TEST_F(ShellTest, RecordsStartupTimings) {
+  ASSERT_FALSE(DartVMRef::IsInstanceRunning());
+  auto shell = CreateShell(CreateSettingsForFixture());
+  ASSERT_TRUE(ValidateShell(shell.get()));
+
+  const auto& timings = shell->GetStartupTimings();
+  ASSERT_TRUE(timings.HasStep(StartupTimings::kDartVMCreation));
+  for (int i = StartupTimings::kRasterizerCreation;
+       i < StartupTimings::kStepCount; i++) {
+    const auto step = static_cast<StartupTimings::Step>(i);
+    ASSERT_TRUE(timings.HasStep(step)) << StartupTimings::GetStepName(step);
+    ASSERT_LE(timings.GetDuration(step), timings.GetTotal());
+  }
+
+  DestroyShell(std::move(shell));
+  ASSERT_FALSE(DartVMRef::IsInstanceRunning());
+}
+
+static std::unique_ptr<Shell> SpawnShell(Shell& spawner,
+                                         std::string entrypoint) {
+  return spawner.Spawn(
+      std::move(entrypoint), "",
+      [](Shell& shell) {
+        const auto& task_runners = shell.GetTaskRunners();
+        return ShellTestPlatformView::Create(
+            shell, task_runners, std::make_shared<ShellTestVsyncClock>(),
+            [task_runners]() {
+              return static_cast<std::unique_ptr<VsyncWaiter>>(
+                  std::make_unique<VsyncWaiterFallback>(task_runners));
+            },
+            ShellTestPlatformView::BackendType::kDefaultBackend, nullptr);
+      },
+      [](Shell& shell) {
+        return std::make_unique<Rasterizer>(shell, shell.GetTaskRunners());
+      });
+}
+
+// Serves an empty font manifest and counts how often it is read.
+class FontManifestCounter final : public AssetResolver {
+ public:
+  explicit FontManifestCounter(std::shared_ptr<std::atomic<int>> reads)
+      : reads_(std::move(reads)) {}
+
+  // |AssetResolver|
+  bool IsValid() const override { return true; }
+
+  // |AssetResolver|
+  std::unique_ptr<fml::Mapping> GetAsMapping(
+      const std::string& asset_name) const override {
+    if (asset_name != "FontManifest.json") {
+      return nullptr;
+    }
+    (*reads_)++;
+    return std::make_unique<fml::DataMapping>(std::string("[]"));
+  }
+
+ private:
+  std::shared_ptr<std::atomic<int>> reads_;
+};
+
+static void FlushTaskRunner(fml::RefPtr<fml::TaskRunner> task_runner) {
+  fml::AutoResetWaitableEvent latch;
+  fml::TaskRunner::RunNowOrPostTask(task_runner,
+                                    [&latch]() { latch.Signal(); });
+  latch.Wait();
+}
+
+TEST_F(ShellTest, SpawnedShellSharesFontsAndAssetsWithItsSpawner) {
+  ASSERT_FALSE(DartVMRef::IsInstanceRunning());
+  auto settings = CreateSettingsForFixture();
+  auto shell = CreateShell(settings);
+  ASSERT_TRUE(ValidateShell(shell.get()));
+
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("emptyMain");
+  RunEngine(shell.get(), std::move(configuration));
+
+  fml::AutoResetWaitableEvent main_latch;
+  AddNativeCallback(
+      "SayHiFromFixturesAreFunctionalMain",
+      CREATE_NATIVE_ENTRY([&main_latch](auto args) { main_latch.Signal(); }));
+
+  auto spawn = SpawnShell(*shell, "fixturesAreFunctionalMain");
+  ASSERT_TRUE(ValidateShell(spawn.get()));
+  main_latch.Wait();
+
+  fml::AutoResetWaitableEvent latch;
+  fml::TaskRunner::RunNowOrPostTask(
+      shell->GetTaskRunners().GetUITaskRunner(), [&]() {
+        auto engine = shell->GetEngine();
+        auto spawned_engine = spawn->GetEngine();
+        EXPECT_TRUE(engine && spawned_engine);
+        if (engine && spawned_engine) {
+          EXPECT_EQ(&engine->GetFontCollection(),
+                    &spawned_engine->GetFontCollection());
+          EXPECT_EQ(engine->GetAssetManager(),
+                    spawned_engine->GetAssetManager());
+        }
+        latch.Signal();
+      });
+  latch.Wait();
+
+  DestroyShell(std::move(spawn));
+  DestroyShell(std::move(shell));
+  ASSERT_FALSE(DartVMRef::IsInstanceRunning());
+}
+
+TEST_F(ShellTest, SpawnedShellDoesNotReadTheSharedAssetsAgain) {
+  ASSERT_FALSE(DartVMRef::IsInstanceRunning());
+  auto settings = CreateSettingsForFixture();
+  auto shell = CreateShell(settings);
+  ASSERT_TRUE(ValidateShell(shell.get()));
+
+  auto reads = std::make_shared<std::atomic<int>>(0);
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("emptyMain");
+  configuration.GetAssetManager()->PushFront(
+      std::make_unique<FontManifestCounter>(reads));
+  RunEngine(shell.get(), std::move(configuration));
+  // The manifest is prefetched on the IO thread.
+  FlushTaskRunner(shell->GetTaskRunners().GetIOTaskRunner());
+  const int spawner_reads = *reads;
+  ASSERT_GT(spawner_reads, 0);
+
+  fml::AutoResetWaitableEvent main_latch;
+  AddNativeCallback(
+      "SayHiFromFixturesAreFunctionalMain",
+      CREATE_NATIVE_ENTRY([&main_latch](auto args) { main_latch.Signal(); }));
+  auto spawn = SpawnShell(*shell, "fixturesAreFunctionalMain");
+  ASSERT_TRUE(ValidateShell(spawn.get()));
+  main_latch.Wait();
+  FlushTaskRunner(shell->GetTaskRunners().GetIOTaskRunner());
+
+  // Neither prefetched nor registered with the font collection again.
+  ASSERT_EQ(*reads, spawner_reads);
+
+  DestroyShell(std::move(spawn));
+  DestroyShell(std::move(shell));
+  ASSERT_FALSE(DartVMRef::IsInstanceRunning());
+}
+
+TEST_F(ShellTest, SpawnedShellOutlivesItsSpawner) {
+  ASSERT_FALSE(DartVMRef::IsInstanceRunning());
+  auto settings = CreateSettingsForFixture();
+  auto shell = CreateShell(settings);
+  ASSERT_TRUE(ValidateShell(shell.get()));
+
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("emptyMain");
+  RunEngine(shell.get(), std::move(configuration));
+
+  fml::AutoResetWaitableEvent main_latch;
+  AddNativeCallback(
+      "SayHiFromFixturesAreFunctionalMain",
+      CREATE_NATIVE_ENTRY([&main_latch](auto args) { main_latch.Signal(); }));
+  auto spawn = SpawnShell(*shell, "fixturesAreFunctionalMain");
+  ASSERT_TRUE(ValidateShell(spawn.get()));
+  main_latch.Wait();
+
+  // The spawned shell holds its own references to the shared resources.
+  DestroyShell(std::move(shell));
+  ASSERT_TRUE(ValidateShell(spawn.get()));
+
+  DestroyShell(std::move(spawn));
+  ASSERT_FALSE(DartVMRef::IsInstanceRunning());
+}
+
 TEST_F(ShellTest, FixturesAreFunctional) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
   auto settings = CreateSettingsForFixture();
@@ -1221,5 +1391,56 @@ TEST_F(ShellTest, OnServiceProtocolGetSkSLsWorks) {
   fml::RemoveFilesInDirectory(temp_dir.fd());
 }
 
+TEST_F(ShellTest, OnServiceProtocolGetResourceCacheUsageWorks) {
+  Settings settings = CreateSettingsForFixture();
+  settings.resource_cache_budget_bytes = 64 << 20;
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+  ServiceProtocol::Handler::ServiceProtocolMap empty_params;
+  rapidjson::Document document;
+  OnServiceProtocol(shell.get(), ServiceProtocolEnum::kGetResourceCacheUsage,
+                    shell->GetTaskRunners().GetIOTaskRunner(), empty_params,
+                    document);
+  DestroyShell(std::move(shell));
+  // The budget is process-wide, so leave it unlimited for the other tests.
+  ResourceCacheBudget::GetInstance().SetMaxBytes(0);
+
+  ASSERT_TRUE(document.IsObject());
+  ASSERT_STREQ(document["type"].GetString(), "ResourceCacheUsage");
+  ASSERT_EQ(document["maxBytes"].GetUint64(), 64u << 20);
+  ASSERT_TRUE(document["participants"].IsArray());
+  for (const auto& participant : document["participants"].GetArray()) {
+    ASSERT_TRUE(participant["engine"].IsString());
+    ASSERT_TRUE(participant["usageBytes"].IsUint64());
+  }
+}
+
+TEST_F(ShellTest, InferredAssetManagerResolvesPackedAssetsFirst) {
+  fml::ScopedTemporaryDirectory assets_dir;
+  ASSERT_TRUE(fml::WriteAtomically(assets_dir.fd(), "packed.txt",
+                                   fml::DataMapping("packed")));
+  ASSERT_TRUE(PackedAssetBundle::PackDirectory(
+      assets_dir.fd(), assets_dir.fd(), PackedAssetBundle::kArchiveFileName));
+  // The archive is resolved ahead of the directory, which still provides the
+  // assets added after packing.
+  ASSERT_TRUE(fml::WriteAtomically(assets_dir.fd(), "packed.txt",
+                                   fml::DataMapping("unpacked")));
+  ASSERT_TRUE(fml::WriteAtomically(assets_dir.fd(), "added.txt",
+                                   fml::DataMapping("added")));
+
+  Settings settings = CreateSettingsForFixture();
+  settings.assets_path = assets_dir.path();
+  auto asset_manager =
+      RunConfiguration::InferFromSettings(settings).GetAssetManager();
+
+  auto packed = asset_manager->GetAsMapping("packed.txt");
+  ASSERT_NE(packed, nullptr);
+  ASSERT_EQ(std::string(reinterpret_cast<const char*>(packed->GetMapping()),
+                        packed->GetSize()),
+            "packed");
+  ASSERT_NE(asset_manager->GetAsMapping("added.txt"), nullptr);
+
+  fml::RemoveFilesInDirectory(assets_dir.fd());
+}
+
 }  // namespace testing
 }  // namespace flutter
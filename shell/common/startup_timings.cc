@@ -0,0 +1,89 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/startup_timings.h"
+
+#include <algorithm>
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+StartupTimings::ScopedStep::ScopedStep(StartupTimings& timings, Step step)
+    : timings_(timings), step_(step), start_(fml::TimePoint::Now()) {}
+
+StartupTimings::ScopedStep::~ScopedStep() {
+  timings_.Record(step_, start_, fml::TimePoint::Now());
+}
+
+void StartupTimings::Record(Step step,
+                            fml::TimePoint start,
+                            fml::TimePoint finish) {
+  FML_DCHECK(step >= 0 && step < kStepCount);
+  FML_DCHECK(start <= finish);
+  steps_[step] = {start, finish};
+}
+
+bool StartupTimings::HasStep(Step step) const {
+  return steps_[step].finish != fml::TimePoint();
+}
+
+fml::TimePoint StartupTimings::GetStart(Step step) const {
+  return steps_[step].start;
+}
+
+fml::TimePoint StartupTimings::GetFinish(Step step) const {
+  return steps_[step].finish;
+}
+
+fml::TimeDelta StartupTimings::GetDuration(Step step) const {
+  if (!HasStep(step)) {
+    return fml::TimeDelta::Zero();
+  }
+  return steps_[step].finish - steps_[step].start;
+}
+
+fml::TimeDelta StartupTimings::GetTotal() const {
+  fml::TimePoint earliest = fml::TimePoint::Max();
+  fml::TimePoint latest = fml::TimePoint::Min();
+  for (const auto& interval : steps_) {
+    if (interval.finish == fml::TimePoint()) {
+      continue;
+    }
+    earliest = std::min(earliest, interval.start);
+    latest = std::max(latest, interval.finish);
+  }
+  if (earliest > latest) {
+    return fml::TimeDelta::Zero();
+  }
+  return latest - earliest;
+}
+
+const char* StartupTimings::GetStepName(Step step) {
+  switch (step) {
+    case kInitializationTasks:
+      return "initializationTasks";
+    case kICUInitialization:
+      return "icuInitialization";
+    case kDartVMCreation:
+      return "dartVMCreation";
+    case kRasterizerCreation:
+      return "rasterizerCreation";
+    case kPlatformViewCreation:
+      return "platformViewCreation";
+    case kVsyncWaiterCreation:
+      return "vsyncWaiterCreation";
+    case kIOManagerCreation:
+      return "ioManagerCreation";
+    case kEngineCreation:
+      return "engineCreation";
+    case kShellSetup:
+      return "shellSetup";
+    case kStepCount:
+      break;
+  }
+  return "unknown";
+}
+
+}  // namespace flutter
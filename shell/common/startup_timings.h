@@ -0,0 +1,85 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_STARTUP_TIMINGS_H_
+#define FLUTTER_SHELL_COMMON_STARTUP_TIMINGS_H_
+
+#include <array>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      The start and finish times of each step of shell startup.
+///
+///             Independent steps run concurrently on different threads, so
+///             the sum of the step durations may exceed the total. Each step
+///             is recorded by a single thread and the timings may only be
+///             read once the shell has been created.
+///
+class StartupTimings {
+ public:
+  enum Step {
+    // Process-wide steps, performed once for the first shell.
+    kInitializationTasks,
+    kICUInitialization,
+    kDartVMCreation,
+    // Steps performed for each shell.
+    kRasterizerCreation,
+    kPlatformViewCreation,
+    kVsyncWaiterCreation,
+    kIOManagerCreation,
+    kEngineCreation,
+    kShellSetup,
+    kStepCount
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Records the duration of a step from its construction to its
+  ///             destruction.
+  ///
+  class ScopedStep {
+   public:
+    ScopedStep(StartupTimings& timings, Step step);
+
+    ~ScopedStep();
+
+   private:
+    StartupTimings& timings_;
+    const Step step_;
+    const fml::TimePoint start_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(ScopedStep);
+  };
+
+  void Record(Step step, fml::TimePoint start, fml::TimePoint finish);
+
+  bool HasStep(Step step) const;
+
+  fml::TimePoint GetStart(Step step) const;
+
+  fml::TimePoint GetFinish(Step step) const;
+
+  fml::TimeDelta GetDuration(Step step) const;
+
+  // The time from the start of the earliest step to the finish of the latest.
+  fml::TimeDelta GetTotal() const;
+
+  static const char* GetStepName(Step step);
+
+ private:
+  struct Interval {
+    fml::TimePoint start;
+    fml::TimePoint finish;
+  };
+
+  std::array<Interval, kStepCount> steps_;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_STARTUP_TIMINGS_H_
@@ -0,0 +1,56 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/startup_timings.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+fml::TimePoint Millis(int64_t millis) {
+  return fml::TimePoint::FromEpochDelta(
+      fml::TimeDelta::FromMilliseconds(millis));
+}
+
+}  // namespace
+
+TEST(StartupTimingsTest, StepsAreUnsetByDefault) {
+  StartupTimings timings;
+  for (int i = 0; i < StartupTimings::kStepCount; i++) {
+    const auto step = static_cast<StartupTimings::Step>(i);
+    ASSERT_FALSE(timings.HasStep(step));
+    ASSERT_EQ(timings.GetDuration(step), fml::TimeDelta::Zero());
+  }
+  ASSERT_EQ(timings.GetTotal(), fml::TimeDelta::Zero());
+}
+
+TEST(StartupTimingsTest, TotalCoversConcurrentSteps) {
+  StartupTimings timings;
+  timings.Record(StartupTimings::kDartVMCreation, Millis(10), Millis(40));
+  timings.Record(StartupTimings::kICUInitialization, Millis(12), Millis(30));
+  timings.Record(StartupTimings::kEngineCreation, Millis(45), Millis(60));
+
+  ASSERT_TRUE(timings.HasStep(StartupTimings::kICUInitialization));
+  ASSERT_EQ(timings.GetDuration(StartupTimings::kICUInitialization),
+            fml::TimeDelta::FromMilliseconds(18));
+  ASSERT_EQ(timings.GetStart(StartupTimings::kEngineCreation), Millis(45));
+  ASSERT_EQ(timings.GetFinish(StartupTimings::kEngineCreation), Millis(60));
+  ASSERT_EQ(timings.GetTotal(), fml::TimeDelta::FromMilliseconds(50));
+}
+
+TEST(StartupTimingsTest, ScopedStepRecordsItsDuration) {
+  StartupTimings timings;
+  const auto before = fml::TimePoint::Now();
+  { StartupTimings::ScopedStep step(timings, StartupTimings::kShellSetup); }
+  const auto after = fml::TimePoint::Now();
+
+  ASSERT_TRUE(timings.HasStep(StartupTimings::kShellSetup));
+  ASSERT_GE(timings.GetStart(StartupTimings::kShellSetup), before);
+  ASSERT_LE(timings.GetFinish(StartupTimings::kShellSetup), after);
+}
+
+}  // namespace testing
+}  // namespace flutter
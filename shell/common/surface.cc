@@ -44,6 +44,12 @@ sk_sp<SkSurface> SurfaceFrame::SkiaSurface() const {
   return surface_;
 }
 
+void SurfaceFrame::NotifyFlushed() const {
+  if (flushed_callback_) {
+    flushed_callback_();
+  }
+}
+
 bool SurfaceFrame::PerformSubmit() {
   if (submit_callback_ == nullptr) {
     return false;
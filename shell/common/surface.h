@@ -20,6 +20,7 @@ class SurfaceFrame {
  public:
   using SubmitCallback =
       std::function<bool(const SurfaceFrame& surface_frame, SkCanvas* canvas)>;
+  using FlushedCallback = std::function<void()>;
 
   SurfaceFrame(sk_sp<SkSurface> surface,
                bool supports_readback,
@@ -35,11 +36,23 @@ class SurfaceFrame {
 
   bool supports_readback() { return supports_readback_; }
 
+  /// Set a callback to be made while submitting the frame once its canvas has
+  /// been flushed and before it is presented. Surfaces that cannot tell the
+  /// two steps apart do not make the callback.
+  void set_flushed_callback(FlushedCallback callback) {
+    flushed_callback_ = std::move(callback);
+  }
+
+  /// Called by the submit callback of the surface once the canvas has been
+  /// flushed.
+  void NotifyFlushed() const;
+
  private:
   bool submitted_;
   sk_sp<SkSurface> surface_;
   bool supports_readback_;
   SubmitCallback submit_callback_;
+  FlushedCallback flushed_callback_;
 
   bool PerformSubmit();
 
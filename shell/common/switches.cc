@@ -281,9 +281,18 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.trace_systrace =
       command_line.HasOption(FlagForSwitch(Switch::TraceSystrace));
 
+  command_line.GetOptionValue(FlagForSwitch(Switch::TraceRecorderCategories),
+                              &settings.trace_recorder_categories);
+
   settings.skia_deterministic_rendering_on_cpu =
       command_line.HasOption(FlagForSwitch(Switch::SkiaDeterministicRendering));
 
+  settings.scale_tolerant_raster_cache =
+      command_line.HasOption(FlagForSwitch(Switch::ScaleTolerantRasterCache));
+
+  GetSwitchValue(command_line, Switch::ResourceCacheBudgetBytes,
+                 &settings.resource_cache_budget_bytes);
+
   settings.verbose_logging =
       command_line.HasOption(FlagForSwitch(Switch::VerboseLogging));
 
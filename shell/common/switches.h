@@ -103,6 +103,18 @@ DEF_SWITCH(SkiaDeterministicRendering,
            "Skips the call to SkGraphics::Init(), thus avoiding swapping out "
            "some Skia function pointers based on available CPU features. This "
            "is used to obtain 100% deterministic behavior in Skia rendering.")
+DEF_SWITCH(ScaleTolerantRasterCache,
+           "scale-tolerant-raster-cache",
+           "Keep pictures that are hinted to change in the raster cache at a "
+           "few fixed scales, and draw them scaled to the scales in between. "
+           "This keeps them cached through scale animations and pinch-zooms "
+           "at the cost of some sharpness.")
+DEF_SWITCH(ResourceCacheBudgetBytes,
+           "resource-cache-budget-bytes",
+           "The most bytes the GPU resource caches of all the engines in the "
+           "process may hold together. The limit is split among the engines "
+           "by their recent usage. There is no process-wide limit by "
+           "default.")
 DEF_SWITCH(FlutterAssetsDir,
            "flutter-assets-dir",
            "Path to the Flutter assets directory.")
@@ -151,6 +163,13 @@ DEF_SWITCH(
     "Trace to the system tracer (instead of the timeline) on platforms where "
     "such a tracer is available. Currently only supported on Android and "
     "Fuchsia.")
+DEF_SWITCH(TraceRecorderCategories,
+           "trace-recorder-categories",
+           "Record the trace events of this comma separated list of "
+           "categories, or of all categories if \"*\", into per-thread ring "
+           "buffers in the engine. The recorded events can be dumped via the "
+           "service protocol or the embedder API, including in release "
+           "builds.")
 DEF_SWITCH(UseTestFonts,
            "use-test-fonts",
            "Running tests that layout and measure text will not yield "
@@ -79,14 +79,8 @@ GPUSurfaceGL::GPUSurfaceGL(GPUSurfaceGLDelegate* delegate,
 
   valid_ = true;
 
-  std::vector<PersistentCache::SkSLCache> caches =
-      PersistentCache::GetCacheForProcess()->LoadSkSLs();
-  int compiled_count = 0;
-  for (const auto& cache : caches) {
-    compiled_count += context_->precompileShader(*cache.first, *cache.second);
-  }
-  FML_LOG(INFO) << "Found " << caches.size() << " SkSL shaders; precompiled "
-                << compiled_count;
+  // Recorded SkSL shaders are precompiled by `Rasterizer::WarmUpShaders`
+  // after the surface is set up.
 
   delegate_->GLContextClearCurrent();
 }
@@ -259,14 +253,15 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceGL::AcquireFrame(const SkISize& size) {
   SurfaceFrame::SubmitCallback submit_callback =
       [weak = weak_factory_.GetWeakPtr()](const SurfaceFrame& surface_frame,
                                           SkCanvas* canvas) {
-        return weak ? weak->PresentSurface(canvas) : false;
+        return weak ? weak->PresentSurface(surface_frame, canvas) : false;
       };
 
   return std::make_unique<SurfaceFrame>(
       surface, delegate_->SurfaceSupportsReadback(), submit_callback);
 }
 
-bool GPUSurfaceGL::PresentSurface(SkCanvas* canvas) {
+bool GPUSurfaceGL::PresentSurface(const SurfaceFrame& surface_frame,
+                                  SkCanvas* canvas) {
   if (delegate_ == nullptr || canvas == nullptr || context_ == nullptr) {
     return false;
   }
@@ -275,6 +270,7 @@ bool GPUSurfaceGL::PresentSurface(SkCanvas* canvas) {
     TRACE_EVENT0("flutter", "SkCanvas::Flush");
     onscreen_surface_->getCanvas()->flush();
   }
+  surface_frame.NotifyFlushed();
 
   if (!delegate_->GLContextPresent()) {
     return false;
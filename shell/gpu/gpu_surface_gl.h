@@ -66,7 +66,7 @@ class GPUSurfaceGL : public Surface {
       const SkISize& untransformed_size,
       const SkMatrix& root_surface_transformation);
 
-  bool PresentSurface(SkCanvas* canvas);
+  bool PresentSurface(const SurfaceFrame& surface_frame, SkCanvas* canvas);
 
   FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceGL);
 };
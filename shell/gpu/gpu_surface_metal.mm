@@ -86,6 +86,7 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceMetal::AcquireFrame(const SkISize& frame
     }
 
     canvas->flush();
+    surface_frame.NotifyFlushed();
 
     if (next_drawable_ == nullptr) {
       FML_DLOG(ERROR) << "Could not acquire next Metal drawable from the SkSurface.";
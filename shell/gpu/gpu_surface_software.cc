@@ -65,6 +65,7 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
     }
 
     canvas->flush();
+    surface_frame.NotifyFlushed();
 
     return self->delegate_->PresentBackingStore(surface_frame.SkiaSurface());
   };
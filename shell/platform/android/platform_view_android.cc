@@ -391,6 +391,14 @@ std::unique_ptr<VsyncWaiter> PlatformViewAndroid::CreateVSyncWaiter() {
   return std::make_unique<VsyncWaiterAndroid>(task_runners_);
 }
 
+// |PlatformView|
+PointerDataDispatcherMaker PlatformViewAndroid::GetDispatcherMaker() {
+  // Touch screens commonly sample at 120Hz or more, out of phase with VSYNC.
+  return [](DefaultPointerDataDispatcher::Delegate& delegate) {
+    return std::make_unique<ResamplingPointerDataDispatcher>(delegate);
+  };
+}
+
 // |PlatformView|
 std::unique_ptr<Surface> PlatformViewAndroid::CreateRenderingSurface() {
   if (!android_surface_) {
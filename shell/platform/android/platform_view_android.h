@@ -96,6 +96,9 @@ class PlatformViewAndroid final : public PlatformView {
   // |PlatformView|
   std::unique_ptr<VsyncWaiter> CreateVSyncWaiter() override;
 
+  // |PlatformView|
+  PointerDataDispatcherMaker GetDispatcherMaker() override;
+
   // |PlatformView|
   std::unique_ptr<Surface> CreateRenderingSurface() override;
 
@@ -8,6 +8,8 @@
 // Utility classes for interacting with a buffer of bytes as a stream, for use
 // in message channel codecs.
 
+#include <algorithm>
+#include <cassert>
 #include <cstdint>
 #include <cstring>
 #include <iostream>
@@ -28,6 +30,7 @@ class ByteBufferStreamReader {
   uint8_t ReadByte() {
     if (location_ >= size_) {
       std::cerr << "Invalid read in StandardCodecByteStreamReader" << std::endl;
+      has_error_ = true;
       return 0;
     }
     return bytes_[location_++];
@@ -36,12 +39,25 @@ class ByteBufferStreamReader {
   // Reads the next |length| bytes from the stream into |buffer|. The caller
   // is responsible for ensuring that |buffer| is large enough.
   void ReadBytes(uint8_t* buffer, size_t length) {
-    if (location_ + length > size_) {
+    const uint8_t* bytes = ReadView(length);
+    if (bytes && length > 0) {
+      std::memcpy(buffer, bytes, length);
+    }
+  }
+
+  // Advances past the next |length| bytes of the stream and returns a pointer
+  // to them within the wrapped buffer, without copying. Returns nullptr if
+  // fewer than |length| bytes remain.
+  const uint8_t* ReadView(size_t length) {
+    if (length > size_ - location_) {
       std::cerr << "Invalid read in StandardCodecByteStreamReader" << std::endl;
-      return;
+      location_ = size_;
+      has_error_ = true;
+      return nullptr;
     }
-    std::memcpy(buffer, &bytes_[location_], length);
+    const uint8_t* bytes = &bytes_[location_];
     location_ += length;
+    return bytes;
   }
 
   // Advances the read cursor to the next multiple of |alignment| relative to
@@ -49,10 +65,13 @@ class ByteBufferStreamReader {
   void ReadAlignment(uint8_t alignment) {
     uint8_t mod = location_ % alignment;
     if (mod) {
-      location_ += alignment - mod;
+      location_ = std::min(location_ + alignment - mod, size_);
     }
   }
 
+  // Returns true if any read has gone past the end of the wrapped buffer.
+  bool HasError() const { return has_error_; }
+
  private:
   // The buffer to read from.
   const uint8_t* bytes_;
@@ -60,6 +79,8 @@ class ByteBufferStreamReader {
   size_t size_;
   // The current read location.
   size_t location_ = 0;
+  // Whether a read has gone past the end of the buffer.
+  bool has_error_ = false;
 };
 
 // Wraps an array of bytes with utility methods for treating it as a writable
@@ -89,9 +110,7 @@ class ByteBufferStreamWriter {
   void WriteAlignment(uint8_t alignment) {
     uint8_t mod = bytes_->size() % alignment;
     if (mod) {
-      for (int i = 0; i < alignment - mod; ++i) {
-        WriteByte(0);
-      }
+      bytes_->insert(bytes_->end(), alignment - mod, 0);
     }
   }
 
@@ -0,0 +1,70 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_COMMON_CPP_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_VISITOR_H_
+#define FLUTTER_SHELL_PLATFORM_COMMON_CPP_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_VISITOR_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace flutter {
+
+// Receives the values of a message encoded with the standard codec as they
+// are decoded, without building an EncodableValue for them.
+//
+// Values are reported in the order they appear in the message. Lists report
+// OnListStart, then each element, then OnListEnd. Maps report OnMapStart,
+// then each key followed by its value, then OnMapEnd.
+//
+// Strings and typed lists are reported as views into the message whenever
+// possible, so they are only valid for the duration of the call. Callers
+// that need them afterwards must copy them.
+//
+// The default implementations ignore the values, so subclasses only need to
+// override the methods for the values they are interested in.
+class StandardCodecVisitor {
+ public:
+  StandardCodecVisitor() = default;
+
+  virtual ~StandardCodecVisitor() = default;
+
+  // Prevent copying.
+  StandardCodecVisitor(StandardCodecVisitor const&) = delete;
+  StandardCodecVisitor& operator=(StandardCodecVisitor const&) = delete;
+
+  virtual void OnNull() {}
+
+  virtual void OnBool(bool value) {}
+
+  virtual void OnInt(int32_t value) {}
+
+  virtual void OnLong(int64_t value) {}
+
+  virtual void OnDouble(double value) {}
+
+  // |data| is UTF-8 encoded and is not null terminated.
+  virtual void OnString(const char* data, size_t size) {}
+
+  virtual void OnByteList(const uint8_t* data, size_t count) {}
+
+  virtual void OnIntList(const int32_t* data, size_t count) {}
+
+  virtual void OnLongList(const int64_t* data, size_t count) {}
+
+  virtual void OnDoubleList(const double* data, size_t count) {}
+
+  // Called before the |count| elements of a list.
+  virtual void OnListStart(size_t count) {}
+
+  virtual void OnListEnd() {}
+
+  // Called before the |count| key/value pairs of a map.
+  virtual void OnMapStart(size_t count) {}
+
+  virtual void OnMapEnd() {}
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_COMMON_CPP_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_VISITOR_H_
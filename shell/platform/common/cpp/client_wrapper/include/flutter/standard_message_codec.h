@@ -5,8 +5,11 @@
 #ifndef FLUTTER_SHELL_PLATFORM_COMMON_CPP_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_MESSAGE_CODEC_H_
 #define FLUTTER_SHELL_PLATFORM_COMMON_CPP_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_MESSAGE_CODEC_H_
 
+#include <vector>
+
 #include "encodable_value.h"
 #include "message_codec.h"
+#include "standard_codec_visitor.h"
 
 namespace flutter {
 
@@ -23,6 +26,22 @@ class StandardMessageCodec : public MessageCodec<EncodableValue> {
   StandardMessageCodec(StandardMessageCodec const&) = delete;
   StandardMessageCodec& operator=(StandardMessageCodec const&) = delete;
 
+  // Writes the binary encoding of |message| to |buffer|, replacing its
+  // contents. Reusing the same buffer for several messages avoids allocating
+  // a new one for each of them.
+  void EncodeMessageToBuffer(const EncodableValue& message,
+                             std::vector<uint8_t>* buffer) const;
+
+  // Decodes |binary_message|, reporting each of its values to |visitor|
+  // instead of building an EncodableValue. This avoids an allocation per
+  // value, and strings and typed lists are reported without being copied.
+  //
+  // Returns false if the message could not be decoded, in which case
+  // |visitor| may already have been given part of it.
+  bool VisitMessage(const uint8_t* binary_message,
+                    size_t message_size,
+                    StandardCodecVisitor* visitor) const;
+
  protected:
   // Instances should be obtained via GetInstance.
   StandardMessageCodec();
@@ -12,8 +12,10 @@
 #include "standard_codec_serializer.h"
 
 #include <assert.h>
+#include <algorithm>
 #include <cstring>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <string>
 #include <vector>
@@ -74,6 +76,10 @@ EncodedType EncodedTypeForValue(const EncodableValue& value) {
   return EncodedType::kNull;
 }
 
+// The largest list length that is reserved up front when decoding a list,
+// since the encoded length has not been validated at that point.
+constexpr size_t kMaxReservedListLength = 1024;
+
 }  // namespace
 
 StandardCodecSerializer::StandardCodecSerializer() = default;
@@ -110,9 +116,11 @@ EncodableValue StandardCodecSerializer::ReadValue(
     case EncodedType::kString: {
       size_t size = ReadSize(stream);
       std::string string_value;
-      string_value.resize(size);
-      stream->ReadBytes(reinterpret_cast<uint8_t*>(&string_value[0]), size);
-      return EncodableValue(string_value);
+      const uint8_t* bytes = stream->ReadView(size);
+      if (bytes) {
+        string_value.assign(reinterpret_cast<const char*>(bytes), size);
+      }
+      return EncodableValue(std::move(string_value));
     }
     case EncodedType::kUInt8List:
       return ReadVector<uint8_t>(stream);
@@ -125,21 +133,23 @@ EncodableValue StandardCodecSerializer::ReadValue(
     case EncodedType::kList: {
       size_t length = ReadSize(stream);
       EncodableList list_value;
-      list_value.reserve(length);
-      for (size_t i = 0; i < length; ++i) {
+      // Don't trust the length to be sane before the elements have been read.
+      list_value.reserve(std::min(length, kMaxReservedListLength));
+      for (size_t i = 0; i < length && !stream->HasError(); ++i) {
         list_value.push_back(ReadValue(stream));
       }
-      return EncodableValue(list_value);
+      return EncodableValue(std::move(list_value));
     }
     case EncodedType::kMap: {
       size_t length = ReadSize(stream);
       EncodableMap map_value;
-      for (size_t i = 0; i < length; ++i) {
+      for (size_t i = 0; i < length && !stream->HasError(); ++i) {
         EncodableValue key = ReadValue(stream);
         EncodableValue value = ReadValue(stream);
-        map_value.emplace(std::move(key), std::move(value));
+        map_value.emplace_hint(map_value.end(), std::move(key),
+                               std::move(value));
       }
-      return EncodableValue(map_value);
+      return EncodableValue(std::move(map_value));
     }
   }
   std::cerr << "Unknown type in StandardCodecSerializer::ReadValue: "
@@ -209,16 +219,144 @@ void StandardCodecSerializer::WriteValue(const EncodableValue& value,
   }
 }
 
+bool StandardCodecSerializer::VisitValue(ByteBufferStreamReader* stream,
+                                         StandardCodecVisitor* visitor) const {
+  EncodedType type = static_cast<EncodedType>(stream->ReadByte());
+  if (stream->HasError()) {
+    return false;
+  }
+  switch (type) {
+    case EncodedType::kNull:
+      visitor->OnNull();
+      return true;
+    case EncodedType::kTrue:
+      visitor->OnBool(true);
+      return true;
+    case EncodedType::kFalse:
+      visitor->OnBool(false);
+      return true;
+    case EncodedType::kInt32: {
+      int32_t int_value = 0;
+      stream->ReadBytes(reinterpret_cast<uint8_t*>(&int_value), 4);
+      if (stream->HasError()) {
+        return false;
+      }
+      visitor->OnInt(int_value);
+      return true;
+    }
+    case EncodedType::kInt64: {
+      int64_t long_value = 0;
+      stream->ReadBytes(reinterpret_cast<uint8_t*>(&long_value), 8);
+      if (stream->HasError()) {
+        return false;
+      }
+      visitor->OnLong(long_value);
+      return true;
+    }
+    case EncodedType::kFloat64: {
+      double double_value = 0;
+      stream->ReadAlignment(8);
+      stream->ReadBytes(reinterpret_cast<uint8_t*>(&double_value), 8);
+      if (stream->HasError()) {
+        return false;
+      }
+      visitor->OnDouble(double_value);
+      return true;
+    }
+    case EncodedType::kLargeInt:
+    case EncodedType::kString: {
+      size_t size = ReadSize(stream);
+      const uint8_t* bytes = stream->ReadView(size);
+      if (stream->HasError()) {
+        return false;
+      }
+      visitor->OnString(reinterpret_cast<const char*>(bytes), size);
+      return true;
+    }
+    case EncodedType::kUInt8List: {
+      const uint8_t* data = nullptr;
+      size_t count = 0;
+      std::vector<uint8_t> scratch;
+      if (!ReadVectorView(stream, &data, &count, &scratch)) {
+        return false;
+      }
+      visitor->OnByteList(data, count);
+      return true;
+    }
+    case EncodedType::kInt32List: {
+      const int32_t* data = nullptr;
+      size_t count = 0;
+      std::vector<int32_t> scratch;
+      if (!ReadVectorView(stream, &data, &count, &scratch)) {
+        return false;
+      }
+      visitor->OnIntList(data, count);
+      return true;
+    }
+    case EncodedType::kInt64List: {
+      const int64_t* data = nullptr;
+      size_t count = 0;
+      std::vector<int64_t> scratch;
+      if (!ReadVectorView(stream, &data, &count, &scratch)) {
+        return false;
+      }
+      visitor->OnLongList(data, count);
+      return true;
+    }
+    case EncodedType::kFloat64List: {
+      const double* data = nullptr;
+      size_t count = 0;
+      std::vector<double> scratch;
+      if (!ReadVectorView(stream, &data, &count, &scratch)) {
+        return false;
+      }
+      visitor->OnDoubleList(data, count);
+      return true;
+    }
+    case EncodedType::kList: {
+      size_t length = ReadSize(stream);
+      if (stream->HasError()) {
+        return false;
+      }
+      visitor->OnListStart(length);
+      for (size_t i = 0; i < length; ++i) {
+        if (!VisitValue(stream, visitor)) {
+          return false;
+        }
+      }
+      visitor->OnListEnd();
+      return true;
+    }
+    case EncodedType::kMap: {
+      size_t length = ReadSize(stream);
+      if (stream->HasError()) {
+        return false;
+      }
+      visitor->OnMapStart(length);
+      for (size_t i = 0; i < length; ++i) {
+        if (!VisitValue(stream, visitor) || !VisitValue(stream, visitor)) {
+          return false;
+        }
+      }
+      visitor->OnMapEnd();
+      return true;
+    }
+  }
+  std::cerr << "Unknown type in StandardCodecSerializer::VisitValue: "
+            << static_cast<int>(type) << std::endl;
+  return false;
+}
+
 size_t StandardCodecSerializer::ReadSize(ByteBufferStreamReader* stream) const {
   uint8_t byte = stream->ReadByte();
   if (byte < 254) {
     return byte;
   } else if (byte == 254) {
-    uint16_t value;
+    uint16_t value = 0;
     stream->ReadBytes(reinterpret_cast<uint8_t*>(&value), 2);
     return value;
   } else {
-    uint32_t value;
+    uint32_t value = 0;
     stream->ReadBytes(reinterpret_cast<uint8_t*>(&value), 4);
     return value;
   }
@@ -244,19 +382,55 @@ EncodableValue StandardCodecSerializer::ReadVector(
     ByteBufferStreamReader* stream) const {
   size_t count = ReadSize(stream);
   std::vector<T> vector;
-  vector.resize(count);
   uint8_t type_size = static_cast<uint8_t>(sizeof(T));
   if (type_size > 1) {
     stream->ReadAlignment(type_size);
   }
-  stream->ReadBytes(reinterpret_cast<uint8_t*>(vector.data()),
-                    count * type_size);
-  return EncodableValue(vector);
+  if (count > std::numeric_limits<size_t>::max() / type_size) {
+    std::cerr << "Invalid list length in StandardCodecSerializer::ReadVector"
+              << std::endl;
+    return EncodableValue(std::move(vector));
+  }
+  const uint8_t* bytes = stream->ReadView(count * type_size);
+  if (bytes && count > 0) {
+    vector.resize(count);
+    std::memcpy(vector.data(), bytes, count * type_size);
+  }
+  return EncodableValue(std::move(vector));
+}
+
+template <typename T>
+bool StandardCodecSerializer::ReadVectorView(ByteBufferStreamReader* stream,
+                                             const T** data,
+                                             size_t* count,
+                                             std::vector<T>* scratch) const {
+  *count = ReadSize(stream);
+  uint8_t type_size = static_cast<uint8_t>(sizeof(T));
+  if (type_size > 1) {
+    stream->ReadAlignment(type_size);
+  }
+  if (*count > std::numeric_limits<size_t>::max() / type_size) {
+    return false;
+  }
+  const uint8_t* bytes = stream->ReadView(*count * type_size);
+  if (stream->HasError()) {
+    return false;
+  }
+  // Elements are aligned relative to the start of the message, so they can
+  // only be used in place if the message itself is suitably aligned.
+  if (reinterpret_cast<uintptr_t>(bytes) % alignof(T) == 0) {
+    *data = reinterpret_cast<const T*>(bytes);
+    return true;
+  }
+  scratch->resize(*count);
+  std::memcpy(scratch->data(), bytes, *count * type_size);
+  *data = scratch->data();
+  return true;
 }
 
 template <typename T>
 void StandardCodecSerializer::WriteVector(
-    const std::vector<T> vector,
+    const std::vector<T>& vector,
     ByteBufferStreamWriter* stream) const {
   size_t count = vector.size();
   WriteSize(count, stream);
@@ -301,6 +475,23 @@ StandardMessageCodec::EncodeMessageInternal(
   return encoded;
 }
 
+void StandardMessageCodec::EncodeMessageToBuffer(
+    const EncodableValue& message,
+    std::vector<uint8_t>* buffer) const {
+  StandardCodecSerializer serializer;
+  buffer->clear();
+  ByteBufferStreamWriter stream(buffer);
+  serializer.WriteValue(message, &stream);
+}
+
+bool StandardMessageCodec::VisitMessage(const uint8_t* binary_message,
+                                        size_t message_size,
+                                        StandardCodecVisitor* visitor) const {
+  StandardCodecSerializer serializer;
+  ByteBufferStreamReader stream(binary_message, message_size);
+  return serializer.VisitValue(&stream, visitor);
+}
+
 // ===== standard_method_codec.h =====
 
 // static
@@ -0,0 +1,145 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/cpp/client_wrapper/include/flutter/standard_codec_visitor.h"
+#include "flutter/shell/platform/common/cpp/client_wrapper/include/flutter/standard_message_codec.h"
+
+namespace flutter {
+
+namespace {
+
+EncodableValue MakeMap(size_t count) {
+  EncodableMap map;
+  for (size_t i = 0; i < count; ++i) {
+    map[EncodableValue("key_" + std::to_string(i))] =
+        EncodableValue(static_cast<int32_t>(i));
+  }
+  return EncodableValue(std::move(map));
+}
+
+EncodableValue MakeString(size_t length) {
+  return EncodableValue(std::string(length, 'a'));
+}
+
+EncodableValue MakeDoubleList(size_t count) {
+  return EncodableValue(std::vector<double>(count, 1.5));
+}
+
+// Sums the numbers in a message so that visiting it can't be optimized away.
+class SummingVisitor : public StandardCodecVisitor {
+ public:
+  double sum = 0;
+
+  void OnInt(int32_t value) override { sum += value; }
+  void OnString(const char* data, size_t size) override { sum += size; }
+  void OnDoubleList(const double* data, size_t count) override {
+    for (size_t i = 0; i < count; ++i) {
+      sum += data[i];
+    }
+  }
+};
+
+void Encode(benchmark::State& state, EncodableValue (*make)(size_t)) {
+  const auto& codec = StandardMessageCodec::GetInstance();
+  const auto value = make(state.range(0));
+  while (state.KeepRunning()) {
+    auto encoded = codec.EncodeMessage(value);
+    benchmark::DoNotOptimize(encoded);
+  }
+}
+
+void EncodeToBuffer(benchmark::State& state, EncodableValue (*make)(size_t)) {
+  const auto& codec = StandardMessageCodec::GetInstance();
+  const auto value = make(state.range(0));
+  std::vector<uint8_t> buffer;
+  while (state.KeepRunning()) {
+    codec.EncodeMessageToBuffer(value, &buffer);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+}
+
+void Decode(benchmark::State& state, EncodableValue (*make)(size_t)) {
+  const auto& codec = StandardMessageCodec::GetInstance();
+  const auto encoded = codec.EncodeMessage(make(state.range(0)));
+  while (state.KeepRunning()) {
+    auto decoded = codec.DecodeMessage(*encoded);
+    benchmark::DoNotOptimize(decoded);
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+void Visit(benchmark::State& state, EncodableValue (*make)(size_t)) {
+  const auto& codec = StandardMessageCodec::GetInstance();
+  const auto encoded = codec.EncodeMessage(make(state.range(0)));
+  while (state.KeepRunning()) {
+    SummingVisitor visitor;
+    codec.VisitMessage(encoded->data(), encoded->size(), &visitor);
+    benchmark::DoNotOptimize(visitor.sum);
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+}  // namespace
+
+static void BM_StandardCodecEncodeMap(benchmark::State& state) {
+  Encode(state, MakeMap);
+}
+
+static void BM_StandardCodecEncodeMapToBuffer(benchmark::State& state) {
+  EncodeToBuffer(state, MakeMap);
+}
+
+static void BM_StandardCodecDecodeMap(benchmark::State& state) {
+  Decode(state, MakeMap);
+}
+
+static void BM_StandardCodecVisitMap(benchmark::State& state) {
+  Visit(state, MakeMap);
+}
+
+static void BM_StandardCodecEncodeString(benchmark::State& state) {
+  Encode(state, MakeString);
+}
+
+static void BM_StandardCodecDecodeString(benchmark::State& state) {
+  Decode(state, MakeString);
+}
+
+static void BM_StandardCodecVisitString(benchmark::State& state) {
+  Visit(state, MakeString);
+}
+
+static void BM_StandardCodecEncodeDoubleList(benchmark::State& state) {
+  Encode(state, MakeDoubleList);
+}
+
+static void BM_StandardCodecEncodeDoubleListToBuffer(benchmark::State& state) {
+  EncodeToBuffer(state, MakeDoubleList);
+}
+
+static void BM_StandardCodecDecodeDoubleList(benchmark::State& state) {
+  Decode(state, MakeDoubleList);
+}
+
+static void BM_StandardCodecVisitDoubleList(benchmark::State& state) {
+  Visit(state, MakeDoubleList);
+}
+
+BENCHMARK(BM_StandardCodecEncodeMap)->Range(8, 1 << 12);
+BENCHMARK(BM_StandardCodecEncodeMapToBuffer)->Range(8, 1 << 12);
+BENCHMARK(BM_StandardCodecDecodeMap)->Range(8, 1 << 12);
+BENCHMARK(BM_StandardCodecVisitMap)->Range(8, 1 << 12);
+BENCHMARK(BM_StandardCodecEncodeString)->Range(8, 1 << 16);
+BENCHMARK(BM_StandardCodecDecodeString)->Range(8, 1 << 16);
+BENCHMARK(BM_StandardCodecVisitString)->Range(8, 1 << 16);
+BENCHMARK(BM_StandardCodecEncodeDoubleList)->Range(8, 1 << 16);
+BENCHMARK(BM_StandardCodecEncodeDoubleListToBuffer)->Range(8, 1 << 16);
+BENCHMARK(BM_StandardCodecDecodeDoubleList)->Range(8, 1 << 16);
+BENCHMARK(BM_StandardCodecVisitDoubleList)->Range(8, 1 << 16);
+
+}  // namespace flutter
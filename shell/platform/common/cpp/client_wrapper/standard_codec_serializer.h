@@ -7,6 +7,7 @@
 
 #include "byte_stream_wrappers.h"
 #include "include/flutter/encodable_value.h"
+#include "include/flutter/standard_codec_visitor.h"
 
 namespace flutter {
 
@@ -28,6 +29,11 @@ class StandardCodecSerializer {
   void WriteValue(const EncodableValue& value,
                   ByteBufferStreamWriter* stream) const;
 
+  // Reports the next value from |stream| to |visitor|. Returns false if the
+  // stream does not contain a complete, valid value.
+  bool VisitValue(ByteBufferStreamReader* stream,
+                  StandardCodecVisitor* visitor) const;
+
  protected:
   // Reads the variable-length size from the current position in |stream|.
   size_t ReadSize(ByteBufferStreamReader* stream) const;
@@ -42,10 +48,21 @@ class StandardCodecSerializer {
   template <typename T>
   EncodableValue ReadVector(ByteBufferStreamReader* stream) const;
 
+  // Reads a fixed-type list whose values are of type T from the current
+  // position in |stream| without copying it, setting |data| to its first
+  // element and |count| to its length. If the elements are not suitably
+  // aligned in memory they are copied to |scratch| instead. Returns false if
+  // the stream does not contain the whole list.
+  template <typename T>
+  bool ReadVectorView(ByteBufferStreamReader* stream,
+                      const T** data,
+                      size_t* count,
+                      std::vector<T>* scratch) const;
+
   // Writes |vector| to |stream| as a fixed-type list. |T| must correspond to
   // one of the support list value types of EncodableValue.
   template <typename T>
-  void WriteVector(const std::vector<T> vector,
+  void WriteVector(const std::vector<T>& vector,
                    ByteBufferStreamWriter* stream) const;
 };
 
@@ -5,6 +5,7 @@
 #include "flutter/shell/platform/common/cpp/client_wrapper/include/flutter/standard_message_codec.h"
 
 #include <map>
+#include <string>
 #include <vector>
 
 #include "flutter/shell/platform/common/cpp/client_wrapper/testing/encodable_value_utils.h"
@@ -12,6 +13,42 @@
 
 namespace flutter {
 
+namespace {
+
+// Records the values reported while visiting a message as a string.
+class RecordingVisitor : public StandardCodecVisitor {
+ public:
+  std::string record;
+
+  void OnNull() override { record += "null "; }
+  void OnBool(bool value) override { record += value ? "true " : "false "; }
+  void OnInt(int32_t value) override {
+    record += "int:" + std::to_string(value) + " ";
+  }
+  void OnLong(int64_t value) override {
+    record += "long:" + std::to_string(value) + " ";
+  }
+  void OnDouble(double value) override {
+    record += "double:" + std::to_string(value) + " ";
+  }
+  void OnString(const char* data, size_t size) override {
+    record += "string:" + std::string(data, size) + " ";
+  }
+  void OnIntList(const int32_t* data, size_t count) override {
+    record += "ints:" + std::to_string(count) + " ";
+  }
+  void OnListStart(size_t count) override {
+    record += "[" + std::to_string(count) + " ";
+  }
+  void OnListEnd() override { record += "] "; }
+  void OnMapStart(size_t count) override {
+    record += "{" + std::to_string(count) + " ";
+  }
+  void OnMapEnd() override { record += "} "; }
+};
+
+}  // namespace
+
 // Validates round-trip encoding and decoding of |value|, and checks that the
 // encoded value matches |expected_encoding|.
 static void CheckEncodeDecode(const EncodableValue& value,
@@ -170,4 +207,71 @@ TEST(StandardMessageCodec, CanEncodeAndDecodeFloat64Array) {
   CheckEncodeDecode(value, bytes);
 }
 
+TEST(StandardMessageCodec, CanReuseEncodeBuffer) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  std::vector<uint8_t> buffer;
+  codec.EncodeMessageToBuffer(EncodableValue("hello"), &buffer);
+  EXPECT_EQ(buffer, *codec.EncodeMessage(EncodableValue("hello")));
+
+  codec.EncodeMessageToBuffer(EncodableValue(true), &buffer);
+  EXPECT_EQ(buffer, std::vector<uint8_t>{0x01});
+}
+
+TEST(StandardMessageCodec, CanVisitNestedValues) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  EncodableValue value(EncodableList{
+      EncodableValue(),
+      EncodableValue(false),
+      EncodableValue(int64_t{1} << 40),
+      EncodableValue(EncodableMap{
+          {EncodableValue("key"), EncodableValue(1.5)},
+      }),
+      EncodableValue(std::vector<int32_t>{1, 2, 3}),
+      EncodableValue(42),
+  });
+  auto encoded = codec.EncodeMessage(value);
+
+  RecordingVisitor visitor;
+  EXPECT_TRUE(codec.VisitMessage(encoded->data(), encoded->size(), &visitor));
+  EXPECT_EQ(visitor.record,
+            "[6 null false long:1099511627776 {1 string:key double:1.500000 "
+            "} ints:3 int:42 ] ");
+}
+
+TEST(StandardMessageCodec, VisitsTypedListsWithoutCopying) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  std::vector<double> values = {1.0, 2.0, 3.0};
+  auto encoded = codec.EncodeMessage(EncodableValue(values));
+
+  class DoubleListVisitor : public StandardCodecVisitor {
+   public:
+    const double* data = nullptr;
+    size_t count = 0;
+    void OnDoubleList(const double* list, size_t size) override {
+      data = list;
+      count = size;
+    }
+  } visitor;
+  EXPECT_TRUE(codec.VisitMessage(encoded->data(), encoded->size(), &visitor));
+  ASSERT_EQ(visitor.count, values.size());
+  // Vector storage is always suitably aligned for doubles, so the list is
+  // reported in place.
+  const uint8_t* list_bytes = reinterpret_cast<const uint8_t*>(visitor.data);
+  EXPECT_GE(list_bytes, encoded->data());
+  EXPECT_LT(list_bytes, encoded->data() + encoded->size());
+  EXPECT_TRUE(std::equal(values.begin(), values.end(), visitor.data));
+}
+
+TEST(StandardMessageCodec, VisitingTruncatedMessageFails) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(EncodableValue(EncodableList{
+      EncodableValue("hello"),
+      EncodableValue(std::vector<int64_t>{1, 2}),
+  }));
+  for (size_t size = 0; size < encoded->size(); ++size) {
+    RecordingVisitor visitor;
+    EXPECT_FALSE(codec.VisitMessage(encoded->data(), size, &visitor));
+  }
+}
+
 }  // namespace flutter
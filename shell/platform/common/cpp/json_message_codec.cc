@@ -8,11 +8,34 @@
 #include <string>
 
 #include "rapidjson/error/en.h"
-#include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 
 namespace flutter {
 
+namespace {
+
+// The initial capacity of a parse stack, which is rapidjson's default.
+constexpr size_t kStackCapacity = 1024;
+
+// A rapidjson output stream that appends to a byte vector, so that encoded
+// messages don't need to be copied out of an intermediate buffer.
+class ByteVectorOutputStream {
+ public:
+  typedef char Ch;
+
+  explicit ByteVectorOutputStream(std::vector<uint8_t>* bytes)
+      : bytes_(bytes) {}
+
+  void Put(Ch c) { bytes_->push_back(static_cast<uint8_t>(c)); }
+
+  void Flush() {}
+
+ private:
+  std::vector<uint8_t>* bytes_;
+};
+
+}  // namespace
+
 // static
 const JsonMessageCodec& JsonMessageCodec::GetInstance() {
   static JsonMessageCodec sInstance;
@@ -21,30 +44,64 @@ const JsonMessageCodec& JsonMessageCodec::GetInstance() {
 
 std::unique_ptr<std::vector<uint8_t>> JsonMessageCodec::EncodeMessageInternal(
     const rapidjson::Document& message) const {
-  // TODO: Look into alternate writers that would avoid the buffer copy.
-  rapidjson::StringBuffer buffer;
-  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  auto encoded = std::make_unique<std::vector<uint8_t>>();
+  ByteVectorOutputStream stream(encoded.get());
+  rapidjson::Writer<ByteVectorOutputStream> writer(stream);
   message.Accept(writer);
-  const char* buffer_start = buffer.GetString();
-  return std::make_unique<std::vector<uint8_t>>(
-      buffer_start, buffer_start + buffer.GetSize());
+  return encoded;
 }
 
 std::unique_ptr<rapidjson::Document> JsonMessageCodec::DecodeMessageInternal(
     const uint8_t* binary_message,
     const size_t message_size) const {
-  auto raw_message = reinterpret_cast<const char*>(binary_message);
   auto json_message = std::make_unique<rapidjson::Document>();
-  rapidjson::ParseResult result =
-      json_message->Parse(raw_message, message_size);
-  bool parsing_successful =
-      result == rapidjson::ParseErrorCode::kParseErrorNone;
-  if (!parsing_successful) {
-    std::cerr << "Unable to parse JSON message:" << std::endl
-              << rapidjson::GetParseError_En(result.Code()) << std::endl;
+  if (!DecodeMessageToDocument(binary_message, message_size,
+                               json_message.get())) {
     return nullptr;
   }
   return json_message;
 }
 
+bool JsonMessageCodec::DecodeMessageInSitu(
+    char* message,
+    rapidjson::Document* document) const {
+  return CheckParseResult(document->ParseInsitu(message));
+}
+
+// static
+bool JsonMessageCodec::CheckParseResult(rapidjson::ParseResult result) {
+  if (!result.IsError()) {
+    return true;
+  }
+  // Handlers stop parsing deliberately once they have what they need.
+  if (result.Code() != rapidjson::kParseErrorTermination) {
+    std::cerr << "Unable to parse JSON message:" << std::endl
+              << rapidjson::GetParseError_En(result.Code()) << std::endl;
+  }
+  return false;
+}
+
+PooledJsonDocument::PooledJsonDocument(size_t pool_size,
+                                       size_t stack_pool_size)
+    : pool_(pool_size),
+      stack_pool_(stack_pool_size),
+      allocator_(pool_.data(), pool_.size()),
+      stack_allocator_(stack_pool_.data(), stack_pool_.size()),
+      document_(&allocator_, kStackCapacity, &stack_allocator_) {}
+
+PooledJsonDocument::~PooledJsonDocument() = default;
+
+bool PooledJsonDocument::Decode(const uint8_t* binary_message,
+                                const size_t message_size) {
+  // Nothing may refer to the previous message's values once the allocator
+  // is cleared.
+  document_.SetNull();
+  allocator_.Clear();
+  // The parse stack is released after each message, so its pool only needs
+  // to be cleared before the next one.
+  stack_allocator_.Clear();
+  return JsonMessageCodec::GetInstance().DecodeMessageToDocument(
+      binary_message, message_size, &document_);
+}
+
 }  // namespace flutter
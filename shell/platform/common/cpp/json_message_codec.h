@@ -6,6 +6,10 @@
 #define FLUTTER_SHELL_PLATFORM_COMMON_CPP_JSON_MESSAGE_CODEC_H_
 
 #include <rapidjson/document.h>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/reader.h>
+
+#include <vector>
 
 #include "flutter/shell/platform/common/cpp/client_wrapper/include/flutter/message_codec.h"
 
@@ -24,6 +28,53 @@ class JsonMessageCodec : public MessageCodec<rapidjson::Document> {
   JsonMessageCodec(JsonMessageCodec const&) = delete;
   JsonMessageCodec& operator=(JsonMessageCodec const&) = delete;
 
+  // Parses |binary_message|, reporting each value to |handler| instead of
+  // building a document. |handler| must implement rapidjson's SAX handler
+  // concept, and can stop parsing early by returning false.
+  //
+  // Returns false if the message is not valid JSON or |handler| stopped
+  // parsing.
+  template <typename Handler>
+  bool ParseMessage(const uint8_t* binary_message,
+                    const size_t message_size,
+                    Handler* handler) const {
+    rapidjson::MemoryStream stream(
+        reinterpret_cast<const char*>(binary_message), message_size);
+    rapidjson::Reader reader;
+    return CheckParseResult(reader.Parse(stream, *handler));
+  }
+
+  // Parses the null-terminated |message| in place, reporting each value to
+  // |handler| as in ParseMessage. Strings are unescaped within |message| and
+  // passed to |handler| without being copied, so |message| is modified.
+  template <typename Handler>
+  bool ParseMessageInSitu(char* message, Handler* handler) const {
+    rapidjson::InsituStringStream stream(message);
+    rapidjson::Reader reader;
+    return CheckParseResult(
+        reader.Parse<rapidjson::kParseInsituFlag>(stream, *handler));
+  }
+
+  // Decodes the null-terminated |message| in place into |document|, which
+  // then refers to the strings within |message| instead of copying them.
+  // |message| is modified, and must outlive |document|.
+  //
+  // Returns false if the message is not valid JSON.
+  bool DecodeMessageInSitu(char* message, rapidjson::Document* document) const;
+
+  // Decodes |binary_message| into |document|, replacing its contents. Values
+  // are allocated with |document|'s allocator, and the parse stack with its
+  // stack allocator; see PooledJsonDocument.
+  //
+  // Returns false if the message is not valid JSON.
+  template <typename Document>
+  bool DecodeMessageToDocument(const uint8_t* binary_message,
+                               const size_t message_size,
+                               Document* document) const {
+    auto raw_message = reinterpret_cast<const char*>(binary_message);
+    return CheckParseResult(document->Parse(raw_message, message_size));
+  }
+
  protected:
   // Instances should be obtained via GetInstance.
   JsonMessageCodec() = default;
@@ -36,6 +87,58 @@ class JsonMessageCodec : public MessageCodec<rapidjson::Document> {
   // |flutter::MessageCodec|
   std::unique_ptr<std::vector<uint8_t>> EncodeMessageInternal(
       const rapidjson::Document& message) const override;
+
+ private:
+  // Logs the error in |result|, if any, and returns whether parsing
+  // succeeded.
+  static bool CheckParseResult(rapidjson::ParseResult result);
+};
+
+// A document whose memory is reused each time a message is decoded into it.
+// Messages whose values and parse stack fit in the pools are decoded without
+// allocating.
+class PooledJsonDocument {
+ public:
+  // The size of the pool for values, which covers typical platform channel
+  // messages.
+  static constexpr size_t kDefaultPoolSize = 16 * 1024;
+
+  // The size of the pool for the parse stack, which holds the values of the
+  // objects and arrays being parsed until they are complete.
+  static constexpr size_t kDefaultStackPoolSize = 4 * 1024;
+
+  // Each pool must be large enough for the allocator's bookkeeping, which is
+  // a few dozen bytes.
+  explicit PooledJsonDocument(size_t pool_size = kDefaultPoolSize,
+                              size_t stack_pool_size = kDefaultStackPoolSize);
+
+  ~PooledJsonDocument();
+
+  // Prevent copying.
+  PooledJsonDocument(PooledJsonDocument const&) = delete;
+  PooledJsonDocument& operator=(PooledJsonDocument const&) = delete;
+
+  // Decodes |binary_message| into the document, invalidating any values
+  // obtained from the previous message. Returns false if the message is not
+  // valid JSON.
+  bool Decode(const uint8_t* binary_message, const size_t message_size);
+
+  const rapidjson::Value& document() const { return document_; }
+
+ private:
+  // rapidjson::Document allocates its parse stack with malloc, so the stack
+  // gets a pool of its own.
+  using Document = rapidjson::GenericDocument<rapidjson::UTF8<>,
+                                              rapidjson::MemoryPoolAllocator<>,
+                                              rapidjson::MemoryPoolAllocator<>>;
+
+  // The memory that each allocator hands out first. It is kept across
+  // messages, while any memory an allocator needs beyond it is released.
+  std::vector<char> pool_;
+  std::vector<char> stack_pool_;
+  rapidjson::MemoryPoolAllocator<> allocator_;
+  rapidjson::MemoryPoolAllocator<> stack_allocator_;
+  Document document_;
 };
 
 }  // namespace flutter
@@ -0,0 +1,148 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/cpp/json_message_codec.h"
+#include "flutter/shell/platform/common/cpp/json_method_codec.h"
+
+namespace flutter {
+
+namespace {
+
+// Returns a message containing |count| copies of the document used by the
+// codec unittests, each tagged with a method name.
+std::vector<uint8_t> MakeMessage(size_t count) {
+  rapidjson::Document array(rapidjson::kArrayType);
+  auto& allocator = array.GetAllocator();
+  for (size_t i = 0; i < count; ++i) {
+    rapidjson::Value map(rapidjson::kObjectType);
+    map.AddMember("method", "TextInput.setEditingState", allocator);
+    map.AddMember("a", -7, allocator);
+    map.AddMember("b", std::numeric_limits<int>::max(), allocator);
+    map.AddMember("c", 3.14159, allocator);
+    map.AddMember("d", true, allocator);
+    map.AddMember("e", rapidjson::Value(), allocator);
+    array.PushBack(map, allocator);
+  }
+  return *JsonMessageCodec::GetInstance().EncodeMessage(array);
+}
+
+// Returns a method call whose arguments are a message from MakeMessage.
+std::vector<uint8_t> MakeMethodCall(size_t count) {
+  const auto arguments = MakeMessage(count);
+  MethodCall<rapidjson::Document> call(
+      "TextInput.setEditingState",
+      JsonMessageCodec::GetInstance().DecodeMessage(arguments));
+  return *JsonMethodCodec::GetInstance().EncodeMethodCall(call);
+}
+
+// Counts the method names in a message.
+struct MethodCountHandler
+    : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>,
+                                          MethodCountHandler> {
+  size_t count = 0;
+
+  bool Key(const char* str, rapidjson::SizeType length, bool copy) {
+    if (length == 6 && std::memcmp(str, "method", 6) == 0) {
+      count++;
+    }
+    return true;
+  }
+};
+
+}  // namespace
+
+static void BM_JsonMessageCodecDecode(benchmark::State& state) {
+  const auto& codec = JsonMessageCodec::GetInstance();
+  const auto message = MakeMessage(state.range(0));
+  while (state.KeepRunning()) {
+    auto document = codec.DecodeMessage(message);
+    benchmark::DoNotOptimize(document);
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+}
+
+static void BM_JsonMessageCodecDecodePooled(benchmark::State& state) {
+  const auto message = MakeMessage(state.range(0));
+  PooledJsonDocument pooled;
+  while (state.KeepRunning()) {
+    pooled.Decode(message.data(), message.size());
+    benchmark::DoNotOptimize(pooled.document());
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+}
+
+static void BM_JsonMessageCodecDecodeInSitu(benchmark::State& state) {
+  const auto& codec = JsonMessageCodec::GetInstance();
+  const auto message = MakeMessage(state.range(0));
+  std::vector<char> buffer;
+  while (state.KeepRunning()) {
+    // Messages from the engine are immutable, so in-situ parsing includes
+    // the cost of copying the message.
+    buffer.assign(message.begin(), message.end());
+    buffer.push_back('\0');
+    rapidjson::Document document;
+    codec.DecodeMessageInSitu(buffer.data(), &document);
+    benchmark::DoNotOptimize(document);
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+}
+
+static void BM_JsonMessageCodecParse(benchmark::State& state) {
+  const auto& codec = JsonMessageCodec::GetInstance();
+  const auto message = MakeMessage(state.range(0));
+  while (state.KeepRunning()) {
+    MethodCountHandler handler;
+    codec.ParseMessage(message.data(), message.size(), &handler);
+    benchmark::DoNotOptimize(handler.count);
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+}
+
+static void BM_JsonMessageCodecEncode(benchmark::State& state) {
+  const auto& codec = JsonMessageCodec::GetInstance();
+  const auto message = MakeMessage(state.range(0));
+  const auto document = codec.DecodeMessage(message);
+  while (state.KeepRunning()) {
+    auto encoded = codec.EncodeMessage(*document);
+    benchmark::DoNotOptimize(encoded);
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+}
+
+static void BM_JsonMethodCodecDecodeMethodCall(benchmark::State& state) {
+  const auto& codec = JsonMethodCodec::GetInstance();
+  const auto message = MakeMethodCall(state.range(0));
+  while (state.KeepRunning()) {
+    auto call = codec.DecodeMethodCall(message);
+    benchmark::DoNotOptimize(call);
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+}
+
+static void BM_JsonMethodCodecDecodeMethodName(benchmark::State& state) {
+  const auto& codec = JsonMethodCodec::GetInstance();
+  const auto message = MakeMethodCall(state.range(0));
+  std::string method_name;
+  while (state.KeepRunning()) {
+    codec.DecodeMethodName(message.data(), message.size(), &method_name);
+    benchmark::DoNotOptimize(method_name);
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+}
+
+BENCHMARK(BM_JsonMessageCodecDecode)->Range(1, 1 << 10);
+BENCHMARK(BM_JsonMessageCodecDecodePooled)->Range(1, 1 << 10);
+BENCHMARK(BM_JsonMessageCodecDecodeInSitu)->Range(1, 1 << 10);
+BENCHMARK(BM_JsonMessageCodecParse)->Range(1, 1 << 10);
+BENCHMARK(BM_JsonMessageCodecEncode)->Range(1, 1 << 10);
+BENCHMARK(BM_JsonMethodCodecDecodeMethodCall)->Range(1, 1 << 10);
+BENCHMARK(BM_JsonMethodCodecDecodeMethodName)->Range(1, 1 << 10);
+
+}  // namespace flutter
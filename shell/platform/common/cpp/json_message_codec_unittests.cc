@@ -4,8 +4,10 @@
 
 #include "flutter/shell/platform/common/cpp/json_message_codec.h"
 
+#include <cstring>
 #include <limits>
 #include <map>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -23,6 +25,40 @@ static void CheckEncodeDecode(const rapidjson::Document& value) {
   EXPECT_EQ(value, *decoded);
 }
 
+// Returns |json| as a message.
+std::vector<uint8_t> ToMessage(const std::string& json) {
+  return std::vector<uint8_t>(json.begin(), json.end());
+}
+
+// Records the value of the "method" key of an object, and stops parsing once
+// it has been found.
+struct MethodNameHandler
+    : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>,
+                                          MethodNameHandler> {
+  bool in_method = false;
+  std::string method;
+  size_t value_count = 0;
+
+  bool Default() {
+    value_count++;
+    return true;
+  }
+
+  bool Key(const char* str, rapidjson::SizeType length, bool copy) {
+    in_method = std::string(str, length) == "method";
+    return true;
+  }
+
+  bool String(const char* str, rapidjson::SizeType length, bool copy) {
+    value_count++;
+    if (in_method) {
+      method.assign(str, length);
+      return false;
+    }
+    return true;
+  }
+};
+
 }  // namespace
 
 // Tests that a JSON document with various data types round-trips correctly.
@@ -43,4 +79,67 @@ TEST(JsonMessageCodec, EncodeDecode) {
   CheckEncodeDecode(array);
 }
 
+// Tests that messages can be parsed without building a document, and that
+// handlers can stop parsing early.
+TEST(JsonMessageCodec, ParseMessageStopsWhenHandlerIsDone) {
+  const JsonMessageCodec& codec = JsonMessageCodec::GetInstance();
+  auto message = ToMessage(R"({"id": 3, "method": "run", "args": [1, 2]})");
+
+  MethodNameHandler handler;
+  EXPECT_FALSE(codec.ParseMessage(message.data(), message.size(), &handler));
+  EXPECT_EQ(handler.method, "run");
+  // Only the object, "id" and "method" are reached.
+  EXPECT_EQ(handler.value_count, 3u);
+
+  MethodNameHandler invalid_handler;
+  auto invalid = ToMessage(R"({"id": )");
+  EXPECT_FALSE(
+      codec.ParseMessage(invalid.data(), invalid.size(), &invalid_handler));
+}
+
+// Tests that in-situ decoding refers to strings within the message.
+TEST(JsonMessageCodec, DecodeMessageInSituDoesNotCopyStrings) {
+  const JsonMessageCodec& codec = JsonMessageCodec::GetInstance();
+  std::string json = R"({"method": "run\tfast"})";
+  std::vector<char> message(json.begin(), json.end());
+  message.push_back('\0');
+
+  rapidjson::Document document;
+  ASSERT_TRUE(codec.DecodeMessageInSitu(message.data(), &document));
+  const char* method = document["method"].GetString();
+  EXPECT_STREQ(method, "run\tfast");
+  EXPECT_GE(method, message.data());
+  EXPECT_LT(method, message.data() + message.size());
+
+  std::vector<char> invalid = {'{', '\0'};
+  EXPECT_FALSE(codec.DecodeMessageInSitu(invalid.data(), &document));
+}
+
+// Tests that a pooled document can decode messages both smaller and larger
+// than its pools.
+TEST(JsonMessageCodec, PooledDocumentDecodesSuccessiveMessages) {
+  PooledJsonDocument pooled(1024, 256);
+
+  auto first = ToMessage(R"({"a": [1, 2, 3]})");
+  ASSERT_TRUE(pooled.Decode(first.data(), first.size()));
+  EXPECT_EQ(pooled.document()["a"].Size(), 3u);
+
+  std::string large = "[";
+  for (int i = 0; i < 1000; ++i) {
+    large += "\"element_" + std::to_string(i) + "\",";
+  }
+  large += "null]";
+  auto second = ToMessage(large);
+  ASSERT_TRUE(pooled.Decode(second.data(), second.size()));
+  ASSERT_EQ(pooled.document().Size(), 1001u);
+  EXPECT_STREQ(pooled.document()[999].GetString(), "element_999");
+
+  auto third = ToMessage("true");
+  ASSERT_TRUE(pooled.Decode(third.data(), third.size()));
+  EXPECT_TRUE(pooled.document().GetBool());
+
+  auto invalid = ToMessage("[");
+  EXPECT_FALSE(pooled.Decode(invalid.data(), invalid.size()));
+}
+
 }  // namespace flutter
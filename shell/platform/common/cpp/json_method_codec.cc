@@ -4,6 +4,8 @@
 
 #include "flutter/shell/platform/common/cpp/json_method_codec.h"
 
+#include <cstring>
+
 #include "flutter/shell/platform/common/cpp/json_message_codec.h"
 
 namespace flutter {
@@ -30,6 +32,67 @@ std::unique_ptr<rapidjson::Document> ExtractElement(
   return extracted;
 }
 
+// Finds the method name of an encoded method call, and stops parsing once it
+// is found.
+class MethodNameHandler
+    : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>,
+                                          MethodNameHandler> {
+ public:
+  explicit MethodNameHandler(std::string* method_name)
+      : method_name_(method_name) {}
+
+  bool found() const { return found_; }
+
+  // Called for every scalar value that is not a string.
+  bool Default() {
+    is_method_name_next_ = false;
+    return true;
+  }
+
+  bool String(const char* str, rapidjson::SizeType length, bool copy) {
+    if (is_method_name_next_) {
+      method_name_->assign(str, length);
+      found_ = true;
+      return false;
+    }
+    return true;
+  }
+
+  bool Key(const char* str, rapidjson::SizeType length, bool copy) {
+    is_method_name_next_ =
+        depth_ == 1 && length == sizeof(kMessageMethodKey) - 1 &&
+        std::memcmp(str, kMessageMethodKey, length) == 0;
+    return true;
+  }
+
+  bool StartObject() { return Start(); }
+
+  bool EndObject(rapidjson::SizeType member_count) { return End(); }
+
+  bool StartArray() { return Start(); }
+
+  bool EndArray(rapidjson::SizeType element_count) { return End(); }
+
+ private:
+  bool Start() {
+    depth_++;
+    is_method_name_next_ = false;
+    return true;
+  }
+
+  bool End() {
+    depth_--;
+    return true;
+  }
+
+  std::string* method_name_;
+  // The nesting level of the value being parsed. The members of the method
+  // call are at level 1.
+  int depth_ = 0;
+  bool is_method_name_next_ = false;
+  bool found_ = false;
+};
+
 }  // namespace
 
 // static
@@ -38,6 +101,15 @@ const JsonMethodCodec& JsonMethodCodec::GetInstance() {
   return sInstance;
 }
 
+bool JsonMethodCodec::DecodeMethodName(const uint8_t* message,
+                                       const size_t message_size,
+                                       std::string* method_name) const {
+  MethodNameHandler handler(method_name);
+  JsonMessageCodec::GetInstance().ParseMessage(message, message_size,
+                                               &handler);
+  return handler.found();
+}
+
 std::unique_ptr<MethodCall<rapidjson::Document>>
 JsonMethodCodec::DecodeMethodCallInternal(const uint8_t* message,
                                           size_t message_size) const {
@@ -7,6 +7,8 @@
 
 #include <rapidjson/document.h>
 
+#include <string>
+
 #include "flutter/shell/platform/common/cpp/client_wrapper/include/flutter/method_call.h"
 #include "flutter/shell/platform/common/cpp/client_wrapper/include/flutter/method_codec.h"
 
@@ -24,6 +26,15 @@ class JsonMethodCodec : public MethodCodec<rapidjson::Document> {
   JsonMethodCodec(JsonMethodCodec const&) = delete;
   JsonMethodCodec& operator=(JsonMethodCodec const&) = delete;
 
+  // Reads only the method name of the method call encoded in |message|, for
+  // example to route the call before its arguments are decoded. Parsing stops
+  // at the method name, so the rest of |message| is not validated.
+  //
+  // Returns false if |message| has no method name.
+  bool DecodeMethodName(const uint8_t* message,
+                        const size_t message_size,
+                        std::string* method_name) const;
+
  protected:
   // Instances should be obtained via GetInstance.
   JsonMethodCodec() = default;
@@ -55,6 +55,28 @@ TEST(JsonMethodCodec, HandlesMethodCallsWithArgument) {
   EXPECT_TRUE(MethodCallsAreEqual(call, *decoded));
 }
 
+TEST(JsonMethodCodec, DecodesOnlyMethodNames) {
+  const JsonMethodCodec& codec = JsonMethodCodec::GetInstance();
+  auto decode = [&codec](const std::string& json, std::string* name) {
+    return codec.DecodeMethodName(
+        reinterpret_cast<const uint8_t*>(json.data()), json.size(), name);
+  };
+
+  std::string name;
+  // Keys named "method" in the arguments are skipped, and parsing stops
+  // before the invalid remainder of the message.
+  EXPECT_TRUE(decode(
+      R"({"args": {"method": "inner", "list": [{"method": 1}]},)"
+      R"( "method": "hello", "invalid)",
+      &name));
+  EXPECT_EQ(name, "hello");
+
+  EXPECT_FALSE(decode(R"({"method": 42, "args": "hello"})", &name));
+  EXPECT_FALSE(decode(R"({"args": "hello"})", &name));
+  EXPECT_FALSE(decode(R"(["method", "hello"])", &name));
+  EXPECT_FALSE(decode(R"({"method": )", &name));
+}
+
 TEST(JsonMethodCodec, HandlesSuccessEnvelopesWithNullResult) {
   const JsonMethodCodec& codec = JsonMethodCodec::GetInstance();
   auto encoded = codec.EncodeSuccessEnvelope();
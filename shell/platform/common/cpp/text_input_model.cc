@@ -18,6 +18,10 @@ namespace flutter {
 
 namespace {
 
+// The number of pieces above which the text is compacted into a single
+// piece, which bounds the cost of finding a position.
+constexpr size_t kMaxPieceCount = 1024;
+
 // Returns true if |code_point| is a leading surrogate of a surrogate pair.
 bool IsLeadingSurrogate(char32_t code_point) {
   return (code_point & 0xFFFFFC00) == 0xD800;
@@ -27,14 +31,72 @@ bool IsTrailingSurrogate(char32_t code_point) {
   return (code_point & 0xFFFFFC00) == 0xDC00;
 }
 
+// Appends the UTF-8 encoding of |code_point| to |output|.
+void AppendUtf8(char32_t code_point, std::string* output) {
+  if (code_point < 0x80) {
+    output->push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    output->push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    output->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    output->push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    output->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    output->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    output->push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    output->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    output->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    output->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+// Converts UTF-16 code units to UTF-8 across calls, so that surrogate pairs
+// may be split between calls. Unpaired surrogates are replaced with U+FFFD.
+class Utf8Converter {
+ public:
+  explicit Utf8Converter(std::string* output) : output_(output) {}
+
+  void Append(const char16_t* text, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+      char16_t c = text[i];
+      if (leading_surrogate_ != 0) {
+        char16_t leading = leading_surrogate_;
+        leading_surrogate_ = 0;
+        if (IsTrailingSurrogate(c)) {
+          AppendUtf8(0x10000 + ((leading - 0xD800) << 10) + (c - 0xDC00),
+                     output_);
+          continue;
+        }
+        AppendUtf8(0xFFFD, output_);
+      }
+      if (IsLeadingSurrogate(c)) {
+        leading_surrogate_ = c;
+      } else if (IsTrailingSurrogate(c)) {
+        AppendUtf8(0xFFFD, output_);
+      } else {
+        AppendUtf8(c, output_);
+      }
+    }
+  }
+
+  // Called after the last code unit.
+  void Finish() {
+    if (leading_surrogate_ != 0) {
+      AppendUtf8(0xFFFD, output_);
+      leading_surrogate_ = 0;
+    }
+  }
+
+ private:
+  std::string* output_;
+  char16_t leading_surrogate_ = 0;
+};
+
 }  // namespace
 
 TextInputModel::TextInputModel(const std::string& input_type,
                                const std::string& input_action)
-    : input_type_(input_type),
-      input_action_(input_action),
-      selection_base_(text_.begin()),
-      selection_extent_(text_.begin()) {}
+    : input_type_(input_type), input_action_(input_action) {}
 
 TextInputModel::~TextInputModel() = default;
 
@@ -44,20 +106,125 @@ bool TextInputModel::SetEditingState(size_t selection_base,
   if (selection_base > selection_extent) {
     return false;
   }
+  std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>
+      utf16_converter;
+  std::u16string utf16_text = utf16_converter.from_bytes(text);
   // Only checks extent since it is implicitly greater-than-or-equal-to base.
-  if (selection_extent > text.size()) {
+  if (selection_extent > utf16_text.size()) {
     return false;
   }
-  std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>
-      utf16_converter;
-  text_ = utf16_converter.from_bytes(text);
-  selection_base_ = text_.begin() + selection_base;
-  selection_extent_ = text_.begin() + selection_extent;
+  original_ = std::move(utf16_text);
+  added_.clear();
+  pieces_.clear();
+  length_ = original_.size();
+  if (length_ > 0) {
+    pieces_.push_back({false, 0, length_});
+  }
+  selection_base_ = selection_base;
+  selection_extent_ = selection_extent;
+  ClearTextChange();
   return true;
 }
 
+void TextInputModel::ClearTextChange() {
+  has_text_change_ = false;
+  text_change_ = TextChange();
+}
+
+size_t TextInputModel::SplitAt(size_t position) {
+  size_t piece_start = 0;
+  for (size_t i = 0; i < pieces_.size(); i++) {
+    if (piece_start == position) {
+      return i;
+    }
+    Piece& piece = pieces_[i];
+    if (position < piece_start + piece.length) {
+      size_t offset = position - piece_start;
+      Piece tail = {piece.added, piece.start + offset, piece.length - offset};
+      piece.length = offset;
+      pieces_.insert(pieces_.begin() + i + 1, tail);
+      return i + 1;
+    }
+    piece_start += piece.length;
+  }
+  return pieces_.size();
+}
+
+char16_t TextInputModel::CharAt(size_t position) const {
+  for (const Piece& piece : pieces_) {
+    if (position < piece.length) {
+      const auto& buffer = piece.added ? added_ : original_;
+      return buffer[piece.start + position];
+    }
+    position -= piece.length;
+  }
+  return 0;
+}
+
+void TextInputModel::Replace(size_t start,
+                             size_t end,
+                             const char16_t* text,
+                             size_t length) {
+  size_t first = SplitAt(start);
+  size_t last = SplitAt(end);
+
+  // Added text is only ever referenced by one piece, so text removed from
+  // the end of the added buffer can be reused.
+  for (size_t i = last; i > first; i--) {
+    const Piece& piece = pieces_[i - 1];
+    if (piece.added && piece.start + piece.length == added_.size()) {
+      added_.resize(piece.start);
+    }
+  }
+  pieces_.erase(pieces_.begin() + first, pieces_.begin() + last);
+
+  if (length > 0) {
+    // Typing extends the piece before the cursor rather than adding one.
+    Piece* previous = first > 0 ? &pieces_[first - 1] : nullptr;
+    if (previous && previous->added &&
+        previous->start + previous->length == added_.size()) {
+      previous->length += length;
+    } else {
+      pieces_.insert(pieces_.begin() + first, {true, added_.size(), length});
+    }
+    added_.append(text, length);
+  }
+  length_ = length_ - (end - start) + length;
+
+  // Merge with the change that hasn't been sent yet.
+  size_t new_end = start + length;
+  if (has_text_change_) {
+    const TextChange& change = text_change_;
+    size_t changed_end = std::max(change.new_end, end);
+    new_end = changed_end - (end - start) + length;
+    end = changed_end - (change.new_end - change.old_end);
+    start = std::min(change.start, start);
+  }
+  text_change_ = {start, end, new_end};
+  has_text_change_ = true;
+
+  if (pieces_.size() > kMaxPieceCount) {
+    Compact();
+  }
+}
+
+void TextInputModel::Compact() {
+  std::u16string text;
+  text.reserve(length_);
+  for (const Piece& piece : pieces_) {
+    const auto& buffer = piece.added ? added_ : original_;
+    text.append(buffer, piece.start, piece.length);
+  }
+  original_ = std::move(text);
+  added_.clear();
+  pieces_.clear();
+  if (length_ > 0) {
+    pieces_.push_back({false, 0, length_});
+  }
+}
+
 void TextInputModel::DeleteSelected() {
-  selection_base_ = text_.erase(selection_base_, selection_extent_);
+  Replace(selection_base_, selection_extent_, nullptr, 0);
   // Moves extent back to base, so that it is a single cursor placement again.
   selection_extent_ = selection_base_;
 }
@@ -77,11 +244,8 @@ void TextInputModel::AddCodePoint(char32_t c) {
 }
 
 void TextInputModel::AddText(const std::u16string& text) {
-  if (selection_base_ != selection_extent_) {
-    DeleteSelected();
-  }
-  selection_extent_ = text_.insert(selection_extent_, text.begin(), text.end());
-  selection_extent_ += text.length();
+  Replace(selection_base_, selection_extent_, text.data(), text.length());
+  selection_extent_ = selection_base_ + text.length();
   selection_base_ = selection_extent_;
 }
 
@@ -90,9 +254,11 @@ bool TextInputModel::Backspace() {
     DeleteSelected();
     return true;
   }
-  if (selection_base_ != text_.begin()) {
-    int count = IsTrailingSurrogate(*(selection_base_ - 1)) ? 2 : 1;
-    selection_base_ = text_.erase(selection_base_ - count, selection_base_);
+  if (selection_base_ != 0) {
+    int count = IsTrailingSurrogate(CharAt(selection_base_ - 1)) ? 2 : 1;
+    count = std::min<size_t>(count, selection_base_);
+    Replace(selection_base_ - count, selection_base_, nullptr, 0);
+    selection_base_ -= count;
     selection_extent_ = selection_base_;
     return true;
   }
@@ -104,9 +270,10 @@ bool TextInputModel::Delete() {
     DeleteSelected();
     return true;
   }
-  if (selection_base_ != text_.end()) {
-    int count = IsLeadingSurrogate(*selection_base_) ? 2 : 1;
-    selection_base_ = text_.erase(selection_base_, selection_base_ + count);
+  if (selection_base_ != length_) {
+    int count = IsLeadingSurrogate(CharAt(selection_base_)) ? 2 : 1;
+    count = std::min<size_t>(count, length_ - selection_base_);
+    Replace(selection_base_, selection_base_ + count, nullptr, 0);
     selection_extent_ = selection_base_;
     return true;
   }
@@ -114,21 +281,21 @@ bool TextInputModel::Delete() {
 }
 
 bool TextInputModel::MoveCursorToBeginning() {
-  if (selection_base_ == text_.begin() && selection_extent_ == text_.begin())
+  if (selection_base_ == 0 && selection_extent_ == 0)
     return false;
 
-  selection_base_ = text_.begin();
-  selection_extent_ = text_.begin();
+  selection_base_ = 0;
+  selection_extent_ = 0;
 
   return true;
 }
 
 bool TextInputModel::MoveCursorToEnd() {
-  if (selection_base_ == text_.end() && selection_extent_ == text_.end())
+  if (selection_base_ == length_ && selection_extent_ == length_)
     return false;
 
-  selection_base_ = text_.end();
-  selection_extent_ = text_.end();
+  selection_base_ = length_;
+  selection_extent_ = length_;
 
   return true;
 }
@@ -140,9 +307,9 @@ bool TextInputModel::MoveCursorForward() {
     return true;
   }
   // If not at the end, move the extent forward.
-  if (selection_extent_ != text_.end()) {
-    int count = IsLeadingSurrogate(*selection_base_) ? 2 : 1;
-    selection_base_ += count;
+  if (selection_extent_ != length_) {
+    int count = IsLeadingSurrogate(CharAt(selection_base_)) ? 2 : 1;
+    selection_base_ = std::min(selection_base_ + count, length_);
     selection_extent_ = selection_base_;
     return true;
   }
@@ -157,9 +324,9 @@ bool TextInputModel::MoveCursorBack() {
     return true;
   }
   // If not at the start, move the beginning backward.
-  if (selection_base_ != text_.begin()) {
-    int count = IsTrailingSurrogate(*(selection_base_ - 1)) ? 2 : 1;
-    selection_base_ -= count;
+  if (selection_base_ != 0) {
+    int count = IsTrailingSurrogate(CharAt(selection_base_ - 1)) ? 2 : 1;
+    selection_base_ -= std::min<size_t>(count, selection_base_);
     selection_extent_ = selection_base_;
     return true;
   }
@@ -167,9 +334,32 @@ bool TextInputModel::MoveCursorBack() {
 }
 
 std::string TextInputModel::GetText() const {
-  std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>
-      utf8_converter;
-  return utf8_converter.to_bytes(text_);
+  return GetTextRange(0, length_);
+}
+
+std::string TextInputModel::GetTextRange(size_t start, size_t end) const {
+  std::string text;
+  if (start > end || end > length_) {
+    return text;
+  }
+  text.reserve(end - start);
+  Utf8Converter converter(&text);
+  size_t piece_start = 0;
+  for (const Piece& piece : pieces_) {
+    size_t piece_end = piece_start + piece.length;
+    if (piece_end > start && piece_start < end) {
+      size_t from = std::max(start, piece_start) - piece_start;
+      size_t to = std::min(end, piece_end) - piece_start;
+      const auto& buffer = piece.added ? added_ : original_;
+      converter.Append(buffer.data() + piece.start + from, to - from);
+    }
+    if (piece_end >= end) {
+      break;
+    }
+    piece_start = piece_end;
+  }
+  converter.Finish();
+  return text;
 }
 
 }  // namespace flutter
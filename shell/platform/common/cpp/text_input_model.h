@@ -7,13 +7,27 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace flutter {
 // Handles underlying text input state, using a simple ASCII model.
 //
+// The text is stored in a piece table, so edits cost time proportional to
+// the number of pieces rather than to the length of the text. Positions are
+// in UTF-16 code units.
+//
 // Ignores special states like "insert mode" for now.
 class TextInputModel {
  public:
+  // A change to the text since the last call to ClearTextChange(): the range
+  // [start, old_end) of the previous text was replaced with the range
+  // [start, new_end) of the current text.
+  struct TextChange {
+    size_t start = 0;
+    size_t old_end = 0;
+    size_t new_end = 0;
+  };
+
   TextInputModel(const std::string& input_type,
                  const std::string& input_action);
   virtual ~TextInputModel();
@@ -21,7 +35,8 @@ class TextInputModel {
   // Attempts to set the text state.
   //
   // Returns false if the state is not valid (base or extent are out of
-  // bounds, or base is less than extent).
+  // bounds, or base is less than extent). Clears the text change, since the
+  // state is set by the framework.
   bool SetEditingState(size_t selection_base,
                        size_t selection_extent,
                        const std::string& text);
@@ -80,15 +95,30 @@ class TextInputModel {
   // Get the current text
   std::string GetText() const;
 
+  // Gets the range [start, end) of the current text.
+  //
+  // Returns an empty string if the range is out of bounds.
+  std::string GetTextRange(size_t start, size_t end) const;
+
+  // The length of the current text in UTF-16 code units.
+  size_t text_length() const { return length_; }
+
+  // Returns true if the text changed since the last call to
+  // ClearTextChange().
+  bool has_text_change() const { return has_text_change_; }
+
+  // The change to the text since the last call to ClearTextChange(). Only
+  // valid if has_text_change() is true.
+  const TextChange& text_change() const { return text_change_; }
+
+  // Marks the current text as known to the framework.
+  void ClearTextChange();
+
   // The position of the cursor
-  int selection_base() const {
-    return static_cast<int>(selection_base_ - text_.begin());
-  }
+  int selection_base() const { return static_cast<int>(selection_base_); }
 
   // The end of the selection
-  int selection_extent() const {
-    return static_cast<int>(selection_extent_ - text_.begin());
-  }
+  int selection_extent() const { return static_cast<int>(selection_extent_); }
 
   // Keyboard type of the client. See available options:
   // https://docs.flutter.io/flutter/services/TextInputType-class.html
@@ -99,13 +129,38 @@ class TextInputModel {
   std::string input_action() const { return input_action_; }
 
  private:
+  // A range of either the original text or the text added since.
+  struct Piece {
+    bool added;
+    size_t start;
+    size_t length;
+  };
+
   void DeleteSelected();
 
-  std::u16string text_;
+  // Replaces the range [start, end) of the text with |length| code units
+  // from |text|.
+  void Replace(size_t start, size_t end, const char16_t* text, size_t length);
+
+  // Ensures a piece starts at |position|, and returns its index.
+  size_t SplitAt(size_t position);
+
+  // Returns the code unit at |position|, which must be in bounds.
+  char16_t CharAt(size_t position) const;
+
+  // Replaces all the pieces with a single piece of original text.
+  void Compact();
+
+  std::u16string original_;
+  std::u16string added_;
+  std::vector<Piece> pieces_;
+  size_t length_ = 0;
   std::string input_type_;
   std::string input_action_;
-  std::u16string::iterator selection_base_;
-  std::u16string::iterator selection_extent_;
+  size_t selection_base_ = 0;
+  size_t selection_extent_ = 0;
+  bool has_text_change_ = false;
+  TextChange text_change_;
 };
 
 }  // namespace flutter
@@ -0,0 +1,76 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/cpp/text_input_model.h"
+
+namespace flutter {
+
+namespace {
+
+// Returns a model containing |length| characters of text, split into lines,
+// with the cursor in the middle.
+std::unique_ptr<TextInputModel> MakeModel(size_t length) {
+  std::string text(length, 'a');
+  for (size_t i = 80; i < length; i += 81) {
+    text[i] = '\n';
+  }
+  auto model = std::make_unique<TextInputModel>("TextInputType.multiline", "");
+  model->SetEditingState(length / 2, length / 2, text);
+  return model;
+}
+
+}  // namespace
+
+static void BM_TextInputModelAddCodePoint(benchmark::State& state) {
+  auto model = MakeModel(state.range(0));
+  while (state.KeepRunning()) {
+    model->AddCodePoint('b');
+    model->Backspace();
+  }
+}
+
+static void BM_TextInputModelAddCodePointScattered(benchmark::State& state) {
+  auto model = MakeModel(state.range(0));
+  size_t i = 0;
+  while (state.KeepRunning()) {
+    // Edits alternate between the start and the end of the text, so each one
+    // splits a piece.
+    if (i++ % 2 == 0) {
+      model->MoveCursorToBeginning();
+    } else {
+      model->MoveCursorToEnd();
+    }
+    model->AddCodePoint('b');
+  }
+}
+
+static void BM_TextInputModelGetText(benchmark::State& state) {
+  auto model = MakeModel(state.range(0));
+  while (state.KeepRunning()) {
+    auto text = model->GetText();
+    benchmark::DoNotOptimize(text);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_TextInputModelGetTextChange(benchmark::State& state) {
+  auto model = MakeModel(state.range(0));
+  while (state.KeepRunning()) {
+    model->AddCodePoint('b');
+    const auto& change = model->text_change();
+    auto text = model->GetTextRange(change.start, change.new_end);
+    benchmark::DoNotOptimize(text);
+    model->ClearTextChange();
+  }
+}
+
+BENCHMARK(BM_TextInputModelAddCodePoint)->Arg(1 << 10)->Arg(10 << 20);
+BENCHMARK(BM_TextInputModelAddCodePointScattered)->Arg(1 << 10)->Arg(10 << 20);
+BENCHMARK(BM_TextInputModelGetText)->Arg(1 << 10)->Arg(10 << 20);
+BENCHMARK(BM_TextInputModelGetTextChange)->Arg(1 << 10)->Arg(10 << 20);
+
+}  // namespace flutter
@@ -380,4 +380,120 @@ TEST(TextInputModel, MoveCursorToEndSelection) {
   EXPECT_STREQ(model->GetText().c_str(), "ABCDE");
 }
 
+TEST(TextInputModel, SetEditingStateOutsideWideString) {
+  auto model = std::make_unique<TextInputModel>("", "");
+  // The selection is in UTF-16 code units, not UTF-8 bytes.
+  EXPECT_TRUE(model->SetEditingState(8, 8, "😄🙃🤪🧐"));
+  EXPECT_FALSE(model->SetEditingState(9, 9, "😄🙃🤪🧐"));
+}
+
+TEST(TextInputModel, EditsBetweenPieces) {
+  auto model = std::make_unique<TextInputModel>("", "");
+  EXPECT_TRUE(model->SetEditingState(2, 2, "ABCDE"));
+  model->AddText(u"xy");
+  ASSERT_TRUE(model->MoveCursorToEnd());
+  model->AddCodePoint('z');
+  ASSERT_TRUE(model->MoveCursorToBeginning());
+  model->AddCodePoint(0x1f604);
+  EXPECT_STREQ(model->GetText().c_str(), "😄ABxyCDEz");
+  EXPECT_EQ(model->text_length(), static_cast<size_t>(10));
+
+  // Delete across the boundaries of several pieces.
+  EXPECT_TRUE(model->SetEditingState(4, 4, model->GetText()));
+  ASSERT_TRUE(model->Backspace());
+  ASSERT_TRUE(model->Delete());
+  ASSERT_TRUE(model->Delete());
+  EXPECT_STREQ(model->GetText().c_str(), "😄ACDEz");
+  ASSERT_TRUE(model->Backspace());
+  ASSERT_TRUE(model->Backspace());
+  EXPECT_STREQ(model->GetText().c_str(), "CDEz");
+  EXPECT_EQ(model->selection_base(), 0);
+  EXPECT_EQ(model->selection_extent(), 0);
+}
+
+TEST(TextInputModel, BackspaceThenType) {
+  auto model = std::make_unique<TextInputModel>("", "");
+  model->AddText(u"ABC");
+  ASSERT_TRUE(model->Backspace());
+  model->AddText(u"D");
+  ASSERT_TRUE(model->MoveCursorBack());
+  ASSERT_TRUE(model->Backspace());
+  model->AddText(u"E");
+  EXPECT_STREQ(model->GetText().c_str(), "AED");
+  EXPECT_EQ(model->selection_base(), 2);
+}
+
+TEST(TextInputModel, ManyScatteredEdits) {
+  auto model = std::make_unique<TextInputModel>("", "");
+  std::string expected(4000, 'a');
+  EXPECT_TRUE(model->SetEditingState(0, 0, expected));
+  // Each edit is at a different position, so each adds a piece until the
+  // text is compacted.
+  for (size_t i = 0; i < 3000; i++) {
+    size_t position = (i * 7919) % expected.size();
+    EXPECT_TRUE(model->SetEditingState(position, position, model->GetText()));
+    model->AddCodePoint('b');
+    expected.insert(position, 1, 'b');
+  }
+  EXPECT_EQ(model->GetText(), expected);
+}
+
+TEST(TextInputModel, GetTextRange) {
+  auto model = std::make_unique<TextInputModel>("", "");
+  EXPECT_TRUE(model->SetEditingState(4, 4, "AB😄CD"));
+  model->AddText(u"xy");
+  EXPECT_STREQ(model->GetTextRange(0, 2).c_str(), "AB");
+  EXPECT_STREQ(model->GetTextRange(2, 4).c_str(), "😄");
+  EXPECT_STREQ(model->GetTextRange(2, 5).c_str(), "😄x");
+  // Unpaired surrogates are replaced.
+  EXPECT_STREQ(model->GetTextRange(3, 6).c_str(), "\xef\xbf\xbdxy");
+  EXPECT_STREQ(model->GetTextRange(4, 8).c_str(), "xyCD");
+  EXPECT_STREQ(model->GetTextRange(4, 9).c_str(), "");
+  EXPECT_STREQ(model->GetTextRange(5, 4).c_str(), "");
+}
+
+TEST(TextInputModel, TextChange) {
+  auto model = std::make_unique<TextInputModel>("", "");
+  EXPECT_TRUE(model->SetEditingState(2, 2, "ABCDE"));
+  EXPECT_FALSE(model->has_text_change());
+  ASSERT_TRUE(model->MoveCursorForward());
+  EXPECT_FALSE(model->has_text_change());
+
+  model->AddText(u"xy");
+  ASSERT_TRUE(model->has_text_change());
+  EXPECT_EQ(model->text_change().start, static_cast<size_t>(3));
+  EXPECT_EQ(model->text_change().old_end, static_cast<size_t>(3));
+  EXPECT_EQ(model->text_change().new_end, static_cast<size_t>(5));
+
+  model->ClearTextChange();
+  EXPECT_FALSE(model->has_text_change());
+  ASSERT_TRUE(model->Backspace());
+  EXPECT_EQ(model->text_change().start, static_cast<size_t>(4));
+  EXPECT_EQ(model->text_change().old_end, static_cast<size_t>(5));
+  EXPECT_EQ(model->text_change().new_end, static_cast<size_t>(4));
+}
+
+TEST(TextInputModel, TextChangeMerges) {
+  auto model = std::make_unique<TextInputModel>("", "");
+  EXPECT_TRUE(model->SetEditingState(4, 4, "ABCDEFGH"));
+  const std::string old_text = model->GetText();
+  model->AddText(u"xyz");
+  ASSERT_TRUE(model->MoveCursorToBeginning());
+  ASSERT_TRUE(model->MoveCursorForward());
+  ASSERT_TRUE(model->Delete());
+  ASSERT_TRUE(model->MoveCursorToEnd());
+  ASSERT_TRUE(model->Backspace());
+  EXPECT_STREQ(model->GetText().c_str(), "ACDxyzEFG");
+
+  // Applying the change to the old text gives the new text.
+  const auto& change = model->text_change();
+  std::string new_text = old_text.substr(0, change.start) +
+                         model->GetTextRange(change.start, change.new_end) +
+                         old_text.substr(change.old_end);
+  EXPECT_EQ(new_text, model->GetText());
+  EXPECT_EQ(change.start, static_cast<size_t>(1));
+  EXPECT_EQ(change.old_end, static_cast<size_t>(8));
+  EXPECT_EQ(change.new_end, static_cast<size_t>(9));
+}
+
 }  // namespace flutter
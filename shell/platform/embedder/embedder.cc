@@ -36,6 +36,7 @@ extern const intptr_t kPlatformStrongDillSize;
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
+#include "flutter/fml/trace_recorder.h"
 #include "flutter/shell/common/persistent_cache.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/switches.h"
@@ -52,6 +53,7 @@ extern const intptr_t kPlatformStrongDillSize;
 
 const int32_t kFlutterSemanticsNodeIdBatchEnd = -1;
 const int32_t kFlutterSemanticsCustomActionIdBatchEnd = -1;
+const uint32_t kFlutterSemanticsUpdateFormatVersion = 1;
 
 static FlutterEngineResult LogEmbedderError(FlutterEngineResult code,
                                             const char* reason,
@@ -681,12 +683,15 @@ FlutterEngineResult FlutterEngineRun(size_t version,
   return FlutterEngineRunInitialized(*engine_out);
 }
 
-FlutterEngineResult FlutterEngineInitialize(size_t version,
-                                            const FlutterRendererConfig* config,
-                                            const FlutterProjectArgs* args,
-                                            void* user_data,
-                                            FLUTTER_API_SYMBOL(FlutterEngine) *
-                                                engine_out) {
+// Creates an engine that is not running. Engines with a |spawner| run on its
+// threads.
+static FlutterEngineResult InitializeEngine(
+    size_t version,
+    const FlutterRendererConfig* config,
+    const FlutterProjectArgs* args,
+    void* user_data,
+    flutter::EmbedderEngine* spawner,
+    FLUTTER_API_SYMBOL(FlutterEngine) * engine_out) {
   // Step 0: Figure out arguments for shell creation.
   if (version != FLUTTER_ENGINE_VERSION) {
     return LOG_EMBEDDER_ERROR(
@@ -882,6 +887,17 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
         };
   }
 
+  flutter::PlatformViewEmbedder::UpdateSemanticsBinaryCallback
+      update_semantics_binary_callback = nullptr;
+  if (SAFE_ACCESS(args, update_semantics_binary_callback, nullptr) !=
+      nullptr) {
+    update_semantics_binary_callback =
+        [ptr = args->update_semantics_binary_callback, user_data](
+            const uint8_t* update, size_t size) {
+          ptr(update, size, user_data);
+        };
+  }
+
   flutter::PlatformViewEmbedder::PlatformMessageResponseCallback
       platform_message_response_callback = nullptr;
   if (SAFE_ACCESS(args, platform_message_callback, nullptr) != nullptr) {
@@ -921,6 +937,7 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
           update_semantics_custom_actions_callback,  //
           platform_message_response_callback,        //
           vsync_callback,                            //
+          update_semantics_binary_callback,          //
       };
 
   auto on_create_platform_view = InferPlatformViewCreationCallback(
@@ -998,9 +1015,14 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
     }
   }
 
-  auto thread_host =
-      flutter::EmbedderThreadHost::CreateEmbedderOrEngineManagedThreadHost(
-          SAFE_ACCESS(args, custom_task_runners, nullptr));
+  std::shared_ptr<flutter::EmbedderThreadHost> thread_host;
+  if (spawner) {
+    thread_host = spawner->GetThreadHost();
+  } else {
+    thread_host =
+        flutter::EmbedderThreadHost::CreateEmbedderOrEngineManagedThreadHost(
+            SAFE_ACCESS(args, custom_task_runners, nullptr));
+  }
 
   if (!thread_host || !thread_host->IsValid()) {
     return LOG_EMBEDDER_ERROR(kInvalidArguments,
@@ -1048,6 +1070,16 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
   return kSuccess;
 }
 
+FlutterEngineResult FlutterEngineInitialize(size_t version,
+                                            const FlutterRendererConfig* config,
+                                            const FlutterProjectArgs* args,
+                                            void* user_data,
+                                            FLUTTER_API_SYMBOL(FlutterEngine) *
+                                                engine_out) {
+  return InitializeEngine(version, config, args, user_data, nullptr,
+                          engine_out);
+}
+
 FlutterEngineResult FlutterEngineRunInitialized(
     FLUTTER_API_SYMBOL(FlutterEngine) engine) {
   if (!engine) {
@@ -1086,6 +1118,54 @@ FlutterEngineResult FlutterEngineRunInitialized(
   return kSuccess;
 }
 
+FlutterEngineResult FlutterEngineSpawn(FLUTTER_API_SYMBOL(FlutterEngine)
+                                           spawner,
+                                       size_t version,
+                                       const FlutterRendererConfig* config,
+                                       const FlutterProjectArgs* args,
+                                       void* user_data,
+                                       FLUTTER_API_SYMBOL(FlutterEngine) *
+                                           engine_out) {
+  if (spawner == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Spawning engine handle was invalid.");
+  }
+
+  auto spawner_engine = reinterpret_cast<flutter::EmbedderEngine*>(spawner);
+  if (!spawner_engine->IsValid()) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "The spawning engine was not running.");
+  }
+
+  auto result = InitializeEngine(version, config, args, user_data,
+                                 spawner_engine, engine_out);
+  if (result != kSuccess) {
+    return result;
+  }
+
+  std::unique_ptr<flutter::EmbedderEngine> embedder_engine(
+      reinterpret_cast<flutter::EmbedderEngine*>(*engine_out));
+  *engine_out = nullptr;
+
+  // Step 1: Spawn the shell. This also runs its root isolate.
+  if (!embedder_engine->SpawnShell(*spawner_engine)) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Could not spawn the engine from the running "
+                              "engine using the supplied arguments.");
+  }
+
+  // Step 2: Tell the platform view to initialize itself.
+  if (!embedder_engine->NotifyCreated()) {
+    embedder_engine->CollectShell();
+    return LOG_EMBEDDER_ERROR(kInternalInconsistency,
+                              "Could not create platform view components.");
+  }
+
+  *engine_out = reinterpret_cast<FLUTTER_API_SYMBOL(FlutterEngine)>(
+      embedder_engine.release());
+  return kSuccess;
+}
+
 FLUTTER_EXPORT
 FlutterEngineResult FlutterEngineDeinitialize(FLUTTER_API_SYMBOL(FlutterEngine)
                                                   engine) {
@@ -1874,3 +1954,105 @@ FlutterEngineResult FlutterEnginePostCallbackOnAllNativeThreads(
                                   "Internal error while attempting to post "
                                   "tasks to all threads.");
 }
+
+FlutterEngineResult FlutterEngineDumpTraceRecorder(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterTraceRecorderDumpCallback callback,
+    void* user_data) {
+  if (engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
+  }
+
+  if (!reinterpret_cast<flutter::EmbedderEngine*>(engine)->IsValid()) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Engine is not running.");
+  }
+
+  if (callback == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Invalid trace recorder dump callback.");
+  }
+
+  const std::string trace =
+      fml::tracing::TraceRecorder::GetInstance().ExportChromeJSON();
+  callback(trace.c_str(), trace.size(), user_data);
+  return kSuccess;
+}
+
+FlutterEngineResult FlutterEngineGetFrameTimingHistogram(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterFrameTimingMetric metric,
+    FlutterFrameTimingHistogram* histogram) {
+  if (engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
+  }
+
+  // Embedders built against older headers may pass smaller structs. Only the
+  // fields that fit are written.
+  if (histogram == nullptr || !SAFE_EXISTS(histogram, sample_count)) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Invalid frame timing histogram.");
+  }
+
+  flutter::FrameTimingHistograms::Metric engine_metric;
+  switch (metric) {
+    case kFlutterFrameTimingMetricBuild:
+      engine_metric = flutter::FrameTimingHistograms::kBuild;
+      break;
+    case kFlutterFrameTimingMetricRaster:
+      engine_metric = flutter::FrameTimingHistograms::kRaster;
+      break;
+    case kFlutterFrameTimingMetricPreroll:
+      engine_metric = flutter::FrameTimingHistograms::kPreroll;
+      break;
+    case kFlutterFrameTimingMetricRasterCachePopulation:
+      engine_metric = flutter::FrameTimingHistograms::kRasterCachePopulation;
+      break;
+    case kFlutterFrameTimingMetricPaint:
+      engine_metric = flutter::FrameTimingHistograms::kPaint;
+      break;
+    case kFlutterFrameTimingMetricFlush:
+      engine_metric = flutter::FrameTimingHistograms::kFlush;
+      break;
+    case kFlutterFrameTimingMetricPresent:
+      engine_metric = flutter::FrameTimingHistograms::kPresent;
+      break;
+    case kFlutterFrameTimingMetricTotal:
+      engine_metric = flutter::FrameTimingHistograms::kTotal;
+      break;
+    case kFlutterFrameTimingMetricRasterCacheEntries:
+      engine_metric = flutter::FrameTimingHistograms::kRasterCacheEntries;
+      break;
+    case kFlutterFrameTimingMetricRasterCacheBytes:
+      engine_metric = flutter::FrameTimingHistograms::kRasterCacheBytes;
+      break;
+    default:
+      return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                                "Invalid frame timing metric.");
+  }
+
+  auto embedder_engine = reinterpret_cast<flutter::EmbedderEngine*>(engine);
+  if (!embedder_engine->IsValid()) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Engine is not running.");
+  }
+
+  const auto result = embedder_engine->GetShell()
+                          .GetFrameTimingHistograms()
+                          .GetHistogram(engine_metric);
+  histogram->sample_count = result.sample_count;
+  if (SAFE_EXISTS(histogram, p50)) {
+    histogram->p50 = result.p50;
+  }
+  if (SAFE_EXISTS(histogram, p90)) {
+    histogram->p90 = result.p90;
+  }
+  if (SAFE_EXISTS(histogram, p99)) {
+    histogram->p99 = result.p99;
+  }
+  if (SAFE_EXISTS(histogram, max)) {
+    histogram->max = result.max;
+  }
+  if (SAFE_EXISTS(histogram, mean)) {
+    histogram->mean = result.mean;
+  }
+  return kSuccess;
+}
@@ -599,6 +599,82 @@ typedef void (*FlutterUpdateSemanticsCustomActionCallback)(
     const FlutterSemanticsCustomAction* /* semantics custom action */,
     void* /* user data */);
 
+/// The version of the binary semantics update format described below. It is
+/// the first value of every update passed to the
+/// `FlutterUpdateSemanticsBinaryCallback`.
+FLUTTER_EXPORT
+extern const uint32_t kFlutterSemanticsUpdateFormatVersion;
+
+/// The fields of a semantics node that may be present in a node record of a
+/// binary semantics update. Fields are serialized in the order of their bits.
+typedef enum {
+  /// An `int32_t` with the `FlutterSemanticsFlag`s of the node.
+  kFlutterSemanticsUpdateFieldFlags = 1 << 0,
+  /// An `int32_t` with the `FlutterSemanticsAction`s of the node.
+  kFlutterSemanticsUpdateFieldActions = 1 << 1,
+  /// Two `int32_t`s: the text selection base and extent.
+  kFlutterSemanticsUpdateFieldTextSelection = 1 << 2,
+  /// Two `int32_t`s: the scroll child count and scroll index.
+  kFlutterSemanticsUpdateFieldScrollChildren = 1 << 3,
+  /// Three `double`s: the scroll position, extent max and extent min.
+  kFlutterSemanticsUpdateFieldScrollPosition = 1 << 4,
+  /// Two `double`s: the elevation and thickness.
+  kFlutterSemanticsUpdateFieldElevation = 1 << 5,
+  /// A `uint32_t` string table index for the label.
+  kFlutterSemanticsUpdateFieldLabel = 1 << 6,
+  /// A `uint32_t` string table index for the hint.
+  kFlutterSemanticsUpdateFieldHint = 1 << 7,
+  /// A `uint32_t` string table index for the value.
+  kFlutterSemanticsUpdateFieldValue = 1 << 8,
+  /// A `uint32_t` string table index for the increased value.
+  kFlutterSemanticsUpdateFieldIncreasedValue = 1 << 9,
+  /// A `uint32_t` string table index for the decreased value.
+  kFlutterSemanticsUpdateFieldDecreasedValue = 1 << 10,
+  /// An `int32_t` with the `FlutterTextDirection` of the node.
+  kFlutterSemanticsUpdateFieldTextDirection = 1 << 11,
+  /// Four `double`s: the left, top, right and bottom of the rect.
+  kFlutterSemanticsUpdateFieldRect = 1 << 12,
+  /// Nine `double`s laid out like `FlutterTransformation`.
+  kFlutterSemanticsUpdateFieldTransform = 1 << 13,
+  /// A `uint32_t` child count followed by that many `int32_t` child IDs in
+  /// traversal order and that many `int32_t` child IDs in hit test order.
+  kFlutterSemanticsUpdateFieldChildren = 1 << 14,
+  /// A `uint32_t` count followed by that many `int32_t` custom action IDs.
+  kFlutterSemanticsUpdateFieldCustomActions = 1 << 15,
+  /// An `int64_t` with the `FlutterPlatformViewIdentifier` of the node.
+  kFlutterSemanticsUpdateFieldPlatformViewId = 1 << 16,
+} FlutterSemanticsUpdateField;
+
+/// The callback invoked with a complete semantics update in the binary format.
+///
+/// All values are in host byte order and are not aligned. An update is laid
+/// out as follows:
+///
+///   uint32_t version (`kFlutterSemanticsUpdateFormatVersion`)
+///   uint32_t string count
+///     for each string: uint32_t byte length, followed by the UTF-8 bytes
+///                      (not NULL terminated)
+///   uint32_t node count
+///     for each node: int32_t id, uint32_t field mask (a combination of
+///                    `FlutterSemanticsUpdateField`), followed by the values of
+///                    the fields present in the mask
+///   uint32_t custom action count
+///     for each action: int32_t id, int32_t override action, uint32_t label
+///                      string index, uint32_t hint string index
+///
+/// Only nodes that changed since the last update are present, and only with
+/// the fields that changed. A node that was not part of any previous update
+/// has all of its fields present. Fields that are absent keep the value they
+/// had in the last update that contained them. After
+/// `FlutterEngineUpdateSemanticsEnabled` disables semantics, the next update
+/// contains every node in full again.
+///
+/// The buffer is only valid for the duration of the callback.
+typedef void (*FlutterUpdateSemanticsBinaryCallback)(
+    const uint8_t* /* update */,
+    size_t /* update size */,
+    void* /* user data */);
+
 typedef struct _FlutterTaskRunner* FlutterTaskRunner;
 
 typedef struct {
@@ -959,6 +1035,56 @@ typedef enum {
 typedef void (*FlutterNativeThreadCallback)(FlutterNativeThreadType type,
                                             void* user_data);
 
+/// The metrics aggregated over the most recently rasterized frames by
+/// `FlutterEngineGetFrameTimingHistogram`.
+typedef enum {
+  /// The time spent building the frame on the UI thread, in microseconds.
+  kFlutterFrameTimingMetricBuild,
+  /// The time spent rasterizing the frame on the raster thread, in
+  /// microseconds.
+  kFlutterFrameTimingMetricRaster,
+  /// The time spent prerolling the layer tree, in microseconds. This includes
+  /// the time spent populating the raster cache.
+  kFlutterFrameTimingMetricPreroll,
+  /// The time spent populating the raster cache, in microseconds.
+  kFlutterFrameTimingMetricRasterCachePopulation,
+  /// The time spent painting the layer tree, in microseconds.
+  kFlutterFrameTimingMetricPaint,
+  /// The time spent flushing the frame to the GPU, in microseconds.
+  kFlutterFrameTimingMetricFlush,
+  /// The time spent presenting the frame, in microseconds.
+  kFlutterFrameTimingMetricPresent,
+  /// The time from the start of the build to the end of the rasterization of
+  /// the frame, in microseconds.
+  kFlutterFrameTimingMetricTotal,
+  /// The number of entries in the raster cache at the end of the frame.
+  kFlutterFrameTimingMetricRasterCacheEntries,
+  /// The size of the images in the raster cache at the end of the frame, in
+  /// bytes.
+  kFlutterFrameTimingMetricRasterCacheBytes,
+} FlutterFrameTimingMetric;
+
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterFrameTimingHistogram).
+  size_t struct_size;
+  /// The number of frames in which the metric was measured. The percentiles
+  /// are only valid if this is non-zero.
+  size_t sample_count;
+  /// The percentiles of the metric.
+  int64_t p50;
+  int64_t p90;
+  int64_t p99;
+  int64_t max;
+  double mean;
+} FlutterFrameTimingHistogram;
+
+/// A callback made by the engine in response to
+/// `FlutterEngineDumpTraceRecorder` with the recorded trace in the Chrome JSON
+/// trace event format. The trace is only valid for the duration of the call.
+typedef void (*FlutterTraceRecorderDumpCallback)(const char* /* trace */,
+                                                 size_t /* trace size */,
+                                                 void* /* user data */);
+
 /// AOT data source type.
 typedef enum {
   kFlutterEngineAOTDataSourceTypeElfPath
@@ -1205,6 +1331,19 @@ typedef struct {
   ///
   /// Embedders can provide either snapshot buffers or aot_data, but not both.
   FlutterEngineAOTData aot_data;
+
+  /// The callback invoked by the engine in order to give the embedder the
+  /// chance to respond to semantics updates from the Dart application using
+  /// the compact binary format documented on
+  /// `FlutterUpdateSemanticsBinaryCallback`. The callback is invoked once per
+  /// update with both the changed nodes and the changed custom actions.
+  ///
+  /// If this callback is provided, `update_semantics_node_callback` and
+  /// `update_semantics_custom_action_callback` are ignored.
+  ///
+  /// The callback will be invoked on the thread on which the `FlutterEngineRun`
+  /// call is made.
+  FlutterUpdateSemanticsBinaryCallback update_semantics_binary_callback;
 } FlutterProjectArgs;
 
 //------------------------------------------------------------------------------
@@ -1316,6 +1455,47 @@ FLUTTER_EXPORT
 FlutterEngineResult FlutterEngineRunInitialized(
     FLUTTER_API_SYMBOL(FlutterEngine) engine);
 
+//------------------------------------------------------------------------------
+/// @brief      Creates and runs an engine for another view from a running
+///             engine. The spawned engine runs on the threads of the spawning
+///             engine and shares its Dart VM, isolate snapshot, assets, fonts
+///             and resource context. This makes it much cheaper to create
+///             than an engine created with `FlutterEngineRun`. Its root
+///             isolate is separate from that of the spawning engine.
+///
+///             The renderer configuration and the callbacks in the project
+///             arguments apply to the spawned engine, along with the
+///             `custom_dart_entrypoint`. The remaining project arguments must
+///             still be valid, but the settings of the spawning engine are
+///             used instead. In particular, the `root_isolate_create_callback`
+///             and the `custom_task_runners` of the arguments are ignored.
+///
+///             The engines may be shut down in any order. The resource context
+///             that the spawning engine made current through its
+///             `make_resource_current` callback stays in use until all of
+///             them are shut down.
+///
+/// @param[in]  spawner    The running engine instance to spawn from.
+/// @param[in]  version    The Flutter embedder API version. Must be
+///                        FLUTTER_ENGINE_VERSION.
+/// @param[in]  config     The renderer configuration of the spawned engine.
+/// @param[in]  args       The Flutter project arguments of the spawned engine.
+/// @param      user_data  A user data baton passed back to embedders in
+///                        callbacks of the spawned engine.
+/// @param[out] engine_out The engine handle on successful engine creation.
+///
+/// @return     The result of the call to spawn the Flutter engine.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineSpawn(FLUTTER_API_SYMBOL(FlutterEngine)
+                                           spawner,
+                                       size_t version,
+                                       const FlutterRendererConfig* config,
+                                       const FlutterProjectArgs* args,
+                                       void* user_data,
+                                       FLUTTER_API_SYMBOL(FlutterEngine) *
+                                           engine_out);
+
 FLUTTER_EXPORT
 FlutterEngineResult FlutterEngineSendWindowMetricsEvent(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
@@ -1790,6 +1970,50 @@ FlutterEngineResult FlutterEnginePostCallbackOnAllNativeThreads(
     FlutterNativeThreadCallback callback,
     void* user_data);
 
+//------------------------------------------------------------------------------
+/// @brief      Dumps the events recorded by the in-process trace recorder. The
+///             recorder keeps the most recent trace events of each thread in
+///             memory and, unlike the timeline, is also available in release
+///             builds. Recording is enabled by passing
+///             `--trace-recorder-categories=<comma separated categories>` (or
+///             `*` for all categories) in
+///             `FlutterProjectArgs.command_line_argv`. The trace recorder is
+///             shared by all engine instances in the process. This call has no
+///             threading restrictions.
+///
+/// @param[in]  engine     A running engine instance.
+/// @param[in]  callback   The callback called synchronously with the recorded
+///                        trace in the Chrome JSON trace event format.
+/// @param[in]  user_data  A baton passed by the engine to the callback. This
+///                        baton is not interpreted by the engine in any way.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineDumpTraceRecorder(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterTraceRecorderDumpCallback callback,
+    void* user_data);
+
+//------------------------------------------------------------------------------
+/// @brief      Gets the percentiles of a metric over the most recently
+///             rasterized frames of a running engine instance. Embedders may
+///             use this to monitor frame performance in the field, including
+///             in release builds. This call has no threading restrictions.
+///
+/// @param[in]  engine     A running engine instance.
+/// @param[in]  metric     The metric to get the percentiles of.
+/// @param[out] histogram  The percentiles of the metric. The `struct_size`
+///                        field must be set by the caller.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineGetFrameTimingHistogram(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterFrameTimingMetric metric,
+    FlutterFrameTimingHistogram* histogram);
+
 #if defined(__cplusplus)
 }  // extern "C"
 #endif
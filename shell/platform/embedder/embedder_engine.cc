@@ -22,7 +22,7 @@ struct ShellArgs {
 };
 
 EmbedderEngine::EmbedderEngine(
-    std::unique_ptr<EmbedderThreadHost> thread_host,
+    std::shared_ptr<EmbedderThreadHost> thread_host,
     flutter::TaskRunners task_runners,
     flutter::Settings settings,
     RunConfiguration run_configuration,
@@ -61,6 +61,29 @@ bool EmbedderEngine::LaunchShell() {
   return IsValid();
 }
 
+bool EmbedderEngine::SpawnShell(EmbedderEngine& spawner) {
+  if (!shell_args_) {
+    FML_DLOG(ERROR) << "Invalid shell arguments.";
+    return false;
+  }
+
+  if (!spawner.IsValid()) {
+    FML_DLOG(ERROR) << "The spawning engine is not running.";
+    return false;
+  }
+
+  shell_ = spawner.shell_->Spawn(run_configuration_.GetEntrypoint(),
+                                 run_configuration_.GetEntrypointLibrary(),
+                                 shell_args_->on_create_platform_view,
+                                 shell_args_->on_create_rasterizer);
+
+  // Reset the args no matter what. They will never be used to initialize a
+  // shell again.
+  shell_args_.reset();
+
+  return IsValid();
+}
+
 bool EmbedderEngine::CollectShell() {
   shell_.reset();
   return IsValid();
@@ -82,6 +105,10 @@ const TaskRunners& EmbedderEngine::GetTaskRunners() const {
   return task_runners_;
 }
 
+std::shared_ptr<EmbedderThreadHost> EmbedderEngine::GetThreadHost() const {
+  return thread_host_;
+}
+
 bool EmbedderEngine::NotifyCreated() {
   if (!IsValid()) {
     return false;
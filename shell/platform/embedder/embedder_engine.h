@@ -24,7 +24,7 @@ struct ShellArgs;
 // instance of the Flutter engine.
 class EmbedderEngine {
  public:
-  EmbedderEngine(std::unique_ptr<EmbedderThreadHost> thread_host,
+  EmbedderEngine(std::shared_ptr<EmbedderThreadHost> thread_host,
                  TaskRunners task_runners,
                  Settings settings,
                  RunConfiguration run_configuration,
@@ -37,10 +37,18 @@ class EmbedderEngine {
 
   bool LaunchShell();
 
+  // Launches the shell of this engine by spawning it from the running shell of
+  // the |spawner|. The root isolate is run with the entrypoint of the run
+  // configuration of this engine as part of the launch.
+  bool SpawnShell(EmbedderEngine& spawner);
+
   bool CollectShell();
 
   const TaskRunners& GetTaskRunners() const;
 
+  // Engines spawned from this one run on the same threads.
+  std::shared_ptr<EmbedderThreadHost> GetThreadHost() const;
+
   bool NotifyCreated();
 
   bool NotifyDestroyed();
@@ -86,7 +94,7 @@ class EmbedderEngine {
   Shell& GetShell();
 
  private:
-  const std::unique_ptr<EmbedderThreadHost> thread_host_;
+  const std::shared_ptr<EmbedderThreadHost> thread_host_;
   TaskRunners task_runners_;
   RunConfiguration run_configuration_;
   std::unique_ptr<ShellArgs> shell_args_;
@@ -17,4 +17,9 @@
     return static_cast<decltype(pointer->member)>((default_value));      \
   })()
 
+#define SAFE_EXISTS(pointer, member)                                  \
+  (offsetof(std::remove_pointer<decltype(pointer)>::type, member) + \
+       sizeof(pointer->member) <=                                   \
+   pointer->struct_size)
+
 #endif  // FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SAFE_ACCESS_H_
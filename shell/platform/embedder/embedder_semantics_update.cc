@@ -0,0 +1,326 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/embedder/embedder_semantics_update.h"
+
+#include <cmath>
+#include <cstring>
+#include <unordered_set>
+#include <vector>
+
+#include "flutter/fml/trace_event.h"
+#include "flutter/shell/platform/embedder/embedder.h"
+#include "third_party/skia/include/core/SkMatrix.h"
+
+namespace flutter {
+
+static constexpr int32_t kRootNodeId = 0;
+
+static constexpr uint32_t kAllFields =
+    kFlutterSemanticsUpdateFieldFlags | kFlutterSemanticsUpdateFieldActions |
+    kFlutterSemanticsUpdateFieldTextSelection |
+    kFlutterSemanticsUpdateFieldScrollChildren |
+    kFlutterSemanticsUpdateFieldScrollPosition |
+    kFlutterSemanticsUpdateFieldElevation | kFlutterSemanticsUpdateFieldLabel |
+    kFlutterSemanticsUpdateFieldHint | kFlutterSemanticsUpdateFieldValue |
+    kFlutterSemanticsUpdateFieldIncreasedValue |
+    kFlutterSemanticsUpdateFieldDecreasedValue |
+    kFlutterSemanticsUpdateFieldTextDirection |
+    kFlutterSemanticsUpdateFieldRect | kFlutterSemanticsUpdateFieldTransform |
+    kFlutterSemanticsUpdateFieldChildren |
+    kFlutterSemanticsUpdateFieldCustomActions |
+    kFlutterSemanticsUpdateFieldPlatformViewId;
+
+// Scroll values are NaN for nodes that are not scrollable. Treat two NaNs as
+// equal so that such nodes are not considered changed on every update.
+static bool SameDouble(double a, double b) {
+  return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+// Appends values to the encoded buffer and interns strings. Strings are
+// referenced by index while the node records are written, and the string table
+// is spliced in front of the records once all strings are known.
+class EmbedderSemanticsUpdateEncoder::Writer {
+ public:
+  template <typename T>
+  void Write(T value) {
+    const size_t offset = records_.size();
+    records_.resize(offset + sizeof(T));
+    memcpy(records_.data() + offset, &value, sizeof(T));
+  }
+
+  void WriteInt32List(const std::vector<int32_t>& values) {
+    const size_t size = values.size() * sizeof(int32_t);
+    const size_t offset = records_.size();
+    records_.resize(offset + size);
+    if (size > 0) {
+      memcpy(records_.data() + offset, values.data(), size);
+    }
+  }
+
+  void WriteString(const std::string& string) {
+    auto [iter, inserted] =
+        string_indices_.try_emplace(string, string_indices_.size());
+    if (inserted) {
+      strings_.push_back(&iter->first);
+    }
+    Write<uint32_t>(iter->second);
+  }
+
+  std::vector<uint8_t> Finish(size_t records_offset) {
+    size_t strings_size = sizeof(uint32_t);
+    for (const auto* string : strings_) {
+      strings_size += sizeof(uint32_t) + string->size();
+    }
+
+    std::vector<uint8_t> result;
+    result.reserve(records_.size() + strings_size);
+    auto append = [&result](const void* data, size_t size) {
+      const auto* bytes = static_cast<const uint8_t*>(data);
+      result.insert(result.end(), bytes, bytes + size);
+    };
+    // The version precedes the string table.
+    append(records_.data(), records_offset);
+    const uint32_t string_count = strings_.size();
+    append(&string_count, sizeof(string_count));
+    for (const auto* string : strings_) {
+      const uint32_t length = string->size();
+      append(&length, sizeof(length));
+      append(string->data(), string->size());
+    }
+    append(records_.data() + records_offset,
+           records_.size() - records_offset);
+    return result;
+  }
+
+  size_t size() const { return records_.size(); }
+
+ private:
+  std::vector<uint8_t> records_;
+  std::unordered_map<std::string, uint32_t> string_indices_;
+  std::vector<const std::string*> strings_;
+};
+
+EmbedderSemanticsUpdateEncoder::EmbedderSemanticsUpdateEncoder() = default;
+
+EmbedderSemanticsUpdateEncoder::~EmbedderSemanticsUpdateEncoder() = default;
+
+void EmbedderSemanticsUpdateEncoder::Reset() {
+  last_nodes_.clear();
+}
+
+uint32_t EmbedderSemanticsUpdateEncoder::GetChangedFields(
+    const SemanticsNode& previous,
+    const SemanticsNode& current) {
+  uint32_t fields = 0;
+  if (previous.flags != current.flags) {
+    fields |= kFlutterSemanticsUpdateFieldFlags;
+  }
+  if (previous.actions != current.actions) {
+    fields |= kFlutterSemanticsUpdateFieldActions;
+  }
+  if (previous.textSelectionBase != current.textSelectionBase ||
+      previous.textSelectionExtent != current.textSelectionExtent) {
+    fields |= kFlutterSemanticsUpdateFieldTextSelection;
+  }
+  if (previous.scrollChildren != current.scrollChildren ||
+      previous.scrollIndex != current.scrollIndex) {
+    fields |= kFlutterSemanticsUpdateFieldScrollChildren;
+  }
+  if (!SameDouble(previous.scrollPosition, current.scrollPosition) ||
+      !SameDouble(previous.scrollExtentMax, current.scrollExtentMax) ||
+      !SameDouble(previous.scrollExtentMin, current.scrollExtentMin)) {
+    fields |= kFlutterSemanticsUpdateFieldScrollPosition;
+  }
+  if (previous.elevation != current.elevation ||
+      previous.thickness != current.thickness) {
+    fields |= kFlutterSemanticsUpdateFieldElevation;
+  }
+  if (previous.label != current.label) {
+    fields |= kFlutterSemanticsUpdateFieldLabel;
+  }
+  if (previous.hint != current.hint) {
+    fields |= kFlutterSemanticsUpdateFieldHint;
+  }
+  if (previous.value != current.value) {
+    fields |= kFlutterSemanticsUpdateFieldValue;
+  }
+  if (previous.increasedValue != current.increasedValue) {
+    fields |= kFlutterSemanticsUpdateFieldIncreasedValue;
+  }
+  if (previous.decreasedValue != current.decreasedValue) {
+    fields |= kFlutterSemanticsUpdateFieldDecreasedValue;
+  }
+  if (previous.textDirection != current.textDirection) {
+    fields |= kFlutterSemanticsUpdateFieldTextDirection;
+  }
+  if (previous.rect != current.rect) {
+    fields |= kFlutterSemanticsUpdateFieldRect;
+  }
+  if (previous.transform != current.transform) {
+    fields |= kFlutterSemanticsUpdateFieldTransform;
+  }
+  if (previous.childrenInTraversalOrder != current.childrenInTraversalOrder ||
+      previous.childrenInHitTestOrder != current.childrenInHitTestOrder) {
+    fields |= kFlutterSemanticsUpdateFieldChildren;
+  }
+  if (previous.customAccessibilityActions !=
+      current.customAccessibilityActions) {
+    fields |= kFlutterSemanticsUpdateFieldCustomActions;
+  }
+  if (previous.platformViewId != current.platformViewId) {
+    fields |= kFlutterSemanticsUpdateFieldPlatformViewId;
+  }
+  return fields;
+}
+
+std::vector<uint8_t> EmbedderSemanticsUpdateEncoder::Encode(
+    const SemanticsNodeUpdates& update,
+    const CustomAccessibilityActionUpdates& actions) {
+  TRACE_EVENT0("flutter", "EmbedderSemanticsUpdateEncoder::Encode");
+  Writer writer;
+  writer.Write<uint32_t>(kFlutterSemanticsUpdateFormatVersion);
+  const size_t records_offset = writer.size();
+
+  // The node count is patched once the unchanged nodes have been skipped.
+  std::vector<std::pair<const SemanticsNode*, uint32_t>> changed_nodes;
+  changed_nodes.reserve(update.size());
+  bool children_changed = false;
+  for (const auto& [id, node] : update) {
+    auto [last, inserted] = last_nodes_.try_emplace(id, node);
+    uint32_t fields = kAllFields;
+    if (!inserted) {
+      fields = GetChangedFields(last->second, node);
+      if (fields == 0) {
+        continue;
+      }
+      last->second = node;
+    }
+    children_changed |= (fields & kFlutterSemanticsUpdateFieldChildren) != 0;
+    changed_nodes.emplace_back(&node, fields);
+  }
+  // Nodes can only become unreachable when the children of a node change.
+  if (children_changed) {
+    PruneUnreachableNodes();
+  }
+
+  writer.Write<uint32_t>(changed_nodes.size());
+  for (const auto& [node, fields] : changed_nodes) {
+    writer.Write<int32_t>(node->id);
+    writer.Write<uint32_t>(fields);
+    if (fields & kFlutterSemanticsUpdateFieldFlags) {
+      writer.Write<int32_t>(node->flags);
+    }
+    if (fields & kFlutterSemanticsUpdateFieldActions) {
+      writer.Write<int32_t>(node->actions);
+    }
+    if (fields & kFlutterSemanticsUpdateFieldTextSelection) {
+      writer.Write<int32_t>(node->textSelectionBase);
+      writer.Write<int32_t>(node->textSelectionExtent);
+    }
+    if (fields & kFlutterSemanticsUpdateFieldScrollChildren) {
+      writer.Write<int32_t>(node->scrollChildren);
+      writer.Write<int32_t>(node->scrollIndex);
+    }
+    if (fields & kFlutterSemanticsUpdateFieldScrollPosition) {
+      writer.Write<double>(node->scrollPosition);
+      writer.Write<double>(node->scrollExtentMax);
+      writer.Write<double>(node->scrollExtentMin);
+    }
+    if (fields & kFlutterSemanticsUpdateFieldElevation) {
+      writer.Write<double>(node->elevation);
+      writer.Write<double>(node->thickness);
+    }
+    if (fields & kFlutterSemanticsUpdateFieldLabel) {
+      writer.WriteString(node->label);
+    }
+    if (fields & kFlutterSemanticsUpdateFieldHint) {
+      writer.WriteString(node->hint);
+    }
+    if (fields & kFlutterSemanticsUpdateFieldValue) {
+      writer.WriteString(node->value);
+    }
+    if (fields & kFlutterSemanticsUpdateFieldIncreasedValue) {
+      writer.WriteString(node->increasedValue);
+    }
+    if (fields & kFlutterSemanticsUpdateFieldDecreasedValue) {
+      writer.WriteString(node->decreasedValue);
+    }
+    if (fields & kFlutterSemanticsUpdateFieldTextDirection) {
+      writer.Write<int32_t>(node->textDirection);
+    }
+    if (fields & kFlutterSemanticsUpdateFieldRect) {
+      writer.Write<double>(node->rect.fLeft);
+      writer.Write<double>(node->rect.fTop);
+      writer.Write<double>(node->rect.fRight);
+      writer.Write<double>(node->rect.fBottom);
+    }
+    if (fields & kFlutterSemanticsUpdateFieldTransform) {
+      const SkMatrix transform = node->transform.asM33();
+      for (int index : {SkMatrix::kMScaleX, SkMatrix::kMSkewX,
+                        SkMatrix::kMTransX, SkMatrix::kMSkewY,
+                        SkMatrix::kMScaleY, SkMatrix::kMTransY,
+                        SkMatrix::kMPersp0, SkMatrix::kMPersp1,
+                        SkMatrix::kMPersp2}) {
+        writer.Write<double>(transform.get(index));
+      }
+    }
+    if (fields & kFlutterSemanticsUpdateFieldChildren) {
+      // The framework always sends both orders with the same length.
+      FML_DCHECK(node->childrenInHitTestOrder.size() ==
+                 node->childrenInTraversalOrder.size());
+      writer.Write<uint32_t>(node->childrenInTraversalOrder.size());
+      writer.WriteInt32List(node->childrenInTraversalOrder);
+      writer.WriteInt32List(node->childrenInHitTestOrder);
+    }
+    if (fields & kFlutterSemanticsUpdateFieldCustomActions) {
+      writer.Write<uint32_t>(node->customAccessibilityActions.size());
+      writer.WriteInt32List(node->customAccessibilityActions);
+    }
+    if (fields & kFlutterSemanticsUpdateFieldPlatformViewId) {
+      writer.Write<int64_t>(node->platformViewId);
+    }
+  }
+
+  writer.Write<uint32_t>(actions.size());
+  for (const auto& [id, action] : actions) {
+    writer.Write<int32_t>(action.id);
+    writer.Write<int32_t>(action.overrideId);
+    writer.WriteString(action.label);
+    writer.WriteString(action.hint);
+  }
+
+  return writer.Finish(records_offset);
+}
+
+void EmbedderSemanticsUpdateEncoder::PruneUnreachableNodes() {
+  // Until the root has been encoded, there is no tree to prune.
+  if (last_nodes_.find(kRootNodeId) == last_nodes_.end()) {
+    return;
+  }
+
+  std::unordered_set<int32_t> reachable;
+  std::vector<int32_t> pending = {kRootNodeId};
+  while (!pending.empty()) {
+    const int32_t id = pending.back();
+    pending.pop_back();
+    auto node = last_nodes_.find(id);
+    if (node == last_nodes_.end() || !reachable.insert(id).second) {
+      continue;
+    }
+    pending.insert(pending.end(),
+                   node->second.childrenInTraversalOrder.begin(),
+                   node->second.childrenInTraversalOrder.end());
+  }
+
+  for (auto it = last_nodes_.begin(); it != last_nodes_.end();) {
+    if (reachable.count(it->first) == 0) {
+      it = last_nodes_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+}  // namespace flutter
@@ -0,0 +1,77 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SEMANTICS_UPDATE_H_
+#define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SEMANTICS_UPDATE_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/lib/ui/semantics/custom_accessibility_action.h"
+#include "flutter/lib/ui/semantics/semantics_node.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Encodes semantics updates into the binary format documented on
+///             `FlutterUpdateSemanticsBinaryCallback`.
+///
+///             The encoder remembers the last state of every node it has
+///             encoded so that subsequent updates only carry the nodes and
+///             fields that actually changed. Nodes are forgotten once they
+///             are no longer reachable from the root node. Strings are
+///             deduplicated into a per-update string table.
+///
+///             This class is not thread safe and is used on the platform
+///             thread.
+///
+class EmbedderSemanticsUpdateEncoder {
+ public:
+  EmbedderSemanticsUpdateEncoder();
+
+  ~EmbedderSemanticsUpdateEncoder();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Encode the given update relative to the previously encoded
+  ///             updates.
+  ///
+  /// @param[in]  update   The semantics nodes updated by the framework.
+  /// @param[in]  actions  The custom accessibility actions updated by the
+  ///                      framework.
+  ///
+  /// @return     The encoded update.
+  ///
+  std::vector<uint8_t> Encode(const SemanticsNodeUpdates& update,
+                              const CustomAccessibilityActionUpdates& actions);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Forget the state of all previously encoded nodes so that the
+  ///             next update encodes every node in full.
+  ///
+  void Reset();
+
+  //----------------------------------------------------------------------------
+  /// @brief      The fields (a combination of `FlutterSemanticsUpdateField`)
+  ///             that differ between two versions of a node.
+  ///
+  static uint32_t GetChangedFields(const SemanticsNode& previous,
+                                   const SemanticsNode& current);
+
+ private:
+  class Writer;
+
+  // Forgets the nodes that are not reachable from the root node, which the
+  // framework has removed from the tree.
+  void PruneUnreachableNodes();
+
+  SemanticsNodeUpdates last_nodes_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(EmbedderSemanticsUpdateEncoder);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SEMANTICS_UPDATE_H_
@@ -729,3 +729,8 @@ void render_targets_are_recycled() {
   };
   window.scheduleFrame();
 }
+
+@pragma('vm:entry-point')
+void can_spawn_engine() {
+  signalNativeTest();
+}
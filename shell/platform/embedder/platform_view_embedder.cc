@@ -37,6 +37,12 @@ PlatformViewEmbedder::~PlatformViewEmbedder() = default;
 void PlatformViewEmbedder::UpdateSemantics(
     flutter::SemanticsNodeUpdates update,
     flutter::CustomAccessibilityActionUpdates actions) {
+  if (platform_dispatch_table_.update_semantics_binary_callback != nullptr) {
+    auto encoded = semantics_update_encoder_.Encode(update, actions);
+    platform_dispatch_table_.update_semantics_binary_callback(encoded.data(),
+                                                              encoded.size());
+    return;
+  }
   if (platform_dispatch_table_.update_semantics_nodes_callback != nullptr) {
     platform_dispatch_table_.update_semantics_nodes_callback(std::move(update));
   }
@@ -47,6 +53,15 @@ void PlatformViewEmbedder::UpdateSemantics(
   }
 }
 
+void PlatformViewEmbedder::SetSemanticsEnabled(bool enabled) {
+  if (!enabled) {
+    // The framework discards its semantics tree when semantics are disabled
+    // and sends it in full once they are enabled again.
+    semantics_update_encoder_.Reset();
+  }
+  PlatformView::SetSemanticsEnabled(enabled);
+}
+
 void PlatformViewEmbedder::HandlePlatformMessage(
     fml::RefPtr<flutter::PlatformMessage> message) {
   if (!message) {
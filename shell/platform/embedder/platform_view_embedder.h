@@ -10,6 +10,7 @@
 #include "flutter/fml/macros.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/platform/embedder/embedder.h"
+#include "flutter/shell/platform/embedder/embedder_semantics_update.h"
 #include "flutter/shell/platform/embedder/embedder_surface.h"
 #include "flutter/shell/platform/embedder/embedder_surface_gl.h"
 #include "flutter/shell/platform/embedder/embedder_surface_software.h"
@@ -23,6 +24,8 @@ class PlatformViewEmbedder final : public PlatformView {
       std::function<void(flutter::SemanticsNodeUpdates update)>;
   using UpdateSemanticsCustomActionsCallback =
       std::function<void(flutter::CustomAccessibilityActionUpdates actions)>;
+  using UpdateSemanticsBinaryCallback =
+      std::function<void(const uint8_t* update, size_t size)>;
   using PlatformMessageResponseCallback =
       std::function<void(fml::RefPtr<flutter::PlatformMessage>)>;
 
@@ -33,6 +36,8 @@ class PlatformViewEmbedder final : public PlatformView {
     PlatformMessageResponseCallback
         platform_message_response_callback;             // optional
     VsyncWaiterEmbedder::VsyncCallback vsync_callback;  // optional
+    // Takes precedence over the node and custom action callbacks above.
+    UpdateSemanticsBinaryCallback update_semantics_binary_callback;  // optional
   };
 
   // Creates a platform view that sets up an OpenGL rasterizer.
@@ -59,6 +64,9 @@ class PlatformViewEmbedder final : public PlatformView {
       flutter::SemanticsNodeUpdates update,
       flutter::CustomAccessibilityActionUpdates actions) override;
 
+  // |PlatformView|
+  void SetSemanticsEnabled(bool enabled) override;
+
   // |PlatformView|
   void HandlePlatformMessage(
       fml::RefPtr<flutter::PlatformMessage> message) override;
@@ -66,6 +74,7 @@ class PlatformViewEmbedder final : public PlatformView {
  private:
   std::unique_ptr<EmbedderSurface> embedder_surface_;
   PlatformDispatchTable platform_dispatch_table_;
+  EmbedderSemanticsUpdateEncoder semantics_update_encoder_;
 
   // |PlatformView|
   std::unique_ptr<Surface> CreateRenderingSurface() override;
@@ -243,7 +243,12 @@ UniqueEngine EmbedderConfigBuilder::InitializeEngine() const {
   return SetupEngine(false);
 }
 
-UniqueEngine EmbedderConfigBuilder::SetupEngine(bool run) const {
+UniqueEngine EmbedderConfigBuilder::SpawnEngine(FlutterEngine spawner) const {
+  return SetupEngine(true, spawner);
+}
+
+UniqueEngine EmbedderConfigBuilder::SetupEngine(bool run,
+                                                FlutterEngine spawner) const {
   FlutterEngine engine = nullptr;
   FlutterProjectArgs project_args = project_args_;
 
@@ -264,11 +269,18 @@ UniqueEngine EmbedderConfigBuilder::SetupEngine(bool run) const {
     project_args.command_line_argc = 0;
   }
 
-  auto result =
-      run ? FlutterEngineRun(FLUTTER_ENGINE_VERSION, &renderer_config_,
-                             &project_args, &context_, &engine)
-          : FlutterEngineInitialize(FLUTTER_ENGINE_VERSION, &renderer_config_,
-                                    &project_args, &context_, &engine);
+  FlutterEngineResult result;
+  if (spawner != nullptr) {
+    result = FlutterEngineSpawn(spawner, FLUTTER_ENGINE_VERSION,
+                                &renderer_config_, &project_args, &context_,
+                                &engine);
+  } else if (run) {
+    result = FlutterEngineRun(FLUTTER_ENGINE_VERSION, &renderer_config_,
+                              &project_args, &context_, &engine);
+  } else {
+    result = FlutterEngineInitialize(FLUTTER_ENGINE_VERSION, &renderer_config_,
+                                     &project_args, &context_, &engine);
+  }
 
   if (result != kSuccess) {
     return {};
@@ -0,0 +1,79 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/embedder/embedder_semantics_update.h"
+
+namespace flutter {
+
+// Builds a tree shaped like a long list: a root with |node_count - 1| children
+// that each have a label, a hint and a distinct rect.
+static SemanticsNodeUpdates CreateListTree(int node_count) {
+  SemanticsNodeUpdates update;
+  SemanticsNode& root = update[0];
+  root.id = 0;
+  root.rect = SkRect::MakeWH(1000, 100000);
+  for (int id = 1; id < node_count; id++) {
+    SemanticsNode& node = update[id];
+    node.id = id;
+    node.flags = static_cast<int32_t>(SemanticsFlags::kIsButton);
+    node.actions = static_cast<int32_t>(SemanticsAction::kTap);
+    node.label = "List item " + std::to_string(id);
+    node.hint = "Double tap to open";
+    node.rect = SkRect::MakeXYWH(0, id * 10, 1000, 10);
+    root.childrenInTraversalOrder.push_back(id);
+    root.childrenInHitTestOrder.push_back(id);
+  }
+  return update;
+}
+
+static void BM_SemanticsUpdateEncodeFull(benchmark::State& state) {
+  const auto update = CreateListTree(state.range(0));
+  for (auto _ : state) {
+    EmbedderSemanticsUpdateEncoder encoder;
+    benchmark::DoNotOptimize(encoder.Encode(update, {}));
+  }
+}
+
+// A frame where only a few nodes changed but the framework still sent the
+// whole tree, e.g. when scrolling updates the rects of visible items.
+static void BM_SemanticsUpdateEncodeFewChanged(benchmark::State& state) {
+  auto update = CreateListTree(state.range(0));
+  EmbedderSemanticsUpdateEncoder encoder;
+  encoder.Encode(update, {});
+  int frame = 0;
+  for (auto _ : state) {
+    frame++;
+    for (int id = 1; id <= 20; id++) {
+      update[id].rect.offset(0, frame % 2 ? 1 : -1);
+    }
+    auto encoded = encoder.Encode(update, {});
+    state.counters["Bytes"] = encoded.size();
+    benchmark::DoNotOptimize(encoded);
+  }
+}
+
+static void BM_SemanticsUpdateEncodeUnchanged(benchmark::State& state) {
+  const auto update = CreateListTree(state.range(0));
+  EmbedderSemanticsUpdateEncoder encoder;
+  encoder.Encode(update, {});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(encoder.Encode(update, {}));
+  }
+}
+
+BENCHMARK(BM_SemanticsUpdateEncodeFull)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SemanticsUpdateEncodeFewChanged)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SemanticsUpdateEncodeUnchanged)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
@@ -0,0 +1,198 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cmath>
+#include <cstring>
+
+#include "flutter/shell/platform/embedder/embedder.h"
+#include "flutter/shell/platform/embedder/embedder_semantics_update.h"
+#include "flutter/testing/testing.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// Reads the values written by |EmbedderSemanticsUpdateEncoder| in order.
+class UpdateReader {
+ public:
+  explicit UpdateReader(const std::vector<uint8_t>& data) : data_(data) {}
+
+  template <typename T>
+  T Read() {
+    T value;
+    EXPECT_LE(offset_ + sizeof(T), data_.size());
+    memcpy(&value, data_.data() + offset_, sizeof(T));
+    offset_ += sizeof(T);
+    return value;
+  }
+
+  std::vector<std::string> ReadStringTable() {
+    std::vector<std::string> strings(Read<uint32_t>());
+    for (auto& string : strings) {
+      const uint32_t length = Read<uint32_t>();
+      string.assign(reinterpret_cast<const char*>(data_.data() + offset_),
+                    length);
+      offset_ += length;
+    }
+    return strings;
+  }
+
+  bool AtEnd() const { return offset_ == data_.size(); }
+
+ private:
+  const std::vector<uint8_t>& data_;
+  size_t offset_ = 0;
+};
+
+SemanticsNode CreateNode(int32_t id, const std::string& label) {
+  SemanticsNode node;
+  node.id = id;
+  node.label = label;
+  node.rect = SkRect::MakeLTRB(0, 0, 100, 50);
+  return node;
+}
+
+}  // namespace
+
+TEST(EmbedderSemanticsUpdateEncoderTest, NewNodesAreEncodedInFull) {
+  EmbedderSemanticsUpdateEncoder encoder;
+  SemanticsNodeUpdates update;
+  update[1] = CreateNode(1, "Shared label");
+  update[2] = CreateNode(2, "Shared label");
+
+  auto encoded = encoder.Encode(update, {});
+  UpdateReader reader(encoded);
+  ASSERT_EQ(reader.Read<uint32_t>(), kFlutterSemanticsUpdateFormatVersion);
+
+  // Identical strings are only stored once.
+  auto strings = reader.ReadStringTable();
+  ASSERT_EQ(strings.size(), 2u);
+  EXPECT_TRUE(strings[0] == "Shared label" || strings[1] == "Shared label");
+
+  ASSERT_EQ(reader.Read<uint32_t>(), 2u);
+  for (int i = 0; i < 2; i++) {
+    const int32_t id = reader.Read<int32_t>();
+    EXPECT_TRUE(id == 1 || id == 2);
+    const uint32_t fields = reader.Read<uint32_t>();
+    EXPECT_TRUE(fields & kFlutterSemanticsUpdateFieldLabel);
+    EXPECT_TRUE(fields & kFlutterSemanticsUpdateFieldPlatformViewId);
+    EXPECT_EQ(reader.Read<int32_t>(), 0);  // flags
+    EXPECT_EQ(reader.Read<int32_t>(), 0);  // actions
+    EXPECT_EQ(reader.Read<int32_t>(), -1);  // text selection base
+    EXPECT_EQ(reader.Read<int32_t>(), -1);  // text selection extent
+    EXPECT_EQ(reader.Read<int32_t>(), 0);  // scroll children
+    EXPECT_EQ(reader.Read<int32_t>(), 0);  // scroll index
+    EXPECT_TRUE(std::isnan(reader.Read<double>()));  // scroll position
+    EXPECT_TRUE(std::isnan(reader.Read<double>()));  // scroll extent max
+    EXPECT_TRUE(std::isnan(reader.Read<double>()));  // scroll extent min
+    EXPECT_EQ(reader.Read<double>(), 0.0);  // elevation
+    EXPECT_EQ(reader.Read<double>(), 0.0);  // thickness
+    EXPECT_EQ(strings[reader.Read<uint32_t>()], "Shared label");
+    EXPECT_EQ(strings[reader.Read<uint32_t>()], "");  // hint
+    EXPECT_EQ(strings[reader.Read<uint32_t>()], "");  // value
+    EXPECT_EQ(strings[reader.Read<uint32_t>()], "");  // increased value
+    EXPECT_EQ(strings[reader.Read<uint32_t>()], "");  // decreased value
+    EXPECT_EQ(reader.Read<int32_t>(), 0);  // text direction
+    EXPECT_EQ(reader.Read<double>(), 0.0);
+    EXPECT_EQ(reader.Read<double>(), 0.0);
+    EXPECT_EQ(reader.Read<double>(), 100.0);
+    EXPECT_EQ(reader.Read<double>(), 50.0);
+    const double identity[] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+    for (double value : identity) {
+      EXPECT_EQ(reader.Read<double>(), value);
+    }
+    EXPECT_EQ(reader.Read<uint32_t>(), 0u);  // children
+    EXPECT_EQ(reader.Read<uint32_t>(), 0u);  // custom actions
+    EXPECT_EQ(reader.Read<int64_t>(), -1);  // platform view id
+  }
+  EXPECT_EQ(reader.Read<uint32_t>(), 0u);  // custom actions
+  EXPECT_TRUE(reader.AtEnd());
+}
+
+TEST(EmbedderSemanticsUpdateEncoderTest, OnlyChangedFieldsAreEncoded) {
+  EmbedderSemanticsUpdateEncoder encoder;
+  SemanticsNodeUpdates update;
+  update[1] = CreateNode(1, "Unchanged");
+  update[2] = CreateNode(2, "Before");
+  encoder.Encode(update, {});
+
+  update[2].label = "After";
+  update[2].childrenInTraversalOrder = {1};
+  update[2].childrenInHitTestOrder = {1};
+  CustomAccessibilityActionUpdates actions;
+  actions[7].id = 7;
+  actions[7].label = "After";
+
+  auto encoded = encoder.Encode(update, actions);
+  UpdateReader reader(encoded);
+  ASSERT_EQ(reader.Read<uint32_t>(), kFlutterSemanticsUpdateFormatVersion);
+  auto strings = reader.ReadStringTable();
+  ASSERT_EQ(strings.size(), 2u);
+  ASSERT_EQ(reader.Read<uint32_t>(), 1u);
+  EXPECT_EQ(reader.Read<int32_t>(), 2);
+  EXPECT_EQ(reader.Read<uint32_t>(),
+            static_cast<uint32_t>(kFlutterSemanticsUpdateFieldLabel |
+                                  kFlutterSemanticsUpdateFieldChildren));
+  EXPECT_EQ(strings[reader.Read<uint32_t>()], "After");
+  EXPECT_EQ(reader.Read<uint32_t>(), 1u);
+  EXPECT_EQ(reader.Read<int32_t>(), 1);
+  EXPECT_EQ(reader.Read<int32_t>(), 1);
+
+  ASSERT_EQ(reader.Read<uint32_t>(), 1u);
+  EXPECT_EQ(reader.Read<int32_t>(), 7);
+  EXPECT_EQ(reader.Read<int32_t>(), -1);
+  EXPECT_EQ(strings[reader.Read<uint32_t>()], "After");
+  EXPECT_EQ(strings[reader.Read<uint32_t>()], "");
+  EXPECT_TRUE(reader.AtEnd());
+}
+
+TEST(EmbedderSemanticsUpdateEncoderTest, ResetEncodesNodesInFullAgain) {
+  EmbedderSemanticsUpdateEncoder encoder;
+  SemanticsNodeUpdates update;
+  update[1] = CreateNode(1, "Label");
+  encoder.Encode(update, {});
+
+  {
+    auto encoded = encoder.Encode(update, {});
+    UpdateReader reader(encoded);
+    reader.Read<uint32_t>();
+    EXPECT_EQ(reader.ReadStringTable().size(), 0u);
+    EXPECT_EQ(reader.Read<uint32_t>(), 0u);
+  }
+
+  encoder.Reset();
+  {
+    auto encoded = encoder.Encode(update, {});
+    UpdateReader reader(encoded);
+    reader.Read<uint32_t>();
+    reader.ReadStringTable();
+    EXPECT_EQ(reader.Read<uint32_t>(), 1u);
+  }
+}
+
+TEST(EmbedderSemanticsUpdateEncoderTest, RemovedNodesAreForgotten) {
+  EmbedderSemanticsUpdateEncoder encoder;
+  SemanticsNodeUpdates update;
+  update[0] = CreateNode(0, "Root");
+  update[0].childrenInTraversalOrder = {1};
+  update[0].childrenInHitTestOrder = {1};
+  update[1] = CreateNode(1, "Child");
+  encoder.Encode(update, {});
+
+  // Removing the child from the root forgets it, so adding it back with the
+  // same contents encodes it again alongside the root.
+  SemanticsNodeUpdates removal;
+  removal[0] = CreateNode(0, "Root");
+  encoder.Encode(removal, {});
+
+  auto encoded = encoder.Encode(update, {});
+  UpdateReader reader(encoded);
+  reader.Read<uint32_t>();
+  EXPECT_EQ(reader.ReadStringTable().size(), 1u);
+  EXPECT_EQ(reader.Read<uint32_t>(), 2u);
+}
+
+}  // namespace testing
+}  // namespace flutter
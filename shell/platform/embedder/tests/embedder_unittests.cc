@@ -17,6 +17,8 @@
 #include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/fml/thread.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/fml/trace_recorder.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/platform/embedder/tests/embedder_assertions.h"
 #include "flutter/shell/platform/embedder/tests/embedder_config_builder.h"
@@ -4316,5 +4318,144 @@ TEST_F(EmbedderTest, CanLaunchAndShutdownWithAValidElfSource) {
   engine.reset();
 }
 
+TEST_F(EmbedderTest, CanDumpTraceRecorder) {
+  auto& context = GetEmbedderContext();
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  ASSERT_EQ(FlutterEngineDumpTraceRecorder(nullptr, nullptr, nullptr),
+            kInvalidArguments);
+  ASSERT_EQ(FlutterEngineDumpTraceRecorder(engine.get(), nullptr, nullptr),
+            kInvalidArguments);
+
+  auto& recorder = fml::tracing::TraceRecorder::GetInstance();
+  recorder.SetEnabledCategories({"embedder_test"});
+  {
+    TRACE_EVENT0("embedder_test", "CanDumpTraceRecorderEvent");
+  }
+  recorder.SetEnabledCategories({});
+
+  std::string trace;
+  ASSERT_EQ(FlutterEngineDumpTraceRecorder(
+                engine.get(),
+                [](const char* data, size_t size, void* user_data) {
+                  reinterpret_cast<std::string*>(user_data)->assign(data, size);
+                },
+                &trace),
+            kSuccess);
+  ASSERT_EQ(trace.find("{\"traceEvents\":["), 0u);
+  ASSERT_NE(trace.find("\"name\":\"CanDumpTraceRecorderEvent\","
+                       "\"cat\":\"embedder_test\",\"ph\":\"B\""),
+            std::string::npos);
+  ASSERT_NE(trace.find("\"name\":\"CanDumpTraceRecorderEvent\","
+                       "\"cat\":\"\",\"ph\":\"E\""),
+            std::string::npos);
+  recorder.Clear();
+}
+
+TEST_F(EmbedderTest, CanGetFrameTimingHistogram) {
+  auto& context = GetEmbedderContext();
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  FlutterFrameTimingHistogram histogram = {};
+  ASSERT_EQ(FlutterEngineGetFrameTimingHistogram(
+                engine.get(), kFlutterFrameTimingMetricRaster, &histogram),
+            kInvalidArguments);
+
+  histogram.struct_size = sizeof(FlutterFrameTimingHistogram);
+  ASSERT_EQ(FlutterEngineGetFrameTimingHistogram(
+                engine.get(), static_cast<FlutterFrameTimingMetric>(-1),
+                &histogram),
+            kInvalidArguments);
+  ASSERT_EQ(FlutterEngineGetFrameTimingHistogram(
+                engine.get(), kFlutterFrameTimingMetricRaster, &histogram),
+            kSuccess);
+  ASSERT_LE(histogram.p50, histogram.max);
+
+  // Structs from older headers only have the fields that fit written.
+  FlutterFrameTimingHistogram truncated = {};
+  truncated.struct_size = offsetof(FlutterFrameTimingHistogram, p90);
+  truncated.p90 = -1;
+  truncated.mean = -1;
+  ASSERT_EQ(FlutterEngineGetFrameTimingHistogram(
+                engine.get(), kFlutterFrameTimingMetricRaster, &truncated),
+            kSuccess);
+  ASSERT_EQ(truncated.p90, -1);
+  ASSERT_EQ(truncated.mean, -1);
+}
+
+//------------------------------------------------------------------------------
+/// Test that an engine can be spawned from a running engine and that the
+/// spawned engine runs its own entrypoint.
+///
+TEST_F(EmbedderTest, CanSpawnEngineFromRunningEngine) {
+  auto& context = GetEmbedderContext();
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+
+  // Engines can only be spawned from running engines.
+  auto initialized = builder.InitializeEngine();
+  ASSERT_TRUE(initialized.is_valid());
+  ASSERT_FALSE(builder.SpawnEngine(initialized.get()).is_valid());
+  initialized.reset();
+
+  auto spawner = builder.LaunchEngine();
+  ASSERT_TRUE(spawner.is_valid());
+
+  fml::AutoResetWaitableEvent latch;
+  context.AddNativeCallback(
+      "SignalNativeTest",
+      CREATE_NATIVE_ENTRY([&latch](Dart_NativeArguments args) {
+        latch.Signal();
+      }));
+  builder.SetDartEntrypoint("can_spawn_engine");
+  auto spawned = builder.SpawnEngine(spawner.get());
+  ASSERT_TRUE(spawned.is_valid());
+  latch.Wait();
+
+  spawned.reset();
+  spawner.reset();
+}
+
+//------------------------------------------------------------------------------
+/// Test that a spawned engine keeps running after the engine it was spawned
+/// from is shut down.
+///
+TEST_F(EmbedderTest, SpawnedEngineOutlivesItsSpawner) {
+  auto& context = GetEmbedderContext();
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+
+  auto spawner = builder.LaunchEngine();
+  ASSERT_TRUE(spawner.is_valid());
+
+  fml::AutoResetWaitableEvent latch;
+  context.AddNativeCallback(
+      "SignalNativeTest",
+      CREATE_NATIVE_ENTRY([&latch](Dart_NativeArguments args) {
+        latch.Signal();
+      }));
+  builder.SetDartEntrypoint("can_spawn_engine");
+  auto spawned = builder.SpawnEngine(spawner.get());
+  ASSERT_TRUE(spawned.is_valid());
+  latch.Wait();
+
+  spawner.reset();
+
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(spawned.get(), &event),
+            kSuccess);
+  spawned.reset();
+}
+
 }  // namespace testing
 }  // namespace flutter
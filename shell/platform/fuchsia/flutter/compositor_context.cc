@@ -38,22 +38,28 @@ class ScopedFrame final : public flutter::CompositorContext::ScopedFrame {
       // Preroll the Flutter layer tree. This allows Flutter to perform
       // pre-paint optimizations.
       TRACE_EVENT0("flutter", "Preroll");
+      RecordRasterPhase(flutter::FrameTiming::kPrerollStart);
       layer_tree.Preroll(*this, ignore_raster_cache);
+      RecordRasterPhase(flutter::FrameTiming::kPrerollFinish);
     }
 
     {
       // Traverse the Flutter layer tree so that the necessary session ops to
       // represent the frame are enqueued in the underlying session.
       TRACE_EVENT0("flutter", "UpdateScene");
+      RecordRasterPhase(flutter::FrameTiming::kPaintStart);
       layer_tree.UpdateScene(session_connection_.scene_update_context(),
                              session_connection_.root_node());
+      RecordRasterPhase(flutter::FrameTiming::kPaintFinish);
     }
 
     {
       // Flush all pending session ops.
       TRACE_EVENT0("flutter", "SessionPresent");
 
+      RecordRasterPhase(flutter::FrameTiming::kPresentStart);
       session_connection_.Present(this);
+      RecordRasterPhase(flutter::FrameTiming::kPresentFinish);
     }
 
     return flutter::RasterStatus::kSuccess;
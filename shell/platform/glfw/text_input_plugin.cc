@@ -19,11 +19,14 @@ static constexpr char kMultilineInputType[] = "TextInputType.multiline";
 
 static constexpr char kUpdateEditingStateMethod[] =
     "TextInputClient.updateEditingState";
+static constexpr char kUpdateEditingStateWithDeltasMethod[] =
+    "TextInputClient.updateEditingStateWithDeltas";
 static constexpr char kPerformActionMethod[] = "TextInputClient.performAction";
 
 static constexpr char kTextInputAction[] = "inputAction";
 static constexpr char kTextInputType[] = "inputType";
 static constexpr char kTextInputTypeName[] = "name";
+static constexpr char kEnableDeltaModel[] = "enableDeltaModel";
 static constexpr char kComposingBaseKey[] = "composingBase";
 static constexpr char kComposingExtentKey[] = "composingExtent";
 static constexpr char kSelectionAffinityKey[] = "selectionAffinity";
@@ -32,6 +35,10 @@ static constexpr char kSelectionBaseKey[] = "selectionBase";
 static constexpr char kSelectionExtentKey[] = "selectionExtent";
 static constexpr char kSelectionIsDirectionalKey[] = "selectionIsDirectional";
 static constexpr char kTextKey[] = "text";
+static constexpr char kDeltasKey[] = "deltas";
+static constexpr char kDeltaTextKey[] = "deltaText";
+static constexpr char kDeltaStartKey[] = "deltaStart";
+static constexpr char kDeltaEndKey[] = "deltaEnd";
 
 static constexpr char kChannelName[] = "flutter/textinput";
 
@@ -46,7 +53,7 @@ void TextInputPlugin::CharHook(GLFWwindow* window, unsigned int code_point) {
     return;
   }
   active_model_->AddCodePoint(code_point);
-  SendStateUpdate(*active_model_);
+  SendStateUpdate(active_model_.get());
 }
 
 void TextInputPlugin::KeyboardHook(GLFWwindow* window,
@@ -61,30 +68,30 @@ void TextInputPlugin::KeyboardHook(GLFWwindow* window,
     switch (key) {
       case GLFW_KEY_LEFT:
         if (active_model_->MoveCursorBack()) {
-          SendStateUpdate(*active_model_);
+          SendStateUpdate(active_model_.get());
         }
         break;
       case GLFW_KEY_RIGHT:
         if (active_model_->MoveCursorForward()) {
-          SendStateUpdate(*active_model_);
+          SendStateUpdate(active_model_.get());
         }
         break;
       case GLFW_KEY_END:
         active_model_->MoveCursorToEnd();
-        SendStateUpdate(*active_model_);
+        SendStateUpdate(active_model_.get());
         break;
       case GLFW_KEY_HOME:
         active_model_->MoveCursorToBeginning();
-        SendStateUpdate(*active_model_);
+        SendStateUpdate(active_model_.get());
         break;
       case GLFW_KEY_BACKSPACE:
         if (active_model_->Backspace()) {
-          SendStateUpdate(*active_model_);
+          SendStateUpdate(active_model_.get());
         }
         break;
       case GLFW_KEY_DELETE:
         if (active_model_->Delete()) {
-          SendStateUpdate(*active_model_);
+          SendStateUpdate(active_model_.get());
         }
         break;
       case GLFW_KEY_ENTER:
@@ -158,6 +165,11 @@ void TextInputPlugin::HandleMethodCall(
         input_type = input_type_json->value.GetString();
       }
     }
+    auto enable_delta_model_json = client_config.FindMember(kEnableDeltaModel);
+    delta_model_enabled_ =
+        enable_delta_model_json != client_config.MemberEnd() &&
+        enable_delta_model_json->value.IsBool() &&
+        enable_delta_model_json->value.GetBool();
     active_model_ = std::make_unique<TextInputModel>(input_type, input_action);
   } else if (method.compare(kSetEditingStateMethod) == 0) {
     if (!method_call.arguments() || method_call.arguments()->IsNull()) {
@@ -199,7 +211,7 @@ void TextInputPlugin::HandleMethodCall(
   result->Success();
 }
 
-void TextInputPlugin::SendStateUpdate(const TextInputModel& model) {
+void TextInputPlugin::SendStateUpdate(TextInputModel* model) {
   auto args = std::make_unique<rapidjson::Document>(rapidjson::kArrayType);
   auto& allocator = args->GetAllocator();
   args->PushBack(client_id_, allocator);
@@ -209,21 +221,50 @@ void TextInputPlugin::SendStateUpdate(const TextInputModel& model) {
   editing_state.AddMember(kComposingExtentKey, -1, allocator);
   editing_state.AddMember(kSelectionAffinityKey, kAffinityDownstream,
                           allocator);
-  editing_state.AddMember(kSelectionBaseKey, model.selection_base(), allocator);
-  editing_state.AddMember(kSelectionExtentKey, model.selection_extent(),
+  editing_state.AddMember(kSelectionBaseKey, model->selection_base(),
+                          allocator);
+  editing_state.AddMember(kSelectionExtentKey, model->selection_extent(),
                           allocator);
   editing_state.AddMember(kSelectionIsDirectionalKey, false, allocator);
+
+  if (!delta_model_enabled_) {
+    editing_state.AddMember(
+        kTextKey, rapidjson::Value(model->GetText(), allocator).Move(),
+        allocator);
+    args->PushBack(editing_state, allocator);
+    model->ClearTextChange();
+    channel_->InvokeMethod(kUpdateEditingStateMethod, std::move(args));
+    return;
+  }
+
+  // A delta without a text change only updates the selection.
+  int delta_start = -1;
+  int delta_end = -1;
+  std::string delta_text;
+  if (model->has_text_change()) {
+    const auto& change = model->text_change();
+    delta_start = static_cast<int>(change.start);
+    delta_end = static_cast<int>(change.old_end);
+    delta_text = model->GetTextRange(change.start, change.new_end);
+  }
+  editing_state.AddMember(kDeltaStartKey, delta_start, allocator);
+  editing_state.AddMember(kDeltaEndKey, delta_end, allocator);
   editing_state.AddMember(
-      kTextKey, rapidjson::Value(model.GetText(), allocator).Move(), allocator);
-  args->PushBack(editing_state, allocator);
+      kDeltaTextKey, rapidjson::Value(delta_text, allocator).Move(), allocator);
+  rapidjson::Value deltas(rapidjson::kArrayType);
+  deltas.PushBack(editing_state, allocator);
+  rapidjson::Value update(rapidjson::kObjectType);
+  update.AddMember(kDeltasKey, deltas, allocator);
+  args->PushBack(update, allocator);
+  model->ClearTextChange();
 
-  channel_->InvokeMethod(kUpdateEditingStateMethod, std::move(args));
+  channel_->InvokeMethod(kUpdateEditingStateWithDeltasMethod, std::move(args));
 }
 
 void TextInputPlugin::EnterPressed(TextInputModel* model) {
   if (model->input_type() == kMultilineInputType) {
     model->AddCodePoint('\n');
-    SendStateUpdate(*model);
+    SendStateUpdate(model);
   }
   auto args = std::make_unique<rapidjson::Document>(rapidjson::kArrayType);
   auto& allocator = args->GetAllocator();
@@ -4,6 +4,7 @@
 
 #include "flutter/shell/platform/linux/public/flutter_linux/fl_standard_message_codec.h"
 #include "flutter/shell/platform/linux/fl_standard_message_codec_private.h"
+#include "flutter/shell/platform/linux/fl_value_private.h"
 
 #include <gmodule.h>
 
@@ -128,14 +129,15 @@ static gboolean read_uint32(GBytes* buffer,
 // Reads a #FL_VALUE_TYPE_INT stored as a signed 32 bit integer from @buffer.
 // Returns a new #FlValue of type #FL_VALUE_TYPE_INT if successful or %NULL on
 // error.
-static FlValue* read_int32_value(GBytes* buffer,
+static FlValue* read_int32_value(FlValueArena* arena,
+                                 GBytes* buffer,
                                  size_t* offset,
                                  GError** error) {
   if (!check_size(buffer, *offset, sizeof(int32_t), error))
     return nullptr;
 
-  FlValue* value = fl_value_new_int(
-      reinterpret_cast<const int32_t*>(get_data(buffer, offset))[0]);
+  FlValue* value = fl_value_arena_new_int(
+      arena, reinterpret_cast<const int32_t*>(get_data(buffer, offset))[0]);
   *offset += sizeof(int32_t);
   return value;
 }
@@ -143,14 +145,15 @@ static FlValue* read_int32_value(GBytes* buffer,
 // Reads a #FL_VALUE_TYPE_INT stored as a signed 64 bit integer from @buffer.
 // Returns a new #FlValue of type #FL_VALUE_TYPE_INT if successful or %NULL on
 // error.
-static FlValue* read_int64_value(GBytes* buffer,
+static FlValue* read_int64_value(FlValueArena* arena,
+                                 GBytes* buffer,
                                  size_t* offset,
                                  GError** error) {
   if (!check_size(buffer, *offset, sizeof(int64_t), error))
     return nullptr;
 
-  FlValue* value = fl_value_new_int(
-      reinterpret_cast<const int64_t*>(get_data(buffer, offset))[0]);
+  FlValue* value = fl_value_arena_new_int(
+      arena, reinterpret_cast<const int64_t*>(get_data(buffer, offset))[0]);
   *offset += sizeof(int64_t);
   return value;
 }
@@ -158,14 +161,15 @@ static FlValue* read_int64_value(GBytes* buffer,
 // Reads a 64 bit floating point number from @buffer and writes it to @value.
 // Returns a new #FlValue of type #FL_VALUE_TYPE_FLOAT if successful or %NULL on
 // error.
-static FlValue* read_float64_value(GBytes* buffer,
+static FlValue* read_float64_value(FlValueArena* arena,
+                                   GBytes* buffer,
                                    size_t* offset,
                                    GError** error) {
   if (!check_size(buffer, *offset, sizeof(double), error))
     return nullptr;
 
-  FlValue* value = fl_value_new_float(
-      reinterpret_cast<const double*>(get_data(buffer, offset))[0]);
+  FlValue* value = fl_value_arena_new_float(
+      arena, reinterpret_cast<const double*>(get_data(buffer, offset))[0]);
   *offset += sizeof(double);
   return value;
 }
@@ -174,6 +178,7 @@ static FlValue* read_float64_value(GBytes* buffer,
 // Returns a new #FlValue of type #FL_VALUE_TYPE_STRING if successful or %NULL
 // on error.
 static FlValue* read_string_value(FlStandardMessageCodec* self,
+                                  FlValueArena* arena,
                                   GBytes* buffer,
                                   size_t* offset,
                                   GError** error) {
@@ -183,8 +188,8 @@ static FlValue* read_string_value(FlStandardMessageCodec* self,
     return nullptr;
   if (!check_size(buffer, *offset, length, error))
     return nullptr;
-  FlValue* value = fl_value_new_string_sized(
-      reinterpret_cast<const gchar*>(get_data(buffer, offset)), length);
+  FlValue* value = fl_value_arena_new_string_sized(
+      arena, reinterpret_cast<const gchar*>(get_data(buffer, offset)), length);
   *offset += length;
   return value;
 }
@@ -193,6 +198,7 @@ static FlValue* read_string_value(FlStandardMessageCodec* self,
 // Returns a new #FlValue of type #FL_VALUE_TYPE_UINT8_LIST if successful or
 // %NULL on error.
 static FlValue* read_uint8_list_value(FlStandardMessageCodec* self,
+                                      FlValueArena* arena,
                                       GBytes* buffer,
                                       size_t* offset,
                                       GError** error) {
@@ -202,7 +208,8 @@ static FlValue* read_uint8_list_value(FlStandardMessageCodec* self,
     return nullptr;
   if (!check_size(buffer, *offset, sizeof(uint8_t) * length, error))
     return nullptr;
-  FlValue* value = fl_value_new_uint8_list(get_data(buffer, offset), length);
+  FlValue* value = fl_value_arena_new_typed_list(
+      arena, FL_VALUE_TYPE_UINT8_LIST, get_data(buffer, offset), length);
   *offset += length;
   return value;
 }
@@ -211,6 +218,7 @@ static FlValue* read_uint8_list_value(FlStandardMessageCodec* self,
 // Returns a new #FlValue of type #FL_VALUE_TYPE_INT32_LIST if successful or
 // %NULL on error.
 static FlValue* read_int32_list_value(FlStandardMessageCodec* self,
+                                      FlValueArena* arena,
                                       GBytes* buffer,
                                       size_t* offset,
                                       GError** error) {
@@ -220,8 +228,8 @@ static FlValue* read_int32_list_value(FlStandardMessageCodec* self,
     return nullptr;
   if (!check_size(buffer, *offset, sizeof(int32_t) * length, error))
     return nullptr;
-  FlValue* value = fl_value_new_int32_list(
-      reinterpret_cast<const int32_t*>(get_data(buffer, offset)), length);
+  FlValue* value = fl_value_arena_new_typed_list(
+      arena, FL_VALUE_TYPE_INT32_LIST, get_data(buffer, offset), length);
   *offset += sizeof(int32_t) * length;
   return value;
 }
@@ -230,6 +238,7 @@ static FlValue* read_int32_list_value(FlStandardMessageCodec* self,
 // Returns a new #FlValue of type #FL_VALUE_TYPE_INT64_LIST if successful or
 // %NULL on error.
 static FlValue* read_int64_list_value(FlStandardMessageCodec* self,
+                                      FlValueArena* arena,
                                       GBytes* buffer,
                                       size_t* offset,
                                       GError** error) {
@@ -239,8 +248,8 @@ static FlValue* read_int64_list_value(FlStandardMessageCodec* self,
     return nullptr;
   if (!check_size(buffer, *offset, sizeof(int64_t) * length, error))
     return nullptr;
-  FlValue* value = fl_value_new_int64_list(
-      reinterpret_cast<const int64_t*>(get_data(buffer, offset)), length);
+  FlValue* value = fl_value_arena_new_typed_list(
+      arena, FL_VALUE_TYPE_INT64_LIST, get_data(buffer, offset), length);
   *offset += sizeof(int64_t) * length;
   return value;
 }
@@ -249,6 +258,7 @@ static FlValue* read_int64_list_value(FlStandardMessageCodec* self,
 // Returns a new #FlValue of type #FL_VALUE_TYPE_FLOAT_LIST if successful or
 // %NULL on error.
 static FlValue* read_float64_list_value(FlStandardMessageCodec* self,
+                                        FlValueArena* arena,
                                         GBytes* buffer,
                                         size_t* offset,
                                         GError** error) {
@@ -258,8 +268,8 @@ static FlValue* read_float64_list_value(FlStandardMessageCodec* self,
     return nullptr;
   if (!check_size(buffer, *offset, sizeof(double) * length, error))
     return nullptr;
-  FlValue* value = fl_value_new_float_list(
-      reinterpret_cast<const double*>(get_data(buffer, offset)), length);
+  FlValue* value = fl_value_arena_new_typed_list(
+      arena, FL_VALUE_TYPE_FLOAT_LIST, get_data(buffer, offset), length);
   *offset += sizeof(double) * length;
   return value;
 }
@@ -268,6 +278,7 @@ static FlValue* read_float64_list_value(FlStandardMessageCodec* self,
 // Returns a new #FlValue of type #FL_VALUE_TYPE_LIST if successful or %NULL on
 // error.
 static FlValue* read_list_value(FlStandardMessageCodec* self,
+                                FlValueArena* arena,
                                 GBytes* buffer,
                                 size_t* offset,
                                 GError** error) {
@@ -276,13 +287,15 @@ static FlValue* read_list_value(FlStandardMessageCodec* self,
                                            error))
     return nullptr;
 
-  g_autoptr(FlValue) list = fl_value_new_list();
+  // Don't trust the length before the values have been read.
+  g_autoptr(FlValue) list = fl_value_arena_new_list(
+      arena, MIN(length, g_bytes_get_size(buffer) - *offset));
   for (size_t i = 0; i < length; i++) {
-    g_autoptr(FlValue) child =
-        fl_standard_message_codec_read_value(self, buffer, offset, error);
+    FlValue* child = fl_standard_message_codec_read_value(self, arena, buffer,
+                                                          offset, error);
     if (child == nullptr)
       return nullptr;
-    fl_value_append(list, child);
+    fl_value_append_take(list, child);
   }
 
   return fl_value_ref(list);
@@ -292,6 +305,7 @@ static FlValue* read_list_value(FlStandardMessageCodec* self,
 // Returns a new #FlValue of type #FL_VALUE_TYPE_MAP if successful or %NULL on
 // error.
 static FlValue* read_map_value(FlStandardMessageCodec* self,
+                               FlValueArena* arena,
                                GBytes* buffer,
                                size_t* offset,
                                GError** error) {
@@ -300,17 +314,20 @@ static FlValue* read_map_value(FlStandardMessageCodec* self,
                                            error))
     return nullptr;
 
-  g_autoptr(FlValue) map = fl_value_new_map();
+  // Don't trust the length before the entries have been read.
+  g_autoptr(FlValue) map = fl_value_arena_new_map(
+      arena, MIN(length, g_bytes_get_size(buffer) - *offset));
   for (size_t i = 0; i < length; i++) {
-    g_autoptr(FlValue) key =
-        fl_standard_message_codec_read_value(self, buffer, offset, error);
+    g_autoptr(FlValue) key = fl_standard_message_codec_read_value(
+        self, arena, buffer, offset, error);
     if (key == nullptr)
       return nullptr;
-    g_autoptr(FlValue) value =
-        fl_standard_message_codec_read_value(self, buffer, offset, error);
+    FlValue* value = fl_standard_message_codec_read_value(self, arena, buffer,
+                                                          offset, error);
     if (value == nullptr)
       return nullptr;
-    fl_value_set(map, key, value);
+    fl_value_arena_map_append_take(
+        map, static_cast<FlValue*>(g_steal_pointer(&key)), value);
   }
 
   return fl_value_ref(map);
@@ -338,8 +355,9 @@ static FlValue* fl_standard_message_codec_decode_message(FlMessageCodec* codec,
       reinterpret_cast<FlStandardMessageCodec*>(codec);
 
   size_t offset = 0;
-  g_autoptr(FlValue) value =
-      fl_standard_message_codec_read_value(self, message, &offset, error);
+  g_autoptr(FlValueArena) arena = fl_value_arena_new(message);
+  g_autoptr(FlValue) value = fl_standard_message_codec_read_value(
+      self, arena, message, &offset, error);
   if (value == nullptr)
     return nullptr;
 
@@ -518,6 +536,7 @@ gboolean fl_standard_message_codec_write_value(FlStandardMessageCodec* self,
 }
 
 FlValue* fl_standard_message_codec_read_value(FlStandardMessageCodec* self,
+                                              FlValueArena* arena,
                                               GBytes* buffer,
                                               size_t* offset,
                                               GError** error) {
@@ -527,31 +546,31 @@ FlValue* fl_standard_message_codec_read_value(FlStandardMessageCodec* self,
 
   g_autoptr(FlValue) value = nullptr;
   if (type == kValueNull)
-    return fl_value_new_null();
+    return fl_value_arena_new_null(arena);
   else if (type == kValueTrue)
-    return fl_value_new_bool(TRUE);
+    return fl_value_arena_new_bool(arena, TRUE);
   else if (type == kValueFalse)
-    return fl_value_new_bool(FALSE);
+    return fl_value_arena_new_bool(arena, FALSE);
   else if (type == kValueInt32)
-    value = read_int32_value(buffer, offset, error);
+    value = read_int32_value(arena, buffer, offset, error);
   else if (type == kValueInt64)
-    value = read_int64_value(buffer, offset, error);
+    value = read_int64_value(arena, buffer, offset, error);
   else if (type == kValueFloat64)
-    value = read_float64_value(buffer, offset, error);
+    value = read_float64_value(arena, buffer, offset, error);
   else if (type == kValueString)
-    value = read_string_value(self, buffer, offset, error);
+    value = read_string_value(self, arena, buffer, offset, error);
   else if (type == kValueUint8List)
-    value = read_uint8_list_value(self, buffer, offset, error);
+    value = read_uint8_list_value(self, arena, buffer, offset, error);
   else if (type == kValueInt32List)
-    value = read_int32_list_value(self, buffer, offset, error);
+    value = read_int32_list_value(self, arena, buffer, offset, error);
   else if (type == kValueInt64List)
-    value = read_int64_list_value(self, buffer, offset, error);
+    value = read_int64_list_value(self, arena, buffer, offset, error);
   else if (type == kValueFloat64List)
-    value = read_float64_list_value(self, buffer, offset, error);
+    value = read_float64_list_value(self, arena, buffer, offset, error);
   else if (type == kValueList)
-    value = read_list_value(self, buffer, offset, error);
+    value = read_list_value(self, arena, buffer, offset, error);
   else if (type == kValueMap)
-    value = read_map_value(self, buffer, offset, error);
+    value = read_map_value(self, arena, buffer, offset, error);
   else {
     g_set_error(error, FL_MESSAGE_CODEC_ERROR,
                 FL_MESSAGE_CODEC_ERROR_UNSUPPORTED_TYPE,
@@ -0,0 +1,83 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/linux/public/flutter_linux/fl_standard_message_codec.h"
+
+namespace {
+
+FlValue* make_map(size_t count) {
+  FlValue* map = fl_value_new_map();
+  for (size_t i = 0; i < count; i++) {
+    g_autofree gchar* key = g_strdup_printf("key_%zu", i);
+    fl_value_set_string_take(map, key, fl_value_new_int(i));
+  }
+  return map;
+}
+
+FlValue* make_string_list(size_t count) {
+  FlValue* list = fl_value_new_list();
+  for (size_t i = 0; i < count; i++) {
+    fl_value_append_take(list,
+                         fl_value_new_string("TextInput.setEditingState"));
+  }
+  return list;
+}
+
+FlValue* make_uint8_list(size_t count) {
+  g_autofree uint8_t* data = static_cast<uint8_t*>(g_malloc0(count));
+  return fl_value_new_uint8_list(data, count);
+}
+
+GBytes* encode(FlStandardMessageCodec* codec, FlValue* value) {
+  g_autoptr(GError) error = nullptr;
+  return fl_message_codec_encode_message(FL_MESSAGE_CODEC(codec), value,
+                                         &error);
+}
+
+void decode(benchmark::State& state, FlValue* (*make)(size_t)) {
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+  g_autoptr(FlValue) value = make(state.range(0));
+  g_autoptr(GBytes) message = encode(codec, value);
+  while (state.KeepRunning()) {
+    g_autoptr(GError) error = nullptr;
+    g_autoptr(FlValue) decoded = fl_message_codec_decode_message(
+        FL_MESSAGE_CODEC(codec), message, &error);
+    benchmark::DoNotOptimize(decoded);
+  }
+  state.SetBytesProcessed(state.iterations() * g_bytes_get_size(message));
+}
+
+void encode(benchmark::State& state, FlValue* (*make)(size_t)) {
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+  g_autoptr(FlValue) value = make(state.range(0));
+  while (state.KeepRunning()) {
+    g_autoptr(GBytes) message = encode(codec, value);
+    benchmark::DoNotOptimize(message);
+  }
+}
+
+}  // namespace
+
+static void BM_FlStandardMessageCodecDecodeMap(benchmark::State& state) {
+  decode(state, make_map);
+}
+
+static void BM_FlStandardMessageCodecEncodeMap(benchmark::State& state) {
+  encode(state, make_map);
+}
+
+static void BM_FlStandardMessageCodecDecodeStringList(
+    benchmark::State& state) {
+  decode(state, make_string_list);
+}
+
+static void BM_FlStandardMessageCodecDecodeUint8List(benchmark::State& state) {
+  decode(state, make_uint8_list);
+}
+
+BENCHMARK(BM_FlStandardMessageCodecDecodeMap)->Range(8, 1 << 12);
+BENCHMARK(BM_FlStandardMessageCodecEncodeMap)->Range(8, 1 << 12);
+BENCHMARK(BM_FlStandardMessageCodecDecodeStringList)->Range(8, 1 << 12);
+BENCHMARK(BM_FlStandardMessageCodecDecodeUint8List)->Range(8, 1 << 16);
@@ -1030,3 +1030,35 @@ TEST(FlStandardMessageCodecTest, EncodeDecode) {
 
   ASSERT_TRUE(fl_value_equal(input, output));
 }
+
+TEST(FlStandardMessageCodecTest, DecodeChildOutlivesList) {
+  g_autoptr(FlValue) list = decode_message("0c02070568656c6c6f0803010203");
+  ASSERT_EQ(fl_value_get_type(list), FL_VALUE_TYPE_LIST);
+  ASSERT_EQ(fl_value_get_length(list), static_cast<size_t>(2));
+
+  g_autoptr(FlValue) string = fl_value_ref(fl_value_get_list_value(list, 0));
+  g_autoptr(FlValue) bytes = fl_value_ref(fl_value_get_list_value(list, 1));
+  g_clear_pointer(&list, fl_value_unref);
+
+  ASSERT_EQ(fl_value_get_type(string), FL_VALUE_TYPE_STRING);
+  EXPECT_STREQ(fl_value_get_string(string), "hello");
+  ASSERT_EQ(fl_value_get_type(bytes), FL_VALUE_TYPE_UINT8_LIST);
+  ASSERT_EQ(fl_value_get_length(bytes), static_cast<size_t>(3));
+  EXPECT_EQ(fl_value_get_uint8_list(bytes)[0], 1);
+  EXPECT_EQ(fl_value_get_uint8_list(bytes)[2], 3);
+}
+
+TEST(FlStandardMessageCodecTest, DecodeUint8ListReferencesMessage) {
+  g_autoptr(FlStandardMessageCodec) codec = fl_standard_message_codec_new();
+  g_autoptr(GBytes) message = hex_string_to_bytes("08050001020304");
+  g_autoptr(GError) error = nullptr;
+  g_autoptr(FlValue) value =
+      fl_message_codec_decode_message(FL_MESSAGE_CODEC(codec), message, &error);
+  EXPECT_EQ(error, nullptr);
+  ASSERT_NE(value, nullptr);
+  ASSERT_EQ(fl_value_get_type(value), FL_VALUE_TYPE_UINT8_LIST);
+
+  const uint8_t* data =
+      static_cast<const uint8_t*>(g_bytes_get_data(message, nullptr));
+  EXPECT_EQ(fl_value_get_uint8_list(value), data + 2);
+}
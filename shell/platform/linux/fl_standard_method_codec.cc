@@ -63,8 +63,9 @@ static gboolean fl_standard_method_codec_decode_method_call(
   FlStandardMethodCodec* self = FL_STANDARD_METHOD_CODEC(codec);
 
   size_t offset = 0;
+  g_autoptr(FlValueArena) arena = fl_value_arena_new(message);
   g_autoptr(FlValue) name_value = fl_standard_message_codec_read_value(
-      self->codec, message, &offset, error);
+      self->codec, arena, message, &offset, error);
   if (name_value == nullptr)
     return FALSE;
   if (fl_value_get_type(name_value) != FL_VALUE_TYPE_STRING) {
@@ -74,7 +75,7 @@ static gboolean fl_standard_method_codec_decode_method_call(
   }
 
   g_autoptr(FlValue) args_value = fl_standard_message_codec_read_value(
-      self->codec, message, &offset, error);
+      self->codec, arena, message, &offset, error);
   if (args_value == nullptr)
     return FALSE;
 
@@ -155,11 +156,12 @@ static FlMethodResponse* fl_standard_method_codec_decode_response(
       static_cast<const guint8*>(g_bytes_get_data(message, nullptr));
   guint8 type = data[0];
   size_t offset = 1;
+  g_autoptr(FlValueArena) arena = fl_value_arena_new(message);
 
   g_autoptr(FlMethodResponse) response = nullptr;
   if (type == kEnvelopeTypeError) {
     g_autoptr(FlValue) code = fl_standard_message_codec_read_value(
-        self->codec, message, &offset, error);
+        self->codec, arena, message, &offset, error);
     if (code == nullptr)
       return nullptr;
     if (fl_value_get_type(code) != FL_VALUE_TYPE_STRING) {
@@ -169,7 +171,7 @@ static FlMethodResponse* fl_standard_method_codec_decode_response(
     }
 
     g_autoptr(FlValue) error_message = fl_standard_message_codec_read_value(
-        self->codec, message, &offset, error);
+        self->codec, arena, message, &offset, error);
     if (error_message == nullptr)
       return nullptr;
     if (fl_value_get_type(error_message) != FL_VALUE_TYPE_STRING &&
@@ -180,7 +182,7 @@ static FlMethodResponse* fl_standard_method_codec_decode_response(
     }
 
     g_autoptr(FlValue) details = fl_standard_message_codec_read_value(
-        self->codec, message, &offset, error);
+        self->codec, arena, message, &offset, error);
     if (details == nullptr)
       return nullptr;
 
@@ -192,7 +194,7 @@ static FlMethodResponse* fl_standard_method_codec_decode_response(
         fl_value_get_type(details) != FL_VALUE_TYPE_NULL ? details : nullptr));
   } else if (type == kEnvelopeTypeSuccess) {
     g_autoptr(FlValue) result = fl_standard_message_codec_read_value(
-        self->codec, message, &offset, error);
+        self->codec, arena, message, &offset, error);
 
     if (result == nullptr)
       return nullptr;
@@ -6,9 +6,51 @@
 
 #include <gmodule.h>
 
+#include "flutter/shell/platform/linux/fl_value_private.h"
+
+// The size of the blocks arenas allocate values from.
+static constexpr size_t kArenaBlockSize = 4096;
+
+// Allocations at least this large get their own block in an arena.
+static constexpr size_t kArenaLargeAllocationSize = kArenaBlockSize / 4;
+
+// The alignment of every allocation in an arena.
+static constexpr size_t kArenaAlignment = 8;
+
 struct _FlValue {
   FlValueType type;
+  // Unused if the value is in an arena, as the arena is reference counted
+  // instead.
   int ref_count;
+  // The arena this value was allocated from, or %NULL if allocated alone.
+  FlValueArena* arena;
+};
+
+// A block of memory in an arena, which is followed by the memory values are
+// allocated from.
+typedef struct _FlValueArenaBlock {
+  struct _FlValueArenaBlock* next;
+  size_t size;
+} FlValueArenaBlock;
+
+struct _FlValueArena {
+  int ref_count;
+
+  // TRUE while the arena is being freed.
+  bool destroying;
+
+  // The message typed lists in this arena may refer to.
+  GBytes* bytes;
+
+  // The lists and maps in this arena, whose arrays are freed with it.
+  GPtrArray* containers;
+
+  // Blocks values are allocated from. The first block is the one currently
+  // being allocated from.
+  FlValueArenaBlock* blocks;
+
+  // Bytes allocated from the first block.
+  size_t block_used;
 };
 
 typedef struct {
@@ -78,6 +120,75 @@ static void fl_value_destroy(gpointer value) {
   fl_value_unref(static_cast<FlValue*>(value));
 }
 
+// Allocates @size bytes from @arena.
+static gpointer fl_value_arena_alloc(FlValueArena* arena, size_t size) {
+  size = (size + kArenaAlignment - 1) & ~(kArenaAlignment - 1);
+
+  // Give large allocations their own block, after the current one so that
+  // the rest of the current block can still be used.
+  if (size >= kArenaLargeAllocationSize) {
+    FlValueArenaBlock* block = static_cast<FlValueArenaBlock*>(
+        g_malloc(sizeof(FlValueArenaBlock) + size));
+    block->size = size;
+    if (arena->blocks == nullptr) {
+      block->next = nullptr;
+      arena->blocks = block;
+      arena->block_used = size;
+    } else {
+      block->next = arena->blocks->next;
+      arena->blocks->next = block;
+    }
+    return block + 1;
+  }
+
+  if (arena->blocks == nullptr ||
+      arena->block_used + size > arena->blocks->size) {
+    FlValueArenaBlock* block = static_cast<FlValueArenaBlock*>(
+        g_malloc(sizeof(FlValueArenaBlock) + kArenaBlockSize));
+    block->size = kArenaBlockSize;
+    block->next = arena->blocks;
+    arena->blocks = block;
+    arena->block_used = 0;
+  }
+
+  gpointer data =
+      reinterpret_cast<uint8_t*>(arena->blocks + 1) + arena->block_used;
+  arena->block_used += size;
+  return data;
+}
+
+// Creates a value in @arena, which holds a reference to @arena.
+static FlValue* fl_value_arena_new_value(FlValueArena* arena,
+                                         FlValueType type,
+                                         size_t size) {
+  FlValue* self = static_cast<FlValue*>(fl_value_arena_alloc(arena, size));
+  memset(self, 0, size);
+  self->type = type;
+  self->arena = fl_value_arena_ref(arena);
+  return self;
+}
+
+// Returns TRUE if @container holds a reference to @value.
+static bool fl_value_holds_reference(FlValue* container, FlValue* value) {
+  // A reference from a value to another in the same arena would keep the
+  // arena alive forever.
+  return value->arena == nullptr || value->arena != container->arena;
+}
+
+// Takes ownership of a reference to @value, which is being added to
+// @container.
+static void fl_value_adopt(FlValue* container, FlValue* value) {
+  if (!fl_value_holds_reference(container, value))
+    fl_value_arena_unref(value->arena);
+}
+
+// Drops the reference @container holds to @value, which has been removed
+// from it.
+static void fl_value_release(FlValue* container, FlValue* value) {
+  if (fl_value_holds_reference(container, value))
+    fl_value_unref(value);
+}
+
 // Finds the index of a key in a FlValueMap.
 // FIXME(robert-ancell) This is highly inefficient, and should be optimised if
 // necessary.
@@ -204,14 +315,193 @@ G_MODULE_EXPORT FlValue* fl_value_new_map() {
   return reinterpret_cast<FlValue*>(self);
 }
 
+// Creates a typed list in @arena of elements of type T.
+template <typename List, typename T>
+static FlValue* fl_value_arena_new_list_of(FlValueArena* arena,
+                                           FlValueType type,
+                                           const uint8_t* data,
+                                           size_t data_length) {
+  List* self = reinterpret_cast<List*>(
+      fl_value_arena_new_value(arena, type, sizeof(List)));
+  self->values_length = data_length;
+  if (reinterpret_cast<uintptr_t>(data) % alignof(T) == 0) {
+    self->values = reinterpret_cast<T*>(const_cast<uint8_t*>(data));
+  } else {
+    self->values =
+        static_cast<T*>(fl_value_arena_alloc(arena, sizeof(T) * data_length));
+    memcpy(self->values, data, sizeof(T) * data_length);
+  }
+  return reinterpret_cast<FlValue*>(self);
+}
+
+FlValueArena* fl_value_arena_new(GBytes* bytes) {
+  FlValueArena* self = g_new0(FlValueArena, 1);
+  self->ref_count = 1;
+  self->bytes = bytes != nullptr ? g_bytes_ref(bytes) : nullptr;
+  self->containers = g_ptr_array_new();
+  return self;
+}
+
+FlValueArena* fl_value_arena_ref(FlValueArena* self) {
+  g_return_val_if_fail(self != nullptr, nullptr);
+  self->ref_count++;
+  return self;
+}
+
+void fl_value_arena_unref(FlValueArena* self) {
+  g_return_if_fail(self != nullptr);
+  g_return_if_fail(self->ref_count > 0);
+  self->ref_count--;
+  if (self->ref_count != 0)
+    return;
+
+  // Values in this arena are freed below, so releasing them from the
+  // containers must not touch the reference count.
+  self->destroying = true;
+  for (guint i = 0; i < self->containers->len; i++) {
+    FlValue* container =
+        static_cast<FlValue*>(g_ptr_array_index(self->containers, i));
+    if (container->type == FL_VALUE_TYPE_LIST) {
+      g_ptr_array_unref(reinterpret_cast<FlValueList*>(container)->values);
+    } else {
+      FlValueMap* map = reinterpret_cast<FlValueMap*>(container);
+      g_ptr_array_unref(map->keys);
+      g_ptr_array_unref(map->values);
+    }
+  }
+  g_ptr_array_unref(self->containers);
+
+  FlValueArenaBlock* block = self->blocks;
+  while (block != nullptr) {
+    FlValueArenaBlock* next = block->next;
+    g_free(block);
+    block = next;
+  }
+
+  if (self->bytes != nullptr)
+    g_bytes_unref(self->bytes);
+  g_free(self);
+}
+
+FlValue* fl_value_arena_new_null(FlValueArena* arena) {
+  g_return_val_if_fail(arena != nullptr, nullptr);
+  return fl_value_arena_new_value(arena, FL_VALUE_TYPE_NULL, sizeof(FlValue));
+}
+
+FlValue* fl_value_arena_new_bool(FlValueArena* arena, bool value) {
+  g_return_val_if_fail(arena != nullptr, nullptr);
+  FlValueBool* self = reinterpret_cast<FlValueBool*>(
+      fl_value_arena_new_value(arena, FL_VALUE_TYPE_BOOL, sizeof(FlValueBool)));
+  self->value = value ? true : false;
+  return reinterpret_cast<FlValue*>(self);
+}
+
+FlValue* fl_value_arena_new_int(FlValueArena* arena, int64_t value) {
+  g_return_val_if_fail(arena != nullptr, nullptr);
+  FlValueInt* self = reinterpret_cast<FlValueInt*>(
+      fl_value_arena_new_value(arena, FL_VALUE_TYPE_INT, sizeof(FlValueInt)));
+  self->value = value;
+  return reinterpret_cast<FlValue*>(self);
+}
+
+FlValue* fl_value_arena_new_float(FlValueArena* arena, double value) {
+  g_return_val_if_fail(arena != nullptr, nullptr);
+  FlValueDouble* self =
+      reinterpret_cast<FlValueDouble*>(fl_value_arena_new_value(
+          arena, FL_VALUE_TYPE_FLOAT, sizeof(FlValueDouble)));
+  self->value = value;
+  return reinterpret_cast<FlValue*>(self);
+}
+
+FlValue* fl_value_arena_new_string_sized(FlValueArena* arena,
+                                         const gchar* value,
+                                         size_t value_length) {
+  g_return_val_if_fail(arena != nullptr, nullptr);
+  FlValueString* self =
+      reinterpret_cast<FlValueString*>(fl_value_arena_new_value(
+          arena, FL_VALUE_TYPE_STRING, sizeof(FlValueString)));
+  self->value =
+      static_cast<gchar*>(fl_value_arena_alloc(arena, value_length + 1));
+  if (value_length > 0)
+    memcpy(self->value, value, value_length);
+  self->value[value_length] = '\0';
+  return reinterpret_cast<FlValue*>(self);
+}
+
+FlValue* fl_value_arena_new_typed_list(FlValueArena* arena,
+                                       FlValueType type,
+                                       const uint8_t* data,
+                                       size_t data_length) {
+  g_return_val_if_fail(arena != nullptr, nullptr);
+  switch (type) {
+    case FL_VALUE_TYPE_UINT8_LIST:
+      return fl_value_arena_new_list_of<FlValueUint8List, uint8_t>(
+          arena, type, data, data_length);
+    case FL_VALUE_TYPE_INT32_LIST:
+      return fl_value_arena_new_list_of<FlValueInt32List, int32_t>(
+          arena, type, data, data_length);
+    case FL_VALUE_TYPE_INT64_LIST:
+      return fl_value_arena_new_list_of<FlValueInt64List, int64_t>(
+          arena, type, data, data_length);
+    case FL_VALUE_TYPE_FLOAT_LIST:
+      return fl_value_arena_new_list_of<FlValueFloatList, double>(
+          arena, type, data, data_length);
+    default:
+      g_return_val_if_reached(nullptr);
+  }
+}
+
+FlValue* fl_value_arena_new_list(FlValueArena* arena, size_t reserved_length) {
+  g_return_val_if_fail(arena != nullptr, nullptr);
+  FlValueList* self = reinterpret_cast<FlValueList*>(
+      fl_value_arena_new_value(arena, FL_VALUE_TYPE_LIST, sizeof(FlValueList)));
+  self->values = g_ptr_array_new_full(reserved_length, fl_value_destroy);
+  g_ptr_array_add(arena->containers, self);
+  return reinterpret_cast<FlValue*>(self);
+}
+
+FlValue* fl_value_arena_new_map(FlValueArena* arena, size_t reserved_length) {
+  g_return_val_if_fail(arena != nullptr, nullptr);
+  FlValueMap* self = reinterpret_cast<FlValueMap*>(
+      fl_value_arena_new_value(arena, FL_VALUE_TYPE_MAP, sizeof(FlValueMap)));
+  self->keys = g_ptr_array_new_full(reserved_length, fl_value_destroy);
+  self->values = g_ptr_array_new_full(reserved_length, fl_value_destroy);
+  g_ptr_array_add(arena->containers, self);
+  return reinterpret_cast<FlValue*>(self);
+}
+
+void fl_value_arena_map_append_take(FlValue* self,
+                                    FlValue* key,
+                                    FlValue* value) {
+  g_return_if_fail(self != nullptr);
+  g_return_if_fail(self->type == FL_VALUE_TYPE_MAP);
+  g_return_if_fail(key != nullptr);
+  g_return_if_fail(value != nullptr);
+
+  FlValueMap* v = reinterpret_cast<FlValueMap*>(self);
+  g_ptr_array_add(v->keys, key);
+  g_ptr_array_add(v->values, value);
+  fl_value_adopt(self, key);
+  fl_value_adopt(self, value);
+}
+
 G_MODULE_EXPORT FlValue* fl_value_ref(FlValue* self) {
   g_return_val_if_fail(self != nullptr, nullptr);
+  if (self->arena != nullptr) {
+    fl_value_arena_ref(self->arena);
+    return self;
+  }
   self->ref_count++;
   return self;
 }
 
 G_MODULE_EXPORT void fl_value_unref(FlValue* self) {
   g_return_if_fail(self != nullptr);
+  if (self->arena != nullptr) {
+    if (!self->arena->destroying)
+      fl_value_arena_unref(self->arena);
+    return;
+  }
   g_return_if_fail(self->ref_count > 0);
   self->ref_count--;
   if (self->ref_count != 0)
@@ -375,6 +665,7 @@ G_MODULE_EXPORT void fl_value_append_take(FlValue* self, FlValue* value) {
 
   FlValueList* v = reinterpret_cast<FlValueList*>(self);
   g_ptr_array_add(v->values, value);
+  fl_value_adopt(self, value);
 }
 
 G_MODULE_EXPORT void fl_value_set(FlValue* self, FlValue* key, FlValue* value) {
@@ -400,11 +691,13 @@ G_MODULE_EXPORT void fl_value_set_take(FlValue* self,
     g_ptr_array_add(v->keys, key);
     g_ptr_array_add(v->values, value);
   } else {
-    fl_value_destroy(v->keys->pdata[index]);
+    fl_value_release(self, static_cast<FlValue*>(v->keys->pdata[index]));
     v->keys->pdata[index] = key;
-    fl_value_destroy(v->values->pdata[index]);
+    fl_value_release(self, static_cast<FlValue*>(v->values->pdata[index]));
     v->values->pdata[index] = value;
   }
+  fl_value_adopt(self, key);
+  fl_value_adopt(self, value);
 }
 
 G_MODULE_EXPORT void fl_value_set_string(FlValue* self,
@@ -0,0 +1,174 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_LINUX_FL_VALUE_PRIVATE_H_
+#define FLUTTER_SHELL_PLATFORM_LINUX_FL_VALUE_PRIVATE_H_
+
+#include "flutter/shell/platform/linux/public/flutter_linux/fl_value.h"
+
+G_BEGIN_DECLS
+
+/**
+ * FlValueArena:
+ *
+ * #FlValueArena allocates the values decoded from a single message together,
+ * so that they are freed in one go rather than individually.
+ *
+ * Values allocated from an arena behave like any other #FlValue, except that
+ * referencing one of them references the whole arena: the arena is freed
+ * once no references remain to any of its values. Containers in an arena
+ * don't hold references to the values of the same arena they contain.
+ *
+ * Typed lists refer to the message the arena was created for rather than
+ * copying it, when the data is suitably aligned.
+ */
+typedef struct _FlValueArena FlValueArena;
+
+/**
+ * fl_value_arena_new:
+ * @bytes: (allow-none): the message values are decoded from, or %NULL.
+ *
+ * Creates a new arena.
+ *
+ * Returns: a new #FlValueArena.
+ */
+FlValueArena* fl_value_arena_new(GBytes* bytes);
+
+/**
+ * fl_value_arena_ref:
+ * @arena: an #FlValueArena.
+ *
+ * Increases the reference count of an #FlValueArena.
+ *
+ * Returns: the arena that was referenced.
+ */
+FlValueArena* fl_value_arena_ref(FlValueArena* arena);
+
+/**
+ * fl_value_arena_unref:
+ * @arena: an #FlValueArena.
+ *
+ * Decreases the reference count of an #FlValueArena. When the reference count
+ * hits zero all the values in the arena are freed.
+ */
+void fl_value_arena_unref(FlValueArena* arena);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FlValueArena, fl_value_arena_unref)
+
+/**
+ * fl_value_arena_new_null:
+ * @arena: an #FlValueArena.
+ *
+ * Creates an #FlValue that contains a null value in @arena.
+ *
+ * Returns: a new #FlValue.
+ */
+FlValue* fl_value_arena_new_null(FlValueArena* arena);
+
+/**
+ * fl_value_arena_new_bool:
+ * @arena: an #FlValueArena.
+ * @value: the value.
+ *
+ * Creates an #FlValue that contains a boolean value in @arena.
+ *
+ * Returns: a new #FlValue.
+ */
+FlValue* fl_value_arena_new_bool(FlValueArena* arena, bool value);
+
+/**
+ * fl_value_arena_new_int:
+ * @arena: an #FlValueArena.
+ * @value: the value.
+ *
+ * Creates an #FlValue that contains an integer number in @arena.
+ *
+ * Returns: a new #FlValue.
+ */
+FlValue* fl_value_arena_new_int(FlValueArena* arena, int64_t value);
+
+/**
+ * fl_value_arena_new_float:
+ * @arena: an #FlValueArena.
+ * @value: the value.
+ *
+ * Creates an #FlValue that contains a floating point number in @arena.
+ *
+ * Returns: a new #FlValue.
+ */
+FlValue* fl_value_arena_new_float(FlValueArena* arena, double value);
+
+/**
+ * fl_value_arena_new_string_sized:
+ * @arena: an #FlValueArena.
+ * @value: a UTF-8 text string, which does not need to be nul-terminated.
+ * @value_length: the number of bytes to use from @value.
+ *
+ * Creates an #FlValue that contains a copy of @value in @arena.
+ *
+ * Returns: a new #FlValue.
+ */
+FlValue* fl_value_arena_new_string_sized(FlValueArena* arena,
+                                         const gchar* value,
+                                         size_t value_length);
+
+/**
+ * fl_value_arena_new_typed_list:
+ * @arena: an #FlValueArena.
+ * @type: one of #FL_VALUE_TYPE_UINT8_LIST, #FL_VALUE_TYPE_INT32_LIST,
+ * #FL_VALUE_TYPE_INT64_LIST or #FL_VALUE_TYPE_FLOAT_LIST.
+ * @data: the elements of the list, within the message @arena was created for.
+ * @data_length: the number of elements in the list.
+ *
+ * Creates an ordered list of numbers in @arena. The list refers to @data
+ * directly if it is suitably aligned for the element type, and otherwise
+ * copies it into @arena.
+ *
+ * Returns: a new #FlValue.
+ */
+FlValue* fl_value_arena_new_typed_list(FlValueArena* arena,
+                                       FlValueType type,
+                                       const uint8_t* data,
+                                       size_t data_length);
+
+/**
+ * fl_value_arena_new_list:
+ * @arena: an #FlValueArena.
+ * @reserved_length: the number of values the list is expected to contain.
+ *
+ * Creates an ordered list in @arena. Values are added with
+ * fl_value_append_take().
+ *
+ * Returns: a new #FlValue.
+ */
+FlValue* fl_value_arena_new_list(FlValueArena* arena, size_t reserved_length);
+
+/**
+ * fl_value_arena_new_map:
+ * @arena: an #FlValueArena.
+ * @reserved_length: the number of entries the map is expected to contain.
+ *
+ * Creates an ordered associative array in @arena. Entries are added with
+ * fl_value_arena_map_append_take().
+ *
+ * Returns: a new #FlValue.
+ */
+FlValue* fl_value_arena_new_map(FlValueArena* arena, size_t reserved_length);
+
+/**
+ * fl_value_arena_map_append_take:
+ * @map: an #FlValue of type #FL_VALUE_TYPE_MAP.
+ * @key: (transfer full): a key, which is not already in @map.
+ * @value: (transfer full): the value to associate with @key.
+ *
+ * Adds an entry to the end of a map without checking whether @key is already
+ * present, unlike fl_value_set_take(). Decoders use this since encoded maps
+ * can't contain duplicate keys, which makes decoding a map linear in its
+ * length.
+ */
+void fl_value_arena_map_append_take(FlValue* map, FlValue* key, FlValue* value);
+
+G_END_DECLS
+
+#endif  // FLUTTER_SHELL_PLATFORM_LINUX_FL_VALUE_PRIVATE_H_
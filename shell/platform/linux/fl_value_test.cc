@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "flutter/shell/platform/linux/public/flutter_linux/fl_value.h"
+#include "flutter/shell/platform/linux/fl_value_private.h"
 #include "gtest/gtest.h"
 
 #include <gmodule.h>
@@ -729,3 +730,101 @@ TEST(FlValueTest, ListMapNotEqual) {
   g_autoptr(FlValue) value2 = fl_value_new_map();
   EXPECT_FALSE(fl_value_equal(value1, value2));
 }
+
+TEST(FlValueTest, ArenaValuesOutliveContainer) {
+  g_autoptr(FlValueArena) arena = fl_value_arena_new(nullptr);
+  g_autoptr(FlValue) list = fl_value_arena_new_list(arena, 2);
+  fl_value_append_take(list, fl_value_arena_new_int(arena, 42));
+  fl_value_append_take(list,
+                       fl_value_arena_new_string_sized(arena, "hello!", 5));
+  ASSERT_EQ(fl_value_get_length(list), static_cast<size_t>(2));
+
+  g_autoptr(FlValue) child = fl_value_ref(fl_value_get_list_value(list, 1));
+  g_clear_pointer(&list, fl_value_unref);
+  g_clear_pointer(&arena, fl_value_arena_unref);
+
+  ASSERT_EQ(fl_value_get_type(child), FL_VALUE_TYPE_STRING);
+  EXPECT_STREQ(fl_value_get_string(child), "hello");
+}
+
+TEST(FlValueTest, ArenaLargeString) {
+  g_autoptr(FlValueArena) arena = fl_value_arena_new(nullptr);
+  g_autofree gchar* text = g_strnfill(10000, 'a');
+  g_autoptr(FlValue) small = fl_value_arena_new_string_sized(arena, "a", 1);
+  g_autoptr(FlValue) large =
+      fl_value_arena_new_string_sized(arena, text, 10000);
+  g_autoptr(FlValue) small2 = fl_value_arena_new_string_sized(arena, "b", 1);
+  EXPECT_STREQ(fl_value_get_string(large), text);
+  EXPECT_STREQ(fl_value_get_string(small), "a");
+  EXPECT_STREQ(fl_value_get_string(small2), "b");
+}
+
+TEST(FlValueTest, ArenaTypedListReferencesBytes) {
+  int32_t data[] = {1, 2, 3, 4};
+  g_autoptr(GBytes) bytes = g_bytes_new(data, sizeof(data));
+  const uint8_t* bytes_data =
+      static_cast<const uint8_t*>(g_bytes_get_data(bytes, nullptr));
+  g_autoptr(FlValueArena) arena = fl_value_arena_new(bytes);
+
+  g_autoptr(FlValue) value = fl_value_arena_new_typed_list(
+      arena, FL_VALUE_TYPE_INT32_LIST, bytes_data, 4);
+  ASSERT_EQ(fl_value_get_type(value), FL_VALUE_TYPE_INT32_LIST);
+  ASSERT_EQ(fl_value_get_length(value), static_cast<size_t>(4));
+  EXPECT_EQ(reinterpret_cast<const uint8_t*>(fl_value_get_int32_list(value)),
+            bytes_data);
+
+  g_autoptr(FlValue) expected = fl_value_new_int32_list(data, 4);
+  EXPECT_TRUE(fl_value_equal(value, expected));
+}
+
+TEST(FlValueTest, ArenaTypedListCopiesUnalignedData) {
+  uint8_t data[] = {0, 1, 0, 0, 0, 0, 0, 0, 0};
+  g_autoptr(GBytes) bytes = g_bytes_new(data, sizeof(data));
+  const uint8_t* bytes_data =
+      static_cast<const uint8_t*>(g_bytes_get_data(bytes, nullptr));
+  g_autoptr(FlValueArena) arena = fl_value_arena_new(bytes);
+
+  g_autoptr(FlValue) value = fl_value_arena_new_typed_list(
+      arena, FL_VALUE_TYPE_INT64_LIST, bytes_data + 1, 1);
+  ASSERT_EQ(fl_value_get_length(value), static_cast<size_t>(1));
+  EXPECT_NE(reinterpret_cast<const uint8_t*>(fl_value_get_int64_list(value)),
+            bytes_data + 1);
+  EXPECT_EQ(fl_value_get_int64_list(value)[0], 1);
+}
+
+TEST(FlValueTest, ArenaListHoldsOtherValues) {
+  g_autoptr(FlValue) heap_value = fl_value_new_string("heap");
+  g_autoptr(FlValueArena) other_arena = fl_value_arena_new(nullptr);
+  g_autoptr(FlValue) other_value = fl_value_arena_new_bool(other_arena, true);
+  g_clear_pointer(&other_arena, fl_value_arena_unref);
+
+  FlValueArena* arena = fl_value_arena_new(nullptr);
+  FlValue* list = fl_value_arena_new_list(arena, 0);
+  fl_value_arena_unref(arena);
+  fl_value_append(list, heap_value);
+  fl_value_append(list, other_value);
+  fl_value_append_take(list, fl_value_arena_new_null(arena));
+  EXPECT_EQ(fl_value_get_length(list), static_cast<size_t>(3));
+  fl_value_unref(list);
+
+  EXPECT_STREQ(fl_value_get_string(heap_value), "heap");
+  EXPECT_TRUE(fl_value_get_bool(other_value));
+}
+
+TEST(FlValueTest, ArenaMapAppendAndSet) {
+  g_autoptr(FlValueArena) arena = fl_value_arena_new(nullptr);
+  g_autoptr(FlValue) map = fl_value_arena_new_map(arena, 2);
+  fl_value_arena_map_append_take(
+      map, fl_value_arena_new_string_sized(arena, "one", 3),
+      fl_value_arena_new_int(arena, 1));
+  fl_value_arena_map_append_take(
+      map, fl_value_arena_new_string_sized(arena, "two", 3),
+      fl_value_arena_new_int(arena, 2));
+  fl_value_set_string_take(map, "two", fl_value_arena_new_int(arena, 22));
+  fl_value_set_string_take(map, "three", fl_value_new_int(3));
+
+  ASSERT_EQ(fl_value_get_length(map), static_cast<size_t>(3));
+  EXPECT_EQ(fl_value_get_int(fl_value_lookup_string(map, "one")), 1);
+  EXPECT_EQ(fl_value_get_int(fl_value_lookup_string(map, "two")), 22);
+  EXPECT_EQ(fl_value_get_int(fl_value_lookup_string(map, "three")), 3);
+}
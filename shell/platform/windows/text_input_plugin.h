@@ -41,7 +41,10 @@ class TextInputPlugin : public KeyboardHookHandler {
 
  private:
   // Sends the current state of the given model to the Flutter engine.
-  void SendStateUpdate(const TextInputModel& model);
+  //
+  // If the client enabled the delta model, only the text that changed since
+  // the last update is sent.
+  void SendStateUpdate(TextInputModel* model);
 
   // Sends an action triggered by the Enter key to the Flutter engine.
   void EnterPressed(TextInputModel* model);
@@ -59,6 +62,9 @@ class TextInputPlugin : public KeyboardHookHandler {
 
   // The active model. nullptr if not set.
   std::unique_ptr<TextInputModel> active_model_;
+
+  // Whether the active client accepts deltas rather than the whole text.
+  bool delta_model_enabled_ = false;
 };
 
 }  // namespace flutter
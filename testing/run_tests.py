@@ -62,6 +62,20 @@ def IsWindows():
   return sys.platform.startswith(('cygwin', 'win'))
 
 
+def AreDesktopEmbeddingsEnabled(build_dir):
+  # Mirrors enable_desktop_embeddings in //flutter/shell/platform/config.gni,
+  # which builds may override in their args.gn.
+  args_path = os.path.join(build_dir, 'args.gn')
+  if not os.path.exists(args_path):
+    return True
+  with open(args_path) as args_file:
+    args = args_file.read()
+  match = re.search(r'^\s*enable_desktop_embeddings\s*=\s*(true|false)', args, re.MULTILINE)
+  if match:
+    return match.group(1) == 'true'
+  return not re.search(r'^\s*is_fuchsia_host\s*=\s*true', args, re.MULTILINE)
+
+
 def ExecutableSuffix():
   return '.exe' if IsWindows() else ''
 
@@ -126,6 +140,8 @@ def RunCCTests(build_dir, filter):
     ]
   RunEngineExecutable(build_dir, 'flow_unittests', filter, flow_flags + shuffle_flags)
 
+  RunEngineExecutable(build_dir, 'assets_unittests', filter, shuffle_flags)
+
   # TODO(44614): Re-enable after https://github.com/flutter/flutter/issues/44614 has been addressed.
   # RunEngineExecutable(build_dir, 'fml_unittests', filter, [ fml_unittests_filter ] + shuffle_flags)
 
@@ -160,9 +176,26 @@ def RunEngineBenchmarks(build_dir, filter):
 
   RunEngineExecutable(build_dir, 'fml_benchmarks', filter)
 
+  RunEngineExecutable(build_dir, 'flow_benchmarks', filter)
+
+  RunEngineExecutable(build_dir, 'ui_benchmarks', filter)
+
+  RunEngineExecutable(build_dir, 'assets_benchmarks', filter)
+
+  RunEngineExecutable(build_dir, 'embedder_benchmarks', filter)
+
+  # Only built with the desktop embeddings, and not on Windows.
+  if AreDesktopEmbeddingsEnabled(build_dir) and not IsWindows():
+    RunEngineExecutable(build_dir, 'client_wrapper_benchmarks', filter)
+
+    RunEngineExecutable(build_dir, 'common_cpp_benchmarks', filter)
+
   if IsLinux():
     RunEngineExecutable(build_dir, 'txt_benchmarks', filter)
 
+  if IsLinux():
+    RunEngineExecutable(build_dir, 'flutter_linux_benchmarks', filter)
+
 
 
 def SnapshotTest(build_dir, dart_file, kernel_file_output, verbose_dart_snapshot):
@@ -0,0 +1,264 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Replays a layer tree captured with the _flutter.screenshotLayerTree service
+// protocol extension on the software backend, and reports how long frames
+// took to raster and, optionally, how long each of the layers took.
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "flutter/flow/compositor_context.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/layers/layer_tree_serialization.h"
+#include "flutter/flow/skia_gpu_object.h"
+#include "flutter/fml/command_line.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/message_loop.h"
+#include "flutter/fml/time/time_point.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+
+namespace {
+
+struct LayerTiming {
+  SerializedLayerType type;
+  uint64_t unique_id;
+  fml::TimeDelta preroll_time;
+  fml::TimeDelta paint_time;
+};
+
+// Wraps a replayed layer to time its preroll and paint, including those of
+// its descendants.
+class TimedLayer : public ContainerLayer {
+ public:
+  explicit TimedLayer(LayerTiming* timing) : timing_(timing) {}
+
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override {
+    const fml::TimePoint start = fml::TimePoint::Now();
+    ContainerLayer::Preroll(context, matrix);
+    timing_->preroll_time =
+        timing_->preroll_time + (fml::TimePoint::Now() - start);
+  }
+
+  void Paint(PaintContext& context) const override {
+    const fml::TimePoint start = fml::TimePoint::Now();
+    ContainerLayer::Paint(context);
+    timing_->paint_time =
+        timing_->paint_time + (fml::TimePoint::Now() - start);
+  }
+
+ private:
+  LayerTiming* timing_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TimedLayer);
+};
+
+void Usage() {
+  std::cout << "Usage:" << std::endl;
+  std::cout << "layer_tree_replay [--frames=<count>] [--time-layers] "
+               "[--layers=<count>] <layer_tree>"
+            << std::endl;
+  std::cout << std::endl;
+  std::cout << "The layer tree file must contain the decoded bytes of the "
+               "layerTree field returned by _flutter.screenshotLayerTree."
+            << std::endl;
+  std::cout << "The tree is rastered --frames times (100 by default) on the "
+               "software backend, keeping its raster cache between frames as "
+               "if every layer were retained."
+            << std::endl;
+  std::cout << "With --time-layers, the tree is then rastered as many times "
+               "again with every layer timed, and the --layers layers (10 by "
+               "default) that took longest to paint are reported. Timing "
+               "the layers slows frames down, so frame times are always "
+               "taken from the untimed frames."
+            << std::endl;
+}
+
+size_t GetCountOption(const fml::CommandLine& command_line,
+                      std::string_view name,
+                      size_t default_value) {
+  std::string value;
+  if (!command_line.GetOptionValue(name, &value)) {
+    return default_value;
+  }
+  return std::strtoul(value.c_str(), nullptr, 10);
+}
+
+double AverageMilliseconds(fml::TimeDelta total, size_t count) {
+  return count == 0 ? 0 : total.ToMillisecondsF() / count;
+}
+
+// Rasters |layer_tree| |frame_count| times with |compositor_context| and
+// returns how long each frame took.
+std::vector<fml::TimeDelta> RasterFrames(CompositorContext& compositor_context,
+                                         SkSurface* surface,
+                                         LayerTree& layer_tree,
+                                         size_t frame_count) {
+  std::vector<fml::TimeDelta> frame_times;
+  for (size_t i = 0; i < frame_count; i++) {
+    const fml::TimePoint start = fml::TimePoint::Now();
+    {
+      auto frame = compositor_context.AcquireFrame(
+          nullptr, surface->getCanvas(), nullptr, SkMatrix::I(), true, true,
+          nullptr);
+      frame->Raster(layer_tree, false);
+    }
+    frame_times.push_back(fml::TimePoint::Now() - start);
+  }
+  return frame_times;
+}
+
+// Rasters the layer tree in |data| |frame_count| times with each of its
+// layers wrapped in a |TimedLayer|, and reports the |layer_count| layers that
+// took longest to paint.
+void ReportLayerTimings(const SkData& data,
+                        fml::RefPtr<SkiaUnrefQueue> unref_queue,
+                        SkSurface* surface,
+                        size_t frame_count,
+                        size_t layer_count) {
+  std::vector<std::unique_ptr<LayerTiming>> timings;
+  auto layer_tree = DeserializeLayerTree(
+      data, unref_queue,
+      [&timings](std::shared_ptr<Layer> layer, SerializedLayerType type,
+                 uint64_t unique_id) -> std::shared_ptr<Layer> {
+        timings.push_back(std::make_unique<LayerTiming>(
+            LayerTiming{type, unique_id, {}, {}}));
+        auto timed_layer = std::make_shared<TimedLayer>(timings.back().get());
+        timed_layer->Add(std::move(layer));
+        return timed_layer;
+      });
+  FML_CHECK(layer_tree && layer_tree->root_layer());
+
+  CompositorContext compositor_context;
+  RasterFrames(compositor_context, surface, *layer_tree, frame_count);
+
+  std::vector<const LayerTiming*> slowest;
+  for (const auto& timing : timings) {
+    slowest.push_back(timing.get());
+  }
+  std::sort(slowest.begin(), slowest.end(),
+            [](const LayerTiming* a, const LayerTiming* b) {
+              return a->paint_time > b->paint_time;
+            });
+  slowest.resize(std::min(slowest.size(), layer_count));
+  std::cout << "Slowest layers, including their descendants, per frame:"
+            << std::endl;
+  for (const auto* timing : slowest) {
+    std::cout << "  " << SerializedLayerTypeName(timing->type) << " #"
+              << timing->unique_id << ": preroll "
+              << AverageMilliseconds(timing->preroll_time, frame_count)
+              << " ms, paint "
+              << AverageMilliseconds(timing->paint_time, frame_count) << " ms"
+              << std::endl;
+  }
+}
+
+int Replay(const fml::CommandLine& command_line) {
+  if (command_line.positional_args().size() != 1) {
+    Usage();
+    return EXIT_FAILURE;
+  }
+  const size_t frame_count = GetCountOption(command_line, "frames", 100);
+  const bool time_layers = command_line.HasOption("time-layers");
+  const size_t layer_count = GetCountOption(command_line, "layers", 10);
+  const std::string& path = command_line.positional_args()[0];
+
+  auto mapping = fml::FileMapping::CreateReadOnly(path);
+  if (!mapping || mapping->GetMapping() == nullptr) {
+    std::cerr << "Could not read " << path << std::endl;
+    return EXIT_FAILURE;
+  }
+  auto data = SkData::MakeWithoutCopy(mapping->GetMapping(),
+                                      mapping->GetSize());
+
+  fml::MessageLoop::EnsureInitializedForCurrentThread();
+  auto unref_queue = fml::MakeRefCounted<SkiaUnrefQueue>(
+      fml::MessageLoop::GetCurrent().GetTaskRunner(), fml::TimeDelta::Zero());
+
+  size_t tree_layer_count = 0;
+  auto layer_tree = DeserializeLayerTree(
+      *data, unref_queue,
+      [&tree_layer_count](std::shared_ptr<Layer> layer, SerializedLayerType,
+                          uint64_t) {
+        tree_layer_count++;
+        return layer;
+      });
+  if (!layer_tree || !layer_tree->root_layer()) {
+    std::cerr << "Could not read a layer tree from " << path << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const SkISize frame_size = layer_tree->frame_size();
+  auto surface = SkSurface::MakeRasterN32Premul(frame_size.width(),
+                                                frame_size.height());
+  if (!surface) {
+    std::cerr << "Could not create a " << frame_size.width() << "x"
+              << frame_size.height() << " surface." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  CompositorContext compositor_context;
+  const std::vector<fml::TimeDelta> frame_times = RasterFrames(
+      compositor_context, surface.get(), *layer_tree, frame_count);
+
+  std::cout << std::fixed << std::setprecision(3);
+  std::cout << "Replayed " << frame_count << " frames of a "
+            << frame_size.width() << "x" << frame_size.height()
+            << " layer tree with " << tree_layer_count << " layers."
+            << std::endl;
+  if (!frame_times.empty()) {
+    std::cout << "First frame: " << frame_times[0].ToMillisecondsF() << " ms"
+              << std::endl;
+    std::vector<fml::TimeDelta> sorted_times(frame_times.begin() + 1,
+                                             frame_times.end());
+    std::sort(sorted_times.begin(), sorted_times.end());
+    if (!sorted_times.empty()) {
+      fml::TimeDelta total;
+      for (const auto& time : sorted_times) {
+        total = total + time;
+      }
+      std::cout << "Later frames: average "
+                << AverageMilliseconds(total, sorted_times.size())
+                << " ms, 90th percentile "
+                << sorted_times[sorted_times.size() * 9 / 10]
+                       .ToMillisecondsF()
+                << " ms, worst " << sorted_times.back().ToMillisecondsF()
+                << " ms" << std::endl;
+    }
+  }
+
+  const RasterCacheFrameStats& stats =
+      compositor_context.raster_cache().GetLastFrameStats();
+  std::cout << "Raster cache: " << stats.picture_count << " pictures ("
+            << stats.picture_bytes << " bytes), " << stats.layer_count
+            << " layers (" << stats.layer_bytes << " bytes), "
+            << stats.shadow_count << " shadows (" << stats.shadow_bytes
+            << " bytes)" << std::endl;
+
+  layer_tree.reset();
+  if (time_layers) {
+    ReportLayerTimings(*data, unref_queue, surface.get(), frame_count,
+                       layer_count);
+  }
+
+  unref_queue->Drain();
+  return EXIT_SUCCESS;
+}
+
+}  // namespace
+
+}  // namespace flutter
+
+int main(int argc, char* argv[]) {
+  return flutter::Replay(fml::CommandLineFromArgcArgv(argc, argv));
+}
@@ -0,0 +1,80 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <iostream>
+#include <string>
+
+#include "flutter/assets/packed_asset_bundle.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+
+void Usage() {
+  std::cout << "Usage:" << std::endl;
+  std::cout << "pack_assets <assets directory> <output directory> "
+               "[<archive name>]"
+            << std::endl;
+  std::cout << std::endl;
+  std::cout << "Packs every file in the assets directory and its "
+               "subdirectories into a single archive that can be resolved by "
+               "a flutter::PackedAssetBundle. Assets are named by their path "
+               "relative to the assets directory."
+            << std::endl;
+  std::cout << "The archive is named "
+            << flutter::PackedAssetBundle::kArchiveFileName
+            << " by default, which is the name the engine looks for in its "
+               "assets directory."
+            << std::endl;
+  std::cout << "The archive will be overwritten if it exists already and "
+               "packing succeeds."
+            << std::endl;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 3 && argc != 4) {
+    Usage();
+    return -1;
+  }
+  const std::string assets_path(argv[1]);
+  const std::string output_path(argv[2]);
+  const std::string archive_name(
+      argc == 4 ? argv[3] : flutter::PackedAssetBundle::kArchiveFileName);
+
+  auto assets_directory = fml::OpenDirectory(assets_path.c_str(), false,
+                                             fml::FilePermission::kRead);
+  if (!assets_directory.is_valid()) {
+    std::cerr << "Failed to open assets directory " << assets_path
+              << "; aborting." << std::endl;
+    return -1;
+  }
+
+  auto output_directory = fml::OpenDirectory(output_path.c_str(), false,
+                                             fml::FilePermission::kReadWrite);
+  if (!output_directory.is_valid()) {
+    output_directory = fml::OpenDirectory(output_path.c_str(), true,
+                                          fml::FilePermission::kReadWrite);
+  }
+  if (!output_directory.is_valid()) {
+    std::cerr << "Failed to open output directory " << output_path
+              << "; aborting." << std::endl;
+    return -1;
+  }
+
+  if (!flutter::PackedAssetBundle::PackDirectory(
+          assets_directory, output_directory, archive_name.c_str())) {
+    std::cerr << "Failed to pack assets; aborting." << std::endl;
+    return -1;
+  }
+
+  flutter::PackedAssetBundle bundle(
+      fml::FileMapping::CreateReadOnly(output_directory, archive_name));
+  if (!bundle.IsValid()) {
+    std::cerr << "The written archive could not be read back; aborting."
+              << std::endl;
+    return -1;
+  }
+
+  std::cout << "Packed " << bundle.GetAssetCount() << " assets into "
+            << archive_name << "." << std::endl;
+  return 0;
+}